@@ -32,9 +32,10 @@
 
 /**
  * @file
- * @brief Gnome Sort.
+ * @brief Generic stable sort.
  *
- * This file contains an implementation of gnome sort
+ * This file contains an implementation of merge sort which
+ * falls back to insertion sort for short runs.
  *
  */
 
@@ -51,15 +52,15 @@
  */
 #define IBUF_SIZE  32
 
+/** Runs up to this many elements are sorted by insertion sort. */
+#define RUN_SIZE  16
+
 /** Array accessor.
  *
  */
 #define INDEX(buf, i, elem_size)  ((buf) + (i) * (elem_size))
 
-/** Gnome sort
- *
- * Apply generic gnome sort algorithm on supplied data,
- * using pre-allocated buffer.
+/** Insertion sort
  *
  * @param data      Pointer to data to be sorted.
  * @param cnt       Number of elements to be sorted.
@@ -70,30 +71,96 @@
  *                  elem_size bytes long.
  *
  */
-static void _gsort(void *data, size_t cnt, size_t elem_size, sort_cmp_t cmp,
+static void _isort(void *data, size_t cnt, size_t elem_size, sort_cmp_t cmp,
     void *arg, void *slot)
 {
-	size_t i = 0;
-
-	while (i < cnt) {
-		if ((i != 0) &&
-		    (cmp(INDEX(data, i, elem_size),
-		    INDEX(data, i - 1, elem_size), arg) < 0)) {
-			memcpy(slot, INDEX(data, i, elem_size), elem_size);
-			memcpy(INDEX(data, i, elem_size), INDEX(data, i - 1, elem_size),
-			    elem_size);
-			memcpy(INDEX(data, i - 1, elem_size), slot, elem_size);
-			i--;
-		} else
+	size_t i;
+	size_t j;
+
+	for (i = 1; i < cnt; i++) {
+		j = i;
+		while ((j > 0) && (cmp(INDEX(data, i, elem_size),
+		    INDEX(data, j - 1, elem_size), arg) < 0))
+			j--;
+
+		if (j == i)
+			continue;
+
+		memcpy(slot, INDEX(data, i, elem_size), elem_size);
+		memmove(INDEX(data, j + 1, elem_size), INDEX(data, j, elem_size),
+		    (i - j) * elem_size);
+		memcpy(INDEX(data, j, elem_size), slot, elem_size);
+	}
+}
+
+/** Merge sort
+ *
+ * Sort both halves recursively and merge them, moving the left
+ * half to @a mbuf first. Elements that compare equal keep their
+ * relative order.
+ *
+ * @param data      Pointer to data to be sorted.
+ * @param cnt       Number of elements to be sorted.
+ * @param elem_size Size of one element.
+ * @param cmp       Comparator function.
+ * @param arg       3rd argument passed to cmp.
+ * @param slot      Pointer to scratch memory buffer
+ *                  elem_size bytes long.
+ * @param mbuf      Pointer to scratch memory buffer
+ *                  (cnt / 2) * elem_size bytes long.
+ *
+ */
+static void _msort(void *data, size_t cnt, size_t elem_size, sort_cmp_t cmp,
+    void *arg, void *slot, void *mbuf)
+{
+	size_t half;
+	size_t i;
+	size_t j;
+	void *dest;
+
+	if (cnt <= RUN_SIZE) {
+		_isort(data, cnt, elem_size, cmp, arg, slot);
+		return;
+	}
+
+	half = cnt / 2;
+	_msort(data, half, elem_size, cmp, arg, slot, mbuf);
+	_msort(INDEX(data, half, elem_size), cnt - half, elem_size, cmp, arg,
+	    slot, mbuf);
+
+	/* Already in order */
+	if (cmp(INDEX(data, half, elem_size), INDEX(data, half - 1, elem_size),
+	    arg) >= 0)
+		return;
+
+	memcpy(mbuf, data, half * elem_size);
+
+	i = 0;
+	j = half;
+	dest = data;
+	while ((i < half) && (j < cnt)) {
+		if (cmp(INDEX(data, j, elem_size), INDEX(mbuf, i, elem_size),
+		    arg) < 0) {
+			memcpy(dest, INDEX(data, j, elem_size), elem_size);
+			j++;
+		} else {
+			memcpy(dest, INDEX(mbuf, i, elem_size), elem_size);
 			i++;
+		}
+
+		dest += elem_size;
 	}
+
+	/* Whatever remains of the right half is already in place */
+	memcpy(dest, INDEX(mbuf, i, elem_size), (half - i) * elem_size);
 }
 
-/** Gnome sort wrapper
+/** Generic stable sort
  *
  * This is only a wrapper that takes care of memory
- * allocations for storing the slot element for generic
- * gnome sort algorithm.
+ * allocations for the slot element and the merge buffer.
+ * If the merge buffer cannot be allocated, the data is
+ * sorted using insertion sort instead.
  *
  * @param data      Pointer to data to be sorted.
  * @param cnt       Number of elements to be sorted.
@@ -108,6 +175,7 @@ bool gsort(void *data, size_t cnt, size_t elem_size, sort_cmp_t cmp, void *arg)
 {
 	uint8_t ibuf_slot[IBUF_SIZE];
 	void *slot;
+	void *mbuf = NULL;
 
 	if (elem_size > IBUF_SIZE) {
 		slot = (void *) malloc(elem_size);
@@ -116,7 +184,14 @@ bool gsort(void *data, size_t cnt, size_t elem_size, sort_cmp_t cmp, void *arg)
 	} else
 		slot = (void *) ibuf_slot;
 
-	_gsort(data, cnt, elem_size, cmp, arg, slot);
+	if (cnt > RUN_SIZE)
+		mbuf = malloc((cnt / 2) * elem_size);
+
+	if (mbuf != NULL) {
+		_msort(data, cnt, elem_size, cmp, arg, slot, mbuf);
+		free(mbuf);
+	} else
+		_isort(data, cnt, elem_size, cmp, arg, slot);
 
 	if (elem_size > IBUF_SIZE)
 		free(slot);
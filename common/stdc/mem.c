@@ -46,6 +46,8 @@
 #undef memmove
 #undef memchr
 
+#ifndef ARCH_HAS_MEMSET
+
 /** Fill memory block with a constant value. */
 DO_NOT_DISCARD
 ATTRIBUTE_OPTIMIZE_NO_TLDP
@@ -102,6 +104,10 @@ ATTRIBUTE_OPTIMIZE_NO_TLDP
 	return dest;
 }
 
+#endif
+
+#ifndef ARCH_HAS_MEMCPY
+
 struct along {
 	unsigned long n;
 } __attribute__((packed));
@@ -202,6 +208,10 @@ ATTRIBUTE_OPTIMIZE_NO_TLDP
 	return dst;
 }
 
+#endif
+
+#ifndef ARCH_HAS_MEMMOVE
+
 /** Move memory block with possible overlapping. */
 DO_NOT_DISCARD
 ATTRIBUTE_OPTIMIZE_NO_TLDP
@@ -239,6 +249,8 @@ void *memmove(void *dst, const void *src, size_t n)
 	return dst;
 }
 
+#endif
+
 /** Compare two memory areas.
  *
  * @param s1  Pointer to the first area to compare.
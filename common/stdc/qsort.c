@@ -33,35 +33,136 @@
 /**
  * @file
  * @brief Quicksort.
+ *
+ * Introsort: quicksort with a median of three pivot that falls back to
+ * heap sort once the recursion gets too deep, so that the worst case is
+ * O(n log n). Short ranges are finished with insertion sort.
  */
 
 #include <qsort.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+/** Ranges up to this many elements are sorted with insertion sort */
+#define QS_INSERTION_THRESHOLD 16
 
 /** Quicksort spec */
 typedef struct {
 	void *base;
 	size_t nmemb;
 	size_t size;
-	int (*compar)(const void *, const void *, void *);
+	/** Comparison function (qsort) or NULL */
+	int (*compar)(const void *, const void *);
+	/** Comparison function (qsort_r) */
+	int (*compar_r)(const void *, const void *, void *);
 	void *arg;
+	/** Element swap function chosen for the element size and alignment */
+	void (*swap)(void *, void *, size_t);
 } qs_spec_t;
 
-/** Comparison function wrapper.
+/** Swap two elements byte by byte.
  *
- * Performs qsort_r comparison using qsort comparison function
+ * @param a First element
+ * @param b Second element
+ * @param size Element size
+ */
+static void swap_bytes(void *a, void *b, size_t size)
+{
+	uint8_t *pa = a;
+	uint8_t *pb = b;
+	uint8_t t;
+	size_t k;
+
+	for (k = 0; k < size; k++) {
+		t = pa[k];
+		pa[k] = pb[k];
+		pb[k] = t;
+	}
+}
+
+/** Swap two elements which are a multiple of words long and word-aligned.
  *
  * @param a First element
  * @param b Second element
- * @param arg qsort comparison function
+ * @param size Element size
  */
-static int compar_wrap(const void *a, const void *b, void *arg)
+static void swap_words(void *a, void *b, size_t size)
 {
-	int (*compar)(const void *, const void *) =
-	    (int (*)(const void *, const void *))arg;
+	unsigned long *pa = a;
+	unsigned long *pb = b;
+	unsigned long t;
+	size_t k;
 
-	return compar(a, b);
+	for (k = 0; k < size / sizeof(unsigned long); k++) {
+		t = pa[k];
+		pa[k] = pb[k];
+		pb[k] = t;
+	}
+}
+
+/** Swap two aligned 32-bit elements.
+ *
+ * @param a First element
+ * @param b Second element
+ * @param size Element size
+ */
+static void swap_u32(void *a, void *b, size_t size)
+{
+	uint32_t t;
+
+	(void) size;
+	t = *(uint32_t *) a;
+	*(uint32_t *) a = *(uint32_t *) b;
+	*(uint32_t *) b = t;
+}
+
+/** Swap two aligned 64-bit elements.
+ *
+ * @param a First element
+ * @param b Second element
+ * @param size Element size
+ */
+static void swap_u64(void *a, void *b, size_t size)
+{
+	uint64_t t;
+
+	(void) size;
+	t = *(uint64_t *) a;
+	*(uint64_t *) a = *(uint64_t *) b;
+	*(uint64_t *) b = t;
+}
+
+/** Initialize quicksort spec.
+ *
+ * Selects the fastest swap function usable for the given array.
+ * All elements are aligned to a power of two if both the base
+ * and the element size are.
+ *
+ * @param qs Quicksort spec
+ * @param base Array to sort
+ * @param nmemb Number of array members
+ * @param size Size of member in bytes
+ */
+static void qs_spec_init(qs_spec_t *qs, void *base, size_t nmemb, size_t size)
+{
+	uintptr_t align = (uintptr_t) base | size;
+
+	qs->base = base;
+	qs->nmemb = nmemb;
+	qs->size = size;
+	qs->compar = NULL;
+	qs->compar_r = NULL;
+	qs->arg = NULL;
+
+	if (size == sizeof(uint32_t) && align % sizeof(uint32_t) == 0)
+		qs->swap = swap_u32;
+	else if (size == sizeof(uint64_t) && align % sizeof(uint64_t) == 0)
+		qs->swap = swap_u64;
+	else if (align % sizeof(unsigned long) == 0)
+		qs->swap = swap_words;
+	else
+		qs->swap = swap_bytes;
 }
 
 /** Determine if one element is less-than another element.
@@ -79,7 +180,10 @@ static bool elem_lt(qs_spec_t *qs, size_t i, size_t j)
 	a = qs->base + i * qs->size;
 	b = qs->base + j * qs->size;
 
-	r = qs->compar(a, b, qs->arg);
+	if (qs->compar != NULL)
+		r = qs->compar(a, b);
+	else
+		r = qs->compar_r(a, b, qs->arg);
 
 	return r < 0;
 }
@@ -92,73 +196,183 @@ static bool elem_lt(qs_spec_t *qs, size_t i, size_t j)
  */
 static void elem_swap(qs_spec_t *qs, size_t i, size_t j)
 {
-	char *a;
-	char *b;
-	char t;
-	size_t k;
+	qs->swap(qs->base + i * qs->size, qs->base + j * qs->size, qs->size);
+}
 
-	a = qs->base + i * qs->size;
-	b = qs->base + j * qs->size;
+/** Sort a range of indices using insertion sort.
+ *
+ * @param qs Quicksort spec
+ * @param lo Lower bound (inclusive)
+ * @param hi Upper bound (exclusive)
+ */
+static void insertion_sort(qs_spec_t *qs, size_t lo, size_t hi)
+{
+	size_t i, j;
+
+	for (i = lo + 1; i < hi; i++) {
+		for (j = i; j > lo && elem_lt(qs, j, j - 1); j--)
+			elem_swap(qs, j, j - 1);
+	}
+}
+
+/** Restore heap property below a heap node.
+ *
+ * @param qs Quicksort spec
+ * @param lo Index of the heap root
+ * @param node Heap node, relative to @a lo
+ * @param cnt Number of elements in the heap
+ */
+static void sift_down(qs_spec_t *qs, size_t lo, size_t node, size_t cnt)
+{
+	size_t child;
+
+	while ((child = 2 * node + 1) < cnt) {
+		if (child + 1 < cnt && elem_lt(qs, lo + child, lo + child + 1))
+			child++;
+
+		if (!elem_lt(qs, lo + node, lo + child))
+			break;
+
+		elem_swap(qs, lo + node, lo + child);
+		node = child;
+	}
+}
+
+/** Sort a range of indices using heap sort.
+ *
+ * @param qs Quicksort spec
+ * @param lo Lower bound (inclusive)
+ * @param hi Upper bound (exclusive)
+ */
+static void heap_sort(qs_spec_t *qs, size_t lo, size_t hi)
+{
+	size_t cnt = hi - lo;
+	size_t i;
+
+	for (i = cnt / 2; i > 0; i--)
+		sift_down(qs, lo, i - 1, cnt);
+
+	for (i = cnt - 1; i > 0; i--) {
+		elem_swap(qs, lo, lo + i);
+		sift_down(qs, lo, 0, i);
+	}
+}
+
+/** Move median of three elements to a given position.
+ *
+ * @param qs Quicksort spec
+ * @param dest Destination index
+ * @param a First candidate index
+ * @param b Second candidate index
+ * @param c Third candidate index
+ */
+static void median_to(qs_spec_t *qs, size_t dest, size_t a, size_t b,
+    size_t c)
+{
+	size_t m;
 
-	for (k = 0; k < qs->size; k++) {
-		t = a[k];
-		a[k] = b[k];
-		b[k] = t;
+	if (elem_lt(qs, a, b)) {
+		if (elem_lt(qs, b, c))
+			m = b;
+		else if (elem_lt(qs, a, c))
+			m = c;
+		else
+			m = a;
+	} else {
+		if (elem_lt(qs, a, c))
+			m = a;
+		else if (elem_lt(qs, b, c))
+			m = c;
+		else
+			m = b;
 	}
+
+	elem_swap(qs, dest, m);
 }
 
 /** Partition a range of indices.
+ *
+ * The pivot is the median of three elements and is moved to @a lo.
+ * The other two candidates stop the scans at the ends of the range,
+ * so that the inner loops do not need bounds checks.
  *
  * @param qs Quicksort spec
  * @param lo Lower bound (inclusive)
- * @param hi Upper bound (inclusive)
- * @return Pivot index
+ * @param hi Upper bound (exclusive), at least four elements above @a lo
+ * @return Index of the first element of the upper partition
  */
 static size_t partition(qs_spec_t *qs, size_t lo, size_t hi)
 {
-	size_t pivot;
 	size_t i, j;
 
-	pivot = lo + (hi - lo) / 2;
-	i = lo;
+	median_to(qs, lo, lo + 1, lo + (hi - lo) / 2, hi - 1);
+
+	i = lo + 1;
 	j = hi;
 	while (true) {
-		while (elem_lt(qs, i, pivot))
+		while (elem_lt(qs, i, lo))
 			++i;
-		while (elem_lt(qs, pivot, j))
+		--j;
+		while (elem_lt(qs, lo, j))
 			--j;
 
 		if (i >= j)
-			return j;
+			return i;
 
 		elem_swap(qs, i, j);
-
-		/* Need to follow pivot movement */
-		if (i == pivot)
-			pivot = j;
-		else if (j == pivot)
-			pivot = i;
-
-		i++;
-		j--;
+		++i;
 	}
 }
 
 /** Sort a range of indices.
+ *
+ * Recurses into the smaller partition and loops over the larger one,
+ * which keeps the stack depth logarithmic.
  *
  * @param qs Quicksort spec
  * @param lo Lower bound (inclusive)
- * @param hi Upper bound (inclusive)
+ * @param hi Upper bound (exclusive)
+ * @param depth Remaining number of partitioning levels before we
+ *              give up on quicksort and switch to heap sort
  */
-static void quicksort(qs_spec_t *qs, size_t lo, size_t hi)
+static void introsort(qs_spec_t *qs, size_t lo, size_t hi, unsigned depth)
 {
 	size_t p;
 
-	if (lo < hi) {
+	while (hi - lo > QS_INSERTION_THRESHOLD) {
+		if (depth == 0) {
+			heap_sort(qs, lo, hi);
+			return;
+		}
+
+		--depth;
 		p = partition(qs, lo, hi);
-		quicksort(qs, lo, p);
-		quicksort(qs, p + 1, hi);
+		if (p - lo < hi - p) {
+			introsort(qs, lo, p, depth);
+			lo = p;
+		} else {
+			introsort(qs, p, hi, depth);
+			hi = p;
+		}
 	}
+
+	insertion_sort(qs, lo, hi);
+}
+
+/** Sort the whole array described by quicksort spec.
+ *
+ * @param qs Quicksort spec
+ */
+static void quicksort(qs_spec_t *qs)
+{
+	unsigned depth = 0;
+	size_t n;
+
+	/* Allow 2 * log2(nmemb) levels of partitioning */
+	for (n = qs->nmemb; n > 1; n /= 2)
+		depth += 2;
+
+	introsort(qs, 0, qs->nmemb, depth);
 }
 
 /** Quicksort.
@@ -176,13 +390,10 @@ void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *,
 	if (nmemb == 0)
 		return;
 
-	qs.base = base;
-	qs.nmemb = nmemb;
-	qs.size = size;
-	qs.compar = compar_wrap;
-	qs.arg = compar;
+	qs_spec_init(&qs, base, nmemb, size);
+	qs.compar = compar;
 
-	quicksort(&qs, 0, nmemb - 1);
+	quicksort(&qs);
 }
 
 /** Quicksort with extra argument to comparison function.
@@ -201,13 +412,11 @@ void qsort_r(void *base, size_t nmemb, size_t size, int (*compar)(const void *,
 	if (nmemb == 0)
 		return;
 
-	qs.base = base;
-	qs.nmemb = nmemb;
-	qs.size = size;
-	qs.compar = compar;
+	qs_spec_init(&qs, base, nmemb, size);
+	qs.compar_r = compar;
 	qs.arg = arg;
 
-	quicksort(&qs, 0, nmemb - 1);
+	quicksort(&qs);
 }
 
 /** @}
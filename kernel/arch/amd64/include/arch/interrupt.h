@@ -82,6 +82,7 @@
 #define VECTOR_SYSCALL            IVT_FREEBASE
 #define VECTOR_TLB_SHOOTDOWN_IPI  (IVT_FREEBASE + 1)
 #define VECTOR_DEBUG_IPI          (IVT_FREEBASE + 2)
+#define VECTOR_RESCHED_IPI        (IVT_FREEBASE + 3)
 
 extern void interrupt_init(void);
 
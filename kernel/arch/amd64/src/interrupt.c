@@ -147,6 +147,12 @@ static void tlb_shootdown_ipi(unsigned int n, istate_t *istate)
 	pic_ops->eoi(0);
 	tlb_shootdown_ipi_recv();
 }
+
+static void resched_ipi(unsigned int n, istate_t *istate)
+{
+	pic_ops->eoi(0);
+	scheduler_resched_ipi_recv();
+}
 #endif
 
 /** Handler of IRQ exceptions.
@@ -226,6 +232,8 @@ void interrupt_init(void)
 #ifdef CONFIG_SMP
 	exc_register(VECTOR_TLB_SHOOTDOWN_IPI, "tlb_shootdown", true,
 	    (iroutine_t) tlb_shootdown_ipi);
+	exc_register(VECTOR_RESCHED_IPI, "resched", true,
+	    (iroutine_t) resched_ipi);
 #endif
 }
 
@@ -46,6 +46,7 @@
 #include <mm/tlb.h>
 #include <mm/as.h>
 #include <arch.h>
+#include <proc/scheduler.h>
 #include <proc/thread.h>
 #include <proc/task.h>
 #include <synch/spinlock.h>
@@ -170,6 +171,13 @@ static void tlb_shootdown_ipi(unsigned int n __attribute__((unused)),
 	pic_ops->eoi(0);
 	tlb_shootdown_ipi_recv();
 }
+
+static void resched_ipi(unsigned int n __attribute__((unused)),
+    istate_t *istate __attribute__((unused)))
+{
+	pic_ops->eoi(0);
+	scheduler_resched_ipi_recv();
+}
 #endif
 
 /** Handler of IRQ exceptions */
@@ -249,6 +257,8 @@ void interrupt_init(void)
 #ifdef CONFIG_SMP
 	exc_register(VECTOR_TLB_SHOOTDOWN_IPI, "tlb_shootdown", true,
 	    (iroutine_t) tlb_shootdown_ipi);
+	exc_register(VECTOR_RESCHED_IPI, "resched", true,
+	    (iroutine_t) resched_ipi);
 #endif
 }
 
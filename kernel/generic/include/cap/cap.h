@@ -38,8 +38,6 @@
 #include <abi/cap.h>
 #include <typedefs.h>
 #include <adt/list.h>
-#include <adt/hash.h>
-#include <adt/hash_table.h>
 #include <lib/ra.h>
 #include <synch/mutex.h>
 #include <atomic.h>
@@ -110,21 +108,57 @@ typedef struct cap {
 	/* Link to the task's capabilities of the same kobject type. */
 	link_t type_link;
 
-	ht_link_t caps_link;
-
 	/* The underlying kernel object. */
 	kobject_t *kobject;
 } cap_t;
 
+/** Number of bits of capability handle resolved by one table level */
+#define CAPS_LEVEL_BITS		6
+#define CAPS_LEVEL_SIZE		(1 << CAPS_LEVEL_BITS)
+
+/** Node of the capability table */
+typedef struct caps_node {
+	/** Next level nodes or capabilities in the last level */
+	void *slot[CAPS_LEVEL_SIZE];
+} caps_node_t;
+
 typedef struct cap_info {
 	mutex_t lock;
 
 	list_t type_list[KOBJECT_TYPE_MAX];
 
-	hash_table_t caps;
+	/** Capability table, a radix tree indexed by capability handle */
+	caps_node_t *caps;
+	/** Number of levels of the capability table */
+	unsigned caps_levels;
 	ra_arena_t *handles;
+
+	/**
+	 * Generation, changes whenever a phone capability stops referring
+	 * to its phone. Validates thread capability caches.
+	 */
+	atomic_size_t gen;
 } cap_info_t;
 
+/** Number of entries in the per-thread capability cache */
+#define CAP_CACHE_SIZE		4
+
+/** Per-thread cache entry of a recently used capability */
+typedef struct {
+	cap_handle_t handle;
+	/** Explicit reference to the kernel object or NULL */
+	kobject_t *kobject;
+	/** Value of cap_info_t.gen when the entry was valid */
+	size_t gen;
+} cap_cache_entry_t;
+
+/** Per-thread cache of recently used phone capabilities */
+typedef struct {
+	cap_cache_entry_t entry[CAP_CACHE_SIZE];
+	/** Next entry to replace */
+	unsigned next;
+} cap_cache_t;
+
 extern void caps_init(void);
 extern errno_t caps_task_alloc(struct task *);
 extern void caps_task_free(struct task *);
@@ -138,6 +172,9 @@ extern kobject_t *cap_unpublish(struct task *, cap_handle_t, kobject_type_t);
 extern void cap_revoke(kobject_t *);
 extern void cap_free(struct task *, cap_handle_t);
 
+extern void cap_cache_initialize(cap_cache_t *);
+extern void cap_cache_flush(cap_cache_t *);
+
 extern kobject_t *kobject_alloc(unsigned int);
 extern void kobject_free(kobject_t *);
 extern void kobject_initialize(kobject_t *, kobject_type_t, void *);
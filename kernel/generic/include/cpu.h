@@ -92,6 +92,15 @@ typedef struct cpu {
 	atomic_size_t nrdy;
 	runq_t rq[RQ_COUNT];
 
+	/**
+	 * Run queue index of the running thread, RQ_COUNT when idle.
+	 * Used to decide whether a wakeup should preempt this CPU.
+	 */
+	atomic_int running_priority;
+
+	/** Reschedule IPI has been sent to this CPU and not handled yet. */
+	atomic_bool resched_pending;
+
 	IRQ_SPINLOCK_DECLARE(timeoutlock);
 	list_t timeout_active_list;
 
@@ -35,7 +35,9 @@
 #ifndef KERN_SCHEDULER_H_
 #define KERN_SCHEDULER_H_
 
+#include <errno.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <synch/spinlock.h>
 #include <time/clock.h>
 #include <atomic.h>
@@ -54,6 +56,10 @@ typedef struct {
 
 extern atomic_size_t nrdy;
 extern void scheduler_init(void);
+extern errno_t scheduler_quantum_set(int, uint32_t);
+extern uint32_t scheduler_quantum_get(int);
+extern void scheduler_preempt_check(void);
+extern void scheduler_resched_ipi_recv(void);
 
 extern void scheduler_fpu_lazy_request(void);
 extern void kcpulb(void *arg);
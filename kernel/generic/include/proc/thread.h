@@ -93,6 +93,9 @@ typedef struct thread {
 	/** Waitq for thread_join_timeout(). */
 	waitq_t join_wq;
 
+	/** Recently used phone capabilities. Only accessed by the thread. */
+	cap_cache_t cap_cache;
+
 	/** Thread accounting. */
 	atomic_time_stat_t ucycles;
 	atomic_time_stat_t kcycles;
@@ -78,6 +78,7 @@
 #include <cap/cap.h>
 #include <abi/cap.h>
 #include <proc/task.h>
+#include <proc/thread.h>
 #include <synch/mutex.h>
 #include <abi/errno.h>
 #include <mm/slab.h>
@@ -105,30 +106,86 @@ kobject_ops_t *kobject_ops[KOBJECT_TYPE_MAX] = {
 	[KOBJECT_TYPE_WAITQ] = &waitq_kobject_ops
 };
 
-static size_t caps_hash(const ht_link_t *item)
+/** Check whether capability table with given number of levels covers index
+ *
+ * @param levels  Number of levels of the capability table.
+ * @param idx     Raw capability handle.
+ */
+static bool caps_covers(unsigned levels, uintptr_t idx)
 {
-	cap_t *cap = hash_table_get_inst(item, cap_t, caps_link);
-	return hash_mix(cap_handle_raw(cap->handle));
+	if (CAPS_LEVEL_BITS * levels >= sizeof(uintptr_t) * 8)
+		return true;
+	return (idx >> (CAPS_LEVEL_BITS * levels)) == 0;
 }
 
-static size_t caps_key_hash(const void *key)
+/** Find slot of capability table corresponding to capability handle
+ *
+ * @param info    Capability info structure.
+ * @param handle  Capability handle.
+ * @param alloc   Allocate missing nodes of the capability table.
+ *
+ * @return Address of the slot.
+ * @return NULL if the slot does not exist and @a alloc is false or if
+ *         memory allocation failed.
+ */
+static void **caps_slot(cap_info_t *info, cap_handle_t handle, bool alloc)
 {
-	const cap_handle_t *handle = key;
-	return hash_mix(cap_handle_raw(*handle));
+	uintptr_t idx = (uintptr_t) cap_handle_raw(handle);
+
+	assert(mutex_locked(&info->lock));
+
+	/* Add levels on top until the table covers the handle */
+	while (!caps_covers(info->caps_levels, idx)) {
+		if (!alloc)
+			return NULL;
+
+		caps_node_t *node = calloc(1, sizeof(caps_node_t));
+		if (!node)
+			return NULL;
+
+		node->slot[0] = info->caps;
+		info->caps = node;
+		info->caps_levels++;
+	}
+
+	void **slot = (void **) &info->caps;
+	for (unsigned level = info->caps_levels; level > 0; level--) {
+		caps_node_t *node = *slot;
+		if (!node) {
+			if (!alloc)
+				return NULL;
+
+			node = calloc(1, sizeof(caps_node_t));
+			if (!node)
+				return NULL;
+
+			*slot = node;
+		}
+
+		slot = &node->slot[(idx >> (CAPS_LEVEL_BITS * (level - 1))) &
+		    (CAPS_LEVEL_SIZE - 1)];
+	}
+
+	return slot;
 }
 
-static bool caps_key_equal(const void *key, size_t hash, const ht_link_t *item)
+/** Free capability table node and all nodes below it
+ *
+ * @param node   Node to free.
+ * @param level  Level of the node, 1 for the last level.
+ */
+static void caps_node_free(caps_node_t *node, unsigned level)
 {
-	const cap_handle_t *handle = key;
-	cap_t *cap = hash_table_get_inst(item, cap_t, caps_link);
-	return *handle == cap->handle;
-}
+	if (!node)
+		return;
 
-static const hash_table_ops_t caps_ops = {
-	.hash = caps_hash,
-	.key_hash = caps_key_hash,
-	.key_equal = caps_key_equal
-};
+	if (level > 1) {
+		for (unsigned i = 0; i < CAPS_LEVEL_SIZE; i++)
+			caps_node_free(node->slot[i], level - 1);
+	}
+
+	free(node);
+}
 
 void caps_init(void)
 {
@@ -152,8 +209,9 @@ errno_t caps_task_alloc(task_t *task)
 		goto error_handles;
 	if (!ra_span_add(task->cap_info->handles, CAPS_START, CAPS_SIZE))
 		goto error_span;
-	if (!hash_table_create(&task->cap_info->caps, 0, 0, &caps_ops))
-		goto error_span;
+	task->cap_info->caps = NULL;
+	task->cap_info->caps_levels = 1;
+	atomic_init(&task->cap_info->gen, 0);
 	return EOK;
 
 error_span:
@@ -181,7 +239,7 @@ void caps_task_init(task_t *task)
  */
 void caps_task_free(task_t *task)
 {
-	hash_table_destroy(&task->cap_info->caps);
+	caps_node_free(task->cap_info->caps, task->cap_info->caps_levels);
 	ra_arena_destroy(task->cap_info->handles);
 	free(task->cap_info);
 }
@@ -245,10 +303,10 @@ static cap_t *cap_get(task_t *task, cap_handle_t handle, cap_state_t state)
 	if ((cap_handle_raw(handle) < CAPS_START) ||
 	    (cap_handle_raw(handle) > CAPS_LAST))
 		return NULL;
-	ht_link_t *link = hash_table_find(&task->cap_info->caps, &handle);
-	if (!link)
+	void **slot = caps_slot(task->cap_info, handle, false);
+	if (!slot || !*slot)
 		return NULL;
-	cap_t *cap = hash_table_get_inst(link, cap_t, caps_link);
+	cap_t *cap = *slot;
 	if (cap->state != state)
 		return NULL;
 	return cap;
@@ -276,8 +334,15 @@ errno_t cap_alloc(task_t *task, cap_handle_t *handle)
 		mutex_unlock(&task->cap_info->lock);
 		return ENOMEM;
 	}
+	void **slot = caps_slot(task->cap_info, (cap_handle_t) hbase, true);
+	if (!slot) {
+		ra_free(task->cap_info->handles, hbase, 1);
+		slab_free(cap_cache, cap);
+		mutex_unlock(&task->cap_info->lock);
+		return ENOMEM;
+	}
 	cap_initialize(cap, task, (cap_handle_t) hbase);
-	hash_table_insert(&task->cap_info->caps, &cap->caps_link);
+	*slot = cap;
 
 	cap->state = CAP_STATE_ALLOCATED;
 	*handle = cap->handle;
@@ -314,6 +379,10 @@ cap_publish(task_t *task, cap_handle_t handle, kobject_t *kobj)
 
 static void cap_unpublish_unsafe(cap_t *cap)
 {
+	/* Only phones are cached, invalidate thread capability caches */
+	if (cap->kobject->type == KOBJECT_TYPE_PHONE)
+		atomic_inc(&cap->task->cap_info->gen);
+
 	cap->kobject = NULL;
 	list_remove(&cap->kobj_link);
 	list_remove(&cap->type_link);
@@ -401,12 +470,99 @@ void cap_free(task_t *task, cap_handle_t handle)
 
 	assert(cap);
 
-	hash_table_remove_item(&task->cap_info->caps, &cap->caps_link);
+	*caps_slot(task->cap_info, handle, false) = NULL;
 	ra_free(task->cap_info->handles, cap_handle_raw(handle), 1);
 	slab_free(cap_cache, cap);
 	mutex_unlock(&task->cap_info->lock);
 }
 
+/** Initialize per-thread capability cache
+ *
+ * @param cache  Capability cache.
+ */
+void cap_cache_initialize(cap_cache_t *cache)
+{
+	for (unsigned i = 0; i < CAP_CACHE_SIZE; i++)
+		cache->entry[i].kobject = NULL;
+	cache->next = 0;
+}
+
+/** Drop all entries of per-thread capability cache
+ *
+ * Must be called before the thread stops using the capabilities of its
+ * task, so that the cached references do not keep kernel objects alive.
+ *
+ * @param cache  Capability cache.
+ */
+void cap_cache_flush(cap_cache_t *cache)
+{
+	for (unsigned i = 0; i < CAP_CACHE_SIZE; i++) {
+		if (cache->entry[i].kobject) {
+			kobject_put(cache->entry[i].kobject);
+			cache->entry[i].kobject = NULL;
+		}
+	}
+}
+
+/** Look up capability in the current thread's capability cache
+ *
+ * The entry is valid if no phone capability of the task has stopped referring
+ * to its phone since the entry was created. In that case the capability
+ * still refers to the cached kernel object, which is kept alive by the
+ * entry's reference.
+ *
+ * @param handle  Capability handle.
+ *
+ * @return Kernel object with incremented reference count on success.
+ * @return NULL if the capability is not cached.
+ */
+static kobject_t *cap_cache_lookup(cap_handle_t handle)
+{
+	cap_cache_t *cache = &THREAD->cap_cache;
+	size_t gen = atomic_load(&TASK->cap_info->gen);
+
+	for (unsigned i = 0; i < CAP_CACHE_SIZE; i++) {
+		cap_cache_entry_t *entry = &cache->entry[i];
+
+		if (!entry->kobject || entry->handle != handle)
+			continue;
+
+		if (entry->gen != gen) {
+			/* Stale entry */
+			kobject_put(entry->kobject);
+			entry->kobject = NULL;
+			return NULL;
+		}
+
+		kobject_add_ref(entry->kobject);
+		return entry->kobject;
+	}
+
+	return NULL;
+}
+
+/** Insert capability into the current thread's capability cache
+ *
+ * @param handle  Capability handle.
+ * @param kobj    Kernel object the capability referred to at @a gen.
+ * @param gen     Generation of the task's capabilities.
+ */
+static void cap_cache_insert(cap_handle_t handle, kobject_t *kobj, size_t gen)
+{
+	cap_cache_t *cache = &THREAD->cap_cache;
+	cap_cache_entry_t *entry = &cache->entry[cache->next];
+
+	cache->next = (cache->next + 1) % CAP_CACHE_SIZE;
+
+	if (entry->kobject)
+		kobject_put(entry->kobject);
+
+	kobject_add_ref(kobj);
+	entry->handle = handle;
+	entry->kobject = kobj;
+	entry->gen = gen;
+}
+
 kobject_t *kobject_alloc(unsigned int flags)
 {
 	return slab_alloc(kobject_cache, flags);
@@ -448,6 +604,17 @@ kobject_t *
 kobject_get(struct task *task, cap_handle_t handle, kobject_type_t type)
 {
 	kobject_t *kobj = NULL;
+	size_t gen;
+
+	/* Phones of the current task are looked up on every IPC call */
+	bool cacheable = (type == KOBJECT_TYPE_PHONE) && THREAD &&
+	    THREAD->uspace && (task == TASK);
+
+	if (cacheable) {
+		kobj = cap_cache_lookup(handle);
+		if (kobj)
+			return kobj;
+	}
 
 	mutex_lock(&task->cap_info->lock);
 	cap_t *cap = cap_get(task, handle, CAP_STATE_PUBLISHED);
@@ -457,8 +624,12 @@ kobject_get(struct task *task, cap_handle_t handle, kobject_type_t type)
 			atomic_inc(&kobj->refcnt);
 		}
 	}
+	gen = atomic_load(&task->cap_info->gen);
 	mutex_unlock(&task->cap_info->lock);
 
+	if (kobj && cacheable)
+		cap_cache_insert(handle, kobj, gen);
+
 	return kobj;
 }
 
@@ -507,6 +507,19 @@ static cmd_info_t sched_info = {
 	.argc = 0
 };
 
+static int cmd_quantum(cmd_arg_t *argv);
+static cmd_arg_t quantum_argv[] = {
+	{ .type = ARG_TYPE_INT },
+	{ .type = ARG_TYPE_INT }
+};
+static cmd_info_t quantum_info = {
+	.name = "quantum",
+	.description = "quantum <rq> <us> Set time quantum of a run queue.",
+	.func = cmd_quantum,
+	.argc = 2,
+	.argv = quantum_argv
+};
+
 static int cmd_caches(cmd_arg_t *argv);
 static cmd_info_t caches_info = {
 	.name = "caches",
@@ -609,6 +622,7 @@ static cmd_info_t *basic_commands[] = {
 	&ipc_info,
 	&kill_info,
 	&physmem_info,
+	&quantum_info,
 	&reboot_info,
 	&sched_info,
 	&set4_info,
@@ -1292,6 +1306,23 @@ int cmd_sched(cmd_arg_t *argv)
 	return 1;
 }
 
+/** Command for setting the time quantum of a run queue
+ *
+ * @param argv Run queue index and time quantum in microseconds.
+ *
+ * @return 0 on failure, 1 on success.
+ */
+int cmd_quantum(cmd_arg_t *argv)
+{
+	if (argv[0].intval >= RQ_COUNT || argv[1].intval > UINT32_MAX ||
+	    scheduler_quantum_set(argv[0].intval, argv[1].intval) != EOK) {
+		printf("Invalid run queue or quantum.\n");
+		return 0;
+	}
+
+	return 1;
+}
+
 /** Command for listing memory zones
  *
  * @param argv Ignored
@@ -82,6 +82,7 @@ void cpu_init(void)
 
 			cpus[i].local.stack = (uint8_t *) PA2KA(stack_phys);
 			cpus[i].id = i;
+			atomic_store(&cpus[i].running_priority, RQ_COUNT);
 
 #ifdef CONFIG_FPU_LAZY
 			irq_spinlock_initialize(&cpus[i].fpu_lock, "cpus[].fpu_lock");
@@ -52,6 +52,8 @@
 #include <stdarg.h>
 #include <symtab.h>
 #include <proc/thread.h>
+#include <proc/scheduler.h>
+#include <cpu.h>
 #include <arch/cycle.h>
 #include <arch/stack.h>
 #include <str.h>
@@ -153,6 +155,11 @@ _NO_TRACE void exc_dispatch(unsigned int n, istate_t *istate)
 	/* Do not charge THREAD for exception cycles */
 	if (THREAD)
 		THREAD->last_cycle = end_cycle;
+
+	/* Switch to a more urgent thread woken up by the handler */
+	if ((THREAD) && (istate_from_uspace(istate)) &&
+	    (CPU_LOCAL->preempt_deadline == 0))
+		scheduler_preempt_check();
 #else
 	panic("No space for any exception handler, yet we want to handle some exception.");
 #endif
@@ -757,16 +757,21 @@ sys_errno_t sys_ipc_hangup(cap_phone_handle_t handle)
 }
 
 /** Wait for an incoming IPC call or an answer.
+ *
+ * Common code for sys_ipc_wait_for_call() and sys_ipc_wait_for_call_batch().
  *
  * @param calldata Pointer to buffer where the call/answer data is stored.
  * @param usec     Timeout. See waitq_sleep_timeout() for explanation.
  * @param flags    Select mode of sleep operation. See waitq_sleep_timeout()
  *                 for explanation.
+ * @param rcount   If not null, userspace address where @a nrecv is stored
+ *                 before the call is handed over to userspace.
+ * @param nrecv    Number of received calls/answers including this one.
  *
  * @return An error code on error.
  */
-sys_errno_t sys_ipc_wait_for_call(uspace_ptr_ipc_data_t calldata, uint32_t usec,
-    unsigned int flags)
+static errno_t ipc_wait_for_call_common(uspace_ptr_ipc_data_t calldata,
+    uint32_t usec, unsigned int flags, uspace_ptr_size_t rcount, size_t nrecv)
 {
 	call_t *call = NULL;
 	errno_t rc;
@@ -796,6 +801,8 @@ restart:
 		call->data.cap_handle = CAP_NIL;
 
 		STRUCT_TO_USPACE(calldata, &call->data);
+		if (rcount)
+			(void) copy_to_uspace(rcount, &nrecv, sizeof(nrecv));
 		kobject_put(call->kobject);
 
 		return EOK;
@@ -812,6 +819,8 @@ restart:
 		call->data.cap_handle = CAP_NIL;
 
 		STRUCT_TO_USPACE(calldata, &call->data);
+		if (rcount)
+			(void) copy_to_uspace(rcount, &nrecv, sizeof(nrecv));
 		kobject_put(call->kobject);
 
 		return EOK;
@@ -835,6 +844,16 @@ restart:
 	if (rc != EOK)
 		goto error;
 
+	/*
+	 * Store the count before publishing the capability so that userspace
+	 * cannot miss a call that has already been dequeued.
+	 */
+	if (rcount) {
+		rc = copy_to_uspace(rcount, &nrecv, sizeof(nrecv));
+		if (rc != EOK)
+			goto error;
+	}
+
 	kobject_add_ref(call->kobject);
 	cap_publish(TASK, handle, call->kobject);
 	return EOK;
@@ -865,6 +884,70 @@ error:
 	return rc;
 }
 
+/** Wait for an incoming IPC call or an answer.
+ *
+ * @param calldata Pointer to buffer where the call/answer data is stored.
+ * @param usec     Timeout. See waitq_sleep_timeout() for explanation.
+ * @param flags    Select mode of sleep operation. See waitq_sleep_timeout()
+ *                 for explanation.
+ *
+ * @return An error code on error.
+ */
+sys_errno_t sys_ipc_wait_for_call(uspace_ptr_ipc_data_t calldata, uint32_t usec,
+    unsigned int flags)
+{
+	return (sys_errno_t) ipc_wait_for_call_common(calldata, usec, flags,
+	    0, 0);
+}
+
+/** Wait for a batch of incoming IPC calls or answers.
+ *
+ * Waits for the first call or answer according to @a usec and @a flags,
+ * then collects up to @a count - 1 more calls or answers that are already
+ * pending, without blocking.
+ *
+ * @param calldata Pointer to an array of @a count buffers where the
+ *                 call/answer data is stored.
+ * @param count    Number of buffers (at most IPC_MAX_BATCH).
+ * @param usec     Timeout. See waitq_sleep_timeout() for explanation.
+ * @param flags    Select mode of sleep operation. See waitq_sleep_timeout()
+ *                 for explanation.
+ * @param rcount   Userspace address where to store number of received
+ *                 calls/answers.
+ *
+ * @return EOK if at least one call or answer was received, otherwise
+ *         an error code.
+ */
+sys_errno_t sys_ipc_wait_for_call_batch(uspace_ptr_ipc_data_t calldata,
+    size_t count, uint32_t usec, unsigned int flags, uspace_ptr_size_t rcount)
+{
+	size_t received;
+	errno_t rc;
+
+	if (count == 0 || count > IPC_MAX_BATCH)
+		return EINVAL;
+
+	/* Make sure the count can be stored before dequeuing anything. */
+	received = 0;
+	rc = copy_to_uspace(rcount, &received, sizeof(received));
+	if (rc != EOK)
+		return (sys_errno_t) rc;
+
+	rc = ipc_wait_for_call_common(calldata, usec, flags, rcount, 1);
+	if (rc != EOK)
+		return (sys_errno_t) rc;
+
+	for (received = 1; received < count; received++) {
+		rc = ipc_wait_for_call_common(calldata +
+		    received * sizeof(ipc_data_t), SYNCH_NO_TIMEOUT,
+		    SYNCH_FLAGS_NON_BLOCKING, rcount, received + 1);
+		if (rc != EOK)
+			break;
+	}
+
+	return EOK;
+}
+
 /** Interrupt one thread from sys_ipc_wait_for_call().
  *
  */
@@ -64,9 +64,18 @@
 #include <stdio.h>
 #include <log.h>
 #include <stacktrace.h>
+#include <interrupt.h>
+#include <preemption.h>
+#include <smp/ipi.h>
 
 atomic_size_t nrdy;  /**< Number of ready threads in the system. */
 
+/** Default time quantum of the highest priority run queue in microseconds. */
+#define QUANTUM_BASE  10000
+
+/** Time quantum in microseconds for each run queue. */
+static atomic_uint_fast32_t quantum[RQ_COUNT];
+
 #ifdef CONFIG_FPU_LAZY
 void scheduler_fpu_lazy_request(void)
 {
@@ -102,8 +111,88 @@ void scheduler_fpu_lazy_request(void)
  */
 void scheduler_init(void)
 {
+	/* Lower priority threads run less often, but for longer. */
+	for (int i = 0; i < RQ_COUNT; i++)
+		atomic_set_unordered(&quantum[i], (i + 1) * QUANTUM_BASE);
+}
+
+/** Set the time quantum of a run queue.
+ *
+ * The new quantum takes effect the next time a thread from the run queue
+ * is scheduled.
+ *
+ * @param rq_index Run queue index.
+ * @param us       Time quantum in microseconds.
+ *
+ * @return EOK on success, EINVAL if the arguments are out of range.
+ *
+ */
+errno_t scheduler_quantum_set(int rq_index, uint32_t us)
+{
+	if (rq_index < 0 || rq_index >= RQ_COUNT || us == 0)
+		return EINVAL;
+
+	atomic_set_unordered(&quantum[rq_index], us);
+	return EOK;
+}
+
+/** Get the time quantum of a run queue in microseconds.
+ *
+ * @param rq_index Run queue index.
+ *
+ */
+uint32_t scheduler_quantum_get(int rq_index)
+{
+	assert(rq_index >= 0 && rq_index < RQ_COUNT);
+	return atomic_get_unordered(&quantum[rq_index]);
+}
+
+/** Preempt the current thread if its time slice has run out.
+ *
+ * Besides the clock interrupt, this is checked at points where it is
+ * safe to switch threads (return from a system call or exception to
+ * userspace, reschedule IPI), so that a preemption requested by a wakeup
+ * (see wakeup_preempt()) is not delayed until the next clock tick.
+ *
+ */
+void scheduler_preempt_check(void)
+{
+	ipl_t ipl = interrupts_disable();
+
+	bool preempt = (THREAD != NULL) && PREEMPTION_ENABLED &&
+	    (CPU_LOCAL->current_clock_tick >= CPU_LOCAL->preempt_deadline);
+
+	interrupts_restore(ipl);
+
+	if (preempt)
+		thread_yield();
+}
+
+#ifdef CONFIG_SMP
+
+/** Receive reschedule IPI.
+ *
+ * Sent by wakeup_preempt() when a thread with a higher priority than the
+ * one running here has been queued on this CPU.
+ *
+ */
+void scheduler_resched_ipi_recv(void)
+{
+	assert(interrupts_disabled());
+	assert(CPU != NULL);
+
+	atomic_store(&CPU->resched_pending, false);
+
+	/* An idle CPU has been woken up by the IPI itself. */
+	if (THREAD == NULL)
+		return;
+
+	CPU_LOCAL->preempt_deadline = 0;
+	scheduler_preempt_check();
 }
 
+#endif /* CONFIG_SMP */
+
 /** Get thread to be scheduled
  *
  * Get the optimal thread to be scheduled
@@ -165,6 +254,13 @@ static thread_t *find_best_thread(int *rq_index)
 	assert(interrupts_disabled());
 	assert(CPU != NULL);
 
+	/*
+	 * Announce the CPU as idle before looking at the run queues so that
+	 * a concurrent wakeup either gets found below or sends an IPI
+	 * that brings the CPU out of sleep.
+	 */
+	atomic_store(&CPU->running_priority, RQ_COUNT);
+
 	while (true) {
 		thread_t *thread = try_find_thread(rq_index);
 
@@ -313,6 +409,7 @@ static void prepare_to_run_thread(int rq_index)
 
 	atomic_set_unordered(&THREAD->state, Running);
 	atomic_set_unordered(&THREAD->priority, rq_index);  /* Correct rq index */
+	atomic_store(&CPU->running_priority, rq_index);
 
 	/*
 	 * Clear the stolen flag so that it can be migrated
@@ -354,7 +451,7 @@ static void prepare_to_run_thread(int rq_index)
 	fpu_restore();
 
 	/* Time allocation in microseconds. */
-	uint64_t time_to_run = (rq_index + 1) * 10000;
+	uint64_t time_to_run = atomic_get_unordered(&quantum[rq_index]);
 
 	/* Set the time of next preemption. */
 	CPU_LOCAL->preempt_deadline =
@@ -398,6 +495,37 @@ static void thread_requeue_preempted(thread_t *thread)
 	add_to_rq(thread, CPU, prio);
 }
 
+/** Preempt a CPU on which a thread with priority @a prio has been queued.
+ *
+ * If the CPU is running a thread from a lower priority run queue (or is
+ * idle), make it reschedule as soon as possible instead of waiting for
+ * the running thread's time slice to expire.
+ *
+ * @param cpu  CPU on which the thread has been queued.
+ * @param prio Run queue index of the thread.
+ *
+ */
+static void wakeup_preempt(cpu_t *cpu, int prio)
+{
+	assert(interrupts_disabled());
+
+	/* Pairs with the store in find_best_thread(). */
+	if (prio >= atomic_load(&cpu->running_priority))
+		return;
+
+	if (cpu == CPU) {
+		/* Picked up on return from the current syscall or interrupt. */
+		if (THREAD != NULL)
+			CPU_LOCAL->preempt_deadline = 0;
+		return;
+	}
+
+#if defined(CONFIG_SMP) && defined(VECTOR_RESCHED_IPI)
+	if (!atomic_exchange(&cpu->resched_pending, true))
+		ipi_unicast(cpu, VECTOR_RESCHED_IPI);
+#endif
+}
+
 void thread_requeue_sleeping(thread_t *thread)
 {
 	ipl_t ipl = interrupts_disable();
@@ -416,6 +544,7 @@ void thread_requeue_sleeping(thread_t *thread)
 	}
 
 	add_to_rq(thread, cpu, 0);
+	wakeup_preempt(cpu, 0);
 
 	interrupts_restore(ipl);
 }
@@ -484,7 +613,14 @@ void scheduler_enter(state_t new_state)
 	thread_t *new_thread = try_find_thread(&rq_index);
 
 	if (new_thread == NULL && new_state == Running) {
-		/* No other thread to run, but we still have work to do here. */
+		/*
+		 * No other thread to run, but we still have work to do here.
+		 * Start a new time slice so that we are not asked to yield
+		 * again on every preemption check.
+		 */
+		CPU_LOCAL->preempt_deadline = CPU_LOCAL->current_clock_tick +
+		    us2ticks(atomic_get_unordered(
+		    &quantum[atomic_get_unordered(&THREAD->priority)]));
 		interrupts_restore(ipl);
 		return;
 	}
@@ -769,13 +905,19 @@ satisfied:
  */
 void sched_print_list(void)
 {
+	printf("quanta:");
+	for (int i = 0; i < RQ_COUNT; i++)
+		printf(" %" PRIu32, scheduler_quantum_get(i));
+	printf(" us\n");
+
 	size_t cpu;
 	for (cpu = 0; cpu < config.cpu_count; cpu++) {
 		if (!cpus[cpu].active)
 			continue;
 
-		printf("cpu%u: address=%p, nrdy=%zu\n",
-		    cpus[cpu].id, &cpus[cpu], atomic_load(&cpus[cpu].nrdy));
+		printf("cpu%u: address=%p, nrdy=%zu, running=%d\n",
+		    cpus[cpu].id, &cpus[cpu], atomic_load(&cpus[cpu].nrdy),
+		    atomic_load(&cpus[cpu].running_priority));
 
 		unsigned int i;
 		for (i = 0; i < RQ_COUNT; i++) {
@@ -278,6 +278,7 @@ thread_t *thread_create(void (*func)(void *), void *arg, task_t *task,
 	atomic_init(&thread->sleep_state, SLEEP_INITIAL);
 
 	waitq_initialize(&thread->join_wq);
+	cap_cache_initialize(&thread->cap_cache);
 
 	thread->task = task;
 
@@ -425,6 +426,9 @@ void thread_attach(thread_t *thread, task_t *task)
 void thread_exit(void)
 {
 	if (THREAD->uspace) {
+		/* Release kernel objects referenced by the capability cache */
+		cap_cache_flush(&THREAD->cap_cache);
+
 #ifdef CONFIG_UDEBUG
 		/* Generate udebug THREAD_E event */
 		udebug_thread_e_event();
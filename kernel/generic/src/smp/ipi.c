@@ -39,6 +39,8 @@
 
 #include <smp/ipi.h>
 #include <config.h>
+#include <cpu.h>
+#include <interrupt.h>
 
 /** Broadcast IPI message
  *
@@ -59,6 +61,25 @@ void ipi_broadcast(int ipi)
 		ipi_broadcast_arch(ipi);
 }
 
+#ifdef VECTOR_RESCHED_IPI
+
+/** Send IPI message to one CPU
+ *
+ * Only architectures which define VECTOR_RESCHED_IPI provide
+ * ipi_unicast_arch().
+ *
+ * @param cpu Destination CPU.
+ * @param ipi Message to send.
+ *
+ */
+void ipi_unicast(cpu_t *cpu, int ipi)
+{
+	if (cpu->active && cpu != CPU)
+		ipi_unicast_arch(cpu, ipi);
+}
+
+#endif /* VECTOR_RESCHED_IPI */
+
 #endif /* CONFIG_SMP */
 
 /** @}
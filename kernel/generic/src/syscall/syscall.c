@@ -40,10 +40,12 @@
 #include <proc/thread.h>
 #include <proc/task.h>
 #include <proc/program.h>
+#include <proc/scheduler.h>
 #include <main/shutdown.h>
 #include <mm/as.h>
 #include <mm/page.h>
 #include <arch.h>
+#include <cpu.h>
 #include <debug.h>
 #include <interrupt.h>
 #include <ipc/sysipc.h>
@@ -100,6 +102,7 @@ static syshandler_t syscall_table[] = {
 	[SYS_IPC_FORWARD_FAST] = (syshandler_t) sys_ipc_forward_fast,
 	[SYS_IPC_FORWARD_SLOW] = (syshandler_t) sys_ipc_forward_slow,
 	[SYS_IPC_WAIT] = (syshandler_t) sys_ipc_wait_for_call,
+	[SYS_IPC_WAIT_BATCH] = (syshandler_t) sys_ipc_wait_for_call_batch,
 	[SYS_IPC_POKE] = (syshandler_t) sys_ipc_poke,
 	[SYS_IPC_HANGUP] = (syshandler_t) sys_ipc_hangup,
 	[SYS_IPC_CONNECT_KBOX] = (syshandler_t) sys_ipc_connect_kbox,
@@ -176,6 +179,16 @@ sysarg_t syscall_handler(sysarg_t a1, sysarg_t a2, sysarg_t a3,
 	if (THREAD->interrupted)
 		thread_exit();
 
+	/*
+	 * Let a thread woken up by this syscall run if it is more urgent.
+	 * wakeup_preempt() clears the deadline in that case, an expired
+	 * time slice is left to the clock interrupt. The read is racy if we
+	 * migrate in the meantime, a missed preemption then waits for the
+	 * next clock tick.
+	 */
+	if (CPU_LOCAL->preempt_deadline == 0)
+		scheduler_preempt_check();
+
 #ifdef CONFIG_UDEBUG
 	if (THREAD->udebug.active) {
 		udebug_syscall_event(a1, a2, a3, a4, a5, a6, id, rc, true);
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Simple micro benchmarks of libcpp containers. These are not tests,
+ * they just report the time each loop took so that changes to the
+ * library can be compared on the same machine.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+
+namespace
+{
+    constexpr unsigned int iterations = 100000;
+
+    /*
+     * Prevents the compiler from optimizing the benchmarked
+     * loop away by consuming its result.
+     */
+    volatile std::size_t sink;
+
+    template<class Body>
+    void bench(const char* name, Body body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+
+        auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+            end - start
+        ).count();
+
+        std::printf("%-28s %8lld us (%u iterations)\n", name,
+            static_cast<long long>(usecs), iterations);
+    }
+
+    void bench_string()
+    {
+        bench("string default construct", [](){
+            std::size_t total{};
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                std::string str{};
+                total += str.size();
+            }
+            sink = total;
+        });
+
+        bench("string short construct", [](){
+            std::size_t total{};
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                std::string str{"identifier"};
+                total += str.size();
+            }
+            sink = total;
+        });
+
+        bench("string long construct", [](){
+            std::size_t total{};
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                std::string str{"a string that does not fit inline"};
+                total += str.size();
+            }
+            sink = total;
+        });
+
+        bench("string to_string", [](){
+            std::size_t total{};
+            for (unsigned int i = 0; i < iterations; ++i)
+                total += std::to_string(i).size();
+            sink = total;
+        });
+
+        bench("string short move", [](){
+            std::string str{"identifier"};
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                std::string tmp{std::move(str)};
+                str = std::move(tmp);
+            }
+            sink = str.size();
+        });
+
+        bench("string short concat", [](){
+            std::size_t total{};
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                std::string key{"key"};
+                key += '_';
+                key += "name";
+                total += key.size();
+            }
+            sink = total;
+        });
+
+        bench("string push_back growth", [](){
+            std::string str{};
+            for (unsigned int i = 0; i < iterations; ++i)
+                str.push_back('a' + (i % 26));
+            sink = str.size();
+        });
+
+        bench("vector<string> emplace", [](){
+            std::vector<std::string> vec{};
+            for (unsigned int i = 0; i < iterations; ++i)
+                vec.emplace_back("element");
+            sink = vec.size();
+        });
+    }
+}
+
+void run_benchmarks()
+{
+    std::printf("Running libcpp benchmarks...\n");
+    bench_string();
+}
@@ -100,8 +100,16 @@
 
 #include <__bits/trycatch.hpp>
 
-int main()
+#include "bench.hpp"
+
+int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::strcmp(argv[1], "bench") == 0)
+    {
+        run_benchmarks();
+        return 0;
+    }
+
     std::test::test_set ts{};
     ts.add<std::test::vector_test>();
     ts.add<std::test::string_test>();
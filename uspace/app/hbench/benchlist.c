@@ -39,14 +39,23 @@
 
 benchmark_t *benchmarks[] = {
 	&benchmark_dir_read,
+	&benchmark_fibril_brwlock_mt,
 	&benchmark_fibril_mutex,
+	&benchmark_fibril_mutex_mt,
+	&benchmark_fibril_rwlock_mt,
 	&benchmark_file_read,
+	&benchmark_gsort,
 	&benchmark_rand_read,
 	&benchmark_seq_read,
 	&benchmark_malloc1,
 	&benchmark_malloc2,
+	&benchmark_memcpy,
+	&benchmark_memmove,
+	&benchmark_memset,
 	&benchmark_ns_ping,
 	&benchmark_ping_pong,
+	&benchmark_qsort,
+	&benchmark_qsort_mt,
 	&benchmark_read1k,
 	&benchmark_taskgetid,
 	&benchmark_write1k,
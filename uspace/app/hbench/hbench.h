@@ -132,14 +132,23 @@ extern size_t benchmark_count;
 
 /* Put your benchmark descriptors here (and also to benchlist.c). */
 extern benchmark_t benchmark_dir_read;
+extern benchmark_t benchmark_fibril_brwlock_mt;
 extern benchmark_t benchmark_fibril_mutex;
+extern benchmark_t benchmark_fibril_mutex_mt;
+extern benchmark_t benchmark_fibril_rwlock_mt;
 extern benchmark_t benchmark_file_read;
+extern benchmark_t benchmark_gsort;
 extern benchmark_t benchmark_rand_read;
 extern benchmark_t benchmark_seq_read;
 extern benchmark_t benchmark_malloc1;
 extern benchmark_t benchmark_malloc2;
+extern benchmark_t benchmark_memcpy;
+extern benchmark_t benchmark_memmove;
+extern benchmark_t benchmark_memset;
 extern benchmark_t benchmark_ns_ping;
 extern benchmark_t benchmark_ping_pong;
+extern benchmark_t benchmark_qsort;
+extern benchmark_t benchmark_qsort_mt;
 extern benchmark_t benchmark_read1k;
 extern benchmark_t benchmark_taskgetid;
 extern benchmark_t benchmark_write1k;
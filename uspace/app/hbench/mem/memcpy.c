@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup hbench
+ * @{
+ */
+
+#include <mem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../hbench.h"
+
+/*
+ * Memory block operation benchmarks. Each iteration of the workload
+ * processes one block. The block size is given by the 'block' parameter
+ * (in bytes, 4096 by default) and the misalignment of the source and
+ * destination by the 'offset' parameter (in bytes, 0 by default).
+ *
+ * For example, to copy blocks of 16 MiB:
+ *
+ *     hbench -p block=16777216 memcpy
+ */
+
+/** Upper bound (exclusive) of the 'offset' parameter. */
+#define MAX_OFFSET 64
+
+/*
+ * Kept in file scope so that the compiler cannot prove the results unused
+ * and drop the operations being measured.
+ */
+static uint8_t *src_buf;
+static uint8_t *dst_buf;
+
+typedef enum {
+	mem_op_memcpy,
+	mem_op_memmove,
+	mem_op_memset
+} mem_op_t;
+
+static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size,
+    mem_op_t op)
+{
+	const char *str;
+	size_t block;
+	size_t offset;
+	uint8_t *src;
+	uint8_t *dst;
+	uint64_t i;
+
+	str = bench_env_param_get(env, "block", "4096");
+	if (sscanf(str, "%zu", &block) < 1)
+		return bench_run_fail(run, "'block' must be a number of bytes.");
+
+	str = bench_env_param_get(env, "offset", "0");
+	if (sscanf(str, "%zu", &offset) < 1 || offset >= MAX_OFFSET) {
+		return bench_run_fail(run, "'offset' must be a number of "
+		    "bytes smaller than %d.", MAX_OFFSET);
+	}
+
+	src_buf = malloc(block + MAX_OFFSET);
+	dst_buf = malloc(block + MAX_OFFSET);
+	if (src_buf == NULL || dst_buf == NULL) {
+		free(src_buf);
+		free(dst_buf);
+		return bench_run_fail(run, "failed to allocate buffers "
+		    "(%zu bytes)", block + MAX_OFFSET);
+	}
+
+	/* Touch all pages so that page faults are not measured. */
+	memset(src_buf, 0x5a, block + MAX_OFFSET);
+	memset(dst_buf, 0, block + MAX_OFFSET);
+
+	src = src_buf + offset;
+	dst = dst_buf;
+
+	bench_run_start(run);
+	switch (op) {
+	case mem_op_memcpy:
+		for (i = 0; i < size; i++)
+			memcpy(dst, src, block);
+		break;
+	case mem_op_memmove:
+		/* Overlapping blocks, moving data towards higher addresses. */
+		for (i = 0; i < size; i++)
+			memmove(src_buf + offset + 1, src_buf, block);
+		break;
+	case mem_op_memset:
+		for (i = 0; i < size; i++)
+			memset(src, (int) i, block);
+		break;
+	}
+	bench_run_stop(run);
+
+	free(src_buf);
+	free(dst_buf);
+	src_buf = NULL;
+	dst_buf = NULL;
+	return true;
+}
+
+static bool runner_memcpy(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	return runner(env, run, size, mem_op_memcpy);
+}
+
+static bool runner_memmove(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	return runner(env, run, size, mem_op_memmove);
+}
+
+static bool runner_memset(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	return runner(env, run, size, mem_op_memset);
+}
+
+benchmark_t benchmark_memcpy = {
+	.name = "memcpy",
+	.desc = "Copy memory blocks (set 'block' and 'offset' parameters).",
+	.entry = &runner_memcpy,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+benchmark_t benchmark_memmove = {
+	.name = "memmove",
+	.desc = "Move overlapping memory blocks (set 'block' and 'offset' "
+	    "parameters).",
+	.entry = &runner_memmove,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+benchmark_t benchmark_memset = {
+	.name = "memset",
+	.desc = "Fill memory blocks (set 'block' and 'offset' parameters).",
+	.entry = &runner_memset,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+/** @}
+ */
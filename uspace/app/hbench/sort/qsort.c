@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup hbench
+ * @{
+ */
+
+#include <fibril.h>
+#include <gsort.h>
+#include <qsort.h>
+#include <qsort_mt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../hbench.h"
+
+/*
+ * Sorting benchmarks. The workload size is the number of integers to sort,
+ * the array is filled with the same pseudorandom sequence for each run.
+ */
+
+static int cmp_int(const void *a, const void *b)
+{
+	int ia = *(const int *)a;
+	int ib = *(const int *)b;
+
+	if (ia == ib)
+		return 0;
+
+	return ia < ib ? -1 : 1;
+}
+
+static int cmp_int_r(const void *a, const void *b, void *arg)
+{
+	return cmp_int(a, b);
+}
+
+static int cmp_int_g(void *a, void *b, void *arg)
+{
+	return cmp_int(a, b);
+}
+
+static int *data_create(bench_run_t *run, uint64_t size)
+{
+	int *data;
+	uint32_t v = 1;
+
+	data = malloc(size * sizeof(int));
+	if (data == NULL) {
+		bench_run_fail(run, "failed to allocate %" PRIu64 " integers",
+		    size);
+		return NULL;
+	}
+
+	for (uint64_t i = 0; i < size; i++) {
+		v = v * 1103515245 + 12345;
+		data[i] = v >> 8;
+	}
+
+	return data;
+}
+
+static bool runner_qsort(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	int *data = data_create(run, size);
+	if (data == NULL)
+		return false;
+
+	bench_run_start(run);
+	qsort(data, size, sizeof(int), cmp_int);
+	bench_run_stop(run);
+
+	free(data);
+	return true;
+}
+
+static bool runner_qsort_mt(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	int *data = data_create(run, size);
+	if (data == NULL)
+		return false;
+
+	bench_run_start(run);
+	qsort_mt(data, size, sizeof(int), cmp_int_r, NULL);
+	bench_run_stop(run);
+
+	free(data);
+	return true;
+}
+
+static bool runner_gsort(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	int *data = data_create(run, size);
+	if (data == NULL)
+		return false;
+
+	bench_run_start(run);
+	if (!gsort(data, size, sizeof(int), cmp_int_g, NULL)) {
+		free(data);
+		return bench_run_fail(run, "gsort failed");
+	}
+	bench_run_stop(run);
+
+	free(data);
+	return true;
+}
+
+static bool setup_mt(bench_env_t *env, bench_run_t *run)
+{
+	fibril_enable_multithreaded();
+	return true;
+}
+
+benchmark_t benchmark_qsort = {
+	.name = "qsort",
+	.desc = "Sort an array of pseudorandom integers with qsort",
+	.entry = &runner_qsort,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+benchmark_t benchmark_qsort_mt = {
+	.name = "qsort_mt",
+	.desc = "Sort an array of pseudorandom integers with multi-fibril qsort",
+	.entry = &runner_qsort_mt,
+	.setup = &setup_mt,
+	.teardown = NULL
+};
+
+benchmark_t benchmark_gsort = {
+	.name = "gsort",
+	.desc = "Sort an array of pseudorandom integers with gsort",
+	.entry = &runner_gsort,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+/** @}
+ */
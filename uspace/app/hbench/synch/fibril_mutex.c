@@ -32,6 +32,7 @@
 
 #include <fibril_synch.h>
 #include <stdatomic.h>
+#include <stdio.h>
 #include "../hbench.h"
 
 /*
@@ -97,5 +98,87 @@ benchmark_t benchmark_fibril_mutex = {
 	.teardown = NULL
 };
 
+/*
+ * Contended variant: several fibrils spread over multiple threads share
+ * one mutex protecting a short critical section. The number of fibrils
+ * is given by the 'fibrils' parameter (4 by default).
+ */
+
+typedef struct {
+	fibril_mutex_t mutex;
+	fibril_semaphore_t done;
+	uint64_t counter;
+	uint64_t iterations;
+} shared_mt_t;
+
+static errno_t worker_mt(void *arg)
+{
+	shared_mt_t *shared = arg;
+
+	for (uint64_t i = 0; i < shared->iterations; i++) {
+		fibril_mutex_lock(&shared->mutex);
+		shared->counter++;
+		fibril_mutex_unlock(&shared->mutex);
+	}
+
+	fibril_semaphore_up(&shared->done);
+	return EOK;
+}
+
+static bool runner_mt(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	shared_mt_t shared;
+	const char *str;
+	unsigned nfibrils;
+
+	str = bench_env_param_get(env, "fibrils", "4");
+	if (sscanf(str, "%u", &nfibrils) < 1 || nfibrils == 0)
+		return bench_run_fail(run, "'fibrils' must be a positive number.");
+
+	fibril_mutex_initialize(&shared.mutex);
+	fibril_semaphore_initialize(&shared.done, 0);
+	shared.counter = 0;
+	shared.iterations = size / nfibrils;
+
+	bench_run_start(run);
+
+	for (unsigned i = 0; i < nfibrils; i++) {
+		fid_t fid = fibril_create(worker_mt, &shared);
+		if (fid == 0) {
+			/* Let the ones already started finish. */
+			for (unsigned j = 0; j < i; j++)
+				fibril_semaphore_down(&shared.done);
+			return bench_run_fail(run, "failed to create fibril");
+		}
+
+		fibril_add_ready(fid);
+	}
+
+	for (unsigned i = 0; i < nfibrils; i++)
+		fibril_semaphore_down(&shared.done);
+
+	bench_run_stop(run);
+
+	if (shared.counter != shared.iterations * nfibrils)
+		return bench_run_fail(run, "mutual exclusion violated");
+
+	return true;
+}
+
+static bool setup_mt(bench_env_t *env, bench_run_t *run)
+{
+	fibril_enable_multithreaded();
+	return true;
+}
+
+benchmark_t benchmark_fibril_mutex_mt = {
+	.name = "fibril_mutex_mt",
+	.desc = "Contended mutex lock/unlock from multiple threads "
+	    "(set 'fibrils' parameter).",
+	.entry = &runner_mt,
+	.setup = &setup_mt,
+	.teardown = NULL
+};
+
 /** @}
  */
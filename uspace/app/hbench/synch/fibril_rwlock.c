@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup hbench
+ * @{
+ */
+
+#include <fibril_synch.h>
+#include <stdio.h>
+#include "../hbench.h"
+
+/*
+ * Read-mostly workload on a small table shared by several fibrils spread
+ * over multiple threads. One operation in 'period' (64 by default) updates
+ * the table, all the others only read it. The number of fibrils is given by
+ * the 'fibrils' parameter (4 by default).
+ *
+ * The same workload is run with the regular and with the reader-biased
+ * rwlock so that the two can be compared.
+ */
+
+#define TABLE_SIZE 16
+
+typedef struct {
+	bool biased;
+	fibril_rwlock_t rwlock;
+	fibril_brwlock_t brwlock;
+	fibril_semaphore_t done;
+	uint64_t iterations;
+	unsigned period;
+	uint64_t table[TABLE_SIZE];
+} shared_t;
+
+static void read_lock(shared_t *shared)
+{
+	if (shared->biased)
+		fibril_brwlock_read_lock(&shared->brwlock);
+	else
+		fibril_rwlock_read_lock(&shared->rwlock);
+}
+
+static void read_unlock(shared_t *shared)
+{
+	if (shared->biased)
+		fibril_brwlock_read_unlock(&shared->brwlock);
+	else
+		fibril_rwlock_read_unlock(&shared->rwlock);
+}
+
+static void write_lock(shared_t *shared)
+{
+	if (shared->biased)
+		fibril_brwlock_write_lock(&shared->brwlock);
+	else
+		fibril_rwlock_write_lock(&shared->rwlock);
+}
+
+static void write_unlock(shared_t *shared)
+{
+	if (shared->biased)
+		fibril_brwlock_write_unlock(&shared->brwlock);
+	else
+		fibril_rwlock_write_unlock(&shared->rwlock);
+}
+
+static errno_t worker(void *arg)
+{
+	shared_t *shared = arg;
+	uint64_t sum = 0;
+
+	for (uint64_t i = 0; i < shared->iterations; i++) {
+		if (i % shared->period == 0) {
+			write_lock(shared);
+			shared->table[i % TABLE_SIZE]++;
+			write_unlock(shared);
+		} else {
+			read_lock(shared);
+			for (unsigned j = 0; j < TABLE_SIZE; j++)
+				sum += shared->table[j];
+			read_unlock(shared);
+		}
+	}
+
+	/* Keep the reads from being optimized away. */
+	if (sum == 0)
+		shared->table[0] = 0;
+
+	fibril_semaphore_up(&shared->done);
+	return EOK;
+}
+
+static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size,
+    bool biased)
+{
+	shared_t shared = { 0 };
+	const char *str;
+	unsigned nfibrils;
+
+	str = bench_env_param_get(env, "fibrils", "4");
+	if (sscanf(str, "%u", &nfibrils) < 1 || nfibrils == 0)
+		return bench_run_fail(run, "'fibrils' must be a positive number.");
+
+	str = bench_env_param_get(env, "period", "64");
+	if (sscanf(str, "%u", &shared.period) < 1 || shared.period == 0)
+		return bench_run_fail(run, "'period' must be a positive number.");
+
+	shared.biased = biased;
+	fibril_rwlock_initialize(&shared.rwlock);
+	fibril_brwlock_initialize(&shared.brwlock);
+	fibril_semaphore_initialize(&shared.done, 0);
+	shared.iterations = size / nfibrils;
+
+	bench_run_start(run);
+
+	for (unsigned i = 0; i < nfibrils; i++) {
+		fid_t fid = fibril_create(worker, &shared);
+		if (fid == 0) {
+			/* Let the ones already started finish. */
+			for (unsigned j = 0; j < i; j++)
+				fibril_semaphore_down(&shared.done);
+			return bench_run_fail(run, "failed to create fibril");
+		}
+
+		fibril_add_ready(fid);
+	}
+
+	for (unsigned i = 0; i < nfibrils; i++)
+		fibril_semaphore_down(&shared.done);
+
+	bench_run_stop(run);
+
+	return true;
+}
+
+static bool runner_rwlock(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	return runner(env, run, size, false);
+}
+
+static bool runner_brwlock(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	return runner(env, run, size, true);
+}
+
+static bool setup(bench_env_t *env, bench_run_t *run)
+{
+	fibril_enable_multithreaded();
+	return true;
+}
+
+benchmark_t benchmark_fibril_rwlock_mt = {
+	.name = "fibril_rwlock_mt",
+	.desc = "Read-mostly table guarded by fibril_rwlock "
+	    "(set 'fibrils' and 'period' parameters).",
+	.entry = &runner_rwlock,
+	.setup = &setup,
+	.teardown = NULL
+};
+
+benchmark_t benchmark_fibril_brwlock_mt = {
+	.name = "fibril_brwlock_mt",
+	.desc = "Read-mostly table guarded by reader-biased fibril_brwlock "
+	    "(set 'fibrils' and 'period' parameters).",
+	.entry = &runner_brwlock,
+	.setup = &setup,
+	.teardown = NULL
+};
+
+/** @}
+ */
@@ -32,8 +32,10 @@
  */
 
 #include <as.h>
+#include <assert.h>
 #include <bd_srv.h>
 #include <errno.h>
+#include <macros.h>
 #include <stdio.h>
 #include <ddf/interrupt.h>
 #include <ddf/log.h>
@@ -109,13 +111,22 @@
 		.cmd = CMD_ACCEPT \
 	}
 
+/** DMA buffer segment. */
+typedef struct {
+	/** Virtual address. */
+	void *virt;
+	/** Physical address. */
+	uintptr_t phys;
+	/** Size in bytes. */
+	size_t size;
+} ahci_seg_t;
+
 static errno_t ahci_read_blocks(sata_dev_t *, uint64_t, size_t, void *);
 static errno_t ahci_write_blocks(sata_dev_t *, uint64_t, size_t, void *);
 
 static errno_t ahci_identify_device(sata_dev_t *);
 static errno_t ahci_set_highest_ultra_dma_mode(sata_dev_t *);
-static errno_t ahci_rb_fpdma(sata_dev_t *, uintptr_t, uint64_t);
-static errno_t ahci_wb_fpdma(sata_dev_t *, uintptr_t, uint64_t);
+static errno_t ahci_fpdma(sata_dev_t *, ahci_seg_t *, uint64_t, size_t, bool);
 
 static void ahci_sata_devices_create(ahci_dev_t *, ddf_dev_t *);
 static ahci_dev_t *ahci_ahci_create(ddf_dev_t *);
@@ -161,6 +172,82 @@ static sata_dev_t *bd_srv_sata(bd_srv_t *bd)
 	return (sata_dev_t *) bd->srvs->sarg;
 }
 
+/** Free DMA buffer.
+ *
+ * @param segs  Buffer segments.
+ * @param nsegs Number of segments.
+ *
+ */
+static void ahci_buf_free(ahci_seg_t *segs, size_t nsegs)
+{
+	for (size_t i = 0; i < nsegs; i++)
+		dmamem_unmap_anonymous(segs[i].virt);
+}
+
+/** Allocate DMA buffer.
+ *
+ * The buffer is made of physically contiguous segments of at most
+ * AHCI_SEG_SIZE bytes, each described by one PRD entry, so that one
+ * command can move a lot of data without needing a large physically
+ * contiguous allocation.
+ *
+ * @param size  Buffer size in bytes, at most AHCI_XFER_MAX_SIZE.
+ * @param segs  Array of AHCI_PRDT_ENTRIES segments to fill in.
+ * @param nsegs Place to store number of allocated segments.
+ *
+ * @return EOK on success, error code otherwise
+ *
+ */
+static errno_t ahci_buf_alloc(size_t size, ahci_seg_t *segs, size_t *nsegs)
+{
+	size_t n = 0;
+
+	assert(size <= AHCI_XFER_MAX_SIZE);
+
+	while (size > 0) {
+		segs[n].virt = AS_AREA_ANY;
+		segs[n].size = min(size, AHCI_SEG_SIZE);
+
+		errno_t rc = dmamem_map_anonymous(segs[n].size, DMAMEM_4GiB,
+		    AS_AREA_READ | AS_AREA_WRITE, 0, &segs[n].phys,
+		    &segs[n].virt);
+		if (rc != EOK) {
+			ahci_buf_free(segs, n);
+			return rc;
+		}
+
+		size -= segs[n].size;
+		n++;
+	}
+
+	*nsegs = n;
+	return EOK;
+}
+
+/** Copy data between DMA buffer and client buffer.
+ *
+ * @param segs   DMA buffer segments.
+ * @param buf    Client buffer.
+ * @param size   Number of bytes to copy.
+ * @param to_dma @c true to copy into DMA buffer, @c false to copy from it.
+ *
+ */
+static void ahci_buf_copy(ahci_seg_t *segs, uint8_t *buf, size_t size,
+    bool to_dma)
+{
+	for (size_t i = 0; size > 0; i++) {
+		size_t n = min(size, segs[i].size);
+
+		if (to_dma)
+			memcpy(segs[i].virt, buf, n);
+		else
+			memcpy(buf, segs[i].virt, n);
+
+		buf += n;
+		size -= n;
+	}
+}
+
 /** Read data blocks from SATA device.
  *
  * @param sata     SATA device
@@ -174,31 +261,34 @@ static sata_dev_t *bd_srv_sata(bd_srv_t *bd)
 static errno_t ahci_read_blocks(sata_dev_t *sata, uint64_t blocknum,
     size_t count, void *buf)
 {
-	uintptr_t phys;
-	void *ibuf = AS_AREA_ANY;
-	errno_t rc = dmamem_map_anonymous(sata->block_size, DMAMEM_4GiB,
-	    AS_AREA_READ | AS_AREA_WRITE, 0, &phys, &ibuf);
+	size_t max_blocks = AHCI_XFER_MAX_SIZE / sata->block_size;
+	ahci_seg_t segs[AHCI_PRDT_ENTRIES];
+	size_t nsegs;
+
+	errno_t rc = ahci_buf_alloc(min(count, max_blocks) * sata->block_size,
+	    segs, &nsegs);
 	if (rc != EOK) {
 		ddf_msg(LVL_ERROR, "Cannot allocate read buffer.");
 		return rc;
 	}
 
-	memset(buf, 0, sata->block_size);
+	uint8_t *bp = (uint8_t *) buf;
 
-	fibril_mutex_lock(&sata->lock);
+	while (count > 0) {
+		size_t n = min(count, max_blocks);
 
-	for (size_t cur = 0; cur < count; cur++) {
-		rc = ahci_rb_fpdma(sata, phys, blocknum + cur);
+		rc = ahci_fpdma(sata, segs, blocknum, n, false);
 		if (rc != EOK)
 			break;
 
-		memcpy((void *) (((uint8_t *) buf) + (sata->block_size * cur)),
-		    ibuf, sata->block_size);
-	}
+		ahci_buf_copy(segs, bp, n * sata->block_size, false);
 
-	fibril_mutex_unlock(&sata->lock);
-	dmamem_unmap_anonymous(ibuf);
+		bp += n * sata->block_size;
+		blocknum += n;
+		count -= n;
+	}
 
+	ahci_buf_free(segs, nsegs);
 	return rc;
 }
 
@@ -214,28 +304,34 @@ static errno_t ahci_read_blocks(sata_dev_t *sata, uint64_t blocknum,
 static errno_t ahci_write_blocks(sata_dev_t *sata, uint64_t blocknum,
     size_t count, void *buf)
 {
-	uintptr_t phys;
-	void *ibuf = AS_AREA_ANY;
-	errno_t rc = dmamem_map_anonymous(sata->block_size, DMAMEM_4GiB,
-	    AS_AREA_READ | AS_AREA_WRITE, 0, &phys, &ibuf);
+	size_t max_blocks = AHCI_XFER_MAX_SIZE / sata->block_size;
+	ahci_seg_t segs[AHCI_PRDT_ENTRIES];
+	size_t nsegs;
+
+	errno_t rc = ahci_buf_alloc(min(count, max_blocks) * sata->block_size,
+	    segs, &nsegs);
 	if (rc != EOK) {
 		ddf_msg(LVL_ERROR, "Cannot allocate write buffer.");
 		return rc;
 	}
 
-	fibril_mutex_lock(&sata->lock);
+	uint8_t *bp = (uint8_t *) buf;
 
-	for (size_t cur = 0; cur < count; cur++) {
-		memcpy(ibuf, (void *) (((uint8_t *) buf) + (sata->block_size * cur)),
-		    sata->block_size);
-		rc = ahci_wb_fpdma(sata, phys, blocknum + cur);
+	while (count > 0) {
+		size_t n = min(count, max_blocks);
+
+		ahci_buf_copy(segs, bp, n * sata->block_size, true);
+
+		rc = ahci_fpdma(sata, segs, blocknum, n, true);
 		if (rc != EOK)
 			break;
-	}
 
-	fibril_mutex_unlock(&sata->lock);
-	dmamem_unmap_anonymous(ibuf);
+		bp += n * sata->block_size;
+		blocknum += n;
+		count -= n;
+	}
 
+	ahci_buf_free(segs, nsegs);
 	return rc;
 }
 
@@ -339,7 +435,7 @@ static ahci_port_is_t ahci_wait_event(sata_dev_t *sata)
 static void ahci_identify_device_cmd(sata_dev_t *sata, uintptr_t phys)
 {
 	volatile sata_std_command_frame_t *cmd =
-	    (sata_std_command_frame_t *) sata->cmd_table;
+	    (sata_std_command_frame_t *) sata->slots[0].cmd_table;
 
 	cmd->fis_type = SATA_CMD_FIS_TYPE;
 	cmd->c = SATA_CMD_FIS_COMMAND_INDICATOR;
@@ -355,7 +451,7 @@ static void ahci_identify_device_cmd(sata_dev_t *sata, uintptr_t phys)
 	cmd->reserved2 = 0;
 
 	volatile ahci_cmd_prdt_t *prdt =
-	    (ahci_cmd_prdt_t *) (&sata->cmd_table[0x20]);
+	    (ahci_cmd_prdt_t *) (&sata->slots[0].cmd_table[0x20]);
 
 	prdt->data_address_low = LO(phys);
 	prdt->data_address_upper = HI(phys);
@@ -371,8 +467,7 @@ static void ahci_identify_device_cmd(sata_dev_t *sata, uintptr_t phys)
 	sata->cmd_header->bytesprocessed = 0;
 
 	/* Run command. */
-	sata->port->pxsact |= 1;
-	sata->port->pxci |= 1;
+	sata->port->pxci = 1;
 }
 
 /** Set AHCI registers for identifying packet SATA device.
@@ -384,7 +479,7 @@ static void ahci_identify_device_cmd(sata_dev_t *sata, uintptr_t phys)
 static void ahci_identify_packet_device_cmd(sata_dev_t *sata, uintptr_t phys)
 {
 	volatile sata_std_command_frame_t *cmd =
-	    (sata_std_command_frame_t *) sata->cmd_table;
+	    (sata_std_command_frame_t *) sata->slots[0].cmd_table;
 
 	cmd->fis_type = SATA_CMD_FIS_TYPE;
 	cmd->c = SATA_CMD_FIS_COMMAND_INDICATOR;
@@ -400,7 +495,7 @@ static void ahci_identify_packet_device_cmd(sata_dev_t *sata, uintptr_t phys)
 	cmd->reserved2 = 0;
 
 	volatile ahci_cmd_prdt_t *prdt =
-	    (ahci_cmd_prdt_t *) (&sata->cmd_table[0x20]);
+	    (ahci_cmd_prdt_t *) (&sata->slots[0].cmd_table[0x20]);
 
 	prdt->data_address_low = LO(phys);
 	prdt->data_address_upper = HI(phys);
@@ -416,8 +511,7 @@ static void ahci_identify_packet_device_cmd(sata_dev_t *sata, uintptr_t phys)
 	sata->cmd_header->bytesprocessed = 0;
 
 	/* Run command. */
-	sata->port->pxsact |= 1;
-	sata->port->pxci |= 1;
+	sata->port->pxci = 1;
 }
 
 /** Fill device identification in SATA device structure.
@@ -482,6 +576,8 @@ static errno_t ahci_identify_device(sata_dev_t *sata)
 		goto error;
 	}
 
+	sata->queue_depth = (idata->queue_depth & 0x1f) + 1;
+
 	uint16_t logsec = idata->physical_logic_sector_size;
 	if ((logsec & 0xc000) == 0x4000) {
 		/* Length of sector may be larger than 512 B */
@@ -565,7 +661,7 @@ error:
 static void ahci_set_mode_cmd(sata_dev_t *sata, uintptr_t phys, uint8_t mode)
 {
 	volatile sata_std_command_frame_t *cmd =
-	    (sata_std_command_frame_t *) sata->cmd_table;
+	    (sata_std_command_frame_t *) sata->slots[0].cmd_table;
 
 	cmd->fis_type = SATA_CMD_FIS_TYPE;
 	cmd->c = SATA_CMD_FIS_COMMAND_INDICATOR;
@@ -581,7 +677,7 @@ static void ahci_set_mode_cmd(sata_dev_t *sata, uintptr_t phys, uint8_t mode)
 	cmd->reserved2 = 0;
 
 	volatile ahci_cmd_prdt_t *prdt =
-	    (ahci_cmd_prdt_t *) (&sata->cmd_table[0x20]);
+	    (ahci_cmd_prdt_t *) (&sata->slots[0].cmd_table[0x20]);
 
 	prdt->data_address_low = LO(phys);
 	prdt->data_address_upper = HI(phys);
@@ -597,8 +693,7 @@ static void ahci_set_mode_cmd(sata_dev_t *sata, uintptr_t phys, uint8_t mode)
 	sata->cmd_header->bytesprocessed = 0;
 
 	/* Run command. */
-	sata->port->pxsact |= 1;
-	sata->port->pxci |= 1;
+	sata->port->pxci = 1;
 }
 
 /** Set highest ultra DMA mode supported by SATA device.
@@ -672,23 +767,26 @@ error:
 	return EINTR;
 }
 
-/** Set AHCI registers for reading one sector from the SATA device using FPDMA.
+/** Set AHCI registers for a FPDMA queued read or write.
  *
  * @param sata     SATA device structure.
- * @param phys     Physical address of buffer for sector data.
- * @param blocknum Block number to read.
+ * @param slot     Command slot, also used as NCQ tag.
+ * @param segs     DMA buffer segments.
+ * @param blocknum Number of first block.
+ * @param count    Number of blocks to transfer.
+ * @param write    @c true to write, @c false to read.
  *
  */
-static void ahci_rb_fpdma_cmd(sata_dev_t *sata, uintptr_t phys,
-    uint64_t blocknum)
+static void ahci_fpdma_cmd(sata_dev_t *sata, unsigned int slot,
+    ahci_seg_t *segs, uint64_t blocknum, size_t count, bool write)
 {
 	volatile sata_ncq_command_frame_t *cmd =
-	    (sata_ncq_command_frame_t *) sata->cmd_table;
+	    (sata_ncq_command_frame_t *) sata->slots[slot].cmd_table;
 
 	cmd->fis_type = SATA_CMD_FIS_TYPE;
 	cmd->c = SATA_CMD_FIS_COMMAND_INDICATOR;
-	cmd->command = 0x60;
-	cmd->tag = 0;
+	cmd->command = write ? 0x61 : 0x60;
+	cmd->tag = slot << 3;
 	cmd->control = 0;
 
 	cmd->reserved1 = 0;
@@ -698,8 +796,8 @@ static void ahci_rb_fpdma_cmd(sata_dev_t *sata, uintptr_t phys,
 	cmd->reserved5 = 0;
 	cmd->reserved6 = 0;
 
-	cmd->sector_count_low = 1;
-	cmd->sector_count_high = 0;
+	cmd->sector_count_low = count & 0xff;
+	cmd->sector_count_high = (count >> 8) & 0xff;
 
 	cmd->lba0 = blocknum & 0xff;
 	cmd->lba1 = (blocknum >> 8) & 0xff;
@@ -708,137 +806,101 @@ static void ahci_rb_fpdma_cmd(sata_dev_t *sata, uintptr_t phys,
 	cmd->lba4 = (blocknum >> 32) & 0xff;
 	cmd->lba5 = (blocknum >> 40) & 0xff;
 
-	volatile ahci_cmd_prdt_t *prdt =
-	    (ahci_cmd_prdt_t *) (&sata->cmd_table[0x20]);
+	volatile ahci_cmd_prdt_t *prdt = (ahci_cmd_prdt_t *)
+	    (&sata->slots[slot].cmd_table[AHCI_CMDTBL_PRDT_OFFSET / 4]);
 
-	prdt->data_address_low = LO(phys);
-	prdt->data_address_upper = HI(phys);
-	prdt->reserved1 = 0;
-	prdt->dbc = sata->block_size - 1;
-	prdt->reserved2 = 0;
-	prdt->ioc = 0;
+	/* One PRD entry per buffer segment */
+	size_t left = count * sata->block_size;
+	unsigned int nprd = 0;
 
-	sata->cmd_header->prdtl = 1;
-	sata->cmd_header->flags =
+	while (left > 0) {
+		size_t size = min(left, segs[nprd].size);
+		assert(size <= AHCI_PRD_MAX_BYTES);
+
+		prdt[nprd].data_address_low = LO(segs[nprd].phys);
+		prdt[nprd].data_address_upper = HI(segs[nprd].phys);
+		prdt[nprd].reserved1 = 0;
+		prdt[nprd].dbc = size - 1;
+		prdt[nprd].reserved2 = 0;
+		prdt[nprd].ioc = 0;
+
+		left -= size;
+		nprd++;
+	}
+
+	volatile ahci_cmdhdr_t *hdr = &sata->cmd_header[slot];
+
+	hdr->prdtl = nprd;
+	hdr->flags =
 	    AHCI_CMDHDR_FLAGS_CLEAR_BUSY_UPON_OK |
+	    (write ? AHCI_CMDHDR_FLAGS_WRITE : 0) |
 	    AHCI_CMDHDR_FLAGS_5DWCMD;
-	sata->cmd_header->bytesprocessed = 0;
-
-	sata->port->pxsact |= 1;
-	sata->port->pxci |= 1;
+	hdr->bytesprocessed = 0;
 }
 
-/** Read one sector from the SATA device using FPDMA.
+/** Read or write blocks using a FPDMA queued command.
+ *
+ * Takes a free command slot, issues the command and waits for its
+ * completion. Commands from concurrent requests are queued in the
+ * device at the same time, up to the number of usable slots.
  *
  * @param sata     SATA device structure.
- * @param phys     Physical address of buffer for sector data.
- * @param blocknum Block number to read.
+ * @param segs     DMA buffer segments, large enough for @a count blocks.
+ * @param blocknum Number of first block.
+ * @param count    Number of blocks to transfer.
+ * @param write    @c true to write, @c false to read.
  *
  * @return EOK on success, error code otherwise
  *
  */
-static errno_t ahci_rb_fpdma(sata_dev_t *sata, uintptr_t phys, uint64_t blocknum)
+static errno_t ahci_fpdma(sata_dev_t *sata, ahci_seg_t *segs,
+    uint64_t blocknum, size_t count, bool write)
 {
 	if (sata->is_invalid_device) {
-		ddf_msg(LVL_ERROR,
-		    "%s: FPDMA read from invalid device", sata->model);
+		ddf_msg(LVL_ERROR, "%s: FPDMA %s invalid device", sata->model,
+		    write ? "write to" : "read from");
 		return EINTR;
 	}
 
-	ahci_rb_fpdma_cmd(sata, phys, blocknum);
-	ahci_port_is_t pxis = ahci_wait_event(sata);
-
-	if ((sata->is_invalid_device) || (ahci_port_is_error(pxis))) {
-		ddf_msg(LVL_ERROR,
-		    "%s: Unrecoverable error during FPDMA read", sata->model);
-		return EINTR;
-	}
+	fibril_mutex_lock(&sata->event_lock);
 
-	return EOK;
-}
+	while (sata->slots_free == 0)
+		fibril_condvar_wait(&sata->slot_free_cv, &sata->event_lock);
 
-/** Set AHCI registers for writing one sector to the SATA device, use FPDMA.
- *
- * @param sata     SATA device structure.
- * @param phys     Physical address of buffer with sector data.
- * @param blocknum Block number to write.
- *
- * @return EOK on success, error code otherwise
- *
- */
-static void ahci_wb_fpdma_cmd(sata_dev_t *sata, uintptr_t phys,
-    uint64_t blocknum)
-{
-	volatile sata_ncq_command_frame_t *cmd =
-	    (sata_ncq_command_frame_t *) sata->cmd_table;
+	unsigned int slot = 0;
+	while ((sata->slots_free & (1u << slot)) == 0)
+		slot++;
 
-	cmd->fis_type = SATA_CMD_FIS_TYPE;
-	cmd->c = SATA_CMD_FIS_COMMAND_INDICATOR;
-	cmd->command = 0x61;
-	cmd->tag = 0;
-	cmd->control = 0;
+	uint32_t mask = 1u << slot;
+	sata->slots_free &= ~mask;
 
-	cmd->reserved1 = 0;
-	cmd->reserved2 = 0;
-	cmd->reserved3 = 0;
-	cmd->reserved4 = 0;
-	cmd->reserved5 = 0;
-	cmd->reserved6 = 0;
+	fibril_mutex_unlock(&sata->event_lock);
 
-	cmd->sector_count_low = 1;
-	cmd->sector_count_high = 0;
+	ahci_fpdma_cmd(sata, slot, segs, blocknum, count, write);
 
-	cmd->lba0 = blocknum & 0xff;
-	cmd->lba1 = (blocknum >> 8) & 0xff;
-	cmd->lba2 = (blocknum >> 16) & 0xff;
-	cmd->lba3 = (blocknum >> 24) & 0xff;
-	cmd->lba4 = (blocknum >> 32) & 0xff;
-	cmd->lba5 = (blocknum >> 40) & 0xff;
+	fibril_mutex_lock(&sata->event_lock);
 
-	volatile ahci_cmd_prdt_t *prdt =
-	    (ahci_cmd_prdt_t *) (&sata->cmd_table[0x20]);
+	sata->slots[slot].done = false;
+	sata->slots[slot].error = false;
+	sata->slots_issued |= mask;
 
-	prdt->data_address_low = LO(phys);
-	prdt->data_address_upper = HI(phys);
-	prdt->reserved1 = 0;
-	prdt->dbc = sata->block_size - 1;
-	prdt->reserved2 = 0;
-	prdt->ioc = 0;
+	/* Run command. */
+	sata->port->pxsact = mask;
+	sata->port->pxci = mask;
 
-	sata->cmd_header->prdtl = 1;
-	sata->cmd_header->flags =
-	    AHCI_CMDHDR_FLAGS_CLEAR_BUSY_UPON_OK |
-	    AHCI_CMDHDR_FLAGS_WRITE |
-	    AHCI_CMDHDR_FLAGS_5DWCMD;
-	sata->cmd_header->bytesprocessed = 0;
+	while (!sata->slots[slot].done)
+		fibril_condvar_wait(&sata->slot_done_cv, &sata->event_lock);
 
-	sata->port->pxsact |= 1;
-	sata->port->pxci |= 1;
-}
+	bool error = sata->slots[slot].error;
 
-/** Write one sector into the SATA device, use FPDMA.
- *
- * @param sata     SATA device structure.
- * @param phys     Physical address of buffer with sector data.
- * @param blocknum Block number to write.
- *
- * @return EOK on success, error code otherwise
- *
- */
-static errno_t ahci_wb_fpdma(sata_dev_t *sata, uintptr_t phys, uint64_t blocknum)
-{
-	if (sata->is_invalid_device) {
-		ddf_msg(LVL_ERROR,
-		    "%s: FPDMA write to invalid device", sata->model);
-		return EINTR;
-	}
+	sata->slots_free |= mask;
+	fibril_condvar_signal(&sata->slot_free_cv);
 
-	ahci_wb_fpdma_cmd(sata, phys, blocknum);
-	ahci_port_is_t pxis = ahci_wait_event(sata);
+	fibril_mutex_unlock(&sata->event_lock);
 
-	if ((sata->is_invalid_device) || (ahci_port_is_error(pxis))) {
-		ddf_msg(LVL_ERROR,
-		    "%s: Unrecoverable error during FPDMA write", sata->model);
+	if ((sata->is_invalid_device) || (error)) {
+		ddf_msg(LVL_ERROR, "%s: Unrecoverable error during FPDMA %s",
+		    sata->model, write ? "write" : "read");
 		return EINTR;
 	}
 
@@ -891,6 +953,48 @@ static irq_cmd_t ahci_cmds[] = {
 	AHCI_PORT_CMDS(31)
 };
 
+/** Complete queued commands.
+ *
+ * A queued command has completed once its bit is clear both in PxCI
+ * (command accepted by the device) and in PxSACT (completion reported
+ * by a Set Device Bits FIS). The port stops processing commands after
+ * an error, so all outstanding commands are failed in that case.
+ *
+ * Must be called with event_lock held.
+ *
+ * @param sata SATA device structure.
+ * @param pxis Value of port interrupt status register.
+ *
+ */
+static void ahci_slots_complete(sata_dev_t *sata, ahci_port_is_t pxis)
+{
+	bool error = ahci_port_is_error(pxis);
+	uint32_t done;
+
+	if (error) {
+		if (ahci_port_is_permanent_error(pxis))
+			sata->is_invalid_device = true;
+
+		done = sata->slots_issued;
+	} else {
+		done = sata->slots_issued &
+		    ~(sata->port->pxsact | sata->port->pxci);
+	}
+
+	if (done == 0)
+		return;
+
+	for (unsigned int i = 0; i < AHCI_MAX_CMD_SLOTS; i++) {
+		if ((done & (1u << i)) != 0) {
+			sata->slots[i].done = true;
+			sata->slots[i].error = error;
+		}
+	}
+
+	sata->slots_issued &= ~done;
+	fibril_condvar_broadcast(&sata->slot_done_cv);
+}
+
 /** AHCI interrupt handler.
  *
  * @param icall The IPC call structure.
@@ -917,6 +1021,8 @@ static void ahci_interrupt(ipc_call_t *icall, void *arg)
 		sata->event_pxis = pxis;
 		fibril_condvar_signal(&sata->event_condvar);
 
+		ahci_slots_complete(sata, pxis);
+
 		fibril_mutex_unlock(&sata->event_lock);
 	}
 }
@@ -935,6 +1041,7 @@ static void ahci_interrupt(ipc_call_t *icall, void *arg)
 static sata_dev_t *ahci_sata_allocate(ahci_dev_t *ahci, volatile ahci_port_t *port)
 {
 	size_t size = 4096;
+	size_t table_size = AHCI_MAX_CMD_SLOTS * AHCI_CMD_TABLE_SIZE;
 	uintptr_t phys = 0;
 	void *virt_fb = AS_AREA_ANY;
 	void *virt_cmd = AS_AREA_ANY;
@@ -971,16 +1078,21 @@ static sata_dev_t *ahci_sata_allocate(ahci_dev_t *ahci, volatile ahci_port_t *po
 	sata->port->pxclb = LO(phys);
 	sata->cmd_header = (ahci_cmdhdr_t *) virt_cmd;
 
-	/* Allocate and init command table structure. */
-	rc = dmamem_map_anonymous(size, DMAMEM_4GiB,
+	/* Allocate and init command table structures, one per slot. */
+	rc = dmamem_map_anonymous(table_size, DMAMEM_4GiB,
 	    AS_AREA_READ | AS_AREA_WRITE, 0, &phys, &virt_table);
 	if (rc != EOK)
 		goto error_table;
 
-	memset(virt_table, 0, size);
-	sata->cmd_header->cmdtableu = HI(phys);
-	sata->cmd_header->cmdtable = LO(phys);
-	sata->cmd_table = (uint32_t *) virt_table;
+	memset(virt_table, 0, table_size);
+	for (unsigned int i = 0; i < AHCI_MAX_CMD_SLOTS; i++) {
+		uintptr_t tphys = phys + i * AHCI_CMD_TABLE_SIZE;
+
+		sata->cmd_header[i].cmdtableu = HI(tphys);
+		sata->cmd_header[i].cmdtable = LO(tphys);
+		sata->slots[i].cmd_table = (uint32_t *)
+		    ((uint8_t *) virt_table + i * AHCI_CMD_TABLE_SIZE);
+	}
 
 	return sata;
 
@@ -1060,6 +1172,8 @@ static errno_t ahci_sata_create(ahci_dev_t *ahci, ddf_dev_t *dev,
 	fibril_mutex_initialize(&sata->lock);
 	fibril_mutex_initialize(&sata->event_lock);
 	fibril_condvar_initialize(&sata->event_condvar);
+	fibril_condvar_initialize(&sata->slot_free_cv);
+	fibril_condvar_initialize(&sata->slot_done_cv);
 
 	ahci_sata_hw_start(sata);
 
@@ -1071,6 +1185,14 @@ static errno_t ahci_sata_create(ahci_dev_t *ahci, ddf_dev_t *dev,
 	if (ahci_set_highest_ultra_dma_mode(sata) != EOK)
 		goto error;
 
+	/* Use as many command slots as both the HBA and the device support. */
+	ahci_ghc_cap_t cap;
+	cap.u32 = ahci->memregs->ghc.cap;
+	unsigned int nslots = min(cap.ncs + 1, sata->queue_depth);
+	sata->slots_usable = (nslots == AHCI_MAX_CMD_SLOTS) ? 0xffffffff :
+	    (1u << nslots) - 1;
+	sata->slots_free = sata->slots_usable;
+
 	/* Add device to the system */
 	char sata_dev_name[16];
 	snprintf(sata_dev_name, 16, "ahci_%u", sata_devices_count);
@@ -42,6 +42,19 @@
 #include <stdint.h>
 #include "ahci_hw.h"
 
+/** Number of PRD entries in one command table. */
+#define AHCI_PRDT_ENTRIES  16
+
+/** Size of one command table in bytes (multiple of 128). */
+#define AHCI_CMD_TABLE_SIZE \
+	(AHCI_CMDTBL_PRDT_OFFSET + AHCI_PRDT_ENTRIES * sizeof(ahci_cmd_prdt_t))
+
+/** Size of one DMA buffer segment, described by one PRD entry. */
+#define AHCI_SEG_SIZE  (64 * 1024)
+
+/** Maximum number of bytes moved by one command. */
+#define AHCI_XFER_MAX_SIZE  (AHCI_PRDT_ENTRIES * AHCI_SEG_SIZE)
+
 /** AHCI Device. */
 typedef struct {
 	/** Pointer to ddf device. */
@@ -57,6 +70,18 @@ typedef struct {
 	async_sess_t *parent_sess;
 } ahci_dev_t;
 
+/** AHCI command slot. */
+typedef struct {
+	/** Pointer to command table of the slot. */
+	volatile uint32_t *cmd_table;
+
+	/** Command has completed. */
+	bool done;
+
+	/** Command has completed with an error. */
+	bool error;
+} ahci_slot_t;
+
 /** SATA Device. */
 typedef struct {
 	/** Pointer to AHCI device. */
@@ -74,16 +99,16 @@ typedef struct {
 	/** Pointer to SATA port. */
 	volatile ahci_port_t *port;
 
-	/** Pointer to command header. */
+	/** Pointer to command list (one command header per slot). */
 	volatile ahci_cmdhdr_t *cmd_header;
 
-	/** Pointer to command table. */
-	volatile uint32_t *cmd_table;
+	/** Command slots. */
+	ahci_slot_t slots[AHCI_MAX_CMD_SLOTS];
 
-	/** Mutex for single operation on device. */
+	/** Mutex for single non-queued operation on device. */
 	fibril_mutex_t lock;
 
-	/** Mutex for event signaling condition variable. */
+	/** Mutex for event signaling and command slot state. */
 	fibril_mutex_t event_lock;
 
 	/** Event signaling condition variable. */
@@ -92,6 +117,21 @@ typedef struct {
 	/** Event interrupt state. */
 	ahci_port_is_t event_pxis;
 
+	/** Bitmap of command slots usable for queued commands. */
+	uint32_t slots_usable;
+
+	/** Bitmap of free command slots. */
+	uint32_t slots_free;
+
+	/** Bitmap of issued queued commands that have not completed. */
+	uint32_t slots_issued;
+
+	/** Signalled when a command slot is freed. */
+	fibril_condvar_t slot_free_cv;
+
+	/** Signalled when a queued command completes. */
+	fibril_condvar_t slot_done_cv;
+
 	/** Number of device data blocks. */
 	uint64_t blocks;
 
@@ -107,6 +147,9 @@ typedef struct {
 	/** Highest UDMA mode supported. */
 	uint8_t highest_udma_mode;
 
+	/** NCQ queue depth supported by the device. */
+	unsigned int queue_depth;
+
 	/** Block device service structure */
 	bd_srvs_t bds;
 } sata_dev_t;
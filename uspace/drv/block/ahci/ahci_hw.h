@@ -1019,6 +1019,15 @@ typedef volatile struct {
 /** 5 DW length command flag. */
 #define AHCI_CMDHDR_FLAGS_5DWCMD  0x0005
 
+/** Number of command slots in the AHCI command list. */
+#define AHCI_MAX_CMD_SLOTS  32
+
+/** Offset of the PRD table within the command table in bytes. */
+#define AHCI_CMDTBL_PRDT_OFFSET  0x80
+
+/** Maximum data byte count of one PRD entry. */
+#define AHCI_PRD_MAX_BYTES  0x400000
+
 /** AHCI Command Physical Region Descriptor entry.
  *
  * This structure is not an AHCI register.
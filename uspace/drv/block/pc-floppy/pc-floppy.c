@@ -1007,20 +1007,26 @@ static errno_t pc_fdc_bd_read_blocks(bd_srv_t *bd, uint64_t ba, size_t cnt,
 		goto error;
 	}
 
+	/* Requests may come from several fibrils, the DMA buffer is shared */
+	fibril_mutex_lock(&drive->fdc->lock);
+
 	while (cnt > 0) {
 		pc_fdc_drive_ba_to_chs(drive, ba, &cyl, &head, &sec);
 
 		/* Read one block */
 		rc = pc_fdc_drive_read_data(drive, cyl, head, sec, buf,
 		    drive->sec_size);
-		if (rc != EOK)
+		if (rc != EOK) {
+			fibril_mutex_unlock(&drive->fdc->lock);
 			goto error;
+		}
 
 		++ba;
 		--cnt;
 		buf += drive->sec_size;
 	}
 
+	fibril_mutex_unlock(&drive->fdc->lock);
 	return EOK;
 error:
 	ddf_msg(LVL_ERROR, "pc_fdc_bd_read_blocks: rc=%d", rc);
@@ -1065,20 +1071,26 @@ static errno_t pc_fdc_bd_write_blocks(bd_srv_t *bd, uint64_t ba, size_t cnt,
 		goto error;
 	}
 
+	/* Requests may come from several fibrils, the DMA buffer is shared */
+	fibril_mutex_lock(&drive->fdc->lock);
+
 	while (cnt > 0) {
 		pc_fdc_drive_ba_to_chs(drive, ba, &cyl, &head, &sec);
 
 		/* Write one block */
 		rc = pc_fdc_drive_write_data(drive, cyl, head, sec, buf,
 		    drive->sec_size);
-		if (rc != EOK)
+		if (rc != EOK) {
+			fibril_mutex_unlock(&drive->fdc->lock);
 			goto error;
+		}
 
 		++ba;
 		--cnt;
 		buf += drive->sec_size;
 	}
 
+	fibril_mutex_unlock(&drive->fdc->lock);
 	return EOK;
 error:
 	ddf_msg(LVL_ERROR, "pc_fdc_bd_write_blocks: rc=%d", rc);
@@ -47,7 +47,7 @@
 #define MASTLOG(format, ...) \
 	usb_log_debug2("USB cl08: " format, ##__VA_ARGS__)
 
-/** Send command via bulk-only transport.
+/** Send command via bulk-only transport, device locked.
  *
  * @param mfun		Mass storage function
  * @param tag		Command block wrapper tag (automatically compared
@@ -56,7 +56,8 @@
  *
  * @return		Error code
  */
-errno_t usb_massstor_cmd(usbmast_fun_t *mfun, uint32_t tag, scsi_cmd_t *cmd)
+static errno_t usb_massstor_cmd_locked(usbmast_fun_t *mfun, uint32_t tag,
+    scsi_cmd_t *cmd)
 {
 	errno_t rc;
 
@@ -185,6 +186,29 @@ errno_t usb_massstor_cmd(usbmast_fun_t *mfun, uint32_t tag, scsi_cmd_t *cmd)
 	return rc;
 }
 
+/** Send command via bulk-only transport.
+ *
+ * Bulk-only transport handles one command at a time, so commands
+ * (possibly for different LUNs) are serialized.
+ *
+ * @param mfun		Mass storage function
+ * @param tag		Command block wrapper tag (automatically compared
+ *			with answer)
+ * @param cmd		SCSI command
+ *
+ * @return		Error code
+ */
+errno_t usb_massstor_cmd(usbmast_fun_t *mfun, uint32_t tag, scsi_cmd_t *cmd)
+{
+	errno_t rc;
+
+	fibril_mutex_lock(&mfun->mdev->lock);
+	rc = usb_massstor_cmd_locked(mfun, tag, cmd);
+	fibril_mutex_unlock(&mfun->mdev->lock);
+
+	return rc;
+}
+
 /** Perform bulk-only mass storage reset.
  *
  * @param mfun		Mass storage function
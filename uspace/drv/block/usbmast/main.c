@@ -167,6 +167,7 @@ static errno_t usbmast_device_add(usb_device_t *dev)
 	}
 
 	mdev->usb_dev = dev;
+	fibril_mutex_initialize(&mdev->lock);
 
 	usb_log_info("Initializing mass storage `%s'.",
 	    usb_device_get_name(dev));
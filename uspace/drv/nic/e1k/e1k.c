@@ -154,6 +154,9 @@ typedef struct {
 	/** Add VLAN tag to frame */
 	bool vlan_tag_add;
 
+	/** Active offload computations (NIC_OFFLOAD_*), protected by tx_lock */
+	uint32_t offload;
+
 	/** Used unicast Receive Address count */
 	unsigned int unicast_ra_count;
 
@@ -199,6 +202,9 @@ static errno_t e1000_autoneg_restart(ddf_fun_t *);
 
 static errno_t e1000_vlan_set_tag(ddf_fun_t *, uint16_t, bool, bool);
 
+static errno_t e1000_offload_probe(ddf_fun_t *, uint32_t *, uint32_t *);
+static errno_t e1000_offload_set(ddf_fun_t *, uint32_t, uint32_t);
+
 /** Network interface options for E1000 card driver */
 static nic_iface_t e1000_nic_iface;
 
@@ -215,6 +221,8 @@ static nic_iface_t e1000_nic_iface = {
 	.vlan_set_tag = &e1000_vlan_set_tag,
 	.defective_get_mode = &e1000_defective_get_mode,
 	.defective_set_mode = &e1000_defective_set_mode,
+	.offload_probe = &e1000_offload_probe,
+	.offload_set = &e1000_offload_set,
 };
 
 /** Basic device operations for E1000 driver */
@@ -1090,6 +1098,57 @@ static errno_t e1000_vlan_set_tag(ddf_fun_t *fun, uint16_t tag, bool add,
 	return EOK;
 }
 
+/** Get supported and active offload computations
+ *
+ * The legacy transmit descriptor can insert a single checksum per frame,
+ * which is used for the TCP checksum.
+ *
+ * @param fun       Device function
+ * @param supported Place to store supported offload computations
+ * @param active    Place to store active offload computations
+ *
+ * @return EOK
+ *
+ */
+static errno_t e1000_offload_probe(ddf_fun_t *fun, uint32_t *supported,
+    uint32_t *active)
+{
+	e1000_t *e1000 = DRIVER_DATA_FUN(fun);
+
+	*supported = NIC_OFFLOAD_TX_TCP_CSUM;
+
+	fibril_mutex_lock(&e1000->tx_lock);
+	*active = e1000->offload;
+	fibril_mutex_unlock(&e1000->tx_lock);
+
+	return EOK;
+}
+
+/** Enable or disable offload computations
+ *
+ * @param fun    Device function
+ * @param mask   Offload computations to change
+ * @param active New state of the computations selected by @a mask
+ *
+ * @return EOK on success
+ * @return ENOTSUP if an unsupported computation should be enabled
+ *
+ */
+static errno_t e1000_offload_set(ddf_fun_t *fun, uint32_t mask,
+    uint32_t active)
+{
+	e1000_t *e1000 = DRIVER_DATA_FUN(fun);
+
+	if ((mask & active & ~NIC_OFFLOAD_TX_TCP_CSUM) != 0)
+		return ENOTSUP;
+
+	fibril_mutex_lock(&e1000->tx_lock);
+	e1000->offload = (e1000->offload & ~mask) | (active & mask);
+	fibril_mutex_unlock(&e1000->tx_lock);
+
+	return EOK;
+}
+
 /** Fill receive descriptor with new empty buffer
  *
  * Store frame in e1000->rx_frame_phys
@@ -2401,6 +2460,19 @@ static void e1000_send_frame(nic_t *nic, void *data, size_t size)
 	    TXDESCRIPTOR_COMMAND_EOP;
 
 	tx_descriptor_addr->checksum_offset = 0;
+	tx_descriptor_addr->checksum_start_field = 0;
+
+	/* Let the controller compute the transport checksum */
+	size_t csum_start;
+	size_t csum_offset;
+	if (e1000->offload != 0 &&
+	    nic_csum_tx_prepare(e1000->tx_frame_virt[tdt], size,
+	    e1000->offload, &csum_start, &csum_offset) == EOK) {
+		tx_descriptor_addr->command |= TXDESCRIPTOR_COMMAND_IC;
+		tx_descriptor_addr->checksum_start_field = csum_start;
+		tx_descriptor_addr->checksum_offset = csum_start + csum_offset;
+	}
+
 	tx_descriptor_addr->status = 0;
 	if (e1000->vlan_tag_add) {
 		tx_descriptor_addr->special = e1000->vlan_tag;
@@ -2408,8 +2480,6 @@ static void e1000_send_frame(nic_t *nic, void *data, size_t size)
 	} else
 		tx_descriptor_addr->special = 0;
 
-	tx_descriptor_addr->checksum_start_field = 0;
-
 	tdt++;
 	if (tdt == E1000_TX_FRAME_COUNT)
 		tdt = 0;
@@ -32,11 +32,15 @@
 #include <stdint.h>
 
 #include <as.h>
+#include <byteorder.h>
 #include <ddf/driver.h>
 #include <ddf/interrupt.h>
 #include <ddf/log.h>
+#include <fibril.h>
+#include <macros.h>
 #include <ops/nic.h>
 #include <pci_dev_iface.h>
+#include <str_error.h>
 #include <nic/nic.h>
 
 #include <nic.h>
@@ -45,17 +49,28 @@
 
 #define NAME	"virtio-net"
 
-#define VIRTIO_NET_NUM_QUEUES	3
-
-#define RX_QUEUE_1	0
-#define TX_QUEUE_1	1
-#define CT_QUEUE_1	2
+/*
+ * Queue pair i uses virtqueues 2 * i (RX) and 2 * i + 1 (TX), the control
+ * virtqueue follows the last queue pair the device supports.
+ */
+#define RX_QUEUE(pair)	(2 * (pair))
+#define TX_QUEUE(pair)	(2 * (pair) + 1)
 
 #define BUFFER_SIZE	2048
 #define RX_BUF_SIZE	BUFFER_SIZE
 #define TX_BUF_SIZE	BUFFER_SIZE
 #define CT_BUF_SIZE	BUFFER_SIZE
 
+/** Control command completion polling */
+#define CT_POLL_USEC	1000
+#define CT_POLL_COUNT	1000
+
+#define ETH_HDR_SIZE	14
+#define ETYPE_IP	0x0800
+#define ETYPE_IP6	0x86dd
+#define PROTO_TCP	6
+#define PROTO_UDP	17
+
 static ddf_dev_ops_t virtio_net_dev_ops;
 
 static errno_t virtio_net_dev_add(ddf_dev_t *dev);
@@ -69,49 +84,177 @@ static driver_t virtio_net_driver = {
 	.driver_ops = &virtio_net_driver_ops
 };
 
-/** VirtIO net IRQ handler.
+/** Receive frames used by the device on one queue pair.
  *
- * @param icall IRQ event notification
- * @param arg Argument (nic_t *)
+ * All consumed RX buffers are handed back to the device in a single batch
+ * before the frames are passed on, so that the device can continue
+ * receiving while we deliver them.
+ *
+ * @param nic NIC
+ * @param pair Queue pair
  */
-static void virtio_net_irq_handler(ipc_call_t *icall, void *arg)
+static void virtio_net_rx(nic_t *nic, virtio_net_pair_t *pair)
 {
-	nic_t *nic = (nic_t *)arg;
 	virtio_net_t *virtio_net = nic_get_specific(nic);
 	virtio_dev_t *vdev = &virtio_net->virtio_dev;
+	uint16_t refill[RX_BUFFERS];
+	size_t nrefill = 0;
+	list_t frames;
+
+	list_initialize(&frames);
 
 	uint16_t descno;
 	uint32_t len;
-	while (virtio_virtq_consume_used(vdev, RX_QUEUE_1, &descno, &len)) {
-		virtio_net_hdr_t *hdr =
-		    (virtio_net_hdr_t *) virtio_net->rx_buf[descno];
+	while (nrefill < RX_BUFFERS &&
+	    virtio_virtq_consume_used(vdev, pair->rx_queue, &descno, &len)) {
+		virtio_net_hdr_t *hdr = (virtio_net_hdr_t *) pair->rx_buf[descno];
+		refill[nrefill++] = descno;
+
 		if (len <= sizeof(*hdr)) {
 			ddf_msg(LVL_WARN,
 			    "RX data length too short, packet dropped");
-			virtio_virtq_produce_available(vdev, RX_QUEUE_1,
-			    descno);
 			continue;
 		}
 
 		nic_frame_t *frame = nic_alloc_frame(nic, len - sizeof(*hdr));
 		if (frame) {
 			memcpy(frame->data, &hdr[1], len - sizeof(*hdr));
-			nic_received_frame(nic, frame);
+			list_append(&frame->link, &frames);
 		} else {
 			ddf_msg(LVL_WARN,
 			    "Cannot allocate RX frame, packet dropped");
 		}
+	}
+
+	virtio_virtq_produce_available_batch(vdev, pair->rx_queue, refill,
+	    nrefill);
 
-		virtio_virtq_produce_available(vdev, RX_QUEUE_1, descno);
+	while (!list_empty(&frames)) {
+		nic_frame_t *frame = list_get_instance(list_first(&frames),
+		    nic_frame_t, link);
+		list_remove(&frame->link);
+		nic_received_frame(nic, frame);
 	}
+}
+
+/** Return TX buffers used by the device to the free list.
+ *
+ * TX interrupts are suppressed, the buffers are reclaimed lazily.
+ *
+ * @param virtio_net VirtIO net device
+ * @param pair Queue pair
+ */
+static void virtio_net_tx_reclaim(virtio_net_t *virtio_net,
+    virtio_net_pair_t *pair)
+{
+	virtio_dev_t *vdev = &virtio_net->virtio_dev;
+	uint16_t descno;
+	uint32_t len;
 
-	while (virtio_virtq_consume_used(vdev, TX_QUEUE_1, &descno, &len)) {
-		virtio_free_desc(vdev, TX_QUEUE_1, &virtio_net->tx_free_head,
+	while (virtio_virtq_consume_used(vdev, pair->tx_queue, &descno, &len))
+		virtio_free_desc(vdev, pair->tx_queue, &pair->tx_free_head,
 		    descno);
+}
+
+/** Process all used buffers.
+ *
+ * The control virtqueue is not processed here, control commands are
+ * completed by virtio_net_ctrl_cmd().
+ *
+ * @param nic NIC
+ */
+static void virtio_net_poll(nic_t *nic)
+{
+	virtio_net_t *virtio_net = nic_get_specific(nic);
+
+	for (unsigned i = 0; i < virtio_net->pairs; i++) {
+		virtio_net_rx(nic, &virtio_net->pair[i]);
+		virtio_net_tx_reclaim(virtio_net, &virtio_net->pair[i]);
 	}
-	while (virtio_virtq_consume_used(vdev, CT_QUEUE_1, &descno, &len)) {
-		virtio_free_desc(vdev, CT_QUEUE_1, &virtio_net->ct_free_head,
-		    descno);
+}
+
+/** Suppress RX interrupts on all queue pairs.
+ *
+ * @param virtio_net VirtIO net device
+ */
+static void virtio_net_rx_intr_disable(virtio_net_t *virtio_net)
+{
+	virtio_dev_t *vdev = &virtio_net->virtio_dev;
+
+	for (unsigned i = 0; i < virtio_net->pairs; i++)
+		virtio_virtq_disable_interrupts(vdev, virtio_net->pair[i].rx_queue);
+}
+
+/** Re-enable RX interrupts on all queue pairs.
+ *
+ * @param virtio_net VirtIO net device
+ * @return True if there are used RX buffers pending on some queue pair
+ */
+static bool virtio_net_rx_intr_enable(virtio_net_t *virtio_net)
+{
+	virtio_dev_t *vdev = &virtio_net->virtio_dev;
+	bool pending = false;
+
+	for (unsigned i = 0; i < virtio_net->pairs; i++) {
+		if (virtio_virtq_enable_interrupts(vdev,
+		    virtio_net->pair[i].rx_queue))
+			pending = true;
+	}
+
+	return pending;
+}
+
+/** VirtIO net IRQ handler.
+ *
+ * The RX interrupt is suppressed while we are processing. Under load we
+ * keep polling until the ring is found empty after re-enabling it.
+ *
+ * @param icall IRQ event notification
+ * @param arg Argument (nic_t *)
+ */
+static void virtio_net_irq_handler(ipc_call_t *icall, void *arg)
+{
+	nic_t *nic = (nic_t *)arg;
+	virtio_net_t *virtio_net = nic_get_specific(nic);
+
+	if (nic_query_poll_mode(nic, NULL) != NIC_POLL_IMMEDIATE) {
+		/* RX is polled by the framework, this is a stray interrupt */
+		virtio_net_poll(nic);
+		return;
+	}
+
+	virtio_net_rx_intr_disable(virtio_net);
+	do {
+		virtio_net_poll(nic);
+	} while (virtio_net_rx_intr_enable(virtio_net));
+}
+
+/** Set polling mode.
+ *
+ * Periodic polling is left to the NIC framework.
+ *
+ * @param nic    NIC
+ * @param mode   Mode to set
+ * @param period Period for NIC_POLL_PERIODIC
+ *
+ * @return EOK if succeed
+ * @return ENOTSUP if the mode is not supported
+ */
+static errno_t virtio_net_poll_mode_change(nic_t *nic, nic_poll_mode_t mode,
+    const struct timespec *period)
+{
+	virtio_net_t *virtio_net = nic_get_specific(nic);
+
+	switch (mode) {
+	case NIC_POLL_IMMEDIATE:
+		if (virtio_net_rx_intr_enable(virtio_net))
+			virtio_net_poll(nic);
+		return EOK;
+	case NIC_POLL_ON_DEMAND:
+		virtio_net_rx_intr_disable(virtio_net);
+		return EOK;
+	default:
+		return ENOTSUP;
 	}
 }
 
@@ -172,6 +315,153 @@ static errno_t virtio_net_register_interrupt(ddf_dev_t *dev)
 	    &virtio_net->irq_handle);
 }
 
+/** Set up the virtqueues and DMA buffers of a queue pair.
+ *
+ * @param virtio_net VirtIO net device
+ * @param i Queue pair index
+ * @return EOK on success or an error code
+ */
+static errno_t virtio_net_pair_setup(virtio_net_t *virtio_net, unsigned i)
+{
+	virtio_dev_t *vdev = &virtio_net->virtio_dev;
+	virtio_net_pair_t *pair = &virtio_net->pair[i];
+	errno_t rc;
+
+	pair->rx_queue = RX_QUEUE(i);
+	pair->tx_queue = TX_QUEUE(i);
+
+	rc = virtio_virtq_setup(vdev, pair->rx_queue, RX_BUFFERS);
+	if (rc != EOK)
+		return rc;
+	rc = virtio_virtq_setup(vdev, pair->tx_queue, TX_BUFFERS);
+	if (rc != EOK)
+		return rc;
+
+	/*
+	 * Setup DMA buffers
+	 */
+	rc = virtio_setup_dma_bufs(RX_BUFFERS, RX_BUF_SIZE, false,
+	    pair->rx_buf, pair->rx_buf_p);
+	if (rc != EOK)
+		return rc;
+	rc = virtio_setup_dma_bufs(TX_BUFFERS, TX_BUF_SIZE, true,
+	    pair->tx_buf, pair->tx_buf_p);
+	if (rc != EOK)
+		return rc;
+
+	/*
+	 * Give all RX buffers to the NIC
+	 */
+	uint16_t rx_desc[RX_BUFFERS];
+	for (unsigned j = 0; j < RX_BUFFERS; j++) {
+		/*
+		 * Associtate the buffer with the descriptor, set length and
+		 * flags.
+		 */
+		virtio_virtq_desc_set(vdev, pair->rx_queue, j,
+		    pair->rx_buf_p[j], RX_BUF_SIZE, VIRTQ_DESC_F_WRITE, 0);
+		rx_desc[j] = j;
+	}
+
+	/*
+	 * Put the set descriptors into the available ring of the RX queue.
+	 */
+	virtio_virtq_produce_available_batch(vdev, pair->rx_queue, rx_desc,
+	    RX_BUFFERS);
+
+	/*
+	 * TX buffers are reclaimed when sending, we do not need to be
+	 * interrupted when the device is done with them.
+	 */
+	virtio_virtq_disable_interrupts(vdev, pair->tx_queue);
+
+	/*
+	 * Put all TX buffers on a free list
+	 */
+	virtio_create_desc_free_list(vdev, pair->tx_queue, TX_BUFFERS,
+	    &pair->tx_free_head);
+
+	return EOK;
+}
+
+static void virtio_net_pair_teardown(virtio_net_pair_t *pair)
+{
+	virtio_teardown_dma_bufs(pair->rx_buf);
+	virtio_teardown_dma_bufs(pair->tx_buf);
+}
+
+/** Execute a command on the control virtqueue.
+ *
+ * The control virtqueue does not interrupt, the command is polled for
+ * completion.
+ *
+ * @param virtio_net VirtIO net device
+ * @param class Command class
+ * @param command Command
+ * @param data Command-specific data
+ * @param size Size of @a data
+ *
+ * @return EOK on success
+ * @return EIO if the device rejected the command
+ * @return ETIMEOUT if the device did not complete the command
+ */
+static errno_t virtio_net_ctrl_cmd(virtio_net_t *virtio_net, uint8_t class,
+    uint8_t command, const void *data, size_t size)
+{
+	virtio_dev_t *vdev = &virtio_net->virtio_dev;
+	uint16_t ct = virtio_net->ct_queue;
+
+	if (sizeof(virtio_net_ctrl_hdr_t) + size > CT_BUF_SIZE)
+		return ELIMIT;
+
+	uint16_t cmd_desc = virtio_alloc_desc(vdev, ct,
+	    &virtio_net->ct_free_head);
+	if (cmd_desc == (uint16_t) -1U)
+		return EBUSY;
+	uint16_t ack_desc = virtio_alloc_desc(vdev, ct,
+	    &virtio_net->ct_free_head);
+	if (ack_desc == (uint16_t) -1U) {
+		virtio_free_desc(vdev, ct, &virtio_net->ct_free_head, cmd_desc);
+		return EBUSY;
+	}
+
+	virtio_net_ctrl_hdr_t *hdr =
+	    (virtio_net_ctrl_hdr_t *) virtio_net->ct_buf[cmd_desc];
+	hdr->class = class;
+	hdr->command = command;
+	memcpy(&hdr[1], data, size);
+
+	uint8_t *ack = (uint8_t *) virtio_net->ct_buf[ack_desc];
+	*ack = VIRTIO_NET_ERR;
+
+	virtio_virtq_desc_set(vdev, ct, cmd_desc,
+	    virtio_net->ct_buf_p[cmd_desc], sizeof(virtio_net_ctrl_hdr_t) + size,
+	    VIRTQ_DESC_F_NEXT, ack_desc);
+	virtio_virtq_desc_set(vdev, ct, ack_desc,
+	    virtio_net->ct_buf_p[ack_desc], sizeof(uint8_t),
+	    VIRTQ_DESC_F_WRITE, 0);
+	virtio_virtq_produce_available(vdev, ct, cmd_desc);
+
+	uint16_t descno;
+	uint32_t len;
+	unsigned i;
+	for (i = 0; i < CT_POLL_COUNT; i++) {
+		if (virtio_virtq_consume_used(vdev, ct, &descno, &len))
+			break;
+		fibril_usleep(CT_POLL_USEC);
+	}
+
+	/* On timeout the device still owns the buffers, do not free them */
+	if (i == CT_POLL_COUNT)
+		return ETIMEOUT;
+
+	errno_t rc = (*ack == VIRTIO_NET_OK) ? EOK : EIO;
+
+	virtio_free_desc(vdev, ct, &virtio_net->ct_free_head, ack_desc);
+	virtio_free_desc(vdev, ct, &virtio_net->ct_free_head, cmd_desc);
+	return rc;
+}
+
 static errno_t virtio_net_initialize(ddf_dev_t *dev)
 {
 	nic_t *nic = nic_create_and_bind(dev);
@@ -203,17 +493,32 @@ static errno_t virtio_net_initialize(ddf_dev_t *dev)
 
 	/* Reset the device and negotiate the feature bits */
 	rc = virtio_device_setup_start(vdev,
-	    VIRTIO_NET_F_MAC | VIRTIO_NET_F_CTRL_VQ);
+	    VIRTIO_NET_F_MAC | VIRTIO_NET_F_CTRL_VQ,
+	    VIRTIO_NET_F_CSUM | VIRTIO_NET_F_MQ | VIRTIO_F_RING_EVENT_IDX);
 	if (rc != EOK)
 		goto fail;
 
 	/* Perform device-specific setup */
 
+	/*
+	 * Determine the number of queue pairs and the control virtqueue
+	 */
+	uint16_t max_pairs = 1;
+	if ((vdev->features & VIRTIO_NET_F_MQ) != 0)
+		max_pairs = pio_read_le16(&netcfg->max_virtqueue_pairs);
+	if (max_pairs < 1) {
+		rc = EINVAL;
+		goto fail;
+	}
+
+	virtio_net->pairs = min(max_pairs, VIRTIO_NET_MAX_PAIRS);
+	virtio_net->ct_queue = 2 * max_pairs;
+
 	/*
 	 * Discover and configure the virtqueues
 	 */
 	uint16_t num_queues = pio_read_le16(&cfg->num_queues);
-	if (num_queues != VIRTIO_NET_NUM_QUEUES) {
+	if (num_queues <= virtio_net->ct_queue) {
 		ddf_msg(LVL_NOTE, "Unsupported number of virtqueues: %u",
 		    num_queues);
 		rc = ELIMIT;
@@ -226,25 +531,13 @@ static errno_t virtio_net_initialize(ddf_dev_t *dev)
 		goto fail;
 	}
 
-	rc = virtio_virtq_setup(vdev, RX_QUEUE_1, RX_BUFFERS);
-	if (rc != EOK)
-		goto fail;
-	rc = virtio_virtq_setup(vdev, TX_QUEUE_1, TX_BUFFERS);
-	if (rc != EOK)
-		goto fail;
-	rc = virtio_virtq_setup(vdev, CT_QUEUE_1, CT_BUFFERS);
-	if (rc != EOK)
-		goto fail;
+	for (unsigned i = 0; i < virtio_net->pairs; i++) {
+		rc = virtio_net_pair_setup(virtio_net, i);
+		if (rc != EOK)
+			goto fail;
+	}
 
-	/*
-	 * Setup DMA buffers
-	 */
-	rc = virtio_setup_dma_bufs(RX_BUFFERS, RX_BUF_SIZE, false,
-	    virtio_net->rx_buf, virtio_net->rx_buf_p);
-	if (rc != EOK)
-		goto fail;
-	rc = virtio_setup_dma_bufs(TX_BUFFERS, TX_BUF_SIZE, true,
-	    virtio_net->tx_buf, virtio_net->tx_buf_p);
+	rc = virtio_virtq_setup(vdev, virtio_net->ct_queue, CT_BUFFERS);
 	if (rc != EOK)
 		goto fail;
 	rc = virtio_setup_dma_bufs(CT_BUFFERS, CT_BUF_SIZE, true,
@@ -252,30 +545,9 @@ static errno_t virtio_net_initialize(ddf_dev_t *dev)
 	if (rc != EOK)
 		goto fail;
 
-	/*
-	 * Give all RX buffers to the NIC
-	 */
-	for (unsigned i = 0; i < RX_BUFFERS; i++) {
-		/*
-		 * Associtate the buffer with the descriptor, set length and
-		 * flags.
-		 */
-		virtio_virtq_desc_set(vdev, RX_QUEUE_1, i,
-		    virtio_net->rx_buf_p[i], RX_BUF_SIZE, VIRTQ_DESC_F_WRITE,
-		    0);
-		/*
-		 * Put the set descriptor into the available ring of the RX
-		 * queue.
-		 */
-		virtio_virtq_produce_available(vdev, RX_QUEUE_1, i);
-	}
-
-	/*
-	 * Put all TX and CT buffers on a free list
-	 */
-	virtio_create_desc_free_list(vdev, TX_QUEUE_1, TX_BUFFERS,
-	    &virtio_net->tx_free_head);
-	virtio_create_desc_free_list(vdev, CT_QUEUE_1, CT_BUFFERS,
+	/* Control commands are polled for completion */
+	virtio_virtq_disable_interrupts(vdev, virtio_net->ct_queue);
+	virtio_create_desc_free_list(vdev, virtio_net->ct_queue, CT_BUFFERS,
 	    &virtio_net->ct_free_head);
 
 	/*
@@ -305,11 +577,27 @@ static errno_t virtio_net_initialize(ddf_dev_t *dev)
 	/* Go live */
 	virtio_device_setup_finalize(vdev);
 
+	/*
+	 * The device only uses the first queue pair until told otherwise
+	 */
+	if (virtio_net->pairs > 1) {
+		uint16_t pairs = host2uint16_t_le(virtio_net->pairs);
+		rc = virtio_net_ctrl_cmd(virtio_net, VIRTIO_NET_CTRL_MQ,
+		    VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET, &pairs, sizeof(pairs));
+		if (rc != EOK) {
+			ddf_msg(LVL_WARN, "Failed enabling %u queue pairs: %s",
+			    virtio_net->pairs, str_error(rc));
+			virtio_net->pairs = 1;
+		}
+	}
+
+	ddf_msg(LVL_NOTE, "Using %u queue pair(s)", virtio_net->pairs);
+
 	return EOK;
 
 fail:
-	virtio_teardown_dma_bufs(virtio_net->rx_buf);
-	virtio_teardown_dma_bufs(virtio_net->tx_buf);
+	for (unsigned i = 0; i < VIRTIO_NET_MAX_PAIRS; i++)
+		virtio_net_pair_teardown(&virtio_net->pair[i]);
 	virtio_teardown_dma_bufs(virtio_net->ct_buf);
 
 	virtio_device_setup_fail(vdev);
@@ -322,14 +610,74 @@ static void virtio_net_uninitialize(ddf_dev_t *dev)
 	nic_t *nic = ddf_dev_data_get(dev);
 	virtio_net_t *virtio_net = (virtio_net_t *) nic_get_specific(nic);
 
-	virtio_teardown_dma_bufs(virtio_net->rx_buf);
-	virtio_teardown_dma_bufs(virtio_net->tx_buf);
+	for (unsigned i = 0; i < VIRTIO_NET_MAX_PAIRS; i++)
+		virtio_net_pair_teardown(&virtio_net->pair[i]);
 	virtio_teardown_dma_bufs(virtio_net->ct_buf);
 
 	virtio_device_setup_fail(&virtio_net->virtio_dev);
 	virtio_pci_dev_cleanup(&virtio_net->virtio_dev);
 }
 
+/** Compute flow hash of an outgoing frame.
+ *
+ * The hash covers the IP addresses and, for TCP and UDP, the ports.
+ * Fragments after the first carry no ports, so the ports are left out
+ * for all fragments of a datagram.
+ *
+ * @param frame Frame data
+ * @param size Frame size in bytes
+ * @return Flow hash, zero for frames other than IPv4 and IPv6
+ */
+static uint32_t virtio_net_flow_hash(const uint8_t *frame, size_t size)
+{
+	const uint8_t *addrs;
+	size_t addrs_size;
+	size_t l4_start;
+	uint8_t proto;
+	bool ports;
+
+	if (size < ETH_HDR_SIZE)
+		return 0;
+
+	const uint8_t *ip = frame + ETH_HDR_SIZE;
+	switch (((uint16_t) frame[12] << 8) | frame[13]) {
+	case ETYPE_IP:
+		if (size < ETH_HDR_SIZE + 20)
+			return 0;
+		addrs = ip + 12;
+		addrs_size = 8;
+		proto = ip[9];
+		l4_start = ETH_HDR_SIZE + (ip[0] & 0x0f) * 4;
+		/* More fragments flag or fragment offset */
+		ports = ((ip[6] & 0x3f) | ip[7]) == 0;
+		break;
+	case ETYPE_IP6:
+		if (size < ETH_HDR_SIZE + 40)
+			return 0;
+		addrs = ip + 8;
+		addrs_size = 32;
+		proto = ip[6];
+		l4_start = ETH_HDR_SIZE + 40;
+		ports = true;
+		break;
+	default:
+		return 0;
+	}
+
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+	for (size_t i = 0; i < addrs_size; i++)
+		hash = (hash ^ addrs[i]) * 16777619U;
+
+	if (ports && (proto == PROTO_TCP || proto == PROTO_UDP) &&
+	    size >= l4_start + 4) {
+		for (size_t i = 0; i < 4; i++)
+			hash = (hash ^ frame[l4_start + i]) * 16777619U;
+	}
+
+	return hash;
+}
+
 static void virtio_net_send(nic_t *nic, void *data, size_t size)
 {
 	virtio_net_t *virtio_net = nic_get_specific(nic);
@@ -340,8 +688,17 @@ static void virtio_net_send(nic_t *nic, void *data, size_t size)
 		return;
 	}
 
-	uint16_t descno = virtio_alloc_desc(vdev, TX_QUEUE_1,
-	    &virtio_net->tx_free_head);
+	/* Keep the frames of one flow in order on the same queue pair */
+	virtio_net_pair_t *pair = &virtio_net->pair[0];
+	if (virtio_net->pairs > 1) {
+		pair = &virtio_net->pair[virtio_net_flow_hash(data, size) %
+		    virtio_net->pairs];
+	}
+
+	virtio_net_tx_reclaim(virtio_net, pair);
+
+	uint16_t descno = virtio_alloc_desc(vdev, pair->tx_queue,
+	    &pair->tx_free_head);
 	if (descno == (uint16_t) -1U) {
 		ddf_msg(LVL_WARN, "No TX buffers available, frame dropped");
 		return;
@@ -349,7 +706,7 @@ static void virtio_net_send(nic_t *nic, void *data, size_t size)
 	assert(descno < TX_BUFFERS);
 
 	/* Setup the packet header */
-	virtio_net_hdr_t *hdr = (virtio_net_hdr_t *) virtio_net->tx_buf[descno];
+	virtio_net_hdr_t *hdr = (virtio_net_hdr_t *) pair->tx_buf[descno];
 	memset(hdr, 0, sizeof(virtio_net_hdr_t));
 	hdr->gso_type = VIRTIO_NET_HDR_GSO_NONE;
 	hdr->num_buffers = 0;
@@ -357,12 +714,23 @@ static void virtio_net_send(nic_t *nic, void *data, size_t size)
 	/* Copy packet data into the buffer just past the header */
 	memcpy(&hdr[1], data, size);
 
+	/* Let the device compute the transport checksum */
+	size_t csum_start;
+	size_t csum_offset;
+	if (virtio_net->offload != 0 &&
+	    nic_csum_tx_prepare(&hdr[1], size, virtio_net->offload,
+	    &csum_start, &csum_offset) == EOK) {
+		hdr->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+		hdr->csum_start = host2uint16_t_le(csum_start);
+		hdr->csum_offset = host2uint16_t_le(csum_offset);
+	}
+
 	/*
 	 * Set the descriptor, put it into the virtqueue and notify the device
 	 */
-	virtio_virtq_desc_set(vdev, TX_QUEUE_1, descno,
-	    virtio_net->tx_buf_p[descno], sizeof(virtio_net_hdr_t) + size, 0, 0);
-	virtio_virtq_produce_available(vdev, TX_QUEUE_1, descno);
+	virtio_virtq_desc_set(vdev, pair->tx_queue, descno,
+	    pair->tx_buf_p[descno], sizeof(virtio_net_hdr_t) + size, 0, 0);
+	virtio_virtq_produce_available(vdev, pair->tx_queue, descno);
 }
 
 static errno_t virtio_net_on_multicast_mode_change(nic_t *nic,
@@ -420,6 +788,8 @@ static errno_t virtio_net_dev_add(ddf_dev_t *dev)
 	nic_set_filtering_change_handlers(nic, NULL,
 	    virtio_net_on_multicast_mode_change,
 	    virtio_net_on_broadcast_mode_change, NULL, NULL);
+	nic_set_poll_handlers(nic, virtio_net_poll_mode_change,
+	    virtio_net_poll);
 
 	rc = ddf_fun_bind(fun);
 	if (rc != EOK) {
@@ -478,10 +848,50 @@ static errno_t virtio_net_get_operation_mode(ddf_fun_t *fun, int *speed,
 	return EOK;
 }
 
+static uint32_t virtio_net_offload_supported(virtio_net_t *virtio_net)
+{
+	if ((virtio_net->virtio_dev.features & VIRTIO_NET_F_CSUM) != 0)
+		return NIC_OFFLOAD_TX_TCP_CSUM | NIC_OFFLOAD_TX_UDP_CSUM;
+
+	return 0;
+}
+
+static errno_t virtio_net_offload_probe(ddf_fun_t *fun, uint32_t *supported,
+    uint32_t *active)
+{
+	nic_t *nic = nic_get_from_ddf_fun(fun);
+	if (!nic)
+		return ENOENT;
+
+	virtio_net_t *virtio_net = nic_get_specific(nic);
+
+	*supported = virtio_net_offload_supported(virtio_net);
+	*active = virtio_net->offload;
+	return EOK;
+}
+
+static errno_t virtio_net_offload_set(ddf_fun_t *fun, uint32_t mask,
+    uint32_t active)
+{
+	nic_t *nic = nic_get_from_ddf_fun(fun);
+	if (!nic)
+		return ENOENT;
+
+	virtio_net_t *virtio_net = nic_get_specific(nic);
+
+	if ((mask & active & ~virtio_net_offload_supported(virtio_net)) != 0)
+		return ENOTSUP;
+
+	virtio_net->offload = (virtio_net->offload & ~mask) | (active & mask);
+	return EOK;
+}
+
 static nic_iface_t virtio_net_nic_iface = {
 	.get_device_info = virtio_net_get_device_info,
 	.get_cable_state = virtio_net_get_cable_state,
 	.get_operation_mode = virtio_net_get_operation_mode,
+	.offload_probe = virtio_net_offload_probe,
+	.offload_set = virtio_net_offload_set,
 };
 
 int main(void)
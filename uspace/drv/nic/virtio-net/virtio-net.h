@@ -37,6 +37,9 @@
 #define TX_BUFFERS	8
 #define CT_BUFFERS	4
 
+/** Maximum number of RX/TX queue pairs used by the driver */
+#define VIRTIO_NET_MAX_PAIRS	4
+
 /** Device handles packets with partial checksum. */
 #define VIRTIO_NET_F_CSUM		(1U << 0)
 /** Driver handles packets with partial checksum. */
@@ -45,6 +48,11 @@
 #define VIRTIO_NET_F_MAC		(1U << 5)
 /** Control channel is available */
 #define VIRTIO_NET_F_CTRL_VQ		(1U << 17)
+/** Device supports multiple RX/TX queue pairs */
+#define VIRTIO_NET_F_MQ			(1U << 22)
+
+/** Checksum starting at csum_start must be inserted at csum_offset. */
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM	1
 
 #define VIRTIO_NET_HDR_GSO_NONE 0
 typedef struct {
@@ -57,22 +65,54 @@ typedef struct {
 	uint16_t num_buffers;
 } virtio_net_hdr_t;
 
+/** Control command acknowledgement */
+#define VIRTIO_NET_OK	0
+#define VIRTIO_NET_ERR	1
+
+/** Multiqueue control class and commands */
+#define VIRTIO_NET_CTRL_MQ			4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET		0
+
+typedef struct {
+	uint8_t class;
+	uint8_t command;
+} virtio_net_ctrl_hdr_t;
+
 typedef struct {
 	uint8_t mac[ETH_ADDR];
+	ioport16_t status;
+	/** Valid if VIRTIO_NET_F_MQ was negotiated */
+	ioport16_t max_virtqueue_pairs;
 } virtio_net_cfg_t;
 
+/** RX/TX queue pair */
 typedef struct {
-	virtio_dev_t virtio_dev;
+	uint16_t rx_queue;
+	uint16_t tx_queue;
+
 	void *rx_buf[RX_BUFFERS];
 	uintptr_t rx_buf_p[RX_BUFFERS];
 	void *tx_buf[TX_BUFFERS];
 	uintptr_t tx_buf_p[TX_BUFFERS];
-	void *ct_buf[CT_BUFFERS];
-	uintptr_t ct_buf_p[CT_BUFFERS];
 
 	uint16_t tx_free_head;
+} virtio_net_pair_t;
+
+typedef struct {
+	virtio_dev_t virtio_dev;
+
+	/** Queue pairs, the device uses the first @c pairs of them */
+	virtio_net_pair_t pair[VIRTIO_NET_MAX_PAIRS];
+	unsigned pairs;
+
+	uint16_t ct_queue;
+	void *ct_buf[CT_BUFFERS];
+	uintptr_t ct_buf_p[CT_BUFFERS];
 	uint16_t ct_free_head;
 
+	/** Active offload computations (NIC_OFFLOAD_*) */
+	uint32_t offload;
+
 	int irq;
 	cap_irq_handle_t irq_handle;
 } virtio_net_t;
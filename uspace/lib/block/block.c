@@ -85,6 +85,25 @@ typedef struct {
 	aoff64_t pblocks;    /**< Number of physical blocks */
 	size_t pblock_size;  /**< Physical block size. */
 	cache_t *cache;
+	/**
+	 * Buffer shared with the block device or @c NULL. It holds the data
+	 * of up to BD_QUEUE_DEPTH cached blocks.
+	 */
+	void *shbuf;
+	/** Size of a block in the shared buffer */
+	size_t shbuf_bsize;
+	/** Protects the shared buffer state */
+	fibril_mutex_t shbuf_lock;
+	/** Signalled when a request completes */
+	fibril_condvar_t shbuf_cv;
+	/** List of free blocks in the shared buffer, linked by first word */
+	void *shbuf_free;
+	/** A fibril is reaping completions */
+	bool shbuf_reaping;
+	/** Request for shared buffer block has completed */
+	bool shbuf_done[BD_QUEUE_DEPTH];
+	/** Completion status of request for shared buffer block */
+	errno_t shbuf_rc[BD_QUEUE_DEPTH];
 } devcon_t;
 
 static errno_t read_blocks(devcon_t *, aoff64_t, size_t, void *, size_t);
@@ -124,6 +143,12 @@ static errno_t devcon_add(service_id_t service_id, async_sess_t *sess,
 	devcon->pblock_size = bsize;
 	devcon->pblocks = dev_size;
 	devcon->cache = NULL;
+	devcon->shbuf = NULL;
+	devcon->shbuf_bsize = 0;
+	fibril_mutex_initialize(&devcon->shbuf_lock);
+	fibril_condvar_initialize(&devcon->shbuf_cv);
+	devcon->shbuf_free = NULL;
+	devcon->shbuf_reaping = false;
 
 	fibril_mutex_lock(&dcl_lock);
 	list_foreach(dcl, link, devcon_t, d) {
@@ -241,6 +266,94 @@ void *block_bb_get(service_id_t service_id)
 	return devcon->bb_buf;
 }
 
+/** Set up buffer shared with the block device.
+ *
+ * The buffer is split into BD_QUEUE_DEPTH blocks used as data of
+ * cached blocks. Devices that do not support a shared buffer are
+ * accessed by copying each request over IPC.
+ *
+ * @param devcon	Device connection.
+ * @param bsize		Size of a cached block.
+ */
+static void shbuf_init(devcon_t *devcon, size_t bsize)
+{
+	void *shbuf;
+	errno_t rc;
+
+	rc = bd_share_buffer(devcon->bd, BD_QUEUE_DEPTH * bsize, &shbuf);
+	if (rc != EOK)
+		return;
+
+	devcon->shbuf = shbuf;
+	devcon->shbuf_bsize = bsize;
+
+	for (size_t i = BD_QUEUE_DEPTH; i > 0; i--) {
+		void **blk = (void **) ((uint8_t *) shbuf + (i - 1) * bsize);
+		*blk = devcon->shbuf_free;
+		devcon->shbuf_free = blk;
+	}
+}
+
+/** Determine if data buffer lies in the buffer shared with the device.
+ *
+ * @param devcon	Device connection.
+ * @param data		Data buffer.
+ *
+ * @return		@c true iff @a data is a block in the shared buffer.
+ */
+static bool shbuf_contains(devcon_t *devcon, void *data)
+{
+	uint8_t *start = devcon->shbuf;
+
+	return start != NULL && (uint8_t *) data >= start &&
+	    (uint8_t *) data < start + BD_QUEUE_DEPTH * devcon->shbuf_bsize;
+}
+
+/** Allocate data buffer of a cached block.
+ *
+ * The buffer is taken from the buffer shared with the device if
+ * possible, so that I/O on the block does not copy data.
+ *
+ * @param devcon	Device connection.
+ * @param size		Size of the block.
+ *
+ * @return		Data buffer or @c NULL if out of memory.
+ */
+static void *block_data_alloc(devcon_t *devcon, size_t size)
+{
+	void **blk = NULL;
+
+	fibril_mutex_lock(&devcon->shbuf_lock);
+	if (size == devcon->shbuf_bsize && devcon->shbuf_free != NULL) {
+		blk = devcon->shbuf_free;
+		devcon->shbuf_free = *blk;
+	}
+	fibril_mutex_unlock(&devcon->shbuf_lock);
+
+	if (blk != NULL)
+		return blk;
+
+	return malloc(size);
+}
+
+/** Free data buffer of a cached block.
+ *
+ * @param devcon	Device connection.
+ * @param data		Data buffer allocated by block_data_alloc().
+ */
+static void block_data_free(devcon_t *devcon, void *data)
+{
+	if (!shbuf_contains(devcon, data)) {
+		free(data);
+		return;
+	}
+
+	fibril_mutex_lock(&devcon->shbuf_lock);
+	*(void **) data = devcon->shbuf_free;
+	devcon->shbuf_free = data;
+	fibril_mutex_unlock(&devcon->shbuf_lock);
+}
+
 static size_t cache_key_hash(const void *key)
 {
 	const aoff64_t *lba = key;
@@ -301,6 +414,9 @@ errno_t block_cache_init(service_id_t service_id, size_t size, unsigned blocks,
 		return ENOMEM;
 	}
 
+	if (devcon->shbuf == NULL)
+		shbuf_init(devcon, cache->lblock_size);
+
 	devcon->cache = cache;
 	return EOK;
 }
@@ -336,7 +452,7 @@ errno_t block_cache_fini(service_id_t service_id)
 
 		hash_table_remove_item(&cache->block_hash, &b->hash_link);
 
-		free(b->data);
+		block_data_free(devcon, b->data);
 		free(b);
 	}
 
@@ -440,7 +556,7 @@ retry:
 			b = malloc(sizeof(block_t));
 			if (!b)
 				goto recycle;
-			b->data = malloc(cache->lblock_size);
+			b->data = block_data_alloc(devcon, cache->lblock_size);
 			if (!b->data) {
 				free(b);
 				b = NULL;
@@ -657,7 +773,7 @@ retry:
 			 */
 			hash_table_remove_item(&cache->block_hash, &block->hash_link);
 			fibril_mutex_unlock(&block->lock);
-			free(block->data);
+			block_data_free(devcon, block->data);
 			free(block);
 			cache->blocks_cached--;
 			fibril_mutex_unlock(&cache->lock);
@@ -908,6 +1024,103 @@ errno_t block_read_toc(service_id_t service_id, uint8_t session, void *buf,
 	return bd_read_toc(devcon->bd, session, buf, bufsize);
 }
 
+/** Wait for completion of shared buffer request.
+ *
+ * Only one fibril reaps completions at a time, the others wait until
+ * it records the completion of their request.
+ *
+ * @param devcon	Device connection.
+ * @param tag		Tag of the request.
+ *
+ * @return		Completion status of the request.
+ */
+static errno_t shbuf_wait(devcon_t *devcon, unsigned tag)
+{
+	bd_compl_t compl[BD_QUEUE_DEPTH];
+	size_t n;
+	errno_t rc;
+
+	fibril_mutex_lock(&devcon->shbuf_lock);
+
+	while (!devcon->shbuf_done[tag]) {
+		if (devcon->shbuf_reaping) {
+			fibril_condvar_wait(&devcon->shbuf_cv,
+			    &devcon->shbuf_lock);
+			continue;
+		}
+
+		devcon->shbuf_reaping = true;
+		fibril_mutex_unlock(&devcon->shbuf_lock);
+
+		rc = bd_reap(devcon->bd, compl, BD_QUEUE_DEPTH, true, &n);
+
+		fibril_mutex_lock(&devcon->shbuf_lock);
+		devcon->shbuf_reaping = false;
+
+		if (rc != EOK) {
+			fibril_condvar_broadcast(&devcon->shbuf_cv);
+			fibril_mutex_unlock(&devcon->shbuf_lock);
+			return rc;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			assert(compl[i].tag < BD_QUEUE_DEPTH);
+			devcon->shbuf_done[compl[i].tag] = true;
+			devcon->shbuf_rc[compl[i].tag] = compl[i].rc;
+		}
+
+		fibril_condvar_broadcast(&devcon->shbuf_cv);
+	}
+
+	rc = devcon->shbuf_rc[tag];
+	fibril_mutex_unlock(&devcon->shbuf_lock);
+	return rc;
+}
+
+/** Transfer blocks in place in the buffer shared with the block device.
+ *
+ * The request is tagged with the index of the shared buffer block.
+ * The caller holds the lock of the cached block owning @a buf, so
+ * there is at most one request per tag and at most BD_QUEUE_DEPTH
+ * requests in flight.
+ *
+ * @param devcon	Device connection.
+ * @param op		Operation.
+ * @param ba		Address of first block.
+ * @param cnt		Number of blocks.
+ * @param buf		Data buffer in the shared buffer.
+ *
+ * @return		EOK on success or an error code on failure.
+ */
+static errno_t shbuf_xfer(devcon_t *devcon, bd_req_op_t op, aoff64_t ba,
+    size_t cnt, void *buf)
+{
+	bd_req_t req;
+	size_t offset;
+	unsigned tag;
+	errno_t rc;
+
+	offset = (uint8_t *) buf - (uint8_t *) devcon->shbuf;
+	tag = offset / devcon->shbuf_bsize;
+	assert(cnt * devcon->pblock_size <= devcon->shbuf_bsize);
+
+	fibril_mutex_lock(&devcon->shbuf_lock);
+	devcon->shbuf_done[tag] = false;
+	fibril_mutex_unlock(&devcon->shbuf_lock);
+
+	req.tag = tag;
+	req.op = op;
+	req.ba = ba;
+	req.cnt = cnt;
+	req.offset = offset;
+
+	rc = bd_submit(devcon->bd, &req, 1);
+	if (rc == EOK)
+		rc = shbuf_wait(devcon, tag);
+
+	return rc;
+}
+
 /** Read blocks from block device.
  *
  * @param devcon	Device connection.
@@ -922,7 +1135,13 @@ static errno_t read_blocks(devcon_t *devcon, aoff64_t ba, size_t cnt, void *buf,
 {
 	assert(devcon);
 
-	errno_t rc = bd_read_blocks(devcon->bd, ba, cnt, buf, size);
+	errno_t rc;
+
+	if (shbuf_contains(devcon, buf))
+		rc = shbuf_xfer(devcon, bdr_read, ba, cnt, buf);
+	else
+		rc = bd_read_blocks(devcon->bd, ba, cnt, buf, size);
+
 	if (rc != EOK) {
 		printf("Error %s reading %zu blocks starting at block %" PRIuOFF64
 		    " from device handle %" PRIun "\n", str_error_name(rc), cnt, ba,
@@ -949,7 +1168,13 @@ static errno_t write_blocks(devcon_t *devcon, aoff64_t ba, size_t cnt, void *dat
 {
 	assert(devcon);
 
-	errno_t rc = bd_write_blocks(devcon->bd, ba, cnt, data, size);
+	errno_t rc;
+
+	if (shbuf_contains(devcon, data))
+		rc = shbuf_xfer(devcon, bdr_write, ba, cnt, data);
+	else
+		rc = bd_write_blocks(devcon->bd, ba, cnt, data, size);
+
 	if (rc != EOK) {
 		printf("Error %s writing %zu blocks starting at block %" PRIuOFF64
 		    " to device handle %" PRIun "\n", str_error_name(rc), cnt, ba, devcon->service_id);
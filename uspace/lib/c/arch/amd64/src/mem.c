@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libcamd64
+ * @{
+ */
+/** @file
+ * @brief Large block hooks for the vectorised memory functions.
+ *
+ * Large blocks use the fast string instructions if the processor
+ * advertises Enhanced REP MOVSB/STOSB (ERMS), which is detected at run
+ * time. Everything else is handled by generic/mem_vec.c.
+ *
+ * AVX is not used since the kernel does not enable the extended register
+ * state.
+ */
+
+#include <libarch/mem.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Size from which the fast string instructions pay off. */
+#define ERMS_THRESHOLD  2048
+
+#define CPUID_EXT_FEATURES  7
+#define CPUID_ERMS  (1 << 9)
+
+/** ERMS support: -1 not yet determined, 0 absent, 1 present. */
+static int erms = -1;
+
+static inline void cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx)
+{
+	uint32_t ecx, edx;
+
+	asm volatile (
+	    "cpuid\n"
+	    : "=a" (*eax), "=b" (*ebx), "=c" (ecx), "=d" (edx)
+	    : "a" (leaf), "c" (0)
+	);
+}
+
+static int erms_detect(void)
+{
+	uint32_t eax, ebx;
+
+	cpuid(0, &eax, &ebx);
+	if (eax < CPUID_EXT_FEATURES)
+		return 0;
+
+	cpuid(CPUID_EXT_FEATURES, &eax, &ebx);
+	return (ebx & CPUID_ERMS) != 0 ? 1 : 0;
+}
+
+/** Determine whether fast string instructions should be used for @a n bytes. */
+static inline int use_erms(size_t n)
+{
+	if (n < ERMS_THRESHOLD)
+		return 0;
+
+	/* Racing threads all arrive at the same answer. */
+	if (erms < 0)
+		erms = erms_detect();
+
+	return erms;
+}
+
+/** Fill a large memory block using rep stosb if it pays off.
+ *
+ * @return @c true if the block was filled, @c false if the caller
+ *         should fill it.
+ */
+bool arch_memset_large(void *dest, int b, size_t n)
+{
+	if (!use_erms(n))
+		return false;
+
+	asm volatile (
+	    "rep stosb\n"
+	    : "+D" (dest), "+c" (n)
+	    : "a" (b)
+	    : "memory"
+	);
+
+	return true;
+}
+
+/** Copy a large memory block using rep movsb if it pays off.
+ *
+ * @return @c true if the block was copied, @c false if the caller
+ *         should copy it.
+ */
+bool arch_memcpy_large(void *dst, const void *src, size_t n)
+{
+	if (!use_erms(n))
+		return false;
+
+	asm volatile (
+	    "rep movsb\n"
+	    : "+D" (dst), "+S" (src), "+c" (n)
+	    :
+	    : "memory"
+	);
+
+	return true;
+}
+
+/** @}
+ */
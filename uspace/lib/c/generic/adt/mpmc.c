@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file Bounded lock-free MPMC queue.
+ *
+ * The queue is an array of cells, each carrying a sequence number next
+ * to the element (D. Vyukov, Bounded MPMC queue). A producer claims the
+ * cell at the enqueue position by advancing the position with CAS once the
+ * cell sequence number shows that the cell is free in the current lap,
+ * stores the element and publishes it by bumping the sequence number.
+ * Consumers do the same on the dequeue side. Producers and consumers
+ * only contend with their own kind, and neither side ever blocks.
+ */
+
+#include <adt/mpmc.h>
+#include <mem.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Assumed cache line size, used to keep the two positions apart */
+#define CACHE_LINE 64
+
+typedef struct {
+	atomic_size_t seq;
+} mpmc_cell_t;
+
+struct mpmc {
+	/** Number of cells minus one, the number of cells is a power of two */
+	size_t mask;
+	/** Size of element in bytes */
+	size_t elem_size;
+	/** Size of cell including the element, in bytes */
+	size_t cell_size;
+	/** Cell array */
+	uint8_t *cells;
+
+	uint8_t pad0[CACHE_LINE];
+	/** Enqueue position */
+	atomic_size_t head;
+	uint8_t pad1[CACHE_LINE];
+	/** Dequeue position */
+	atomic_size_t tail;
+};
+
+static inline mpmc_cell_t *mpmc_cell(mpmc_t *q, size_t pos)
+{
+	return (mpmc_cell_t *) (q->cells + (pos & q->mask) * q->cell_size);
+}
+
+static inline void *mpmc_cell_data(mpmc_cell_t *cell)
+{
+	return (void *) (cell + 1);
+}
+
+/** Create queue.
+ *
+ * @param nelems Minimum number of elements the queue can hold, it is
+ *               rounded up to a power of two
+ * @param elem_size Size of one element in bytes
+ * @return New queue or @c NULL if out of memory
+ */
+mpmc_t *mpmc_create(size_t nelems, size_t elem_size)
+{
+	mpmc_t *q;
+	size_t ncells;
+	size_t i;
+
+	ncells = 2;
+	while (ncells < nelems) {
+		if (ncells > SIZE_MAX / 2)
+			return NULL;
+		ncells *= 2;
+	}
+
+	q = calloc(1, sizeof(mpmc_t));
+	if (q == NULL)
+		return NULL;
+
+	q->mask = ncells - 1;
+	q->elem_size = elem_size;
+	q->cell_size = (sizeof(mpmc_cell_t) + elem_size +
+	    _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+
+	if (q->cell_size > SIZE_MAX / ncells) {
+		free(q);
+		return NULL;
+	}
+
+	q->cells = malloc(ncells * q->cell_size);
+	if (q->cells == NULL) {
+		free(q);
+		return NULL;
+	}
+
+	for (i = 0; i < ncells; i++)
+		atomic_init(&mpmc_cell(q, i)->seq, i);
+
+	atomic_init(&q->head, 0);
+	atomic_init(&q->tail, 0);
+	return q;
+}
+
+/** Destroy queue.
+ *
+ * There must be no concurrent users of the queue.
+ *
+ * @param q Queue or @c NULL
+ */
+void mpmc_destroy(mpmc_t *q)
+{
+	if (q == NULL)
+		return;
+
+	free(q->cells);
+	free(q);
+}
+
+/** Get queue capacity.
+ *
+ * @param q Queue
+ * @return Maximum number of elements the queue can hold
+ */
+size_t mpmc_capacity(mpmc_t *q)
+{
+	return q->mask + 1;
+}
+
+/** Insert element at the end of the queue.
+ *
+ * @param q Queue
+ * @param data Element to copy into the queue
+ * @return EOK on success, ELIMIT if the queue is full
+ */
+errno_t mpmc_push(mpmc_t *q, const void *data)
+{
+	mpmc_cell_t *cell;
+	size_t pos;
+	size_t seq;
+	intptr_t dif;
+
+	pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+	while (true) {
+		cell = mpmc_cell(q, pos);
+		seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+		dif = (intptr_t) seq - (intptr_t) pos;
+
+		if (dif == 0) {
+			/* Cell is free, try to claim it. */
+			if (atomic_compare_exchange_weak_explicit(&q->head,
+			    &pos, pos + 1, memory_order_relaxed,
+			    memory_order_relaxed))
+				break;
+		} else if (dif < 0) {
+			/* Cell still holds an element from the previous lap. */
+			return ELIMIT;
+		} else {
+			/* Another producer got here first. */
+			pos = atomic_load_explicit(&q->head,
+			    memory_order_relaxed);
+		}
+	}
+
+	memcpy(mpmc_cell_data(cell), data, q->elem_size);
+	atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+	return EOK;
+}
+
+/** Remove element from the beginning of the queue.
+ *
+ * @param q Queue
+ * @param data Place to copy the element to
+ * @return EOK on success, ENOENT if the queue is empty
+ */
+errno_t mpmc_pop(mpmc_t *q, void *data)
+{
+	mpmc_cell_t *cell;
+	size_t pos;
+	size_t seq;
+	intptr_t dif;
+
+	pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	while (true) {
+		cell = mpmc_cell(q, pos);
+		seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+		dif = (intptr_t) seq - (intptr_t) (pos + 1);
+
+		if (dif == 0) {
+			/* Cell holds an element, try to claim it. */
+			if (atomic_compare_exchange_weak_explicit(&q->tail,
+			    &pos, pos + 1, memory_order_relaxed,
+			    memory_order_relaxed))
+				break;
+		} else if (dif < 0) {
+			/* Element has not been published yet. */
+			return ENOENT;
+		} else {
+			/* Another consumer got here first. */
+			pos = atomic_load_explicit(&q->tail,
+			    memory_order_relaxed);
+		}
+	}
+
+	memcpy(data, mpmc_cell_data(cell), q->elem_size);
+	atomic_store_explicit(&cell->seq, pos + q->mask + 1,
+	    memory_order_release);
+	return EOK;
+}
+
+/** @}
+ */
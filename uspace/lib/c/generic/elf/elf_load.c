@@ -51,10 +51,11 @@
 /** Load ELF program.
  *
  * @param file File handle
+ * @param flags Flags for loading the program and its modules
  * @param info Place to store ELF program information
  * @return EOK on success or an error code
  */
-errno_t elf_load(int file, elf_info_t *info)
+errno_t elf_load(int file, eld_flags_t flags, elf_info_t *info)
 {
 #ifdef CONFIG_RTLD
 	rtld_t *env;
@@ -62,7 +63,7 @@ errno_t elf_load(int file, elf_info_t *info)
 	errno_t rc = EOK;
 	elf_finfo_t *finfo = &info->finfo;
 
-	rc = elf_load_file(file, 0, finfo);
+	rc = elf_load_file(file, flags, finfo);
 	if (rc != EOK) {
 		DPRINTF("Failed to load executable.\n");
 		return rc;
@@ -70,7 +71,7 @@ errno_t elf_load(int file, elf_info_t *info)
 
 #ifdef CONFIG_RTLD
 	DPRINTF("- prog dynamic: %p\n", finfo->dynamic);
-	rc = rtld_prog_process(finfo, &env);
+	rc = rtld_prog_process(finfo, flags, &env);
 	if (rc != EOK) {
 		DPRINTF("Failed to process executable.\n");
 		return rc;
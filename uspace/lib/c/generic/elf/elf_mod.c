@@ -37,13 +37,17 @@
  * @brief	Userspace ELF module loader.
  *
  * This module allows loading ELF binaries (both executables and
- * shared objects) from VFS. The current implementation allocates
- * anonymous memory, fills it with segment data and then adjusts
- * the memory areas' flags to the final value. In the future,
- * the segments will be mapped directly from the file.
+ * shared objects) from VFS. By default it allocates anonymous memory,
+ * fills it with segment data and then adjusts the memory areas' flags
+ * to the final value. With ELDF_PAGED, segments are instead mapped
+ * from the file through the VFS pager and faulted in on demand.
  */
 
 #include <errno.h>
+#include <fibril_synch.h>
+#include <ipc/services.h>
+#include <ipc/vfs.h>
+#include <ns.h>
 #include <stdio.h>
 #include <vfs/vfs.h>
 #include <stddef.h>
@@ -67,6 +71,11 @@ static errno_t elf_load_module(elf_ld_t *elf);
 static errno_t segment_header(elf_ld_t *elf, elf_segment_header_t *entry);
 static errno_t load_segment(elf_ld_t *elf, elf_segment_header_t *entry);
 
+/** Protects @c elf_pager_sess */
+static FIBRIL_MUTEX_INITIALIZE(elf_pager_lock);
+/** Session to the VFS pager, kept for the lifetime of the task */
+static async_sess_t *elf_pager_sess;
+
 /** Load ELF binary from a file.
  *
  * Load an ELF binary from the specified file. If the file is
@@ -98,9 +107,11 @@ errno_t elf_load_file(int file, eld_flags_t flags, elf_finfo_t *info)
 	elf.fd = ofile;
 	elf.info = info;
 	elf.flags = flags;
+	elf.pager_id = 0;
 
 	rc = elf_load_module(&elf);
 
+	/* Paged segments refer to the file through the pager handle */
 	vfs_put(ofile);
 	return rc;
 }
@@ -371,6 +382,90 @@ static errno_t segment_header(elf_ld_t *elf, elf_segment_header_t *entry)
 	return EOK;
 }
 
+/** Get session to the VFS pager.
+ *
+ * @return Session or @c NULL on failure
+ */
+static async_sess_t *elf_pager_get(void)
+{
+	fibril_mutex_lock(&elf_pager_lock);
+	if (elf_pager_sess == NULL) {
+		elf_pager_sess = service_connect_blocking(SERVICE_VFS,
+		    INTERFACE_PAGER, 0, NULL);
+	}
+	fibril_mutex_unlock(&elf_pager_lock);
+
+	return elf_pager_sess;
+}
+
+/** Map segment from the file through the VFS pager.
+ *
+ * Pages holding file data are faulted in from the file on demand.
+ * Read-only segments are shared with other tasks mapping the same
+ * file, pages of writable segments are private copies. Pages that
+ * only contain zero-initialized data are mapped as anonymous memory.
+ *
+ * @param elf	Loader state.
+ * @param entry Program header entry describing segment to be loaded.
+ * @param base	Page-aligned address of the segment (without bias)
+ * @param flags Final memory area flags
+ *
+ * @return EOK on success, error code otherwise.
+ */
+static errno_t load_segment_paged(elf_ld_t *elf, elf_segment_header_t *entry,
+    uintptr_t base, unsigned int flags)
+{
+	async_sess_t *pager;
+	uintptr_t pad;
+	size_t file_sz;
+	size_t paged_sz;
+	size_t mem_sz;
+	sysarg_t id1;
+	errno_t rc;
+	void *a;
+
+	pager = elf_pager_get();
+	if (pager == NULL)
+		return EIO;
+
+	if (elf->pager_id == 0) {
+		rc = vfs_pager_pin(elf->fd, &elf->pager_id);
+		if (rc != EOK)
+			return rc;
+	}
+
+	pad = entry->p_vaddr - base;
+	file_sz = entry->p_filesz + pad;
+	mem_sz = entry->p_memsz + pad;
+	paged_sz = min(ALIGN_UP(file_sz, PAGE_SIZE), mem_sz);
+
+	id1 = elf->pager_id;
+	if ((flags & AS_AREA_WRITE) == 0)
+		id1 |= VFS_PAGER_SHARED;
+
+	a = async_as_area_create((uint8_t *) base + elf->bias, paged_sz, flags,
+	    pager, id1, entry->p_offset - pad, file_sz);
+	if (a == AS_MAP_FAILED) {
+		DPRINTF("paged mapping failed (%p, %zu)\n",
+		    (void *) (base + elf->bias), paged_sz);
+		return ENOMEM;
+	}
+
+	if (mem_sz > paged_sz) {
+		/* Zero-initialized data past the last file-backed page */
+		a = as_area_create((uint8_t *) base + elf->bias + paged_sz,
+		    mem_sz - paged_sz, flags, AS_AREA_UNPAGED);
+		if (a == AS_MAP_FAILED) {
+			DPRINTF("memory mapping failed (%p, %zu)\n",
+			    (void *) (base + elf->bias + paged_sz),
+			    mem_sz - paged_sz);
+			return ENOMEM;
+		}
+	}
+
+	return EOK;
+}
+
 /** Load segment described by program header entry.
  *
  * @param elf	Loader state.
@@ -428,6 +523,16 @@ errno_t load_segment(elf_ld_t *elf, elf_segment_header_t *entry)
 	base = ALIGN_DOWN(entry->p_vaddr, PAGE_SIZE);
 	mem_sz = entry->p_memsz + (entry->p_vaddr - base);
 
+	/*
+	 * Segments that need to be modified after loading cannot be
+	 * mapped from the file, since the area flags of a paged area
+	 * cannot be changed.
+	 */
+	if ((elf->flags & (ELDF_PAGED | ELDF_RW)) == ELDF_PAGED &&
+	    entry->p_filesz > 0 &&
+	    entry->p_offset >= entry->p_vaddr - base)
+		return load_segment_paged(elf, entry, base, flags);
+
 	DPRINTF("Map to seg_addr=%p-%p.\n", (void *) seg_addr,
 	    (void *) (entry->p_vaddr + bias +
 	    ALIGN_UP(entry->p_memsz, PAGE_SIZE)));
@@ -176,6 +176,27 @@ errno_t ipc_wait(ipc_call_t *call, sysarg_t usec, unsigned int flags)
 	return __SYSCALL3(SYS_IPC_WAIT, (sysarg_t) call, usec, flags);
 }
 
+/** Wait for a batch of calls or answers.
+ *
+ * Waits for the first call or answer, then collects any further calls
+ * or answers that are already pending, up to @a count in total, without
+ * blocking again.
+ *
+ * @param calls     Array of buffers for the received calls.
+ * @param count     Number of buffers (at most IPC_MAX_BATCH).
+ * @param usec      Timeout for the first call.
+ * @param flags     Flags for waiting for the first call.
+ * @param rcount    Place to store number of received calls.
+ *
+ * @return EOK if at least one call was received, otherwise an error code.
+ */
+errno_t ipc_wait_batch(ipc_call_t *calls, size_t count, sysarg_t usec,
+    unsigned int flags, size_t *rcount)
+{
+	return (errno_t) __SYSCALL5(SYS_IPC_WAIT_BATCH, (sysarg_t) calls,
+	    (sysarg_t) count, usec, flags, (sysarg_t) rcount);
+}
+
 /** Hang up a phone.
  *
  * @param phandle  Handle of the phone to be hung up.
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file
+ * @brief Vectorised memset(), memcpy() and memmove().
+ *
+ * Used by architectures that set ARCH_HAS_MEMSET, ARCH_HAS_MEMCPY and
+ * ARCH_HAS_MEMMOVE. Short blocks are handled by a few overlapping unaligned
+ * loads and stores instead of byte loops. Longer blocks use a loop over
+ * 16-byte vectors with aligned stores, which the compiler maps to SSE2 on
+ * amd64 and to Advanced SIMD on arm64.
+ *
+ * Architectures can take over large blocks via the hooks in
+ * <libarch/mem.h>.
+ */
+
+#include <mem.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <libarch/mem.h>
+
+#undef memset
+#undef memcpy
+#undef memmove
+
+/*
+ * Prevent the compiler from turning the loops below into calls
+ * to the very functions they implement.
+ */
+#ifndef __clang__
+#define ATTRIBUTE_NO_TLDP \
+    __attribute__ ((optimize("-fno-tree-loop-distribute-patterns")))
+#else
+#define ATTRIBUTE_NO_TLDP
+#endif
+
+#ifdef CONFIG_LTO
+#define DO_NOT_DISCARD __attribute__ ((used))
+#else
+#define DO_NOT_DISCARD
+#endif
+
+typedef uint16_t u16_u __attribute__ ((aligned(1), may_alias));
+typedef uint32_t u32_u __attribute__ ((aligned(1), may_alias));
+typedef uint64_t u64_u __attribute__ ((aligned(1), may_alias));
+typedef uint8_t vec_t __attribute__ ((vector_size(16), may_alias));
+typedef uint8_t vec_u __attribute__ ((vector_size(16), aligned(1), may_alias));
+
+/** Fill memory block with a constant value. */
+DO_NOT_DISCARD
+ATTRIBUTE_NO_TLDP
+    void *memset(void *dest, int b, size_t n)
+{
+	uint8_t *d = dest;
+	uint64_t p;
+	vec_t v;
+
+	if (n < 16) {
+		p = (uint8_t) b * UINT64_C(0x0101010101010101);
+		if (n >= 8) {
+			*(u64_u *) d = p;
+			*(u64_u *) (d + n - 8) = p;
+		} else if (n >= 4) {
+			*(u32_u *) d = (uint32_t) p;
+			*(u32_u *) (d + n - 4) = (uint32_t) p;
+		} else if (n != 0) {
+			d[0] = b;
+			d[n / 2] = b;
+			d[n - 1] = b;
+		}
+		return dest;
+	}
+
+	v = (vec_t) { 0 } + (uint8_t) b;
+
+	if (n <= 64) {
+		*(vec_u *) d = v;
+		*(vec_u *) (d + n - 16) = v;
+		if (n > 32) {
+			*(vec_u *) (d + 16) = v;
+			*(vec_u *) (d + n - 32) = v;
+		}
+		return dest;
+	}
+
+	if (arch_memset_large(dest, b, n))
+		return dest;
+
+	/* Unaligned head, aligned body, unaligned tail. */
+	uint8_t *end = d + n;
+	*(vec_u *) d = v;
+	d = (uint8_t *) (((uintptr_t) d + 16) & ~(uintptr_t) 15);
+
+	while (end - d > 64) {
+		((vec_t *) d)[0] = v;
+		((vec_t *) d)[1] = v;
+		((vec_t *) d)[2] = v;
+		((vec_t *) d)[3] = v;
+		d += 64;
+	}
+
+	*(vec_u *) (end - 64) = v;
+	*(vec_u *) (end - 48) = v;
+	*(vec_u *) (end - 32) = v;
+	*(vec_u *) (end - 16) = v;
+
+	return dest;
+}
+
+/** Copy a block of at most 64 bytes.
+ *
+ * All data is loaded before anything is stored, so the blocks may overlap.
+ */
+static inline void copy_small(uint8_t *d, const uint8_t *s, size_t n)
+{
+	if (n >= 16) {
+		vec_t a = *(const vec_u *) s;
+		vec_t b = *(const vec_u *) (s + n - 16);
+		if (n > 32) {
+			vec_t c = *(const vec_u *) (s + 16);
+			vec_t e = *(const vec_u *) (s + n - 32);
+			*(vec_u *) (d + 16) = c;
+			*(vec_u *) (d + n - 32) = e;
+		}
+		*(vec_u *) d = a;
+		*(vec_u *) (d + n - 16) = b;
+	} else if (n >= 8) {
+		uint64_t a = *(const u64_u *) s;
+		uint64_t b = *(const u64_u *) (s + n - 8);
+		*(u64_u *) d = a;
+		*(u64_u *) (d + n - 8) = b;
+	} else if (n >= 4) {
+		uint32_t a = *(const u32_u *) s;
+		uint32_t b = *(const u32_u *) (s + n - 4);
+		*(u32_u *) d = a;
+		*(u32_u *) (d + n - 4) = b;
+	} else if (n >= 2) {
+		uint16_t a = *(const u16_u *) s;
+		uint16_t b = *(const u16_u *) (s + n - 2);
+		*(u16_u *) d = a;
+		*(u16_u *) (d + n - 2) = b;
+	} else if (n != 0) {
+		*d = *s;
+	}
+}
+
+/** Copy more than 64 bytes front to back.
+ *
+ * Safe for overlapping blocks as long as @a d is below @a s.
+ */
+static inline void copy_forward(uint8_t *d, const uint8_t *s, size_t n)
+{
+	uint8_t *end = d + n;
+	vec_t head = *(const vec_u *) s;
+	vec_t t0 = *(const vec_u *) (s + n - 64);
+	vec_t t1 = *(const vec_u *) (s + n - 48);
+	vec_t t2 = *(const vec_u *) (s + n - 32);
+	vec_t t3 = *(const vec_u *) (s + n - 16);
+	size_t skew;
+
+	/* Advance so that the destination is 16-byte aligned. */
+	skew = 16 - ((uintptr_t) d & 15);
+	uint8_t *dp = d + skew;
+	s += skew;
+
+	while (end - dp > 64) {
+		vec_t a = ((const vec_u *) s)[0];
+		vec_t b = ((const vec_u *) s)[1];
+		vec_t c = ((const vec_u *) s)[2];
+		vec_t e = ((const vec_u *) s)[3];
+		((vec_t *) dp)[0] = a;
+		((vec_t *) dp)[1] = b;
+		((vec_t *) dp)[2] = c;
+		((vec_t *) dp)[3] = e;
+		dp += 64;
+		s += 64;
+	}
+
+	*(vec_u *) (end - 64) = t0;
+	*(vec_u *) (end - 48) = t1;
+	*(vec_u *) (end - 32) = t2;
+	*(vec_u *) (end - 16) = t3;
+	*(vec_u *) d = head;
+}
+
+/** Copy more than 64 bytes back to front.
+ *
+ * Safe for overlapping blocks as long as @a d is above @a s.
+ */
+static inline void copy_backward(uint8_t *d, const uint8_t *s, size_t n)
+{
+	uint8_t *dp = d + n;
+	const uint8_t *sp = s + n;
+	vec_t tail = *(const vec_u *) (sp - 16);
+	vec_t h0 = *(const vec_u *) s;
+	vec_t h1 = *(const vec_u *) (s + 16);
+	vec_t h2 = *(const vec_u *) (s + 32);
+	vec_t h3 = *(const vec_u *) (s + 48);
+	uint8_t *end = dp;
+	size_t skew;
+
+	/* Retreat so that the destination end is 16-byte aligned. */
+	skew = ((uintptr_t) dp & 15);
+	if (skew == 0)
+		skew = 16;
+	dp -= skew;
+	sp -= skew;
+
+	while (dp - d > 64) {
+		vec_t a = ((const vec_u *) sp)[-1];
+		vec_t b = ((const vec_u *) sp)[-2];
+		vec_t c = ((const vec_u *) sp)[-3];
+		vec_t e = ((const vec_u *) sp)[-4];
+		((vec_t *) dp)[-1] = a;
+		((vec_t *) dp)[-2] = b;
+		((vec_t *) dp)[-3] = c;
+		((vec_t *) dp)[-4] = e;
+		dp -= 64;
+		sp -= 64;
+	}
+
+	*(vec_u *) d = h0;
+	*(vec_u *) (d + 16) = h1;
+	*(vec_u *) (d + 32) = h2;
+	*(vec_u *) (d + 48) = h3;
+	*(vec_u *) (end - 16) = tail;
+}
+
+/** Copy memory block. */
+DO_NOT_DISCARD
+ATTRIBUTE_NO_TLDP
+    void *memcpy(void *dst, const void *src, size_t n)
+{
+	if (n <= 64) {
+		copy_small(dst, src, n);
+		return dst;
+	}
+
+	if (arch_memcpy_large(dst, src, n))
+		return dst;
+
+	copy_forward(dst, src, n);
+	return dst;
+}
+
+/** Move memory block with possible overlapping. */
+DO_NOT_DISCARD
+ATTRIBUTE_NO_TLDP
+    void *memmove(void *dst, const void *src, size_t n)
+{
+	if (n <= 64) {
+		copy_small(dst, src, n);
+		return dst;
+	}
+
+	if ((uintptr_t) dst - (uintptr_t) src >= n) {
+		/* Disjoint, or destination below source. */
+		copy_forward(dst, src, n);
+	} else {
+		copy_backward(dst, src, n);
+	}
+
+	return dst;
+}
+
+/** @}
+ */
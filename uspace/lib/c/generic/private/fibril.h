@@ -75,6 +75,7 @@ extern fibril_t *fibril_alloc(void);
 extern void fibril_setup(fibril_t *);
 extern void fibril_teardown(fibril_t *f);
 extern fibril_t *fibril_self(void);
+extern bool fibril_is_multithreaded(void);
 
 extern void __fibrils_init(void);
 extern void __fibrils_fini(void);
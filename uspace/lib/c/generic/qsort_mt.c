@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+
+/**
+ * @file
+ * @brief Multi-fibril quicksort.
+ *
+ * The array is split into a few parts, which are sorted by qsort_r() in
+ * separate fibrils. The sorted parts are then merged pairwise, again in
+ * separate fibrils, using a temporary buffer as large as the array.
+ *
+ * The fibrils only run in parallel if the task has more than one fibril
+ * runner, see fibril_enable_multithreaded().
+ */
+
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <mem.h>
+#include <qsort.h>
+#include <qsort_mt.h>
+#include <stdlib.h>
+
+/** Arrays shorter than this are sorted by plain qsort_r() */
+#define QSORT_MT_THRESHOLD 16384
+
+/** Number of parts the array is split into (must be a power of two) */
+#define QSORT_MT_PARTS 4
+
+/** Multi-fibril quicksort spec */
+typedef struct {
+	size_t size;
+	int (*compar)(const void *, const void *, void *);
+	void *arg;
+	/** Signalled whenever a job is finished */
+	fibril_semaphore_t done;
+} qsort_mt_t;
+
+/** Sort or merge job */
+typedef struct {
+	qsort_mt_t *qs;
+	/** Source array */
+	void *src;
+	/** Destination array for merge or @c NULL to sort @c src in place */
+	void *dest;
+	/** Lower bound (inclusive) */
+	size_t lo;
+	/** Start of the second sorted run (merge only) */
+	size_t mid;
+	/** Upper bound (exclusive) */
+	size_t hi;
+} qsort_mt_job_t;
+
+/** Merge two sorted runs of a job into its destination array.
+ *
+ * @param job Merge job
+ */
+static void qsort_mt_merge(qsort_mt_job_t *job)
+{
+	size_t size = job->qs->size;
+	void *a = job->src + job->lo * size;
+	void *a_end = job->src + job->mid * size;
+	void *b = a_end;
+	void *b_end = job->src + job->hi * size;
+	void *dest = job->dest + job->lo * size;
+
+	while (a < a_end && b < b_end) {
+		if (job->qs->compar(b, a, job->qs->arg) < 0) {
+			memcpy(dest, b, size);
+			b += size;
+		} else {
+			memcpy(dest, a, size);
+			a += size;
+		}
+
+		dest += size;
+	}
+
+	memcpy(dest, a, a_end - a);
+	dest += a_end - a;
+	memcpy(dest, b, b_end - b);
+}
+
+/** Execute a sort or merge job.
+ *
+ * @param arg Job
+ * @return EOK
+ */
+static errno_t qsort_mt_job_run(void *arg)
+{
+	qsort_mt_job_t *job = (qsort_mt_job_t *) arg;
+	qsort_mt_t *qs = job->qs;
+
+	if (job->dest == NULL) {
+		qsort_r(job->src + job->lo * qs->size, job->hi - job->lo,
+		    qs->size, qs->compar, qs->arg);
+	} else {
+		qsort_mt_merge(job);
+	}
+
+	fibril_semaphore_up(&qs->done);
+	return EOK;
+}
+
+/** Execute jobs in parallel and wait for all of them to finish.
+ *
+ * The first job is executed by the calling fibril. If a fibril
+ * cannot be created, the job is executed by the calling fibril too.
+ *
+ * @param qs Multi-fibril quicksort spec
+ * @param jobs Array of jobs
+ * @param njobs Number of jobs
+ */
+static void qsort_mt_jobs_run(qsort_mt_t *qs, qsort_mt_job_t *jobs,
+    size_t njobs)
+{
+	fid_t fid;
+	size_t i;
+
+	for (i = 1; i < njobs; i++) {
+		fid = fibril_create(qsort_mt_job_run, &jobs[i]);
+		if (fid == 0) {
+			qsort_mt_job_run(&jobs[i]);
+			continue;
+		}
+
+		fibril_add_ready(fid);
+	}
+
+	qsort_mt_job_run(&jobs[0]);
+
+	for (i = 0; i < njobs; i++)
+		fibril_semaphore_down(&qs->done);
+}
+
+/** Multi-fibril quicksort.
+ *
+ * Sorts the array like qsort_r(), but uses several fibrils for large
+ * arrays. Falls back to qsort_r() for small arrays or if the temporary
+ * buffer cannot be allocated.
+ *
+ * @param base Array to sort
+ * @param nmemb Number of array members
+ * @param size Size of member in bytes
+ * @param compar Comparison function
+ * @param arg Argument to comparison function
+ */
+void qsort_mt(void *base, size_t nmemb, size_t size, int (*compar)(const void *,
+    const void *, void *), void *arg)
+{
+	qsort_mt_t qs;
+	qsort_mt_job_t jobs[QSORT_MT_PARTS];
+	size_t bound[QSORT_MT_PARTS + 1];
+	size_t njobs;
+	size_t width;
+	size_t i;
+	void *buf;
+	void *src;
+	void *dest;
+	void *tmp;
+
+	if (nmemb < QSORT_MT_THRESHOLD) {
+		qsort_r(base, nmemb, size, compar, arg);
+		return;
+	}
+
+	buf = malloc(nmemb * size);
+	if (buf == NULL) {
+		qsort_r(base, nmemb, size, compar, arg);
+		return;
+	}
+
+	qs.size = size;
+	qs.compar = compar;
+	qs.arg = arg;
+	fibril_semaphore_initialize(&qs.done, 0);
+
+	for (i = 0; i <= QSORT_MT_PARTS; i++)
+		bound[i] = nmemb * i / QSORT_MT_PARTS;
+
+	/* Sort the parts */
+	for (i = 0; i < QSORT_MT_PARTS; i++) {
+		jobs[i].qs = &qs;
+		jobs[i].src = base;
+		jobs[i].dest = NULL;
+		jobs[i].lo = bound[i];
+		jobs[i].mid = bound[i + 1];
+		jobs[i].hi = bound[i + 1];
+	}
+
+	qsort_mt_jobs_run(&qs, jobs, QSORT_MT_PARTS);
+
+	/* Merge neighbouring runs until there is only one */
+	src = base;
+	dest = buf;
+	for (width = 1; width < QSORT_MT_PARTS; width *= 2) {
+		njobs = 0;
+		for (i = 0; i < QSORT_MT_PARTS; i += 2 * width) {
+			jobs[njobs].qs = &qs;
+			jobs[njobs].src = src;
+			jobs[njobs].dest = dest;
+			jobs[njobs].lo = bound[i];
+			jobs[njobs].mid = bound[i + width];
+			jobs[njobs].hi = bound[i + 2 * width];
+			++njobs;
+		}
+
+		qsort_mt_jobs_run(&qs, jobs, njobs);
+
+		tmp = src;
+		src = dest;
+		dest = tmp;
+	}
+
+	if (src != base)
+		memcpy(base, src, nmemb * size);
+
+	free(buf);
+}
+
+/** @}
+ */
@@ -216,7 +216,8 @@ module_t *module_load(rtld_t *rtld, const char *name, mlflags_t flags)
 
 	DPRINTF("filename:'%s'\n", name_buf);
 
-	rc = elf_load_file_name(name_buf, RTLD_MODULE_LDF, &info);
+	rc = elf_load_file_name(name_buf, RTLD_MODULE_LDF | rtld->ldflags,
+	    &info);
 	if (rc != EOK) {
 		DPRINTF("Failed to load '%s'\n", name_buf);
 		goto error;
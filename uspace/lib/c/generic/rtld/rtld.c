@@ -46,9 +46,11 @@ rtld_t *runtime_env;
 /** Initialize and process an executable.
  *
  * @param p_info Program info
+ * @param ldflags Flags for loading modules
  * @return EOK on success or non-zero error code
  */
-errno_t rtld_prog_process(elf_finfo_t *p_info, rtld_t **rre)
+errno_t rtld_prog_process(elf_finfo_t *p_info, eld_flags_t ldflags,
+    rtld_t **rre)
 {
 	rtld_t *env;
 	bool is_dynamic = p_info->dynamic != NULL;
@@ -62,6 +64,7 @@ errno_t rtld_prog_process(elf_finfo_t *p_info, rtld_t **rre)
 	list_initialize(&env->modules);
 	list_initialize(&env->imodules);
 	env->next_id = 1;
+	env->ldflags = ldflags;
 
 	module_t *module;
 	errno_t rc = module_create_entrypoint(p_info, env, &module);
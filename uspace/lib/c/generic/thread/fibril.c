@@ -35,6 +35,7 @@
  */
 
 #include <adt/list.h>
+#include <adt/odict.h>
 #include <fibril.h>
 #include <stack.h>
 #include <tls.h>
@@ -47,6 +48,7 @@
 #include <str.h>
 #include <ipc/ipc.h>
 #include <libarch/faddr.h>
+#include <macros.h>
 
 #include "../private/thread.h"
 #include "../private/futex.h"
@@ -56,9 +58,9 @@
 #define DPRINTF(...) ((void)0)
 #undef READY_DEBUG
 
-/** Member of timeout_list. */
+/** Member of timeouts. */
 typedef struct {
-	link_t link;
+	odlink_t link;
 	struct timespec expires;
 	fibril_event_t *event;
 } _timeout_t;
@@ -92,7 +94,20 @@ static long ready_st_count;
 
 static LIST_INITIALIZE(ready_list);
 static LIST_INITIALIZE(fibril_list);
-static LIST_INITIALIZE(timeout_list);
+
+/*
+ * Pending timeouts ordered by expiration time. Insertion and removal
+ * are logarithmic in the number of pending timeouts.
+ */
+static odict_t timeouts;
+
+/*
+ * Timeouts expiring within this many nanoseconds after the current time
+ * are fired together with the ones that already expired, saving a wakeup
+ * for each of them. This is below the kernel timer resolution on all
+ * platforms, so it does not make timeouts noticeably less precise.
+ */
+#define TIMEOUT_SLACK_NSEC  MSEC2NSEC(1)
 
 static futex_t ipc_lists_futex;
 static LIST_INITIALIZE(ipc_waiter_list);
@@ -237,24 +252,70 @@ static fibril_t *_fibril_trigger_internal(fibril_event_t *event, fibril_t *reaso
 	return f;
 }
 
-static errno_t _ipc_wait(ipc_call_t *call, const struct timespec *expires)
+static errno_t _ipc_wait(ipc_call_t *calls, size_t count,
+    const struct timespec *expires, size_t *rcount)
+{
+	sysarg_t usec = SYNCH_NO_TIMEOUT;
+	unsigned int flags = SYNCH_FLAGS_NONE;
+
+	if (expires) {
+		struct timespec now;
+
+		if (expires->tv_sec == 0) {
+			flags = SYNCH_FLAGS_NON_BLOCKING;
+		} else {
+			getuptime(&now);
+			if (ts_gteq(&now, expires))
+				flags = SYNCH_FLAGS_NON_BLOCKING;
+			else
+				usec = NSEC2USEC(ts_sub_diff(expires, &now));
+		}
+	}
+
+	*rcount = 1;
+
+	if (count == 1)
+		return ipc_wait(calls, usec, flags);
+
+	return ipc_wait_batch(calls, count, usec, flags, rcount);
+}
+
+/*
+ * Hands a received call over to a fibril waiting for IPC, or stores it
+ * in the call buffer. The caller must hold a ready token. The token is
+ * either returned, or it stays with the buffer entry until the buffer
+ * is consumed. Returns the woken up fibril, if any.
+ */
+static fibril_t *_ipc_deliver(ipc_call_t *call, errno_t rc)
 {
-	if (!expires)
-		return ipc_wait(call, SYNCH_NO_TIMEOUT, SYNCH_FLAGS_NONE);
+	fibril_t *f = NULL;
 
-	if (expires->tv_sec == 0)
-		return ipc_wait(call, SYNCH_NO_TIMEOUT, SYNCH_FLAGS_NON_BLOCKING);
+	futex_assert_is_locked(&fibril_futex);
 
-	struct timespec now;
-	getuptime(&now);
+	_ipc_waiter_t *w = list_pop(&ipc_waiter_list, _ipc_waiter_t, link);
+	if (w) {
+		*w->call = *call;
+		w->rc = rc;
+		f = _fibril_trigger_internal(&w->event, _EVENT_TRIGGERED);
 
-	if (ts_gteq(&now, expires))
-		return ipc_wait(call, SYNCH_NO_TIMEOUT, SYNCH_FLAGS_NON_BLOCKING);
+		/* Return token. */
+		_ready_up();
+	} else {
+		_ipc_buffer_t *buf = list_pop(&ipc_buffer_free_list, _ipc_buffer_t, link);
+		assert(buf);
+		*buf = (_ipc_buffer_t) { .call = *call, .rc = rc };
+		list_append(&buf->link, &ipc_buffer_list);
+	}
 
-	return ipc_wait(call, NSEC2USEC(ts_sub_diff(expires, &now)),
-	    SYNCH_FLAGS_NONE);
+	return f;
 }
 
+/*
+ * Call buffer for batched IPC wait. Only used while single-threaded, when
+ * there is exactly one thread that can be in IPC wait.
+ */
+static ipc_call_t ipc_batch[IPC_MAX_BATCH];
+
 /*
  * Waits until a ready fibril is added to the list, or an IPC message arrives.
  * Returns NULL on timeout and may also return NULL if returning from IPC
@@ -297,9 +358,25 @@ static fibril_t *_ready_list_pop(const struct timespec *expires, bool locked)
 	if (!multithreaded)
 		assert(list_empty(&ipc_buffer_list));
 
-	/* No fibril is ready, IPC wait it is. */
+	/*
+	 * No fibril is ready, IPC wait it is.
+	 *
+	 * When single-threaded, the remaining tokens all belong to free call
+	 * buffer entries, so we can receive that many extra pending calls
+	 * with the same system call.
+	 */
 	ipc_call_t call = { 0 };
-	rc = _ipc_wait(&call, expires);
+	ipc_call_t *calls = &call;
+	size_t count = 1;
+	size_t rcount;
+
+	if (!multithreaded && ready_st_count > 0) {
+		calls = ipc_batch;
+		count = min((size_t) ready_st_count + 1, IPC_MAX_BATCH);
+		memset(calls, 0, sizeof(ipc_call_t));
+	}
+
+	rc = _ipc_wait(calls, count, expires, &rcount);
 
 	atomic_fetch_sub_explicit(&threads_in_ipc_wait, 1,
 	    memory_order_relaxed);
@@ -329,20 +406,19 @@ static fibril_t *_ready_list_pop(const struct timespec *expires, bool locked)
 
 	futex_lock(&ipc_lists_futex);
 
-	_ipc_waiter_t *w = list_pop(&ipc_waiter_list, _ipc_waiter_t, link);
-	if (w) {
-		*w->call = call;
-		w->rc = rc;
-		/* We switch to the woken up fibril immediately if possible. */
-		f = _fibril_trigger_internal(&w->event, _EVENT_TRIGGERED);
+	/* We switch to the woken up fibril immediately if possible. */
+	f = _ipc_deliver(&calls[0], rc);
 
-		/* Return token. */
-		_ready_up();
-	} else {
-		_ipc_buffer_t *buf = list_pop(&ipc_buffer_free_list, _ipc_buffer_t, link);
-		assert(buf);
-		*buf = (_ipc_buffer_t) { .call = call, .rc = rc };
-		list_append(&buf->link, &ipc_buffer_list);
+	/* Extra calls from a batch, each takes another buffer token. */
+	for (size_t i = 1; i < rcount; i++) {
+		assert(!multithreaded);
+		(void) _ready_down(NULL);
+
+		fibril_t *w = _ipc_deliver(&calls[i], EOK);
+		if (w != NULL) {
+			list_append(&w->link, &ready_list);
+			_ready_up();
+		}
 	}
 
 	futex_unlock(&ipc_lists_futex);
@@ -414,28 +490,65 @@ static errno_t _wait_ipc(ipc_call_t *call, const struct timespec *expires)
 	return rc;
 }
 
-/** Fire all timeouts that expired. */
+/** Get key of a pending timeout.
+ *
+ * @param link Link in timeouts
+ * @return Pointer to expiration time
+ */
+static void *_timeout_getkey(odlink_t *link)
+{
+	return &odict_get_instance(link, _timeout_t, link)->expires;
+}
+
+/** Compare expiration times of two timeouts.
+ *
+ * @param a First expiration time
+ * @param b Second expiration time
+ * @return <0, 0, >0 if @a a is earlier, equal or later than @a b
+ */
+static int _timeout_cmp(void *a, void *b)
+{
+	struct timespec *ta = (struct timespec *) a;
+	struct timespec *tb = (struct timespec *) b;
+
+	if (ts_gt(ta, tb))
+		return 1;
+	if (ts_gt(tb, ta))
+		return -1;
+	return 0;
+}
+
+/** Fire all timeouts that expired.
+ *
+ * Timeouts that expire within TIMEOUT_SLACK_NSEC from now are fired as
+ * well, so that several timeouts expiring at nearly the same time are
+ * handled after a single wakeup. Returns the time of the earliest
+ * remaining timeout, or NULL if there is none.
+ */
 static struct timespec *_handle_expired_timeouts(struct timespec *next_timeout)
 {
-	struct timespec ts;
-	getuptime(&ts);
+	struct timespec limit;
+	getuptime(&limit);
+	ts_add_diff(&limit, TIMEOUT_SLACK_NSEC);
 
 	futex_lock(&fibril_futex);
 
-	while (!list_empty(&timeout_list)) {
-		link_t *cur = list_first(&timeout_list);
-		_timeout_t *to = list_get_instance(cur, _timeout_t, link);
+	odlink_t *cur = odict_first(&timeouts);
+	while (cur != NULL) {
+		_timeout_t *to = odict_get_instance(cur, _timeout_t, link);
 
-		if (ts_gt(&to->expires, &ts)) {
+		if (ts_gt(&to->expires, &limit)) {
 			*next_timeout = to->expires;
 			futex_unlock(&fibril_futex);
 			return next_timeout;
 		}
 
-		list_remove(&to->link);
+		odict_remove(&to->link);
 
 		_ready_list_push(_fibril_trigger_internal(
 		    to->event, _EVENT_TIMED_OUT));
+
+		cur = odict_first(&timeouts);
 	}
 
 	futex_unlock(&fibril_futex);
@@ -600,17 +713,7 @@ static void _insert_timeout(_timeout_t *timeout)
 	futex_assert_is_locked(&fibril_futex);
 	assert(timeout);
 
-	link_t *tmp = timeout_list.head.next;
-	while (tmp != &timeout_list.head) {
-		_timeout_t *cur = list_get_instance(tmp, _timeout_t, link);
-
-		if (ts_gteq(&cur->expires, &timeout->expires))
-			break;
-
-		tmp = tmp->next;
-	}
-
-	list_insert_before(&timeout->link, tmp);
+	odict_insert(&timeout->link, &timeouts, NULL);
 }
 
 /**
@@ -678,6 +781,7 @@ errno_t fibril_wait_timeout(fibril_event_t *event,
 	}
 
 	_timeout_t timeout = { 0 };
+	odlink_initialize(&timeout.link);
 	if (expires) {
 		timeout.expires = *expires;
 		timeout.event = event;
@@ -697,7 +801,8 @@ errno_t fibril_wait_timeout(fibril_event_t *event,
 	assert(event->fibril != _EVENT_INITIAL);
 	assert(event->fibril == _EVENT_TIMED_OUT || event->fibril == _EVENT_TRIGGERED);
 
-	list_remove(&timeout.link);
+	if (odlink_used(&timeout.link))
+		odict_remove(&timeout.link);
 	errno_t rc = (event->fibril == _EVENT_TIMED_OUT) ? ETIMEOUT : EOK;
 	event->fibril = _EVENT_INITIAL;
 
@@ -816,6 +921,16 @@ int fibril_test_spawn_runners(int n)
 	return n;
 }
 
+/**
+ * Determine whether fibrils may run on more than one thread.
+ *
+ * Once a task becomes multithreaded, it stays so.
+ */
+bool fibril_is_multithreaded(void)
+{
+	return multithreaded;
+}
+
 /**
  * Opt-in to have more than one runner thread.
  *
@@ -869,6 +984,8 @@ void __fibrils_init(void)
 	if (futex_initialize(&ipc_lists_futex, 1) != EOK)
 		abort();
 
+	odict_initialize(&timeouts, _timeout_getkey, _timeout_cmp);
+
 	/*
 	 * We allow a fixed, small amount of parallelism for IPC reads, but
 	 * since IPC is currently serialized in kernel, there's not much
@@ -178,13 +178,80 @@ static void check_for_deadlock(fibril_owner_info_t *oi)
 	check_fibril_for_deadlock(oi, fibril_self());
 }
 
+/*
+ * Mutex counter values:
+ *
+ *    1  unlocked
+ *    0  locked, nobody waiting
+ *   <0  locked, the absolute value is the number of waiters
+ *
+ * Uncontended lock and unlock only touch the counter. Anything that involves
+ * the waiter list is done with fibril_synch_futex held, which also makes sure
+ * that a fibril that has decremented the counter below zero is on the list
+ * by the time the owner looks for it.
+ */
+
+/** Number of attempts to take a contended lock before parking the fibril. */
+#define SPIN_ATTEMPTS  100
+
+static inline void spin_hint(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	asm volatile ("pause");
+#elif defined(__aarch64__)
+	asm volatile ("yield");
+#else
+	atomic_signal_fence(memory_order_seq_cst);
+#endif
+}
+
+static inline bool mutex_try_acquire(fibril_mutex_t *fm)
+{
+	int expected = 1;
+
+	return __atomic_compare_exchange_n(&fm->counter, &expected, 0, false,
+	    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/** Try to take a contended mutex by spinning.
+ *
+ * The owner running on another thread may release the mutex soon.
+ * Spinning only makes sense if the owner can make progress meanwhile,
+ * so single-threaded tasks go straight to sleep.
+ */
+static bool mutex_spin_acquire(fibril_mutex_t *fm)
+{
+	if (!fibril_is_multithreaded())
+		return false;
+
+	for (int i = 0; i < SPIN_ATTEMPTS; i++) {
+		int counter = __atomic_load_n(&fm->counter, __ATOMIC_RELAXED);
+
+		/* Someone is already queued, do not jump ahead of them. */
+		if (counter < 0)
+			return false;
+
+		if (counter == 1 && mutex_try_acquire(fm))
+			return true;
+
+		spin_hint();
+	}
+
+	return false;
+}
+
 void fibril_mutex_lock(fibril_mutex_t *fm)
 {
 	fibril_t *f = (fibril_t *) fibril_get_id();
 
+	if (mutex_try_acquire(fm) || mutex_spin_acquire(fm)) {
+		fm->oi.owned_by = f;
+		return;
+	}
+
 	futex_lock(&fibril_synch_futex);
 
-	if (fm->counter-- > 0) {
+	if (__atomic_fetch_sub(&fm->counter, 1, __ATOMIC_ACQUIRE) > 0) {
 		fm->oi.owned_by = f;
 		futex_unlock(&fibril_synch_futex);
 		return;
@@ -202,41 +269,71 @@ void fibril_mutex_lock(fibril_mutex_t *fm)
 
 bool fibril_mutex_trylock(fibril_mutex_t *fm)
 {
-	bool locked = false;
-
-	futex_lock(&fibril_synch_futex);
-	if (fm->counter > 0) {
-		fm->counter--;
-		fm->oi.owned_by = (fibril_t *) fibril_get_id();
-		locked = true;
-	}
-	futex_unlock(&fibril_synch_futex);
+	if (!mutex_try_acquire(fm))
+		return false;
 
-	return locked;
+	fm->oi.owned_by = (fibril_t *) fibril_get_id();
+	return true;
 }
 
-static void _fibril_mutex_unlock_unsafe(fibril_mutex_t *fm)
+/** Release mutex if nobody is waiting for it.
+ *
+ * @return @c true if the mutex was released, @c false if there are waiters
+ *         and the mutex needs to be handed over.
+ */
+static bool _fibril_mutex_unlock_fast(fibril_mutex_t *fm)
 {
+	int expected = 0;
+
 	assert(fm->oi.owned_by == (fibril_t *) fibril_get_id());
 
-	if (fm->counter++ < 0) {
-		awaiter_t *wdp = list_pop(&fm->waiters, awaiter_t, link);
-		assert(wdp);
+	/* Must be cleared before anyone else can grab the mutex. */
+	fm->oi.owned_by = NULL;
 
-		fibril_t *f = (fibril_t *) wdp->fid;
-		fm->oi.owned_by = f;
-		f->waits_for = NULL;
+	if (__atomic_compare_exchange_n(&fm->counter, &expected, 1, false,
+	    __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		return true;
 
-		fibril_notify(&wdp->event);
-	} else {
-		fm->oi.owned_by = NULL;
-	}
+	fm->oi.owned_by = (fibril_t *) fibril_get_id();
+	return false;
+}
+
+/** Hand the mutex over to the first waiter. */
+static void _fibril_mutex_handover(fibril_mutex_t *fm)
+{
+	futex_assert_is_locked(&fibril_synch_futex);
+
+	/*
+	 * Only the owner can increment the counter of a locked mutex, so
+	 * the waiters are still there.
+	 */
+	int old = __atomic_fetch_add(&fm->counter, 1, __ATOMIC_RELEASE);
+	assert(old < 0);
+	(void) old;
+
+	awaiter_t *wdp = list_pop(&fm->waiters, awaiter_t, link);
+	assert(wdp);
+
+	fibril_t *f = (fibril_t *) wdp->fid;
+	fm->oi.owned_by = f;
+	f->waits_for = NULL;
+
+	fibril_notify(&wdp->event);
+}
+
+static void _fibril_mutex_unlock_unsafe(fibril_mutex_t *fm)
+{
+	if (!_fibril_mutex_unlock_fast(fm))
+		_fibril_mutex_handover(fm);
 }
 
 void fibril_mutex_unlock(fibril_mutex_t *fm)
 {
+	if (_fibril_mutex_unlock_fast(fm))
+		return;
+
 	futex_lock(&fibril_synch_futex);
-	_fibril_mutex_unlock_unsafe(fm);
+	_fibril_mutex_handover(fm);
 	futex_unlock(&fibril_synch_futex);
 }
 
@@ -402,6 +499,255 @@ bool fibril_rwlock_is_locked(fibril_rwlock_t *frw)
 	    fibril_rwlock_is_write_locked(frw);
 }
 
+/*
+ * Reader-biased rwlock state word: the number of readers holding the lock
+ * in the low bits plus the following flags.
+ *
+ * BRW_WAITERS is only changed with fibril_synch_futex held and is set if and
+ * only if the waiter list is not empty. Setting it forces the holders into
+ * the slow path on unlock, where the lock is handed over to the waiters.
+ */
+#define BRW_WRITER   (1 << 30)
+#define BRW_WAITERS  (1 << 29)
+#define BRW_READERS  (BRW_WAITERS - 1)
+
+void fibril_brwlock_initialize(fibril_brwlock_t *brw)
+{
+	brw->oi.owned_by = NULL;
+	brw->state = 0;
+	list_initialize(&brw->waiters);
+}
+
+static inline bool brw_cas(fibril_brwlock_t *brw, int *expected, int desired,
+    int memorder)
+{
+	return __atomic_compare_exchange_n(&brw->state, expected, desired,
+	    false, memorder, __ATOMIC_RELAXED);
+}
+
+/** Queue the current fibril on the rwlock and put it to sleep.
+ *
+ * Must be called with fibril_synch_futex held and BRW_WAITERS set.
+ * Returns once the lock has been handed over to the fibril.
+ */
+static void brw_wait(fibril_brwlock_t *brw, bool writer)
+{
+	fibril_t *f = fibril_self();
+
+	futex_assert_is_locked(&fibril_synch_futex);
+
+	f->is_writer = writer;
+
+	awaiter_t wdata = AWAITER_INIT;
+	list_append(&wdata.link, &brw->waiters);
+	check_for_deadlock(&brw->oi);
+	f->waits_for = &brw->oi;
+
+	futex_unlock(&fibril_synch_futex);
+
+	fibril_wait_for(&wdata.event);
+}
+
+/** Hand the rwlock over to the waiters.
+ *
+ * Must be called with fibril_synch_futex held and the state set to
+ * BRW_WRITER | BRW_WAITERS, which keeps everybody else out. All waiting
+ * readers are admitted at once. Only if there are none, the first waiting
+ * writer gets the lock.
+ */
+static void brw_handover(fibril_brwlock_t *brw)
+{
+	size_t readers = 0;
+	size_t waiters = 0;
+	awaiter_t *w;
+	fibril_t *f;
+	int state;
+
+	futex_assert_is_locked(&fibril_synch_futex);
+	assert(__atomic_load_n(&brw->state, __ATOMIC_RELAXED) ==
+	    (BRW_WRITER | BRW_WAITERS));
+
+	list_foreach(brw->waiters, link, awaiter_t, wdp) {
+		if (!((fibril_t *) wdp->fid)->is_writer)
+			readers++;
+		waiters++;
+	}
+
+	if (readers > 0) {
+		state = readers;
+		if (readers < waiters)
+			state |= BRW_WAITERS;
+
+		brw->oi.owned_by = NULL;
+		__atomic_store_n(&brw->state, state, __ATOMIC_RELEASE);
+
+		link_t *link = list_first(&brw->waiters);
+		while (link != NULL) {
+			w = list_get_instance(link, awaiter_t, link);
+			link = list_next(link, &brw->waiters);
+
+			f = (fibril_t *) w->fid;
+			if (f->is_writer)
+				continue;
+
+			list_remove(&w->link);
+			f->waits_for = NULL;
+			fibril_notify(&w->event);
+		}
+
+		return;
+	}
+
+	w = list_pop(&brw->waiters, awaiter_t, link);
+	assert(w != NULL);
+
+	state = BRW_WRITER;
+	if (!list_empty(&brw->waiters))
+		state |= BRW_WAITERS;
+
+	f = (fibril_t *) w->fid;
+	brw->oi.owned_by = f;
+	__atomic_store_n(&brw->state, state, __ATOMIC_RELEASE);
+
+	f->waits_for = NULL;
+	fibril_notify(&w->event);
+}
+
+void fibril_brwlock_read_lock(fibril_brwlock_t *brw)
+{
+	int state = __atomic_load_n(&brw->state, __ATOMIC_RELAXED);
+	int spins = fibril_is_multithreaded() ? SPIN_ATTEMPTS : 0;
+
+	while (true) {
+		if ((state & BRW_WRITER) == 0) {
+			if (brw_cas(brw, &state, state + 1, __ATOMIC_ACQUIRE))
+				return;
+			continue;
+		}
+
+		if (spins-- <= 0)
+			break;
+
+		spin_hint();
+		state = __atomic_load_n(&brw->state, __ATOMIC_RELAXED);
+	}
+
+	futex_lock(&fibril_synch_futex);
+
+	state = __atomic_load_n(&brw->state, __ATOMIC_RELAXED);
+	while (true) {
+		if ((state & BRW_WRITER) == 0) {
+			if (brw_cas(brw, &state, state + 1, __ATOMIC_ACQUIRE)) {
+				futex_unlock(&fibril_synch_futex);
+				return;
+			}
+		} else if (brw_cas(brw, &state, state | BRW_WAITERS,
+		    __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	brw_wait(brw, false);
+}
+
+void fibril_brwlock_write_lock(fibril_brwlock_t *brw)
+{
+	int spins = fibril_is_multithreaded() ? SPIN_ATTEMPTS : 0;
+	int state;
+
+	while (true) {
+		state = 0;
+		if (__atomic_load_n(&brw->state, __ATOMIC_RELAXED) == 0 &&
+		    brw_cas(brw, &state, BRW_WRITER, __ATOMIC_ACQUIRE)) {
+			brw->oi.owned_by = fibril_self();
+			return;
+		}
+
+		if (spins-- <= 0)
+			break;
+
+		spin_hint();
+	}
+
+	futex_lock(&fibril_synch_futex);
+
+	state = __atomic_load_n(&brw->state, __ATOMIC_RELAXED);
+	while (true) {
+		if (state == 0) {
+			if (brw_cas(brw, &state, BRW_WRITER, __ATOMIC_ACQUIRE)) {
+				brw->oi.owned_by = fibril_self();
+				futex_unlock(&fibril_synch_futex);
+				return;
+			}
+		} else if (brw_cas(brw, &state, state | BRW_WAITERS,
+		    __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	brw_wait(brw, true);
+}
+
+void fibril_brwlock_read_unlock(fibril_brwlock_t *brw)
+{
+	int state = __atomic_load_n(&brw->state, __ATOMIC_RELAXED);
+
+	/* The last reader leaving must hand the lock over to the waiters. */
+	while ((state & BRW_READERS) != 1 || (state & BRW_WAITERS) == 0) {
+		assert((state & BRW_READERS) > 0);
+		if (brw_cas(brw, &state, state - 1, __ATOMIC_RELEASE))
+			return;
+	}
+
+	futex_lock(&fibril_synch_futex);
+
+	state = __atomic_load_n(&brw->state, __ATOMIC_RELAXED);
+	while (true) {
+		assert((state & BRW_READERS) > 0);
+
+		if ((state & BRW_READERS) == 1 && (state & BRW_WAITERS) != 0) {
+			if (brw_cas(brw, &state, BRW_WRITER | BRW_WAITERS,
+			    __ATOMIC_ACQ_REL)) {
+				brw_handover(brw);
+				break;
+			}
+		} else if (brw_cas(brw, &state, state - 1, __ATOMIC_RELEASE)) {
+			break;
+		}
+	}
+
+	futex_unlock(&fibril_synch_futex);
+}
+
+void fibril_brwlock_write_unlock(fibril_brwlock_t *brw)
+{
+	int state = BRW_WRITER;
+
+	assert(brw->oi.owned_by == fibril_self());
+	brw->oi.owned_by = NULL;
+
+	if (brw_cas(brw, &state, 0, __ATOMIC_RELEASE))
+		return;
+
+	futex_lock(&fibril_synch_futex);
+	assert(__atomic_load_n(&brw->state, __ATOMIC_RELAXED) ==
+	    (BRW_WRITER | BRW_WAITERS));
+	brw_handover(brw);
+	futex_unlock(&fibril_synch_futex);
+}
+
+bool fibril_brwlock_is_read_locked(fibril_brwlock_t *brw)
+{
+	return (__atomic_load_n(&brw->state, __ATOMIC_RELAXED) &
+	    BRW_READERS) != 0;
+}
+
+bool fibril_brwlock_is_write_locked(fibril_brwlock_t *brw)
+{
+	return (__atomic_load_n(&brw->state, __ATOMIC_RELAXED) &
+	    BRW_WRITER) != 0 && brw->oi.owned_by == fibril_self();
+}
+
 void fibril_condvar_initialize(fibril_condvar_t *fcv)
 {
 	list_initialize(&fcv->waiters);
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file Read-copy-update for read-mostly data.
+ *
+ * Readers traverse shared data without taking locks, they only bracket
+ * the traversal with rcu_read_lock() and rcu_read_unlock(). Writers
+ * serialize among themselves by other means, publish new versions with
+ * rcu_assign_pointer() and reclaim the old ones only after a grace period,
+ * i.e. when all readers that might still see them have left their
+ * read-side critical sections. Reclamation can be synchronous
+ * (rcu_synchronize()) or deferred (rcu_call()).
+ *
+ * Read-side critical sections must not block, so that a grace period
+ * cannot be held up by a sleeping fibril.
+ */
+
+#include <assert.h>
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <rcu.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/** Number of deferred items that triggers a grace period in rcu_call() */
+#define RCU_BATCH  64
+
+/** Longest sleep while waiting for readers, in microseconds */
+#define RCU_MAX_BACKOFF  1000
+
+/** Initialize RCU domain.
+ *
+ * @param dom RCU domain
+ */
+void rcu_domain_initialize(rcu_domain_t *dom)
+{
+	atomic_init(&dom->epoch, 0);
+	atomic_init(&dom->readers[0], 0);
+	atomic_init(&dom->readers[1], 0);
+	fibril_mutex_initialize(&dom->sync_lock);
+	fibril_mutex_initialize(&dom->barrier_lock);
+	atomic_init(&dom->pending, NULL);
+	atomic_init(&dom->npending, 0);
+}
+
+/** Enter read-side critical section.
+ *
+ * Critical sections may nest.
+ *
+ * @param dom RCU domain
+ * @return Token to pass to rcu_read_unlock()
+ */
+unsigned rcu_read_lock(rcu_domain_t *dom)
+{
+	unsigned epoch;
+	unsigned idx;
+
+	while (true) {
+		epoch = atomic_load(&dom->epoch);
+		idx = epoch & 1;
+
+		atomic_fetch_add(&dom->readers[idx], 1);
+
+		/*
+		 * If the epoch has not changed, any grace period that started
+		 * after we loaded it will see our counter.
+		 */
+		if (atomic_load(&dom->epoch) == epoch)
+			return idx;
+
+		atomic_fetch_sub(&dom->readers[idx], 1);
+	}
+}
+
+/** Leave read-side critical section.
+ *
+ * @param dom RCU domain
+ * @param idx Token returned by the matching rcu_read_lock()
+ */
+void rcu_read_unlock(rcu_domain_t *dom, unsigned idx)
+{
+	atomic_fetch_sub_explicit(&dom->readers[idx], 1, memory_order_release);
+}
+
+/** Wait for a grace period.
+ *
+ * Returns after all read-side critical sections that were active
+ * when the function was called have finished. Must not be called
+ * from within a read-side critical section of the same domain.
+ *
+ * @param dom RCU domain
+ */
+void rcu_synchronize(rcu_domain_t *dom)
+{
+	unsigned epoch;
+	usec_t backoff = 1;
+
+	fibril_mutex_lock(&dom->sync_lock);
+
+	/*
+	 * Readers that have announced themselves under the previous epoch
+	 * are guaranteed to have drained by the previous grace period.
+	 * Move new readers to that counter and wait for the current one.
+	 */
+	epoch = atomic_load(&dom->epoch);
+	atomic_store(&dom->epoch, epoch + 1);
+
+	while (atomic_load_explicit(&dom->readers[epoch & 1],
+	    memory_order_acquire) != 0) {
+		/* Readers are short, first just let them run. */
+		if (backoff < 8) {
+			fibril_yield();
+			backoff++;
+			continue;
+		}
+
+		fibril_usleep(backoff);
+		if (backoff < RCU_MAX_BACKOFF)
+			backoff *= 2;
+	}
+
+	fibril_mutex_unlock(&dom->sync_lock);
+}
+
+/** Run deferred callbacks with the barrier lock held.
+ *
+ * @param dom RCU domain
+ */
+static void rcu_barrier_locked(rcu_domain_t *dom)
+{
+	rcu_item_t *item;
+	rcu_item_t *next;
+	size_t count = 0;
+
+	assert(fibril_mutex_is_locked(&dom->barrier_lock));
+
+	item = atomic_exchange(&dom->pending, NULL);
+	if (item == NULL)
+		return;
+
+	for (next = item; next != NULL; next = next->next)
+		count++;
+	atomic_fetch_sub(&dom->npending, count);
+
+	rcu_synchronize(dom);
+
+	while (item != NULL) {
+		next = item->next;
+		item->func(item);
+		item = next;
+	}
+}
+
+/** Run all deferred callbacks queued so far.
+ *
+ * Waits for a grace period and then invokes the callbacks of all items
+ * passed to rcu_call() before this function was called. If another
+ * barrier is in progress, waits for it to finish first, since it may
+ * have taken some of those items already. Must not be called from
+ * a callback.
+ *
+ * @param dom RCU domain
+ */
+void rcu_barrier(rcu_domain_t *dom)
+{
+	fibril_mutex_lock(&dom->barrier_lock);
+	rcu_barrier_locked(dom);
+	fibril_mutex_unlock(&dom->barrier_lock);
+}
+
+/** Defer action until the end of a grace period.
+ *
+ * Typically used to free a structure that has been unlinked from shared
+ * data, but may still be accessed by readers. Once enough items have
+ * accumulated, the caller waits for a grace period and runs the callbacks,
+ * so this function may sleep.
+ *
+ * @param dom RCU domain
+ * @param item Item embedded in the structure
+ * @param func Function to call with @a item after the grace period
+ */
+void rcu_call(rcu_domain_t *dom, rcu_item_t *item, rcu_func_t func)
+{
+	size_t npending;
+
+	/* Count the item first so that rcu_barrier() cannot underflow. */
+	npending = atomic_fetch_add(&dom->npending, 1) + 1;
+
+	item->func = func;
+	item->next = atomic_load_explicit(&dom->pending, memory_order_relaxed);
+
+	while (!atomic_compare_exchange_weak_explicit(&dom->pending,
+	    &item->next, item, memory_order_release, memory_order_relaxed))
+		;
+
+	/*
+	 * If a barrier is already in progress (possibly in our own callback),
+	 * leave the items for the next one.
+	 */
+	if (npending >= RCU_BATCH && fibril_mutex_trylock(&dom->barrier_lock)) {
+		rcu_barrier_locked(dom);
+		fibril_mutex_unlock(&dom->barrier_lock);
+	}
+}
+
+/** @}
+ */
@@ -760,6 +760,26 @@ errno_t vfs_open(int file, int mode)
 	return rc;
 }
 
+/** Pin a file for mapping through the VFS pager
+ *
+ * The pager handle keeps the file open until the task terminates, even
+ * after @a file is put. While the file is pinned, it cannot be written
+ * to or resized.
+ *
+ * @param file  File handle open for reading
+ * @param[out] id  Pager handle to use as the first pager ID
+ *
+ * @return      EOK on success or an error code
+ */
+errno_t vfs_pager_pin(int file, sysarg_t *id)
+{
+	async_exch_t *exch = vfs_exchange_begin();
+	errno_t rc = async_req_1_1(exch, VFS_IN_PAGER_PIN, file, id);
+	vfs_exchange_end(exch);
+
+	return rc;
+}
+
 /** Pass a file handle to another VFS client
  *
  * @param vfs_exch      Donor's VFS exchange
@@ -40,11 +40,14 @@
 #include <elf/elf.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <types/common.h>
 #include <loader/pcb.h>
 
 typedef enum {
 	/** Leave all segments in RW access mode. */
-	ELDF_RW = 1
+	ELDF_RW = 1,
+	/** Map segments from the file through the VFS pager. */
+	ELDF_PAGED = 2
 } eld_flags_t;
 
 /** TLS info for a module */
@@ -94,6 +97,9 @@ typedef struct {
 	/** Flags passed to the ELF loader. */
 	eld_flags_t flags;
 
+	/** VFS pager handle of @c fd or zero if no segment is mapped yet */
+	sysarg_t pager_id;
+
 	/** Store extracted info here */
 	elf_finfo_t *info;
 } elf_ld_t;
@@ -68,6 +68,18 @@
 #define FIBRIL_RWLOCK_INITIALIZE(name) \
 	fibril_rwlock_t name = FIBRIL_RWLOCK_INITIALIZER(name)
 
+#define FIBRIL_BRWLOCK_INITIALIZER(name) \
+	{ \
+		.oi = { \
+			.owned_by = NULL \
+		}, \
+		.state = 0, \
+		.waiters = LIST_INITIALIZER((name).waiters), \
+	}
+
+#define FIBRIL_BRWLOCK_INITIALIZE(name) \
+	fibril_brwlock_t name = FIBRIL_BRWLOCK_INITIALIZER(name)
+
 #define FIBRIL_CONDVAR_INITIALIZER(name) \
 	{ \
 		.waiters = LIST_INITIALIZER((name).waiters), \
@@ -102,6 +114,19 @@ typedef struct {
 	list_t waiters;
 } fibril_rwlock_t;
 
+/** Reader-biased reader-writer lock.
+ *
+ * Readers are admitted whenever no writer holds the lock, even if writers
+ * are waiting. Uncontended operations only update the state word, which
+ * makes the lock suitable for read-mostly data shared by fibrils running
+ * on several threads. Writers can starve under a steady stream of readers.
+ */
+typedef struct {
+	fibril_owner_info_t oi;  /**< Keep this the first thing. */
+	int state;
+	list_t waiters;
+} fibril_brwlock_t;
+
 typedef struct {
 	list_t waiters;
 } fibril_condvar_t;
@@ -179,6 +204,14 @@ extern bool fibril_rwlock_is_read_locked(fibril_rwlock_t *);
 extern bool fibril_rwlock_is_write_locked(fibril_rwlock_t *);
 extern bool fibril_rwlock_is_locked(fibril_rwlock_t *);
 
+extern void fibril_brwlock_initialize(fibril_brwlock_t *);
+extern void fibril_brwlock_read_lock(fibril_brwlock_t *);
+extern void fibril_brwlock_write_lock(fibril_brwlock_t *);
+extern void fibril_brwlock_read_unlock(fibril_brwlock_t *);
+extern void fibril_brwlock_write_unlock(fibril_brwlock_t *);
+extern bool fibril_brwlock_is_read_locked(fibril_brwlock_t *);
+extern bool fibril_brwlock_is_write_locked(fibril_brwlock_t *);
+
 extern void fibril_condvar_initialize(fibril_condvar_t *);
 extern errno_t fibril_condvar_wait_timeout(fibril_condvar_t *, fibril_mutex_t *,
     usec_t);
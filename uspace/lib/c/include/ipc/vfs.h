@@ -61,6 +61,8 @@ typedef struct {
 	unsigned int instance;
 	bool concurrent_read_write;
 	bool write_retains_size;
+	/** Names change without VFS knowing, do not cache lookups. */
+	bool uncached_lookup;
 } vfs_info_t;
 
 /** Data returned by filesystem probe regarding a specific volume. */
@@ -75,6 +77,7 @@ typedef enum {
 	VFS_IN_FSTYPES,
 	VFS_IN_MOUNT,
 	VFS_IN_OPEN,
+	VFS_IN_PAGER_PIN,
 	VFS_IN_PUT,
 	VFS_IN_READ,
 	VFS_IN_REGISTER,
@@ -109,6 +112,12 @@ typedef enum {
 	VFS_OUT_LAST
 } vfs_out_request_t;
 
+/**
+ * VFS pager: set in the first pager ID (pager handle) if the mapping
+ * is read-only and its pages can be shared with other tasks.
+ */
+#define VFS_PAGER_SHARED	((sysarg_t) 1 << (sizeof(sysarg_t) * 8 - 1))
+
 /*
  * Lookup flags.
  */
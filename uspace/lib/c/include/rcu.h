@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file
+ */
+
+#ifndef _LIBC_RCU_H_
+#define _LIBC_RCU_H_
+
+#include <fibril_synch.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+typedef struct rcu_item rcu_item_t;
+
+/** Callback invoked once a retired item can no longer be seen by readers */
+typedef void (*rcu_func_t)(rcu_item_t *);
+
+/** Link for deferring an action until the end of a grace period.
+ *
+ * Embed in the structure that is to be reclaimed.
+ */
+struct rcu_item {
+	rcu_item_t *next;
+	rcu_func_t func;
+};
+
+/** RCU domain.
+ *
+ * Readers of data protected by the domain announce themselves in one of two
+ * counters, selected by the parity of the current epoch. A grace period
+ * advances the epoch and waits for the counter of the previous epoch
+ * to drain.
+ */
+typedef struct {
+	/** Current epoch */
+	atomic_uint epoch;
+	/** Number of readers per epoch parity */
+	atomic_long readers[2];
+	/** Serializes grace periods */
+	fibril_mutex_t sync_lock;
+	/** Serializes processing of deferred items */
+	fibril_mutex_t barrier_lock;
+	/** Items waiting for a grace period */
+	_Atomic(rcu_item_t *) pending;
+	/** Number of items waiting for a grace period */
+	atomic_size_t npending;
+} rcu_domain_t;
+
+#define RCU_DOMAIN_INITIALIZER(name) \
+	{ \
+		.epoch = 0, \
+		.readers = { 0, 0 }, \
+		.sync_lock = FIBRIL_MUTEX_INITIALIZER((name).sync_lock), \
+		.barrier_lock = FIBRIL_MUTEX_INITIALIZER((name).barrier_lock), \
+		.pending = NULL, \
+		.npending = 0, \
+	}
+
+#define RCU_DOMAIN_INITIALIZE(name) \
+	rcu_domain_t name = RCU_DOMAIN_INITIALIZER(name)
+
+/** Read pointer published with rcu_assign_pointer().
+ *
+ * Only valid inside a read-side critical section.
+ */
+#define rcu_dereference(ptr) \
+	__atomic_load_n(&(ptr), __ATOMIC_ACQUIRE)
+
+/** Publish pointer to an initialized structure to readers. */
+#define rcu_assign_pointer(ptr, value) \
+	__atomic_store_n(&(ptr), (value), __ATOMIC_RELEASE)
+
+extern void rcu_domain_initialize(rcu_domain_t *);
+extern unsigned rcu_read_lock(rcu_domain_t *);
+extern void rcu_read_unlock(rcu_domain_t *, unsigned);
+extern void rcu_synchronize(rcu_domain_t *);
+extern void rcu_call(rcu_domain_t *, rcu_item_t *, rcu_func_t);
+extern void rcu_barrier(rcu_domain_t *);
+
+#endif
+
+/** @}
+ */
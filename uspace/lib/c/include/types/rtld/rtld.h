@@ -51,6 +51,9 @@ typedef struct rtld {
 	/** Next module ID */
 	unsigned long next_id;
 
+	/** Flags for loading modules */
+	eld_flags_t ldflags;
+
 	/** Size of initial TLS tdata + tbss */
 	size_t tls_size;
 	size_t tls_align;
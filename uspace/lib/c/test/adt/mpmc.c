@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <adt/mpmc.h>
+#include <pcut/pcut.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(mpmc);
+
+/** Capacity is rounded up to a power of two */
+PCUT_TEST(create_destroy)
+{
+	mpmc_t *q;
+
+	q = mpmc_create(100, sizeof(int));
+	PCUT_ASSERT_NOT_NULL(q);
+	PCUT_ASSERT_INT_EQUALS(128, mpmc_capacity(q));
+	mpmc_destroy(q);
+}
+
+/** Elements come out in FIFO order, full and empty are reported */
+PCUT_TEST(push_pop)
+{
+	mpmc_t *q;
+	errno_t rc;
+	int lap;
+	int i;
+	int v;
+
+	q = mpmc_create(16, sizeof(int));
+	PCUT_ASSERT_NOT_NULL(q);
+
+	rc = mpmc_pop(q, &v);
+	PCUT_ASSERT_ERRNO_VAL(ENOENT, rc);
+
+	/* Go around several times to exercise the sequence numbers. */
+	for (lap = 0; lap < 3; lap++) {
+		for (i = 0; i < 16; i++) {
+			rc = mpmc_push(q, &i);
+			PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+		}
+
+		rc = mpmc_push(q, &i);
+		PCUT_ASSERT_ERRNO_VAL(ELIMIT, rc);
+
+		for (i = 0; i < 16; i++) {
+			rc = mpmc_pop(q, &v);
+			PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+			PCUT_ASSERT_INT_EQUALS(i, v);
+		}
+
+		rc = mpmc_pop(q, &v);
+		PCUT_ASSERT_ERRNO_VAL(ENOENT, rc);
+	}
+
+	mpmc_destroy(q);
+}
+
+/** Elements of odd size are copied in full */
+PCUT_TEST(odd_size)
+{
+	mpmc_t *q;
+	char in[7] = "abcdef";
+	char out[7];
+	errno_t rc;
+
+	q = mpmc_create(4, sizeof(in));
+	PCUT_ASSERT_NOT_NULL(q);
+
+	rc = mpmc_push(q, in);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	rc = mpmc_pop(q, out);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_STR_EQUALS(in, out);
+
+	mpmc_destroy(q);
+}
+
+PCUT_EXPORT(mpmc);
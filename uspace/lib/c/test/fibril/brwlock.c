@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <pcut/pcut.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(fibril_brwlock);
+
+typedef struct {
+	fibril_brwlock_t *brw;
+	fibril_semaphore_t done;
+	bool acquired;
+} test_waiter_t;
+
+static errno_t test_reader_fn(void *arg)
+{
+	test_waiter_t *w = (test_waiter_t *) arg;
+
+	fibril_brwlock_read_lock(w->brw);
+	w->acquired = true;
+	fibril_brwlock_read_unlock(w->brw);
+	fibril_semaphore_up(&w->done);
+	return EOK;
+}
+
+static errno_t test_writer_fn(void *arg)
+{
+	test_waiter_t *w = (test_waiter_t *) arg;
+
+	fibril_brwlock_write_lock(w->brw);
+	w->acquired = true;
+	fibril_brwlock_write_unlock(w->brw);
+	fibril_semaphore_up(&w->done);
+	return EOK;
+}
+
+static void test_waiter_start(test_waiter_t *w, fibril_brwlock_t *brw,
+    errno_t (*fn)(void *))
+{
+	fid_t fid;
+
+	w->brw = brw;
+	w->acquired = false;
+	fibril_semaphore_initialize(&w->done, 0);
+
+	fid = fibril_create(fn, w);
+	PCUT_ASSERT_TRUE(fid != 0);
+	fibril_add_ready(fid);
+}
+
+/** Multiple readers can hold the lock at the same time */
+PCUT_TEST(read_shared)
+{
+	FIBRIL_BRWLOCK_INITIALIZE(brw);
+
+	fibril_brwlock_read_lock(&brw);
+	fibril_brwlock_read_lock(&brw);
+	PCUT_ASSERT_TRUE(fibril_brwlock_is_read_locked(&brw));
+	PCUT_ASSERT_FALSE(fibril_brwlock_is_write_locked(&brw));
+
+	fibril_brwlock_read_unlock(&brw);
+	PCUT_ASSERT_TRUE(fibril_brwlock_is_read_locked(&brw));
+	fibril_brwlock_read_unlock(&brw);
+	PCUT_ASSERT_FALSE(fibril_brwlock_is_read_locked(&brw));
+}
+
+/** A writer excludes readers until it unlocks */
+PCUT_TEST(write_excludes_read)
+{
+	fibril_brwlock_t brw;
+	test_waiter_t w;
+
+	fibril_brwlock_initialize(&brw);
+	fibril_brwlock_write_lock(&brw);
+	PCUT_ASSERT_TRUE(fibril_brwlock_is_write_locked(&brw));
+
+	test_waiter_start(&w, &brw, test_reader_fn);
+	fibril_usleep(1000);
+	PCUT_ASSERT_FALSE(w.acquired);
+
+	fibril_brwlock_write_unlock(&brw);
+	fibril_semaphore_down(&w.done);
+	PCUT_ASSERT_TRUE(w.acquired);
+	PCUT_ASSERT_FALSE(fibril_brwlock_is_read_locked(&brw));
+}
+
+/** Readers are admitted even if a writer is waiting */
+PCUT_TEST(read_bias)
+{
+	fibril_brwlock_t brw;
+	test_waiter_t ww;
+	test_waiter_t rw;
+
+	fibril_brwlock_initialize(&brw);
+	fibril_brwlock_read_lock(&brw);
+
+	test_waiter_start(&ww, &brw, test_writer_fn);
+	fibril_usleep(1000);
+	PCUT_ASSERT_FALSE(ww.acquired);
+
+	test_waiter_start(&rw, &brw, test_reader_fn);
+	fibril_semaphore_down(&rw.done);
+	PCUT_ASSERT_TRUE(rw.acquired);
+	PCUT_ASSERT_FALSE(ww.acquired);
+
+	fibril_brwlock_read_unlock(&brw);
+	fibril_semaphore_down(&ww.done);
+	PCUT_ASSERT_TRUE(ww.acquired);
+}
+
+/** Waiting readers are let in together when the writer leaves */
+PCUT_TEST(write_handover_to_readers)
+{
+	fibril_brwlock_t brw;
+	test_waiter_t rw[3];
+	test_waiter_t ww;
+	int i;
+
+	fibril_brwlock_initialize(&brw);
+	fibril_brwlock_write_lock(&brw);
+
+	for (i = 0; i < 3; i++)
+		test_waiter_start(&rw[i], &brw, test_reader_fn);
+	test_waiter_start(&ww, &brw, test_writer_fn);
+	fibril_usleep(1000);
+
+	fibril_brwlock_write_unlock(&brw);
+
+	for (i = 0; i < 3; i++) {
+		fibril_semaphore_down(&rw[i].done);
+		PCUT_ASSERT_TRUE(rw[i].acquired);
+	}
+
+	fibril_semaphore_down(&ww.done);
+	PCUT_ASSERT_TRUE(ww.acquired);
+	PCUT_ASSERT_FALSE(fibril_brwlock_is_read_locked(&brw));
+	PCUT_ASSERT_FALSE(fibril_brwlock_is_write_locked(&brw));
+}
+
+PCUT_EXPORT(fibril_brwlock);
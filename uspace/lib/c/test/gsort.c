@@ -40,6 +40,22 @@ static int cmp_func(void *a, void *b, void *param)
 	return ia < ib ? -1 : 1;
 }
 
+typedef struct {
+	int key;
+	int idx;
+} test_pair_t;
+
+static int cmp_pair_key(void *a, void *b, void *param)
+{
+	test_pair_t *pa = (test_pair_t *)a;
+	test_pair_t *pb = (test_pair_t *)b;
+
+	if (pa->key == pb->key)
+		return 0;
+
+	return pa->key < pb->key ? -1 : 1;
+}
+
 PCUT_INIT;
 
 PCUT_TEST_SUITE(gsort);
@@ -105,4 +121,25 @@ PCUT_TEST(gsort_desc)
 	}
 }
 
+/* long sequence, equal keys must keep their original order */
+PCUT_TEST(gsort_stable)
+{
+	int size = 1000;
+	test_pair_t data[size];
+
+	for (int i = 0; i < size; i++) {
+		data[i].key = (i * 13) % 7;
+		data[i].idx = i;
+	}
+
+	bool ret = gsort(data, size, sizeof(test_pair_t), cmp_pair_key, NULL);
+	PCUT_ASSERT_TRUE(ret);
+
+	for (int i = 1; i < size; i++) {
+		PCUT_ASSERT_TRUE(data[i - 1].key <= data[i].key);
+		if (data[i - 1].key == data[i].key)
+			PCUT_ASSERT_TRUE(data[i - 1].idx < data[i].idx);
+	}
+}
+
 PCUT_EXPORT(gsort);
@@ -27,10 +27,31 @@
  */
 
 #include <mem.h>
+#include <stdint.h>
 #include <pcut/pcut.h>
 
 PCUT_INIT;
 
+#define BLOCK_MAX 4200
+#define GUARD 32
+
+/** Block sizes around the thresholds used by optimised implementations */
+static const size_t block_sizes[] = {
+	0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65,
+	127, 128, 129, 1000, 2047, 2048, 2049, 4096
+};
+
+static uint8_t buf_a[BLOCK_MAX + 2 * GUARD];
+static uint8_t buf_b[BLOCK_MAX + 2 * GUARD];
+
+static void pattern_fill(uint8_t *p, size_t n, uint8_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		p[i] = (uint8_t) (seed + i * 7);
+}
+
 PCUT_TEST_SUITE(mem);
 
 /** memcpy function */
@@ -115,4 +136,92 @@ PCUT_TEST(memset)
 	PCUT_ASSERT_INT_EQUALS('x', buf[4]);
 }
 
+/** memcpy with various block sizes and alignments */
+PCUT_TEST(memcpy_sizes)
+{
+	size_t si, i, n;
+	unsigned so, dof;
+	void *p;
+
+	for (si = 0; si < sizeof(block_sizes) / sizeof(block_sizes[0]); si++) {
+		n = block_sizes[si];
+		for (so = 0; so < 16; so += 5) {
+			for (dof = 0; dof < 16; dof += 3) {
+				pattern_fill(buf_a, sizeof(buf_a), so);
+				pattern_fill(buf_b, sizeof(buf_b), 0x80);
+
+				p = memcpy(buf_b + GUARD + dof,
+				    buf_a + GUARD + so, n);
+				PCUT_ASSERT_TRUE(p == buf_b + GUARD + dof);
+
+				for (i = 0; i < n; i++) {
+					PCUT_ASSERT_INT_EQUALS(
+					    buf_a[GUARD + so + i],
+					    buf_b[GUARD + dof + i]);
+				}
+
+				/* Bytes around the block must be intact */
+				for (i = 0; i < GUARD + dof; i++) {
+					PCUT_ASSERT_INT_EQUALS(
+					    (uint8_t) (0x80 + i * 7), buf_b[i]);
+				}
+				for (i = GUARD + dof + n; i < sizeof(buf_b); i++) {
+					PCUT_ASSERT_INT_EQUALS(
+					    (uint8_t) (0x80 + i * 7), buf_b[i]);
+				}
+			}
+		}
+	}
+}
+
+/** memmove with overlapping blocks in both directions */
+PCUT_TEST(memmove_overlap)
+{
+	size_t si, i, n;
+	int shift;
+	void *p;
+
+	for (si = 0; si < sizeof(block_sizes) / sizeof(block_sizes[0]); si++) {
+		n = block_sizes[si];
+		for (shift = -GUARD + 1; shift < GUARD; shift += 3) {
+			pattern_fill(buf_a, sizeof(buf_a), 1);
+
+			p = memmove(buf_a + GUARD + shift, buf_a + GUARD, n);
+			PCUT_ASSERT_TRUE(p == buf_a + GUARD + shift);
+
+			for (i = 0; i < n; i++) {
+				PCUT_ASSERT_INT_EQUALS((uint8_t) (1 +
+				    (GUARD + i) * 7), buf_a[GUARD + shift + i]);
+			}
+		}
+	}
+}
+
+/** memset with various block sizes and alignments */
+PCUT_TEST(memset_sizes)
+{
+	size_t si, i, n;
+	unsigned dof;
+	void *p;
+
+	for (si = 0; si < sizeof(block_sizes) / sizeof(block_sizes[0]); si++) {
+		n = block_sizes[si];
+		for (dof = 0; dof < 16; dof++) {
+			pattern_fill(buf_b, sizeof(buf_b), 0x80);
+
+			p = memset(buf_b + GUARD + dof, 0x1a5, n);
+			PCUT_ASSERT_TRUE(p == buf_b + GUARD + dof);
+
+			for (i = 0; i < sizeof(buf_b); i++) {
+				if (i >= GUARD + dof && i < GUARD + dof + n) {
+					PCUT_ASSERT_INT_EQUALS(0xa5, buf_b[i]);
+				} else {
+					PCUT_ASSERT_INT_EQUALS(
+					    (uint8_t) (0x80 + i * 7), buf_b[i]);
+				}
+			}
+		}
+	}
+}
+
 PCUT_EXPORT(mem);
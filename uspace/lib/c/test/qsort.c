@@ -28,12 +28,19 @@
 
 #include <pcut/pcut.h>
 #include <qsort.h>
+#include <qsort_mt.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 enum {
 	/** Length of test number sequences */
-	test_seq_len = 5
+	test_seq_len = 5,
+	/** Length of long test number sequences */
+	test_long_seq_len = 1000,
+	/** Length of sequences sorted by multiple fibrils */
+	test_mt_seq_len = 20000
 };
 
 /** Test compare function.
@@ -66,6 +73,29 @@ static void bubble_sort(int *seq, size_t nmemb)
 		}
 }
 
+/** Test compare function with extra argument.
+ *
+ * @param a First key
+ * @param b Second key
+ * @param arg Argument (unused)
+ * @return <0, 0, >0 if @a a is less than, equal or greater than @a b
+ */
+static int test_cmp_r(const void *a, const void *b, void *arg)
+{
+	int *ia = (int *)a;
+	int *ib = (int *)b;
+
+	(void)arg;
+	return *ia - *ib;
+}
+
+/** Test compare function for three-byte keys. */
+static int test_cmp3(const void *a, const void *b, void *arg)
+{
+	(void)arg;
+	return memcmp(a, b, 3);
+}
+
 PCUT_INIT;
 
 PCUT_TEST_SUITE(qsort);
@@ -171,4 +201,112 @@ PCUT_TEST(pseudorandom_seq)
 	free(seq2);
 }
 
+/** Test sorting long pseudorandom sequence. */
+PCUT_TEST(long_pseudorandom_seq)
+{
+	int *seq;
+	int i;
+	int v;
+
+	seq = calloc(test_long_seq_len, sizeof(int));
+	PCUT_ASSERT_NOT_NULL(seq);
+
+	v = 1;
+	for (i = 0; i < test_long_seq_len; i++) {
+		seq[i] = v;
+		v = seq_next(v);
+	}
+
+	qsort(seq, test_long_seq_len, sizeof(int), test_cmp);
+
+	for (i = 1; i < test_long_seq_len; i++) {
+		PCUT_ASSERT_TRUE(seq[i - 1] <= seq[i]);
+	}
+
+	free(seq);
+}
+
+/** Test sorting long sequence with only a few distinct values. */
+PCUT_TEST(long_few_values_seq)
+{
+	int *seq;
+	int i;
+
+	seq = calloc(test_long_seq_len, sizeof(int));
+	PCUT_ASSERT_NOT_NULL(seq);
+
+	for (i = 0; i < test_long_seq_len; i++)
+		seq[i] = (i * 7) % 3;
+
+	qsort_r(seq, test_long_seq_len, sizeof(int), test_cmp_r,
+	    NULL);
+
+	for (i = 0; i < test_long_seq_len; i++) {
+		PCUT_ASSERT_INT_EQUALS(i * 3 / test_long_seq_len, seq[i]);
+	}
+
+	free(seq);
+}
+
+/** Test sorting members whose size is not a multiple of a word. */
+PCUT_TEST(odd_size_members)
+{
+	uint8_t *seq;
+	int i;
+	int v;
+
+	seq = calloc(test_long_seq_len, 3);
+	PCUT_ASSERT_NOT_NULL(seq);
+
+	v = 1;
+	for (i = 0; i < test_long_seq_len; i++) {
+		seq[3 * i] = v % 7;
+		seq[3 * i + 1] = v % 256;
+		seq[3 * i + 2] = i % 256;
+		v = seq_next(v);
+	}
+
+	qsort_r(seq, test_long_seq_len, 3, test_cmp3, NULL);
+
+	for (i = 1; i < test_long_seq_len; i++) {
+		PCUT_ASSERT_TRUE(memcmp(&seq[3 * (i - 1)], &seq[3 * i], 3) <= 0);
+	}
+
+	free(seq);
+}
+
+/** Test sorting long pseudorandom sequence using multiple fibrils. */
+PCUT_TEST(mt_pseudorandom_seq)
+{
+	int *seq;
+	int i;
+	int v;
+	long long sum1;
+	long long sum2;
+
+	seq = calloc(test_mt_seq_len, sizeof(int));
+	PCUT_ASSERT_NOT_NULL(seq);
+
+	sum1 = 0;
+	v = 1;
+	for (i = 0; i < test_mt_seq_len; i++) {
+		seq[i] = v;
+		sum1 += v;
+		v = seq_next(v);
+	}
+
+	qsort_mt(seq, test_mt_seq_len, sizeof(int), test_cmp_r,
+	    NULL);
+
+	sum2 = seq[0];
+	for (i = 1; i < test_mt_seq_len; i++) {
+		PCUT_ASSERT_TRUE(seq[i - 1] <= seq[i]);
+		sum2 += seq[i];
+	}
+
+	PCUT_ASSERT_TRUE(sum1 == sum2);
+
+	free(seq);
+}
+
 PCUT_EXPORT(qsort);
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fibril.h>
+#include <pcut/pcut.h>
+#include <rcu.h>
+#include <stdlib.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(rcu);
+
+typedef struct {
+	rcu_item_t item;
+	int value;
+} test_obj_t;
+
+static int freed;
+
+static void test_obj_free(rcu_item_t *item)
+{
+	test_obj_t *obj = (test_obj_t *) item;
+
+	free(obj);
+	freed++;
+}
+
+typedef struct {
+	rcu_domain_t *dom;
+	fibril_semaphore_t done;
+	bool finished;
+} test_sync_t;
+
+static errno_t test_sync_fn(void *arg)
+{
+	test_sync_t *sync = (test_sync_t *) arg;
+
+	rcu_synchronize(sync->dom);
+	sync->finished = true;
+	fibril_semaphore_up(&sync->done);
+	return EOK;
+}
+
+static errno_t test_barrier_fn(void *arg)
+{
+	test_sync_t *sync = (test_sync_t *) arg;
+
+	rcu_barrier(sync->dom);
+	sync->finished = true;
+	fibril_semaphore_up(&sync->done);
+	return EOK;
+}
+
+/** Reader sees published pointer */
+PCUT_TEST(read_publish)
+{
+	RCU_DOMAIN_INITIALIZE(dom);
+	test_obj_t *shared = NULL;
+	test_obj_t *obj;
+	unsigned idx;
+
+	obj = calloc(1, sizeof(test_obj_t));
+	PCUT_ASSERT_NOT_NULL(obj);
+	obj->value = 42;
+	rcu_assign_pointer(shared, obj);
+
+	idx = rcu_read_lock(&dom);
+	PCUT_ASSERT_INT_EQUALS(42, rcu_dereference(shared)->value);
+	rcu_read_unlock(&dom, idx);
+
+	rcu_assign_pointer(shared, NULL);
+	rcu_synchronize(&dom);
+	free(obj);
+}
+
+/** Grace period waits for a reader that started before it */
+PCUT_TEST(synchronize_waits)
+{
+	rcu_domain_t dom;
+	test_sync_t sync;
+	unsigned idx;
+	fid_t fid;
+
+	rcu_domain_initialize(&dom);
+	sync.dom = &dom;
+	sync.finished = false;
+	fibril_semaphore_initialize(&sync.done, 0);
+
+	idx = rcu_read_lock(&dom);
+
+	fid = fibril_create(test_sync_fn, &sync);
+	PCUT_ASSERT_TRUE(fid != 0);
+	fibril_add_ready(fid);
+
+	fibril_usleep(10000);
+	PCUT_ASSERT_FALSE(sync.finished);
+
+	rcu_read_unlock(&dom, idx);
+	fibril_semaphore_down(&sync.done);
+	PCUT_ASSERT_TRUE(sync.finished);
+}
+
+/** Deferred callbacks run after rcu_barrier() */
+PCUT_TEST(call_barrier)
+{
+	rcu_domain_t dom;
+	test_obj_t *obj;
+	int i;
+
+	rcu_domain_initialize(&dom);
+	freed = 0;
+
+	for (i = 0; i < 10; i++) {
+		obj = calloc(1, sizeof(test_obj_t));
+		PCUT_ASSERT_NOT_NULL(obj);
+		rcu_call(&dom, &obj->item, test_obj_free);
+	}
+
+	PCUT_ASSERT_INT_EQUALS(0, freed);
+	rcu_barrier(&dom);
+	PCUT_ASSERT_INT_EQUALS(10, freed);
+}
+
+/** Concurrent rcu_barrier() waits for callbacks taken by another one */
+PCUT_TEST(barrier_concurrent)
+{
+	rcu_domain_t dom;
+	test_sync_t sync1;
+	test_sync_t sync2;
+	test_obj_t *obj;
+	unsigned idx;
+	fid_t fid;
+	int i;
+
+	rcu_domain_initialize(&dom);
+	freed = 0;
+
+	for (i = 0; i < 10; i++) {
+		obj = calloc(1, sizeof(test_obj_t));
+		PCUT_ASSERT_NOT_NULL(obj);
+		rcu_call(&dom, &obj->item, test_obj_free);
+	}
+
+	/* Hold up the grace period of the first barrier. */
+	idx = rcu_read_lock(&dom);
+
+	sync1.dom = &dom;
+	sync1.finished = false;
+	fibril_semaphore_initialize(&sync1.done, 0);
+	fid = fibril_create(test_barrier_fn, &sync1);
+	PCUT_ASSERT_TRUE(fid != 0);
+	fibril_add_ready(fid);
+
+	fibril_usleep(10000);
+
+	sync2.dom = &dom;
+	sync2.finished = false;
+	fibril_semaphore_initialize(&sync2.done, 0);
+	fid = fibril_create(test_barrier_fn, &sync2);
+	PCUT_ASSERT_TRUE(fid != 0);
+	fibril_add_ready(fid);
+
+	fibril_usleep(10000);
+	PCUT_ASSERT_FALSE(sync2.finished);
+	PCUT_ASSERT_INT_EQUALS(0, freed);
+
+	rcu_read_unlock(&dom, idx);
+	fibril_semaphore_down(&sync2.done);
+	PCUT_ASSERT_INT_EQUALS(10, freed);
+	fibril_semaphore_down(&sync1.done);
+}
+
+PCUT_EXPORT(rcu);
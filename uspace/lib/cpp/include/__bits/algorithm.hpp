@@ -30,6 +30,7 @@
 #define LIBCPP_BITS_ALGORITHM
 
 #include <iterator>
+#include <new>
 #include <utility>
 
 namespace std
@@ -653,7 +654,45 @@ namespace std
      * 25.3.11, rotate:
      */
 
-    // TODO: implement
+    template<class ForwardIterator>
+    ForwardIterator rotate(ForwardIterator first, ForwardIterator middle,
+                           ForwardIterator last)
+    {
+        if (first == middle)
+            return last;
+        if (middle == last)
+            return first;
+
+        /**
+         * Note: Each pass swaps [first, middle) into place
+         *       and leaves the rest of the range as a smaller
+         *       rotation, which is handled by the next pass.
+         */
+        ForwardIterator res{};
+        bool first_pass{true};
+        while (true)
+        {
+            auto next = first;
+            for (auto it = middle; it != last; ++first, ++it)
+            {
+                if (first == next)
+                    next = it;
+                iter_swap(first, it);
+            }
+
+            if (first_pass)
+            {
+                res = first;
+                first_pass = false;
+            }
+
+            if (first == next || next == last)
+                break;
+            middle = next;
+        }
+
+        return res;
+    }
 
     /**
      * 25.3.12, shuffle:
@@ -695,28 +734,325 @@ namespace std
         sort(first, last, less<value_type>{});
     }
 
+    namespace aux
+    {
+        /**
+         * Partitions shorter than this are left for the
+         * final insertion sort pass of introsort.
+         */
+        constexpr ptrdiff_t introsort_threshold{16};
+
+        template<class RandomAccessIterator, class Compare>
+        void insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare comp)
+        {
+            if (first == last)
+                return;
+
+            for (auto it = first + 1; it != last; ++it)
+            {
+                auto tmp = move(*it);
+                auto hole = it;
+
+                while (hole != first && comp(tmp, *(hole - 1)))
+                {
+                    *hole = move(*(hole - 1));
+                    --hole;
+                }
+
+                *hole = move(tmp);
+            }
+        }
+
+        template<class RandomAccessIterator, class Compare>
+        void move_median_to_first(RandomAccessIterator res, RandomAccessIterator a,
+                                  RandomAccessIterator b, RandomAccessIterator c,
+                                  Compare comp)
+        {
+            if (comp(*a, *b))
+            {
+                if (comp(*b, *c))
+                    iter_swap(res, b);
+                else if (comp(*a, *c))
+                    iter_swap(res, c);
+                else
+                    iter_swap(res, a);
+            }
+            else if (comp(*a, *c))
+                iter_swap(res, a);
+            else if (comp(*b, *c))
+                iter_swap(res, c);
+            else
+                iter_swap(res, b);
+        }
+
+        /**
+         * Partitions [first, last) (at least 4 elements) around
+         * the median of three and returns the start of the upper
+         * part. Elements before it are not greater and elements
+         * after it are not less than the pivot.
+         */
+        template<class RandomAccessIterator, class Compare>
+        RandomAccessIterator partition_pivot(RandomAccessIterator first,
+                                             RandomAccessIterator last,
+                                             Compare comp)
+        {
+            auto mid = first + (last - first) / 2;
+            move_median_to_first(first, first + 1, mid, last - 1, comp);
+
+            /**
+             * Note: The pivot is now at first and the other two
+             *       median candidates act as sentinels, so neither
+             *       of the scans needs a bounds check.
+             */
+            auto left = first + 1;
+            auto right = last;
+            while (true)
+            {
+                while (comp(*left, *first))
+                    ++left;
+                --right;
+                while (comp(*first, *right))
+                    --right;
+
+                if (!(left < right))
+                    return left;
+
+                iter_swap(left, right);
+                ++left;
+            }
+        }
+
+        template<class Size>
+        Size introsort_depth(Size count)
+        {
+            Size depth{};
+            while (count > 1)
+            {
+                count /= 2;
+                ++depth;
+            }
+
+            return 2 * depth;
+        }
+
+        template<class RandomAccessIterator, class Size, class Compare>
+        void introsort_loop(RandomAccessIterator first, RandomAccessIterator last,
+                            Size depth_limit, Compare comp)
+        {
+            while (last - first > introsort_threshold)
+            {
+                if (depth_limit == 0)
+                {
+                    /**
+                     * Too many bad pivots, heap sort guarantees
+                     * n log n for the rest of this partition.
+                     */
+                    make_heap(first, last, comp);
+                    sort_heap(first, last, comp);
+
+                    return;
+                }
+                --depth_limit;
+
+                auto cut = partition_pivot(first, last, comp);
+                introsort_loop(cut, last, depth_limit, comp);
+                last = cut;
+            }
+        }
+    }
+
     template<class RandomAccessIterator, class Compare>
     void sort(RandomAccessIterator first, RandomAccessIterator last,
               Compare comp)
     {
         /**
-         * Note: This isn't the most effective approach,
-         *       but since we already have these two functions
-         *       and they satisfy asymptotic limitations
-         *       imposed by the standard, we're using them at
-         *       the moment. Might be good to change it to qsort
-         *       or merge sort later.
+         * Note: Introsort, quicksort with median of three pivots
+         *       falls back to heap sort if the recursion gets too
+         *       deep and leaves short partitions to a single
+         *       insertion sort pass at the end.
          */
+        auto count = last - first;
+        if (count < 2)
+            return;
 
-        make_heap(first, last, comp);
-        sort_heap(first, last, comp);
+        aux::introsort_loop(first, last, aux::introsort_depth(count), comp);
+        aux::insertion_sort(first, last, comp);
     }
 
     /**
      * 25.4.1.2, stable_sort:
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator lower_bound(ForwardIterator, ForwardIterator,
+                                const T&, Compare);
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator upper_bound(ForwardIterator, ForwardIterator,
+                                const T&, Compare);
+
+    namespace aux
+    {
+        /**
+         * Runs of this length are sorted by insertion
+         * sort before merging.
+         */
+        constexpr ptrdiff_t stable_sort_run{32};
+
+        /**
+         * Merges [first, middle) and [middle, last) with the help
+         * of buf, which is uninitialized storage for at least
+         * distance(first, middle) elements.
+         */
+        template<class BidirectionalIterator, class T, class Compare>
+        void merge_with_buffer(BidirectionalIterator first, BidirectionalIterator middle,
+                               BidirectionalIterator last, T* buf, Compare comp)
+        {
+            auto buf_end = buf;
+            for (auto it = first; it != middle; ++it, ++buf_end)
+                ::new(static_cast<void*>(buf_end)) T(move(*it));
+
+            auto buf_it = buf;
+            auto right = middle;
+            auto res = first;
+            while (buf_it != buf_end && right != last)
+            {
+                // Ties go to the left run to keep the sort stable.
+                if (comp(*right, *buf_it))
+                    *res++ = move(*right++);
+                else
+                    *res++ = move(*buf_it++);
+            }
+
+            while (buf_it != buf_end)
+                *res++ = move(*buf_it++);
+
+            for (auto it = buf; it != buf_end; ++it)
+                it->~T();
+        }
+
+        /**
+         * Used when we cannot get a buffer, this is O(n log n)
+         * instead of O(n) but needs no additional memory.
+         */
+        template<class BidirectionalIterator, class Compare>
+        void merge_without_buffer(BidirectionalIterator first, BidirectionalIterator middle,
+                                  BidirectionalIterator last, Compare comp)
+        {
+            auto len1 = distance(first, middle);
+            auto len2 = distance(middle, last);
+            if (len1 == 0 || len2 == 0)
+                return;
+
+            if (len1 + len2 == 2)
+            {
+                if (comp(*middle, *first))
+                    iter_swap(first, middle);
+
+                return;
+            }
+
+            auto cut1 = first;
+            auto cut2 = middle;
+            if (len1 > len2)
+            {
+                advance(cut1, len1 / 2);
+                cut2 = lower_bound(middle, last, *cut1, comp);
+            }
+            else
+            {
+                advance(cut2, len2 / 2);
+                cut1 = upper_bound(first, middle, *cut2, comp);
+            }
+
+            auto new_middle = rotate(cut1, middle, cut2);
+            merge_without_buffer(first, cut1, new_middle, comp);
+            merge_without_buffer(new_middle, cut2, last, comp);
+        }
+
+        template<class BidirectionalIterator, class Compare>
+        void merge_adaptive(BidirectionalIterator first, BidirectionalIterator middle,
+                            BidirectionalIterator last, Compare comp)
+        {
+            using value_type = typename iterator_traits<BidirectionalIterator>::value_type;
+
+            if (first == middle || middle == last)
+                return;
+
+            auto count = static_cast<size_t>(distance(first, middle));
+            auto buf = static_cast<value_type*>(
+                ::operator new(count * sizeof(value_type), nothrow)
+            );
+
+            if (buf)
+            {
+                merge_with_buffer(first, middle, last, buf, comp);
+                ::operator delete(buf);
+            }
+            else
+                merge_without_buffer(first, middle, last, comp);
+        }
+
+        template<class RandomAccessIterator, class T, class Compare>
+        void merge_sort(RandomAccessIterator first, RandomAccessIterator last,
+                        T* buf, Compare comp)
+        {
+            if (last - first <= stable_sort_run)
+            {
+                insertion_sort(first, last, comp);
+                return;
+            }
+
+            auto middle = first + (last - first) / 2;
+            merge_sort(first, middle, buf, comp);
+            merge_sort(middle, last, buf, comp);
+
+            // Skip the merge if the runs are already in order.
+            if (!comp(*middle, *(middle - 1)))
+                return;
+
+            if (buf)
+                merge_with_buffer(first, middle, last, buf, comp);
+            else
+                merge_without_buffer(first, middle, last, comp);
+        }
+    }
+
+    template<class RandomAccessIterator>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        stable_sort(first, last, less<value_type>{});
+    }
+
+    template<class RandomAccessIterator, class Compare>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare comp)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        auto count = last - first;
+        if (count < 2)
+            return;
+
+        /**
+         * Note: The left half of a merge is never longer than
+         *       half of the range, so that is all the buffer
+         *       we need. If we do not get it, the merges are
+         *       done in place.
+         */
+        auto buf_size = static_cast<size_t>(count / 2);
+        auto buf = static_cast<value_type*>(
+            ::operator new(buf_size * sizeof(value_type), nothrow)
+        );
+
+        aux::merge_sort(first, last, buf, comp);
+
+        if (buf)
+            ::operator delete(buf);
+    }
 
     /**
      * 25.4.1.3, partial_sort:
@@ -734,6 +1070,12 @@ namespace std
      * 25.4.1.5, is_sorted:
      */
 
+    template<class ForwardIterator>
+    ForwardIterator is_sorted_until(ForwardIterator, ForwardIterator);
+
+    template<class ForwardIterator, class Comp>
+    ForwardIterator is_sorted_until(ForwardIterator, ForwardIterator, Comp);
+
     template<class ForwardIterator>
     bool is_sorted(ForwardIterator first, ForwardIterator last)
     {
@@ -750,13 +1092,15 @@ namespace std
     template<class ForwardIterator>
     ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last)
     {
-        if (distance(first, last) < 2)
+        if (first == last)
             return last;
 
-        while (first != last)
+        auto next = first;
+        while (++next != last)
         {
-            if (*first > *(++first))
-                return first;
+            if (*next < *first)
+                return next;
+            first = next;
         }
 
         return last;
@@ -766,13 +1110,15 @@ namespace std
     ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last,
                                     Comp comp)
     {
-        if (distance(first, last) < 2)
+        if (first == last)
             return last;
 
-        while (first != last)
+        auto next = first;
+        while (++next != last)
         {
-            if (!comp(*first, *(++first)))
-                return first;
+            if (comp(*next, *first))
+                return next;
+            first = next;
         }
 
         return last;
@@ -792,13 +1138,69 @@ namespace std
      * 25.4.3.1, lower_bound
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T>
+    ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value)
+    {
+        return lower_bound(first, last, value, less<T>{});
+    }
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value, Compare comp)
+    {
+        auto count = distance(first, last);
+        while (count > 0)
+        {
+            auto step = count / 2;
+            auto it = first;
+            advance(it, step);
+
+            if (comp(*it, value))
+            {
+                first = ++it;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        return first;
+    }
 
     /**
      * 25.4.3.2, upper_bound
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T>
+    ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value)
+    {
+        return upper_bound(first, last, value, less<T>{});
+    }
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value, Compare comp)
+    {
+        auto count = distance(first, last);
+        while (count > 0)
+        {
+            auto step = count / 2;
+            auto it = first;
+            advance(it, step);
+
+            if (!comp(value, *it))
+            {
+                first = ++it;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        return first;
+    }
 
     /**
      * 25.4.3.3, equal_range:
@@ -816,7 +1218,21 @@ namespace std
      * 25.4.4, merge:
      */
 
-    // TODO: implement
+    template<class BidirectionalIterator>
+    void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                       BidirectionalIterator last)
+    {
+        using value_type = typename iterator_traits<BidirectionalIterator>::value_type;
+
+        inplace_merge(first, middle, last, less<value_type>{});
+    }
+
+    template<class BidirectionalIterator, class Compare>
+    void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                       BidirectionalIterator last, Compare comp)
+    {
+        aux::merge_adaptive(first, middle, last, comp);
+    }
 
     /**
      * 25.4.5, set operations on sorted structures:
@@ -886,8 +1302,8 @@ namespace std
             auto left = heap_left_child(idx);
             auto right = heap_right_child(idx);
 
-            bool left_incorrect{comp(first[idx], first[left])};
-            bool right_incorrect{comp(first[idx], first[right])};
+            bool left_incorrect{left < count && comp(first[idx], first[left])};
+            bool right_incorrect{right < count && comp(first[idx], first[right])};
             while ((left < count && left_incorrect) ||
                    (right < count && right_incorrect))
             {
@@ -907,8 +1323,8 @@ namespace std
                 left = heap_left_child(idx);
                 right = heap_right_child(idx);
 
-                left_incorrect = comp(first[idx], first[left]);
-                right_incorrect = comp(first[idx], first[right]);
+                left_incorrect = left < count && comp(first[idx], first[left]);
+                right_incorrect = right < count && comp(first[idx], first[right]);
             }
         }
     }
@@ -971,7 +1387,7 @@ namespace std
             return;
 
         swap(first[0], first[count - 1]);
-        aux::correct_children(first, decltype(count){}, count - 2, comp);
+        aux::correct_children(first, decltype(count){}, count - 1, comp);
     }
 
     /**
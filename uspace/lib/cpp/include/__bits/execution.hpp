@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_EXECUTION
+#define LIBCPP_BITS_EXECUTION
+
+#include <__bits/algorithm.hpp>
+#include <__bits/functional/arithmetic_operations.hpp>
+#include <__bits/thread/thread.hpp>
+#include <type_traits>
+
+namespace std::execution
+{
+    /**
+     * 25.2.4, sequenced execution policy:
+     */
+
+    class sequenced_policy
+    { /* DUMMY BODY */ };
+
+    /**
+     * 25.2.5, parallel execution policy:
+     */
+
+    class parallel_policy
+    { /* DUMMY BODY */ };
+
+    /**
+     * 25.2.6, parallel and unsequenced execution policy:
+     */
+
+    class parallel_unsequenced_policy
+    { /* DUMMY BODY */ };
+
+    /**
+     * 25.2.7, execution policy objects:
+     */
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+    inline constexpr parallel_unsequenced_policy par_unseq{};
+}
+
+namespace std
+{
+    /**
+     * 25.2.3, execution policy type trait:
+     */
+
+    template<class T>
+    struct is_execution_policy: false_type
+    { /* DUMMY BODY */ };
+
+    template<>
+    struct is_execution_policy<execution::sequenced_policy>: true_type
+    { /* DUMMY BODY */ };
+
+    template<>
+    struct is_execution_policy<execution::parallel_policy>: true_type
+    { /* DUMMY BODY */ };
+
+    template<>
+    struct is_execution_policy<execution::parallel_unsequenced_policy>: true_type
+    { /* DUMMY BODY */ };
+
+    template<class T>
+    inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+    namespace aux
+    {
+        template<class ExecutionPolicy>
+        using enable_if_policy_t = enable_if_t<
+            is_execution_policy_v<decay_t<ExecutionPolicy>>
+        >;
+
+        template<class ExecutionPolicy>
+        inline constexpr bool is_parallel_policy_v = !is_same_v<
+            decay_t<ExecutionPolicy>, execution::sequenced_policy
+        >;
+
+        /**
+         * Ranges shorter than this are sorted sequentially,
+         * they are not worth the thread creation.
+         */
+        constexpr ptrdiff_t parallel_sort_threshold{4096};
+
+        /**
+         * Each level splits the work in two, so this
+         * limits a single sort to 8 threads.
+         */
+        constexpr unsigned int parallel_sort_depth{3};
+
+        /**
+         * Note: The threads are fibrils, so the sort can only
+         *       run in parallel if the task has more than one
+         *       fibril runner.
+         */
+        template<class RandomAccessIterator, class Compare>
+        void parallel_sort(RandomAccessIterator first, RandomAccessIterator last,
+                           unsigned int depth, Compare comp)
+        {
+            if (depth == 0 || last - first <= parallel_sort_threshold)
+            {
+                sort(first, last, comp);
+                return;
+            }
+
+            auto cut = partition_pivot(first, last, comp);
+            thread thr{[=](){
+                parallel_sort(cut, last, depth - 1, comp);
+            }};
+
+            parallel_sort(first, cut, depth - 1, comp);
+            thr.join();
+        }
+
+        template<class RandomAccessIterator, class Compare>
+        void parallel_stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                  unsigned int depth, Compare comp)
+        {
+            if (depth == 0 || last - first <= parallel_sort_threshold)
+            {
+                stable_sort(first, last, comp);
+                return;
+            }
+
+            auto middle = first + (last - first) / 2;
+            thread thr{[=](){
+                parallel_stable_sort(middle, last, depth - 1, comp);
+            }};
+
+            parallel_stable_sort(first, middle, depth - 1, comp);
+            thr.join();
+
+            merge_adaptive(first, middle, last, comp);
+        }
+    }
+
+    /**
+     * 25.4.1.1, sort:
+     */
+
+    template<class ExecutionPolicy, class RandomAccessIterator, class Compare,
+             class = aux::enable_if_policy_t<ExecutionPolicy>>
+    void sort(ExecutionPolicy&&, RandomAccessIterator first,
+              RandomAccessIterator last, Compare comp)
+    {
+        if constexpr (aux::is_parallel_policy_v<ExecutionPolicy>)
+            aux::parallel_sort(first, last, aux::parallel_sort_depth, comp);
+        else
+            sort(first, last, comp);
+    }
+
+    template<class ExecutionPolicy, class RandomAccessIterator,
+             class = aux::enable_if_policy_t<ExecutionPolicy>>
+    void sort(ExecutionPolicy&& policy, RandomAccessIterator first,
+              RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        sort(forward<ExecutionPolicy>(policy), first, last, less<value_type>{});
+    }
+
+    /**
+     * 25.4.1.2, stable_sort:
+     */
+
+    template<class ExecutionPolicy, class RandomAccessIterator, class Compare,
+             class = aux::enable_if_policy_t<ExecutionPolicy>>
+    void stable_sort(ExecutionPolicy&&, RandomAccessIterator first,
+                     RandomAccessIterator last, Compare comp)
+    {
+        if constexpr (aux::is_parallel_policy_v<ExecutionPolicy>)
+            aux::parallel_stable_sort(first, last, aux::parallel_sort_depth, comp);
+        else
+            stable_sort(first, last, comp);
+    }
+
+    template<class ExecutionPolicy, class RandomAccessIterator,
+             class = aux::enable_if_policy_t<ExecutionPolicy>>
+    void stable_sort(ExecutionPolicy&& policy, RandomAccessIterator first,
+                     RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        stable_sort(forward<ExecutionPolicy>(policy), first, last, less<value_type>{});
+    }
+}
+
+#endif
@@ -72,9 +72,13 @@ namespace std
             basic_stringbuf(const basic_stringbuf&) = delete;
 
             basic_stringbuf(basic_stringbuf&& other)
-                : mode_{move(other.mode_)}, str_{move(other.str_)}
+                : mode_{move(other.mode_)}, str_{}
             {
+                auto old_data = other.str_.begin();
+
+                str_ = move(other.str_);
                 basic_streambuf<char_type, traits_type>::swap(other);
+                rebase_(old_data);
             }
 
             /**
@@ -86,14 +90,21 @@ namespace std
             basic_stringbuf& operator=(basic_stringbuf&& other)
             {
                 swap(other);
+
+                return *this;
             }
 
             void swap(basic_stringbuf& rhs)
             {
+                auto old_data = str_.begin();
+                auto rhs_old_data = rhs.str_.begin();
+
                 std::swap(mode_, rhs.mode_);
                 std::swap(str_, rhs.str_);
 
                 basic_streambuf<char_type, traits_type>::swap(rhs);
+                rebase_(rhs_old_data);
+                rhs.rebase_(old_data);
             }
 
             /**
@@ -250,6 +261,31 @@ namespace std
                 }
             }
 
+            /**
+             * Short strings live inside the string object,
+             * so moving it around can change the address of
+             * its buffer, this moves the get and put areas
+             * from old_data to the current buffer.
+             */
+            void rebase_(char_type* old_data)
+            {
+                auto data = str_.begin();
+
+                if (this->input_begin_)
+                {
+                    this->input_next_ = data + (this->input_next_ - old_data);
+                    this->input_end_ = data + (this->input_end_ - old_data);
+                    this->input_begin_ = data + (this->input_begin_ - old_data);
+                }
+
+                if (this->output_begin_)
+                {
+                    this->output_next_ = data + (this->output_next_ - old_data);
+                    this->output_end_ = data + (this->output_end_ - old_data);
+                    this->output_begin_ = data + (this->output_begin_ - old_data);
+                }
+            }
+
             bool ensure_free_space_(size_t n = 1)
             {
                 str_.ensure_free_space_(n);
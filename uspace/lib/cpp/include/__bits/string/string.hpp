@@ -470,7 +470,7 @@ namespace std
             { /* DUMMY BODY */ }
 
             explicit basic_string(const allocator_type& alloc)
-                : data_{}, size_{}, capacity_{}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
                 /**
                  * Postconditions:
@@ -478,8 +478,7 @@ namespace std
                  *  size() = 0
                  *  capacity() = unspecified
                  */
-                data_ = allocator_.allocate(default_capacity_);
-                capacity_ = default_capacity_;
+                ensure_null_terminator_();
             }
 
             basic_string(const basic_string& other)
@@ -490,12 +489,9 @@ namespace std
             }
 
             basic_string(basic_string&& other)
-                : data_{other.data_}, size_{other.size_},
-                  capacity_{other.capacity_}, allocator_{move(other.allocator_)}
+                : data_{}, size_{}, capacity_{}, allocator_{move(other.allocator_)}
             {
-                other.data_ = nullptr;
-                other.size_ = 0;
-                other.capacity_ = 0;
+                steal_(other);
             }
 
             basic_string(const basic_string& other, size_type pos, size_type n = npos,
@@ -520,9 +516,9 @@ namespace std
             }
 
             basic_string(size_type n, value_type c, const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{n}, capacity_{n + 1}, allocator_{alloc}
+                : data_{}, size_{n}, capacity_{}, allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                acquire_(n + 1);
                 for (size_type i = 0; i < size_; ++i)
                     traits_type::assign(data_[i], c);
                 ensure_null_terminator_();
@@ -536,8 +532,7 @@ namespace std
                 if constexpr (is_integral<InputIterator>::value)
                 { // Required by the standard.
                     size_ = static_cast<size_type>(first);
-                    capacity_ = size_;
-                    data_ = allocator_.allocate(capacity_);
+                    acquire_(size_ + 1);
 
                     for (size_type i = 0; i < size_; ++i)
                         traits_type::assign(data_[i], static_cast<value_type>(last));
@@ -561,25 +556,20 @@ namespace std
             }
 
             basic_string(basic_string&& other, const allocator_type& alloc)
-                : data_{other.data_}, size_{other.size_}, capacity_{other.capacity_}, allocator_{alloc}
+                : data_{}, size_{}, capacity_{}, allocator_{alloc}
             {
-                other.data_ = nullptr;
-                other.size_ = 0;
-                other.capacity_ = 0;
+                steal_(other);
             }
 
             ~basic_string()
             {
-                allocator_.deallocate(data_, capacity_);
+                release_();
             }
 
             basic_string& operator=(const basic_string& other)
             {
                 if (this != &other)
-                {
-                    basic_string tmp{other};
-                    swap(tmp);
-                }
+                    assign(other.data(), other.size());
 
                 return *this;
             }
@@ -589,30 +579,27 @@ namespace std
                          allocator_traits<allocator_type>::is_always_equal::value)
             {
                 if (this != &other)
-                    swap(other);
+                {
+                    release_();
+                    steal_(other);
+                }
 
                 return *this;
             }
 
             basic_string& operator=(const value_type* other)
             {
-                *this = basic_string{other};
-
-                return *this;
+                return assign(other);
             }
 
             basic_string& operator=(value_type c)
             {
-                *this = basic_string{1, c};
-
-                return *this;
+                return assign(1, c);
             }
 
             basic_string& operator=(initializer_list<value_type> init)
             {
-                *this = basic_string{init};
-
-                return *this;
+                return assign(init.begin(), init.size());
             }
 
             /**
@@ -706,7 +693,7 @@ namespace std
                 {
                     ensure_free_space_(new_size - size_ + 1);
                     for (size_type i = size_; i < new_size; ++i)
-                        traits_type::assign(data_[i], i);
+                        traits_type::assign(data_[i], c);
                 }
 
                 size_ = new_size;
@@ -736,8 +723,15 @@ namespace std
 
             void shrink_to_fit()
             {
-                if (size_ != capacity_)
-                    resize_with_copy_(size_, capacity_);
+                if (is_small_() || size_ + 1 == capacity_)
+                    return;
+
+                auto old_data = data_;
+                auto old_capacity = capacity_;
+
+                acquire_(size_ + 1);
+                traits_type::copy(data_, old_data, size_ + 1);
+                allocator_.deallocate(old_data, old_capacity);
             }
 
             void clear() noexcept
@@ -884,9 +878,7 @@ namespace std
 
             basic_string& assign(basic_string&& str)
             {
-                swap(str);
-
-                return *this;
+                return *this = move(str);
             }
 
             basic_string& assign(const basic_string& str, size_type pos,
@@ -895,7 +887,6 @@ namespace std
                 if (pos < str.size())
                 {
                     auto len = min(n, str.size() - pos);
-                    ensure_free_space_(len);
 
                     return assign(str.data() + pos, len);
                 }
@@ -907,8 +898,14 @@ namespace std
             basic_string& assign(const value_type* str, size_type n)
             {
                 // TODO: if (n > max_size()) throw length_error.
-                resize_without_copy_(n + 1);
-                traits_type::copy(begin(), str, n);
+                if (n + 1 > capacity_)
+                    resize_without_copy_(max(n + 1, next_capacity_()));
+
+                /**
+                 * Note: The source can be a part of this string
+                 *       if it fits, so we need move here.
+                 */
+                traits_type::move(begin(), str, n);
                 size_ = n;
                 ensure_null_terminator_();
 
@@ -922,7 +919,15 @@ namespace std
 
             basic_string& assign(size_type n, value_type c)
             {
-                return assign(basic_string(n, c));
+                if (n + 1 > capacity_)
+                    resize_without_copy_(max(n + 1, next_capacity_()));
+
+                for (size_type i = 0; i < n; ++i)
+                    traits_type::assign(data_[i], c);
+                size_ = n;
+                ensure_null_terminator_();
+
+                return *this;
             }
 
             template<class InputIterator>
@@ -1160,9 +1165,18 @@ namespace std
                 noexcept(allocator_traits<allocator_type>::propagate_on_container_swap::value ||
                          allocator_traits<allocator_type>::is_always_equal::value)
             {
-                std::swap(data_, other.data_);
-                std::swap(size_, other.size_);
-                std::swap(capacity_, other.capacity_);
+                if (is_small_() || other.is_small_())
+                {
+                    basic_string tmp{move(other)};
+                    other = move(*this);
+                    *this = move(tmp);
+                }
+                else
+                {
+                    std::swap(data_, other.data_);
+                    std::swap(size_, other.size_);
+                    std::swap(capacity_, other.capacity_);
+                }
             }
 
             /**
@@ -1476,31 +1490,86 @@ namespace std
             }
 
         private:
+            /**
+             * Short strings (including the null terminator)
+             * are kept in sso_ inside the object, so that
+             * the empty string and most keys/identifiers
+             * never touch the allocator. The value is chosen
+             * so that 15 chars fit, which covers most of the
+             * strings in our code base.
+             */
+            static constexpr size_type sso_capacity_{16};
+
             value_type* data_;
             size_type size_;
             size_type capacity_;
             allocator_type allocator_;
+            value_type sso_[sso_capacity_];
 
             template<class C, class T, class A>
             friend class basic_stringbuf;
 
+            bool is_small_() const noexcept
+            {
+                return data_ == sso_;
+            }
+
             /**
-             * Arbitrary value, standard just requires
-             * data() to have some capacity.
-             * (Well, we could've done data_ = &data_ and
-             * set capacity to 0, but that would be too cryptic.)
+             * Sets data_ to a buffer of at least the given capacity,
+             * the previous buffer (if any) is not released.
              */
-            static constexpr size_type default_capacity_{4};
+            void acquire_(size_type capacity)
+            {
+                if (capacity <= sso_capacity_)
+                {
+                    data_ = sso_;
+                    capacity_ = sso_capacity_;
+                }
+                else
+                {
+                    data_ = allocator_.allocate(capacity);
+                    capacity_ = capacity;
+                }
+            }
 
-            void init_(const value_type* str, size_type size)
+            void release_()
             {
-                if (data_)
+                if (data_ && !is_small_())
                     allocator_.deallocate(data_, capacity_);
+            }
 
-                size_ = size;
-                capacity_ = size + 1;
+            /**
+             * Takes over the contents of other and leaves
+             * it as an empty string. This never allocates,
+             * small strings are just copied over.
+             */
+            void steal_(basic_string& other) noexcept
+            {
+                size_ = other.size_;
+                if (other.is_small_())
+                {
+                    data_ = sso_;
+                    capacity_ = sso_capacity_;
+                    traits_type::copy(sso_, other.sso_, size_ + 1);
+                }
+                else
+                {
+                    data_ = other.data_;
+                    capacity_ = other.capacity_;
+                }
 
-                data_ = allocator_.allocate(capacity_);
+                other.data_ = other.sso_;
+                other.size_ = 0;
+                other.capacity_ = sso_capacity_;
+                other.ensure_null_terminator_();
+            }
+
+            void init_(const value_type* str, size_type size)
+            {
+                release_();
+
+                size_ = size;
+                acquire_(size + 1);
                 traits_type::copy(data_, str, size);
                 ensure_null_terminator_();
             }
@@ -1526,30 +1595,27 @@ namespace std
 
             void resize_without_copy_(size_type capacity)
             {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                release_();
 
-                data_ = allocator_.allocate(capacity);
+                acquire_(capacity);
                 size_ = 0;
-                capacity_ = capacity;
                 ensure_null_terminator_();
             }
 
             void resize_with_copy_(size_type size, size_type capacity)
             {
-                if(capacity_ == 0 || capacity_ < capacity)
+                if (capacity_ < capacity)
                 {
                     auto new_data = allocator_.allocate(capacity);
 
                     auto to_copy = min(size, size_);
-                    traits_type::move(new_data, data_, to_copy);
-
-                    std::swap(data_, new_data);
+                    traits_type::copy(new_data, data_, to_copy);
 
-                    allocator_.deallocate(new_data, capacity_);
+                    release_();
+                    data_ = new_data;
+                    capacity_ = capacity;
                 }
 
-                capacity_ = capacity;
                 size_ = size;
                 ensure_null_terminator_();
             }
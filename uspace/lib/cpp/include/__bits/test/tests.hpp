@@ -123,6 +123,7 @@ namespace std::test
             void test_find();
             void test_substr();
             void test_compare();
+            void test_small_strings();
     };
 
     class bitset_test: public test_suite
@@ -293,6 +294,7 @@ namespace std::test
         private:
             void test_non_modifying();
             void test_mutating();
+            void test_sorting();
     };
 
     class future_test: public test_suite
@@ -29,8 +29,11 @@
 #include <__bits/test/tests.hpp>
 #include <algorithm>
 #include <array>
+#include <execution>
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace std::test
 {
@@ -41,6 +44,7 @@ namespace std::test
 
         test_non_modifying();
         test_mutating();
+        test_sorting();
 
         return end();
     }
@@ -293,4 +297,103 @@ namespace std::test
         );
         test_eq("transform pt2", res6, data10.end());
     }
+
+    void algorithm_test::test_sorting()
+    {
+        auto check1 = {1, 2, 2, 3, 5, 7, 8, 9};
+        std::array<int, 8> data1{7, 2, 9, 1, 5, 2, 8, 3};
+
+        std::sort(data1.begin(), data1.end());
+        test_eq(
+            "sort small", check1.begin(), check1.end(),
+            data1.begin(), data1.end()
+        );
+
+        /**
+         * Large enough for the quicksort partitioning,
+         * parallel splitting and the merges to kick in.
+         */
+        std::vector<int> data2(10000);
+        unsigned int seed{1};
+        for (auto& x: data2)
+        {
+            seed = seed * 1103515245 + 12345;
+            x = static_cast<int>((seed >> 16) % 1000);
+        }
+
+        auto data3 = data2;
+        std::sort(data3.begin(), data3.end());
+        test("sort large", std::is_sorted(data3.begin(), data3.end()));
+
+        auto data4 = data2;
+        std::sort(data4.begin(), data4.end(), std::greater<int>{});
+        test(
+            "sort large with comparator",
+            std::is_sorted(data4.rbegin(), data4.rend())
+        );
+
+        std::vector<int> data5(10000, 4);
+        std::sort(data5.begin(), data5.end());
+        test("sort all equal", std::is_sorted(data5.begin(), data5.end()));
+
+        auto data6 = data2;
+        std::sort(std::execution::par, data6.begin(), data6.end());
+        test_eq(
+            "sort parallel", data3.begin(), data3.end(),
+            data6.begin(), data6.end()
+        );
+
+        auto data7 = data2;
+        std::sort(std::execution::seq, data7.begin(), data7.end());
+        test_eq(
+            "sort sequenced policy", data3.begin(), data3.end(),
+            data7.begin(), data7.end()
+        );
+
+        /**
+         * Sort pairs of (key, original index) by the key only,
+         * stability means indices stay ascending within a key.
+         */
+        std::vector<std::pair<int, int>> data8{};
+        for (int i = 0; i < static_cast<int>(data2.size()); ++i)
+            data8.emplace_back(data2[i] % 10, i);
+        auto by_key = [](const auto& a, const auto& b){ return a.first < b.first; };
+        auto is_stable = [](const auto& a, const auto& b){
+            return a.first < b.first || (a.first == b.first && a.second < b.second);
+        };
+
+        auto data9 = data8;
+        std::stable_sort(data9.begin(), data9.end(), by_key);
+        test("stable_sort", std::is_sorted(data9.begin(), data9.end(), is_stable));
+
+        auto data10 = data8;
+        std::stable_sort(std::execution::par, data10.begin(), data10.end(), by_key);
+        test(
+            "stable_sort parallel",
+            std::is_sorted(data10.begin(), data10.end(), is_stable)
+        );
+
+        auto check2 = {1, 2, 3, 4, 5, 6, 7};
+        std::array<int, 7> data11{2, 4, 6, 1, 3, 5, 7};
+        std::inplace_merge(data11.begin(), data11.begin() + 3, data11.end());
+        test_eq(
+            "inplace_merge", check2.begin(), check2.end(),
+            data11.begin(), data11.end()
+        );
+
+        auto res1 = std::lower_bound(data11.begin(), data11.end(), 4);
+        test_eq("lower_bound", res1, data11.begin() + 3);
+
+        auto res2 = std::upper_bound(data11.begin(), data11.end(), 4);
+        test_eq("upper_bound", res2, data11.begin() + 4);
+
+        std::array<int, 5> data12{1, 2, 3, 4, 5};
+        auto check3 = {3, 4, 5, 1, 2};
+        auto res3 = std::rotate(data12.begin(), data12.begin() + 2, data12.end());
+        test_eq(
+            "rotate pt1", check3.begin(), check3.end(),
+            data12.begin(), data12.end()
+        );
+        test_eq("rotate pt2", res3, data12.begin() + 3);
+    }
 }
@@ -47,6 +47,7 @@ namespace std::test
         test_find();
         test_substr();
         test_compare();
+        test_small_strings();
 
         return end();
     }
@@ -703,4 +704,77 @@ namespace std::test
             res, 0
         );
     }
+
+    void string_test::test_small_strings()
+    {
+        std::string check_short{"short"};
+        std::string check_long{"this string is too long to be stored inline"};
+
+        std::string str1{check_short};
+        std::string str2{check_long};
+        str1.swap(str2);
+        test_eq(
+            "swap short with long (1)",
+            str1.begin(), str1.end(),
+            check_long.begin(), check_long.end()
+        );
+        test_eq(
+            "swap short with long (2)",
+            str2.begin(), str2.end(),
+            check_short.begin(), check_short.end()
+        );
+
+        std::string str3{std::move(str2)};
+        test_eq(
+            "move short",
+            str3.begin(), str3.end(),
+            check_short.begin(), check_short.end()
+        );
+        test_eq(
+            "move short source empty",
+            str2.size(), 0ul
+        );
+
+        str2 = std::move(str1);
+        test_eq(
+            "move assign long",
+            str2.begin(), str2.end(),
+            check_long.begin(), check_long.end()
+        );
+        test(
+            "move assign long source null terminated",
+            str1.c_str()[0] == '\0'
+        );
+
+        std::string str4{};
+        for (auto c: check_long)
+            str4.push_back(c);
+        test_eq(
+            "push_back past inline buffer",
+            str4.begin(), str4.end(),
+            check_long.begin(), check_long.end()
+        );
+
+        str4.assign(str4, 5ul, 6ul);
+        test_eq(
+            "assign own substring",
+            str4.begin(), str4.end(),
+            check_long.begin() + 5, check_long.begin() + 11
+        );
+
+        str4.shrink_to_fit();
+        test_eq(
+            "shrink_to_fit into inline buffer",
+            str4.begin(), str4.end(),
+            check_long.begin() + 5, check_long.begin() + 11
+        );
+
+        const char* check_resize = "shortxxx";
+        str3.resize(8, 'x');
+        test_eq(
+            "resize with fill",
+            str3.begin(), str3.end(),
+            check_resize, check_resize + 8
+        );
+    }
 }
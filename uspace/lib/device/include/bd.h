@@ -36,10 +36,27 @@
 #define LIBDEVICE_BD_H
 
 #include <async.h>
+#include <fibril_synch.h>
 #include <offset.h>
+#include <stdbool.h>
+#include <types/bd.h>
 
 typedef struct {
 	async_sess_t *sess;
+	/** Buffer shared with the server or @c NULL */
+	void *shbuf;
+	/** Protects completion ring and in-flight count */
+	fibril_mutex_t lock;
+	/** Signalled when a completion arrives */
+	fibril_condvar_t cv;
+	/** Ring of completions not yet reaped */
+	bd_compl_t ring[BD_QUEUE_DEPTH];
+	/** Index of first completion in ring */
+	size_t ring_head;
+	/** Number of completions in ring */
+	size_t ring_count;
+	/** Number of submitted requests not yet reaped */
+	size_t inflight;
 } bd_t;
 
 extern errno_t bd_open(async_sess_t *, bd_t **);
@@ -51,6 +68,9 @@ extern errno_t bd_sync_cache(bd_t *, aoff64_t, size_t);
 extern errno_t bd_get_block_size(bd_t *, size_t *);
 extern errno_t bd_get_num_blocks(bd_t *, aoff64_t *);
 extern errno_t bd_eject(bd_t *);
+extern errno_t bd_share_buffer(bd_t *, size_t, void **);
+extern errno_t bd_submit(bd_t *, const bd_req_t *, size_t);
+extern errno_t bd_reap(bd_t *, bd_compl_t *, size_t, bool, size_t *);
 
 #endif
 
@@ -40,6 +40,7 @@
 #include <fibril_synch.h>
 #include <stdbool.h>
 #include <offset.h>
+#include <types/bd.h>
 
 typedef struct bd_ops bd_ops_t;
 
@@ -49,11 +50,40 @@ typedef struct {
 	void *sarg;
 } bd_srvs_t;
 
+/** Queued shared-buffer request */
+typedef struct {
+	/** Link to bd_srv_t.reqq or bd_srv_t.reqfree */
+	link_t lreqs;
+	/** Request */
+	bd_req_t req;
+} bd_srv_req_t;
+
 /** Server structure (per client session) */
 typedef struct {
 	bd_srvs_t *srvs;
 	async_sess_t *client_sess;
 	void *carg;
+
+	/** Buffer area shared by the client or @c NULL */
+	void *shbuf;
+	/** Size of shared buffer area */
+	size_t shbuf_size;
+	/** Synchronizes shared-buffer request processing */
+	fibril_mutex_t lock;
+	/** Signalled when requests are queued or a worker exits */
+	fibril_condvar_t cv;
+	/** Queued requests (bd_srv_req_t) */
+	list_t reqq;
+	/** Free request entries (bd_srv_req_t) */
+	list_t reqfree;
+	/** Request entries */
+	bd_srv_req_t reqs[BD_QUEUE_DEPTH];
+	/** Number of accepted requests that have not completed */
+	size_t inflight;
+	/** Number of worker fibrils */
+	size_t nworkers;
+	/** Connection is closing, workers should exit */
+	bool closing;
 } bd_srv_t;
 
 struct bd_ops {
@@ -66,6 +96,17 @@ struct bd_ops {
 	errno_t (*get_block_size)(bd_srv_t *, size_t *);
 	errno_t (*get_num_blocks)(bd_srv_t *, aoff64_t *);
 	errno_t (*eject)(bd_srv_t *);
+	/** Translate block range for forwarding to another block device.
+	 *
+	 * If implemented, read and write requests are forwarded to the
+	 * returned session with the translated block address, data are
+	 * transferred directly between the client and that device.
+	 * On success fwd_end is called once the request is finished.
+	 * Such a server does not accept a shared buffer.
+	 */
+	errno_t (*fwd_begin)(bd_srv_t *, aoff64_t, size_t, async_sess_t **,
+	    aoff64_t *);
+	void (*fwd_end)(bd_srv_t *);
 };
 
 extern void bd_srvs_init(bd_srvs_t *);
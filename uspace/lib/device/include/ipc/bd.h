@@ -44,9 +44,15 @@ typedef enum {
 	BD_SYNC_CACHE,
 	BD_WRITE_BLOCKS,
 	BD_READ_TOC,
-	BD_EJECT
+	BD_EJECT,
+	BD_SHARE_BUFFER,
+	BD_SUBMIT
 } bd_request_t;
 
+typedef enum {
+	BD_CB_COMPLETE = IPC_FIRST_USER_METHOD
+} bd_cb_request_t;
+
 #endif
 
 /** @}
@@ -75,6 +75,15 @@
 #define NIC_DEFECTIVE_BAD_TCP_CHECKSUM   0x0080
 #define NIC_DEFECTIVE_BAD_UDP_CHECKSUM   0x0100
 
+/** NIC inserts TCP checksum into transmitted IPv4/IPv6 frames */
+#define NIC_OFFLOAD_TX_TCP_CSUM  0x0001
+/** NIC inserts UDP checksum into transmitted IPv4/IPv6 frames */
+#define NIC_OFFLOAD_TX_UDP_CSUM  0x0002
+/** NIC verifies TCP/UDP checksums of received frames */
+#define NIC_OFFLOAD_RX_CSUM      0x0004
+/** NIC performs TCP segmentation */
+#define NIC_OFFLOAD_TSO          0x0008
+
 /**
  * The bitmap uses single bit for each of the 2^12 = 4096 possible VLAN tags.
  * This means its size is 4096/8 = 512 bytes.
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libdevice
+ * @{
+ */
+/** @file Shared-buffer block device request types
+ */
+
+#ifndef LIBDEVICE_TYPES_BD_H
+#define LIBDEVICE_TYPES_BD_H
+
+#include <errno.h>
+#include <stdint.h>
+
+/** Maximum number of outstanding shared-buffer requests per session */
+#define BD_QUEUE_DEPTH  32
+
+/** Shared-buffer request operation */
+typedef enum {
+	/** Read blocks into the shared buffer */
+	bdr_read,
+	/** Write blocks from the shared buffer */
+	bdr_write
+} bd_req_op_t;
+
+/** Shared-buffer block device request.
+ *
+ * The data lives in the buffer area that the client shared with the
+ * server by bd_share_buffer().
+ */
+typedef struct {
+	/** Client-chosen tag, returned in the completion */
+	uint32_t tag;
+	/** Operation (bd_req_op_t) */
+	uint32_t op;
+	/** Address of first block */
+	uint64_t ba;
+	/** Number of blocks */
+	uint64_t cnt;
+	/** Offset of the data in the shared buffer in bytes */
+	uint64_t offset;
+} bd_req_t;
+
+/** Shared-buffer request completion */
+typedef struct {
+	/** Tag of the completed request */
+	uint32_t tag;
+	/** Completion status */
+	errno_t rc;
+} bd_compl_t;
+
+#endif
+
+/** @}
+ */
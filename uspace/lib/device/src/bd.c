@@ -34,10 +34,12 @@
  * @brief Block device client interface
  */
 
+#include <as.h>
 #include <async.h>
 #include <assert.h>
 #include <bd.h>
 #include <errno.h>
+#include <fibril_synch.h>
 #include <ipc/bd.h>
 #include <ipc/services.h>
 #include <loc.h>
@@ -54,6 +56,8 @@ errno_t bd_open(async_sess_t *sess, bd_t **rbd)
 		return ENOMEM;
 
 	bd->sess = sess;
+	fibril_mutex_initialize(&bd->lock);
+	fibril_condvar_initialize(&bd->cv);
 
 	async_exch_t *exch = async_exchange_begin(sess);
 
@@ -79,6 +83,8 @@ error:
 void bd_close(bd_t *bd)
 {
 	/* XXX Synchronize with bd_cb_conn */
+	if (bd->shbuf != NULL)
+		as_area_destroy(bd->shbuf);
 	free(bd);
 }
 
@@ -205,12 +211,171 @@ errno_t bd_eject(bd_t *bd)
 	return rc;
 }
 
+/** Share buffer for vectored requests with the block device.
+ *
+ * Creates a buffer of @a size bytes which is shared with the block
+ * device server. Requests submitted with bd_submit() transfer data
+ * to/from this buffer, identified by an offset.
+ *
+ * @param bd Block device
+ * @param size Buffer size in bytes
+ * @param rbuf Place to store pointer to the shared buffer
+ * @return EOK on success or an error code
+ */
+errno_t bd_share_buffer(bd_t *bd, size_t size, void **rbuf)
+{
+	void *buf;
+	errno_t rc;
+
+	if (bd->shbuf != NULL)
+		return EBUSY;
+
+	buf = as_area_create(AS_AREA_ANY, size,
+	    AS_AREA_READ | AS_AREA_WRITE | AS_AREA_CACHEABLE, AS_AREA_UNPAGED);
+	if (buf == AS_MAP_FAILED)
+		return ENOMEM;
+
+	async_exch_t *exch = async_exchange_begin(bd->sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_0(exch, BD_SHARE_BUFFER, &answer);
+	rc = async_share_out_start(exch, buf,
+	    AS_AREA_READ | AS_AREA_WRITE | AS_AREA_CACHEABLE);
+	async_exchange_end(exch);
+
+	if (rc != EOK) {
+		async_forget(req);
+		as_area_destroy(buf);
+		return rc;
+	}
+
+	errno_t retval;
+	async_wait_for(req, &retval);
+	if (retval != EOK) {
+		as_area_destroy(buf);
+		return retval;
+	}
+
+	bd->shbuf = buf;
+	*rbuf = buf;
+	return EOK;
+}
+
+/** Submit vectored requests to block device.
+ *
+ * The requests are queued by the server and executed asynchronously.
+ * A completion carrying the request tag is delivered for every request,
+ * use bd_reap() to collect them. At most BD_QUEUE_DEPTH requests
+ * can be in flight.
+ *
+ * @param bd Block device
+ * @param reqs Array of requests
+ * @param n Number of requests
+ * @return EOK on success, ELIMIT if the queue would overflow
+ *         or an error code
+ */
+errno_t bd_submit(bd_t *bd, const bd_req_t *reqs, size_t n)
+{
+	errno_t rc;
+
+	fibril_mutex_lock(&bd->lock);
+	if (bd->inflight + n > BD_QUEUE_DEPTH) {
+		fibril_mutex_unlock(&bd->lock);
+		return ELIMIT;
+	}
+
+	bd->inflight += n;
+	fibril_mutex_unlock(&bd->lock);
+
+	async_exch_t *exch = async_exchange_begin(bd->sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_0(exch, BD_SUBMIT, &answer);
+	rc = async_data_write_start(exch, reqs, n * sizeof(bd_req_t));
+	async_exchange_end(exch);
+
+	if (rc != EOK) {
+		async_forget(req);
+		goto error;
+	}
+
+	async_wait_for(req, &rc);
+	if (rc != EOK)
+		goto error;
+
+	return EOK;
+error:
+	fibril_mutex_lock(&bd->lock);
+	bd->inflight -= n;
+	fibril_condvar_broadcast(&bd->cv);
+	fibril_mutex_unlock(&bd->lock);
+	return rc;
+}
+
+/** Reap completions of requests submitted with bd_submit().
+ *
+ * @param bd Block device
+ * @param compl Array to fill in with completions
+ * @param max Maximum number of completions to return
+ * @param wait @c true to wait until at least one completion is available
+ * @param rcount Place to store number of completions returned
+ * @return EOK on success, ENOENT if there are no completions
+ *         (and none can arrive if @a wait is @c true)
+ */
+errno_t bd_reap(bd_t *bd, bd_compl_t *compl, size_t max, bool wait,
+    size_t *rcount)
+{
+	size_t i;
+
+	fibril_mutex_lock(&bd->lock);
+
+	if (wait) {
+		while (bd->ring_count == 0 && bd->inflight > 0)
+			fibril_condvar_wait(&bd->cv, &bd->lock);
+	}
+
+	if (bd->ring_count == 0) {
+		fibril_mutex_unlock(&bd->lock);
+		return ENOENT;
+	}
+
+	for (i = 0; i < max && bd->ring_count > 0; i++) {
+		compl[i] = bd->ring[bd->ring_head];
+		bd->ring_head = (bd->ring_head + 1) % BD_QUEUE_DEPTH;
+		bd->ring_count--;
+		bd->inflight--;
+	}
+
+	fibril_mutex_unlock(&bd->lock);
+
+	*rcount = i;
+	return EOK;
+}
+
+static void bd_complete_srv(bd_t *bd, ipc_call_t *call)
+{
+	size_t idx;
+
+	fibril_mutex_lock(&bd->lock);
+
+	/* The server never has more than BD_QUEUE_DEPTH requests in flight */
+	assert(bd->ring_count < BD_QUEUE_DEPTH);
+
+	idx = (bd->ring_head + bd->ring_count) % BD_QUEUE_DEPTH;
+	bd->ring[idx].tag = ipc_get_arg1(call);
+	bd->ring[idx].rc = ipc_get_arg2(call);
+	bd->ring_count++;
+
+	fibril_condvar_broadcast(&bd->cv);
+	fibril_mutex_unlock(&bd->lock);
+
+	async_answer_0(call, EOK);
+}
+
 static void bd_cb_conn(ipc_call_t *icall, void *arg)
 {
 	bd_t *bd = (bd_t *)arg;
 
-	(void)bd;
-
 	while (true) {
 		ipc_call_t call;
 		async_get_call(&call);
@@ -221,6 +386,9 @@ static void bd_cb_conn(ipc_call_t *icall, void *arg)
 		}
 
 		switch (ipc_get_imethod(&call)) {
+		case BD_CB_COMPLETE:
+			bd_complete_srv(bd, &call);
+			break;
 		default:
 			async_answer_0(&call, ENOTSUP);
 		}
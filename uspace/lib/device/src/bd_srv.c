@@ -33,7 +33,9 @@
  * @file
  * @brief Block device server stub
  */
+#include <as.h>
 #include <errno.h>
+#include <fibril.h>
 #include <ipc/bd.h>
 #include <macros.h>
 #include <stdlib.h>
@@ -42,6 +44,57 @@
 
 #include <bd_srv.h>
 
+/** Forward read or write request to another block device.
+ *
+ * The client's data transfer request is forwarded along with the
+ * request, so the data never pass through this server.
+ *
+ * @param srv Block device server
+ * @param call Read or write blocks request
+ */
+static void bd_fwd_blocks_srv(bd_srv_t *srv, ipc_call_t *call)
+{
+	sysarg_t method;
+	aoff64_t ba;
+	size_t cnt;
+	async_sess_t *sess;
+	aoff64_t fba;
+	errno_t rc;
+
+	method = ipc_get_imethod(call);
+	ba = MERGE_LOUP32(ipc_get_arg1(call), ipc_get_arg2(call));
+	cnt = ipc_get_arg3(call);
+
+	rc = srv->srvs->ops->fwd_begin(srv, ba, cnt, &sess, &fba);
+	if (rc != EOK) {
+		ipc_call_t dcall;
+
+		if (method == BD_READ_BLOCKS)
+			(void) async_data_read_receive(&dcall, NULL);
+		else
+			(void) async_data_write_receive(&dcall, NULL);
+
+		async_answer_0(&dcall, rc);
+		async_answer_0(call, rc);
+		return;
+	}
+
+	async_exch_t *exch = async_exchange_begin(sess);
+
+	if (method == BD_READ_BLOCKS) {
+		rc = async_data_read_forward_3_0(exch, BD_READ_BLOCKS,
+		    LOWER32(fba), UPPER32(fba), cnt);
+	} else {
+		rc = async_data_write_forward_3_0(exch, BD_WRITE_BLOCKS,
+		    LOWER32(fba), UPPER32(fba), cnt);
+	}
+
+	async_exchange_end(exch);
+	srv->srvs->ops->fwd_end(srv);
+
+	async_answer_0(call, rc);
+}
+
 static void bd_read_blocks_srv(bd_srv_t *srv, ipc_call_t *call)
 {
 	aoff64_t ba;
@@ -218,6 +271,251 @@ static void bd_eject_srv(bd_srv_t *srv, ipc_call_t *call)
 	async_answer_0(call, rc);
 }
 
+static void bd_share_buffer_srv(bd_srv_t *srv, ipc_call_t *call)
+{
+	ipc_call_t scall;
+	size_t size;
+	unsigned int flags;
+	void *buf;
+	errno_t rc;
+
+	if (!async_share_out_receive(&scall, &size, &flags)) {
+		async_answer_0(&scall, EINVAL);
+		async_answer_0(call, EINVAL);
+		return;
+	}
+
+	/*
+	 * Read and write requests to a forwarding server go straight to
+	 * the underlying device, while shared-buffer requests would be
+	 * copied here. Make the client use the former.
+	 */
+	if (srv->srvs->ops->fwd_begin != NULL) {
+		async_answer_0(&scall, ENOTSUP);
+		async_answer_0(call, ENOTSUP);
+		return;
+	}
+
+	if (srv->shbuf != NULL) {
+		async_answer_0(&scall, EBUSY);
+		async_answer_0(call, EBUSY);
+		return;
+	}
+
+	/* Requests move data both in and out of the buffer */
+	if ((flags & (AS_AREA_READ | AS_AREA_WRITE)) !=
+	    (AS_AREA_READ | AS_AREA_WRITE)) {
+		async_answer_0(&scall, EINVAL);
+		async_answer_0(call, EINVAL);
+		return;
+	}
+
+	rc = async_share_out_finalize(&scall, &buf);
+	if (rc != EOK || buf == AS_MAP_FAILED) {
+		async_answer_0(call, ENOMEM);
+		return;
+	}
+
+	srv->shbuf = buf;
+	srv->shbuf_size = size;
+	async_answer_0(call, EOK);
+}
+
+/** Execute shared-buffer request.
+ *
+ * The data is read or written directly from/to the shared buffer,
+ * the request has been validated by bd_submit_srv().
+ *
+ * @param srv Block device server
+ * @param req Request
+ * @return EOK on success or an error code
+ */
+static errno_t bd_srv_req_exec(bd_srv_t *srv, bd_req_t *req)
+{
+	void *buf = (uint8_t *) srv->shbuf + req->offset;
+	size_t size = srv->shbuf_size - req->offset;
+
+	if (req->op == bdr_read) {
+		return srv->srvs->ops->read_blocks(srv, req->ba, req->cnt,
+		    buf, size);
+	}
+
+	return srv->srvs->ops->write_blocks(srv, req->ba, req->cnt, buf, size);
+}
+
+/** Shared-buffer request worker fibril.
+ *
+ * Several workers run at the same time so that the driver can have
+ * several requests in progress (e.g. queued in the device).
+ *
+ * @param arg Block device server (bd_srv_t *)
+ * @return EOK
+ */
+static errno_t bd_srv_worker(void *arg)
+{
+	bd_srv_t *srv = (bd_srv_t *) arg;
+
+	fibril_mutex_lock(&srv->lock);
+
+	while (true) {
+		while (list_empty(&srv->reqq) && !srv->closing)
+			fibril_condvar_wait(&srv->cv, &srv->lock);
+
+		/* Closing and nothing left to do */
+		if (list_empty(&srv->reqq))
+			break;
+
+		bd_srv_req_t *sreq = list_get_instance(list_first(&srv->reqq),
+		    bd_srv_req_t, lreqs);
+		list_remove(&sreq->lreqs);
+		bd_req_t req = sreq->req;
+		list_append(&sreq->lreqs, &srv->reqfree);
+
+		fibril_mutex_unlock(&srv->lock);
+		errno_t rc = bd_srv_req_exec(srv, &req);
+		fibril_mutex_lock(&srv->lock);
+
+		/*
+		 * Post the completion before decrementing the in-flight count
+		 * so that the client cannot overrun the queue.
+		 */
+		async_exch_t *exch = async_exchange_begin(srv->client_sess);
+		async_msg_2(exch, BD_CB_COMPLETE, req.tag, rc);
+		async_exchange_end(exch);
+
+		srv->inflight--;
+	}
+
+	srv->nworkers--;
+	fibril_condvar_broadcast(&srv->cv);
+	fibril_mutex_unlock(&srv->lock);
+
+	return EOK;
+}
+
+static void bd_submit_srv(bd_srv_t *srv, ipc_call_t *call)
+{
+	bd_req_t *reqs;
+	size_t size;
+	size_t bsize;
+	errno_t rc;
+
+	rc = async_data_write_accept((void **) &reqs, false, sizeof(bd_req_t),
+	    BD_QUEUE_DEPTH * sizeof(bd_req_t), sizeof(bd_req_t), &size);
+	if (rc != EOK) {
+		async_answer_0(call, rc);
+		return;
+	}
+
+	size_t n = size / sizeof(bd_req_t);
+
+	if (srv->shbuf == NULL) {
+		rc = EINVAL;
+		goto error;
+	}
+
+	if (srv->srvs->ops->get_block_size == NULL) {
+		rc = ENOTSUP;
+		goto error;
+	}
+
+	rc = srv->srvs->ops->get_block_size(srv, &bsize);
+	if (rc != EOK)
+		goto error;
+
+	if (bsize == 0) {
+		rc = EIO;
+		goto error;
+	}
+
+	/* Validate all requests before accepting any */
+	for (size_t i = 0; i < n; i++) {
+		if (reqs[i].op == bdr_read) {
+			if (srv->srvs->ops->read_blocks == NULL) {
+				rc = ENOTSUP;
+				goto error;
+			}
+		} else if (reqs[i].op == bdr_write) {
+			if (srv->srvs->ops->write_blocks == NULL) {
+				rc = ENOTSUP;
+				goto error;
+			}
+		} else {
+			rc = EINVAL;
+			goto error;
+		}
+
+		if (reqs[i].offset > srv->shbuf_size ||
+		    reqs[i].cnt > (srv->shbuf_size - reqs[i].offset) / bsize) {
+			rc = EINVAL;
+			goto error;
+		}
+	}
+
+	fibril_mutex_lock(&srv->lock);
+
+	if (srv->inflight + n > BD_QUEUE_DEPTH) {
+		fibril_mutex_unlock(&srv->lock);
+		rc = ELIMIT;
+		goto error;
+	}
+
+	/* Make sure there is a worker for each request in flight */
+	while (srv->nworkers < srv->inflight + n) {
+		fid_t fid = fibril_create(bd_srv_worker, srv);
+		if (fid == 0)
+			break;
+
+		srv->nworkers++;
+		fibril_add_ready(fid);
+	}
+
+	if (srv->nworkers == 0) {
+		fibril_mutex_unlock(&srv->lock);
+		rc = ENOMEM;
+		goto error;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		bd_srv_req_t *sreq = list_get_instance(
+		    list_first(&srv->reqfree), bd_srv_req_t, lreqs);
+		list_remove(&sreq->lreqs);
+		sreq->req = reqs[i];
+		list_append(&sreq->lreqs, &srv->reqq);
+	}
+
+	srv->inflight += n;
+	fibril_condvar_broadcast(&srv->cv);
+	fibril_mutex_unlock(&srv->lock);
+
+	free(reqs);
+	async_answer_0(call, EOK);
+	return;
+error:
+	free(reqs);
+	async_answer_0(call, rc);
+}
+
+/** Finish processing shared-buffer requests and release shared buffer.
+ *
+ * @param srv Block device server
+ */
+static void bd_srv_shutdown(bd_srv_t *srv)
+{
+	fibril_mutex_lock(&srv->lock);
+
+	srv->closing = true;
+	fibril_condvar_broadcast(&srv->cv);
+
+	while (srv->nworkers > 0)
+		fibril_condvar_wait(&srv->cv, &srv->lock);
+
+	fibril_mutex_unlock(&srv->lock);
+
+	if (srv->shbuf != NULL)
+		as_area_destroy(srv->shbuf);
+}
+
 static bd_srv_t *bd_srv_create(bd_srvs_t *srvs)
 {
 	bd_srv_t *srv;
@@ -227,6 +525,14 @@ static bd_srv_t *bd_srv_create(bd_srvs_t *srvs)
 		return NULL;
 
 	srv->srvs = srvs;
+	fibril_mutex_initialize(&srv->lock);
+	fibril_condvar_initialize(&srv->cv);
+	list_initialize(&srv->reqq);
+	list_initialize(&srv->reqfree);
+
+	for (size_t i = 0; i < BD_QUEUE_DEPTH; i++)
+		list_append(&srv->reqs[i].lreqs, &srv->reqfree);
+
 	return srv;
 }
 
@@ -271,7 +577,10 @@ errno_t bd_conn(ipc_call_t *icall, bd_srvs_t *srvs)
 
 		switch (method) {
 		case BD_READ_BLOCKS:
-			bd_read_blocks_srv(srv, &call);
+			if (srvs->ops->fwd_begin != NULL)
+				bd_fwd_blocks_srv(srv, &call);
+			else
+				bd_read_blocks_srv(srv, &call);
 			break;
 		case BD_READ_TOC:
 			bd_read_toc_srv(srv, &call);
@@ -280,7 +589,10 @@ errno_t bd_conn(ipc_call_t *icall, bd_srvs_t *srvs)
 			bd_sync_cache_srv(srv, &call);
 			break;
 		case BD_WRITE_BLOCKS:
-			bd_write_blocks_srv(srv, &call);
+			if (srvs->ops->fwd_begin != NULL)
+				bd_fwd_blocks_srv(srv, &call);
+			else
+				bd_write_blocks_srv(srv, &call);
 			break;
 		case BD_GET_BLOCK_SIZE:
 			bd_get_block_size_srv(srv, &call);
@@ -291,11 +603,19 @@ errno_t bd_conn(ipc_call_t *icall, bd_srvs_t *srvs)
 		case BD_EJECT:
 			bd_eject_srv(srv, &call);
 			break;
+		case BD_SHARE_BUFFER:
+			bd_share_buffer_srv(srv, &call);
+			break;
+		case BD_SUBMIT:
+			bd_submit_srv(srv, &call);
+			break;
 		default:
 			async_answer_0(&call, EINVAL);
 		}
 	}
 
+	bd_srv_shutdown(srv);
+
 	rc = srvs->ops->close(srv);
 	free(srv);
 
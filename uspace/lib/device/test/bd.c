@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <async.h>
+#include <bd.h>
+#include <bd_srv.h>
+#include <errno.h>
+#include <loc.h>
+#include <mem.h>
+#include <pcut/pcut.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(bd);
+
+static const char *test_bd_server = "test-bd";
+static const char *test_bd_svc = "test/bd";
+
+#define TEST_BSIZE 512
+#define TEST_NBLOCKS 16
+
+static void test_bd_conn(ipc_call_t *, void *);
+
+static errno_t test_bd_open(bd_srvs_t *, bd_srv_t *);
+static errno_t test_bd_close(bd_srv_t *);
+static errno_t test_bd_read_blocks(bd_srv_t *, aoff64_t, size_t, void *,
+    size_t);
+static errno_t test_bd_write_blocks(bd_srv_t *, aoff64_t, size_t,
+    const void *, size_t);
+static errno_t test_bd_get_block_size(bd_srv_t *, size_t *);
+static errno_t test_bd_get_num_blocks(bd_srv_t *, aoff64_t *);
+static errno_t test_bd_fwd_begin(bd_srv_t *, aoff64_t, size_t,
+    async_sess_t **, aoff64_t *);
+static void test_bd_fwd_end(bd_srv_t *);
+
+static bd_ops_t test_bd_ops = {
+	.open = test_bd_open,
+	.close = test_bd_close,
+	.read_blocks = test_bd_read_blocks,
+	.write_blocks = test_bd_write_blocks,
+	.get_block_size = test_bd_get_block_size,
+	.get_num_blocks = test_bd_get_num_blocks
+};
+
+/** Test block device backed by memory */
+typedef struct {
+	bd_srvs_t srvs;
+	size_t bsize;
+	uint8_t data[TEST_NBLOCKS * TEST_BSIZE];
+} test_bd_t;
+
+static test_bd_t test_bd;
+
+/** Register test block device service and connect to it. */
+static void test_bd_setup(loc_srv_t **rsrv, service_id_t *rsid, bd_t **rbd)
+{
+	async_sess_t *sess;
+	errno_t rc;
+
+	bd_srvs_init(&test_bd.srvs);
+	test_bd.srvs.ops = &test_bd_ops;
+	test_bd.srvs.sarg = &test_bd;
+	test_bd.bsize = TEST_BSIZE;
+	memset(test_bd.data, 0, sizeof(test_bd.data));
+
+	async_set_fallback_port_handler(test_bd_conn, &test_bd);
+
+	// FIXME This causes this test to be non-reentrant!
+	rc = loc_server_register(test_bd_server, rsrv);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = loc_service_register(*rsrv, test_bd_svc, fallback_port_id, rsid);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	sess = loc_service_connect(*rsid, INTERFACE_BLOCK, 0);
+	PCUT_ASSERT_NOT_NULL(sess);
+
+	rc = bd_open(sess, rbd);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+}
+
+static void test_bd_teardown(loc_srv_t *srv, service_id_t sid, bd_t *bd)
+{
+	async_sess_t *sess = bd->sess;
+	errno_t rc;
+
+	bd_close(bd);
+	async_hangup(sess);
+
+	rc = loc_service_unregister(srv, sid);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	loc_server_unregister(srv);
+}
+
+/** Shared buffer write and read requests complete with correct data */
+PCUT_TEST(submit_write_read)
+{
+	loc_srv_t *srv;
+	service_id_t sid;
+	bd_t *bd;
+	uint8_t *buf;
+	bd_req_t reqs[2];
+	bd_compl_t compl[2];
+	size_t ncompl;
+	size_t i;
+	errno_t rc;
+
+	test_bd_setup(&srv, &sid, &bd);
+
+	rc = bd_share_buffer(bd, 4 * TEST_BSIZE, (void **) &buf);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	memset(buf, 0x5a, 2 * TEST_BSIZE);
+
+	reqs[0].tag = 1;
+	reqs[0].op = bdr_write;
+	reqs[0].ba = 3;
+	reqs[0].cnt = 2;
+	reqs[0].offset = 0;
+
+	rc = bd_submit(bd, reqs, 1);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = bd_reap(bd, compl, 2, true, &ncompl);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_INT_EQUALS(1, ncompl);
+	PCUT_ASSERT_INT_EQUALS(1, compl[0].tag);
+	PCUT_ASSERT_ERRNO_VAL(EOK, compl[0].rc);
+
+	PCUT_ASSERT_INT_EQUALS(0, test_bd.data[3 * TEST_BSIZE - 1]);
+	PCUT_ASSERT_INT_EQUALS(0x5a, test_bd.data[3 * TEST_BSIZE]);
+	PCUT_ASSERT_INT_EQUALS(0x5a, test_bd.data[5 * TEST_BSIZE - 1]);
+	PCUT_ASSERT_INT_EQUALS(0, test_bd.data[5 * TEST_BSIZE]);
+
+	/* Read back the written blocks in two requests */
+	memset(buf, 0, 4 * TEST_BSIZE);
+
+	reqs[0].tag = 2;
+	reqs[0].op = bdr_read;
+	reqs[0].ba = 3;
+	reqs[0].cnt = 1;
+	reqs[0].offset = 2 * TEST_BSIZE;
+
+	reqs[1].tag = 3;
+	reqs[1].op = bdr_read;
+	reqs[1].ba = 4;
+	reqs[1].cnt = 1;
+	reqs[1].offset = 3 * TEST_BSIZE;
+
+	rc = bd_submit(bd, reqs, 2);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	ncompl = 0;
+	while (ncompl < 2) {
+		size_t n;
+
+		rc = bd_reap(bd, compl + ncompl, 2 - ncompl, true, &n);
+		PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+		ncompl += n;
+	}
+
+	for (i = 0; i < 2; i++) {
+		PCUT_ASSERT_TRUE(compl[i].tag == 2 || compl[i].tag == 3);
+		PCUT_ASSERT_ERRNO_VAL(EOK, compl[i].rc);
+	}
+
+	PCUT_ASSERT_INT_EQUALS(0, buf[2 * TEST_BSIZE - 1]);
+	for (i = 2 * TEST_BSIZE; i < 4 * TEST_BSIZE; i++)
+		PCUT_ASSERT_INT_EQUALS(0x5a, buf[i]);
+
+	test_bd_teardown(srv, sid, bd);
+}
+
+/** Requests not fitting in the shared buffer are rejected */
+PCUT_TEST(submit_out_of_range)
+{
+	loc_srv_t *srv;
+	service_id_t sid;
+	bd_t *bd;
+	void *buf;
+	bd_req_t req;
+	errno_t rc;
+
+	test_bd_setup(&srv, &sid, &bd);
+
+	rc = bd_share_buffer(bd, 2 * TEST_BSIZE, &buf);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	req.tag = 1;
+	req.op = bdr_read;
+	req.ba = 0;
+	req.cnt = 2;
+	req.offset = TEST_BSIZE;
+
+	rc = bd_submit(bd, &req, 1);
+	PCUT_ASSERT_ERRNO_VAL(EINVAL, rc);
+
+	test_bd_teardown(srv, sid, bd);
+}
+
+/** Requests are rejected if the server reports zero block size */
+PCUT_TEST(submit_zero_bsize)
+{
+	loc_srv_t *srv;
+	service_id_t sid;
+	bd_t *bd;
+	void *buf;
+	bd_req_t req;
+	errno_t rc;
+
+	test_bd_setup(&srv, &sid, &bd);
+	test_bd.bsize = 0;
+
+	rc = bd_share_buffer(bd, 2 * TEST_BSIZE, &buf);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	req.tag = 1;
+	req.op = bdr_read;
+	req.ba = 0;
+	req.cnt = 1;
+	req.offset = 0;
+
+	rc = bd_submit(bd, &req, 1);
+	PCUT_ASSERT_ERRNO_VAL(EIO, rc);
+
+	test_bd_teardown(srv, sid, bd);
+}
+
+/** Forwarding server does not accept a shared buffer */
+PCUT_TEST(share_buffer_fwd)
+{
+	loc_srv_t *srv;
+	service_id_t sid;
+	bd_t *bd;
+	void *buf;
+	errno_t rc;
+
+	test_bd_setup(&srv, &sid, &bd);
+	test_bd_ops.fwd_begin = test_bd_fwd_begin;
+	test_bd_ops.fwd_end = test_bd_fwd_end;
+
+	rc = bd_share_buffer(bd, 2 * TEST_BSIZE, &buf);
+	PCUT_ASSERT_ERRNO_VAL(ENOTSUP, rc);
+
+	test_bd_ops.fwd_begin = NULL;
+	test_bd_ops.fwd_end = NULL;
+	test_bd_teardown(srv, sid, bd);
+}
+
+static void test_bd_conn(ipc_call_t *icall, void *arg)
+{
+	test_bd_t *tbd = (test_bd_t *) arg;
+
+	(void) bd_conn(icall, &tbd->srvs);
+}
+
+static errno_t test_bd_open(bd_srvs_t *srvs, bd_srv_t *srv)
+{
+	return EOK;
+}
+
+static errno_t test_bd_close(bd_srv_t *srv)
+{
+	return EOK;
+}
+
+static errno_t test_bd_read_blocks(bd_srv_t *srv, aoff64_t ba, size_t cnt,
+    void *buf, size_t size)
+{
+	test_bd_t *tbd = (test_bd_t *) srv->srvs->sarg;
+
+	if (ba + cnt > TEST_NBLOCKS || size < cnt * TEST_BSIZE)
+		return EINVAL;
+
+	memcpy(buf, tbd->data + ba * TEST_BSIZE, cnt * TEST_BSIZE);
+	return EOK;
+}
+
+static errno_t test_bd_write_blocks(bd_srv_t *srv, aoff64_t ba, size_t cnt,
+    const void *buf, size_t size)
+{
+	test_bd_t *tbd = (test_bd_t *) srv->srvs->sarg;
+
+	if (ba + cnt > TEST_NBLOCKS || size < cnt * TEST_BSIZE)
+		return EINVAL;
+
+	memcpy(tbd->data + ba * TEST_BSIZE, buf, cnt * TEST_BSIZE);
+	return EOK;
+}
+
+static errno_t test_bd_get_block_size(bd_srv_t *srv, size_t *rsize)
+{
+	test_bd_t *tbd = (test_bd_t *) srv->srvs->sarg;
+
+	*rsize = tbd->bsize;
+	return EOK;
+}
+
+static errno_t test_bd_get_num_blocks(bd_srv_t *srv, aoff64_t *rnb)
+{
+	*rnb = TEST_NBLOCKS;
+	return EOK;
+}
+
+static errno_t test_bd_fwd_begin(bd_srv_t *srv, aoff64_t ba, size_t cnt,
+    async_sess_t **rsess, aoff64_t *rba)
+{
+	return ENOTSUP;
+}
+
+static void test_bd_fwd_end(bd_srv_t *srv)
+{
+}
+
+PCUT_EXPORT(bd);
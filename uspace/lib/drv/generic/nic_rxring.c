@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libdrv
+ * @{
+ */
+/** @file Shared receive ring between a NIC driver and its client.
+ *
+ * The client allocates an area holding a pool of frame buffers and two
+ * single-producer single-consumer queues of buffer indices and shares it
+ * with the driver. The driver takes a buffer from the free queue, fills
+ * it with a received frame and puts its index on the rx queue. The client
+ * processes frames from the rx queue and hands the buffers back through
+ * the free queue. Neither side blocks or takes a lock on the other side.
+ *
+ * The driver notifies the client (NIC_EV_RXRING) only if the client set
+ * need_notify before it went to sleep, so a burst of frames costs a single
+ * message. Both sides use a full barrier between updating the queue and
+ * checking need_notify (or the queue, respectively) so that a frame cannot
+ * be left in the queue with the client asleep.
+ *
+ * Indices read from the other side are masked and sizes clamped, so a
+ * misbehaving peer cannot make us access memory outside the area.
+ */
+
+#include <align.h>
+#include <as.h>
+#include <assert.h>
+#include <errno.h>
+#include <mem.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "nic_rxring.h"
+
+#define NIC_RXRING_MASK (NIC_RXRING_SLOTS - 1)
+
+/** Offset of the frame buffers in the shared area */
+#define NIC_RXRING_FRAMES_OFFSET \
+	ALIGN_UP(sizeof(nic_rxring_hdr_t), (size_t) NIC_RXRING_FRAME_SIZE)
+
+static_assert((NIC_RXRING_SLOTS & NIC_RXRING_MASK) == 0,
+    "NIC_RXRING_SLOTS must be a power of two");
+
+/** Append entry to queue (producer side).
+ *
+ * @param q Queue
+ * @param value Entry value
+ * @return @c true on success, @c false if the queue is full
+ */
+static bool nic_rxring_queue_push(nic_rxring_queue_t *q, uint32_t value)
+{
+	uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+	uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+	if (head - tail >= NIC_RXRING_SLOTS)
+		return false;
+
+	q->entry[head & NIC_RXRING_MASK] = value;
+	atomic_store_explicit(&q->head, head + 1, memory_order_release);
+	return true;
+}
+
+/** Remove entry from queue (consumer side).
+ *
+ * @param q Queue
+ * @param value Place to store the entry value
+ * @return @c true on success, @c false if the queue is empty
+ */
+static bool nic_rxring_queue_pop(nic_rxring_queue_t *q, uint32_t *value)
+{
+	uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+	if (head == tail)
+		return false;
+
+	*value = q->entry[tail & NIC_RXRING_MASK] & NIC_RXRING_MASK;
+	atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+	return true;
+}
+
+static nic_rxring_t *nic_rxring_new(void *area, size_t size)
+{
+	nic_rxring_t *ring = calloc(1, sizeof(nic_rxring_t));
+	if (ring == NULL)
+		return NULL;
+
+	ring->hdr = (nic_rxring_hdr_t *) area;
+	ring->frames = (uint8_t *) area + NIC_RXRING_FRAMES_OFFSET;
+	ring->size = size;
+	return ring;
+}
+
+/** Get size of the shared area.
+ *
+ * @return Size of the area in bytes
+ */
+size_t nic_rxring_area_size(void)
+{
+	return NIC_RXRING_FRAMES_OFFSET +
+	    (size_t) NIC_RXRING_SLOTS * NIC_RXRING_FRAME_SIZE;
+}
+
+/** Create receive ring (client side).
+ *
+ * Allocates the shared area and places all frame buffers in the free
+ * queue. The area can then be shared with the driver using
+ * nic_rxring_set().
+ *
+ * @param rring Place to store pointer to the new ring
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t nic_rxring_create(nic_rxring_t **rring)
+{
+	nic_rxring_t *ring;
+	size_t size;
+	void *area;
+	uint32_t i;
+
+	size = nic_rxring_area_size();
+	area = as_area_create(AS_AREA_ANY, size,
+	    AS_AREA_READ | AS_AREA_WRITE | AS_AREA_CACHEABLE, AS_AREA_UNPAGED);
+	if (area == AS_MAP_FAILED)
+		return ENOMEM;
+
+	ring = nic_rxring_new(area, size);
+	if (ring == NULL) {
+		as_area_destroy(area);
+		return ENOMEM;
+	}
+
+	memset(ring->hdr, 0, sizeof(nic_rxring_hdr_t));
+	for (i = 0; i < NIC_RXRING_SLOTS; i++)
+		ring->hdr->free.entry[i] = i;
+	atomic_store(&ring->hdr->free.head, NIC_RXRING_SLOTS);
+	atomic_store(&ring->hdr->need_notify, 1);
+
+	*rring = ring;
+	return EOK;
+}
+
+/** Attach to receive ring shared by the client (driver side).
+ *
+ * On success the ring takes over the area and destroys it in
+ * nic_rxring_destroy().
+ *
+ * @param area Shared area
+ * @param size Size of the shared area
+ * @param rring Place to store pointer to the new ring
+ * @return EOK on success, EINVAL if the area is too small, ENOMEM
+ *         if out of memory
+ */
+errno_t nic_rxring_attach(void *area, size_t size, nic_rxring_t **rring)
+{
+	nic_rxring_t *ring;
+
+	if (size < nic_rxring_area_size())
+		return EINVAL;
+
+	ring = nic_rxring_new(area, size);
+	if (ring == NULL)
+		return ENOMEM;
+
+	*rring = ring;
+	return EOK;
+}
+
+/** Destroy receive ring and unmap the shared area.
+ *
+ * @param ring Receive ring
+ */
+void nic_rxring_destroy(nic_rxring_t *ring)
+{
+	as_area_destroy(ring->hdr);
+	free(ring);
+}
+
+/** Put received frame into the ring (driver side).
+ *
+ * @param ring Receive ring
+ * @param data Frame data
+ * @param size Frame size in bytes
+ * @param notify Place to store @c true if the client must be notified
+ * @return EOK on success, ELIMIT if the frame does not fit into a buffer,
+ *         ENOMEM if no free buffer is available
+ */
+errno_t nic_rxring_put(nic_rxring_t *ring, const void *data, size_t size,
+    bool *notify)
+{
+	nic_rxring_hdr_t *hdr = ring->hdr;
+	uint32_t idx;
+
+	if (size > NIC_RXRING_FRAME_SIZE)
+		return ELIMIT;
+
+	if (!nic_rxring_queue_pop(&hdr->free, &idx))
+		return ENOMEM;
+
+	memcpy(ring->frames + (size_t) idx * NIC_RXRING_FRAME_SIZE, data,
+	    size);
+	hdr->size[idx] = size;
+
+	/*
+	 * There are only as many buffers as there are rx queue entries,
+	 * so this can only fail if the client returns bogus indices.
+	 */
+	if (!nic_rxring_queue_push(&hdr->rx, idx))
+		return ENOMEM;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	*notify = atomic_exchange(&hdr->need_notify, 0) != 0;
+	return EOK;
+}
+
+/** Get next received frame from the ring (client side).
+ *
+ * The frame buffer must be returned using nic_rxring_release() once
+ * the frame has been processed.
+ *
+ * @param ring Receive ring
+ * @param ridx Place to store the frame buffer index
+ * @param rdata Place to store pointer to the frame data
+ * @param rsize Place to store the frame size
+ * @return @c true if a frame was returned, @c false if the ring is empty
+ */
+bool nic_rxring_get(nic_rxring_t *ring, uint32_t *ridx, void **rdata,
+    size_t *rsize)
+{
+	uint32_t idx;
+	size_t size;
+
+	if (!nic_rxring_queue_pop(&ring->hdr->rx, &idx))
+		return false;
+
+	size = ring->hdr->size[idx];
+	if (size > NIC_RXRING_FRAME_SIZE)
+		size = NIC_RXRING_FRAME_SIZE;
+
+	*ridx = idx;
+	*rdata = ring->frames + (size_t) idx * NIC_RXRING_FRAME_SIZE;
+	*rsize = size;
+	return true;
+}
+
+/** Return frame buffer to the driver (client side).
+ *
+ * @param ring Receive ring
+ * @param idx Frame buffer index returned by nic_rxring_get()
+ */
+void nic_rxring_release(nic_rxring_t *ring, uint32_t idx)
+{
+	/* Cannot fail, each buffer is either queued or held by us */
+	(void) nic_rxring_queue_push(&ring->hdr->free, idx);
+}
+
+/** Ask for notification before going to sleep (client side).
+ *
+ * @param ring Receive ring
+ * @return @c true if the ring is empty and the client can wait for
+ *         NIC_EV_RXRING, @c false if more frames arrived meanwhile
+ */
+bool nic_rxring_arm(nic_rxring_t *ring)
+{
+	nic_rxring_queue_t *rx = &ring->hdr->rx;
+
+	atomic_store(&ring->hdr->need_notify, 1);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	return atomic_load_explicit(&rx->head, memory_order_acquire) ==
+	    atomic_load_explicit(&rx->tail, memory_order_relaxed);
+}
+
+/** @}
+ */
@@ -34,6 +34,7 @@
  * @brief Driver-side RPC skeletons for DDF NIC interface
  */
 
+#include <as.h>
 #include <assert.h>
 #include <async.h>
 #include <errno.h>
@@ -85,7 +86,8 @@ typedef enum {
 	NIC_OFFLOAD_SET,
 	NIC_POLL_GET_MODE,
 	NIC_POLL_SET_MODE,
-	NIC_POLL_NOW
+	NIC_POLL_NOW,
+	NIC_RXRING_SET
 } nic_funcs_t;
 
 /** Send frame from NIC
@@ -1244,7 +1246,7 @@ errno_t nic_offload_set(async_sess_t *dev_sess, uint32_t mask, uint32_t active)
 {
 	async_exch_t *exch = async_exchange_begin(dev_sess);
 	errno_t rc = async_req_3_0(exch, DEV_IFACE_ID(NIC_DEV_IFACE),
-	    NIC_AUTONEG_RESTART, (sysarg_t) mask, (sysarg_t) active);
+	    NIC_OFFLOAD_SET, (sysarg_t) mask, (sysarg_t) active);
 	async_exchange_end(exch);
 
 	return rc;
@@ -1335,6 +1337,40 @@ errno_t nic_poll_now(async_sess_t *dev_sess)
 	return rc;
 }
 
+/** Share receive ring with the NIC
+ *
+ * Received frames are then placed into the ring and announced by
+ * NIC_EV_RXRING instead of being sent by NIC_EV_RECEIVED one by one.
+ * The callback connection must already exist.
+ *
+ * @param[in] dev_sess
+ * @param[in] ring     Receive ring created by nic_rxring_create()
+ *
+ * @return EOK If the operation was successfully completed
+ * @return ENOTSUP If the NIC does not support receive rings
+ *
+ */
+errno_t nic_rxring_set(async_sess_t *dev_sess, nic_rxring_t *ring)
+{
+	async_exch_t *exch = async_exchange_begin(dev_sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_1(exch, DEV_IFACE_ID(NIC_DEV_IFACE),
+	    NIC_RXRING_SET, &answer);
+	errno_t rc = async_share_out_start(exch, ring->hdr,
+	    AS_AREA_READ | AS_AREA_WRITE | AS_AREA_CACHEABLE);
+	async_exchange_end(exch);
+
+	if (rc != EOK) {
+		async_forget(req);
+		return rc;
+	}
+
+	errno_t retval;
+	async_wait_for(req, &retval);
+	return retval;
+}
+
 static void remote_nic_send_frame(ddf_fun_t *dev, void *iface,
     ipc_call_t *call)
 {
@@ -2485,6 +2521,48 @@ static void remote_nic_poll_now(ddf_fun_t *dev, void *iface,
 	async_answer_0(call, rc);
 }
 
+static void remote_nic_rxring_set(ddf_fun_t *dev, void *iface,
+    ipc_call_t *call)
+{
+	nic_iface_t *nic_iface = (nic_iface_t *) iface;
+	ipc_call_t scall;
+	size_t size;
+	unsigned int flags;
+	void *area;
+
+	if (!async_share_out_receive(&scall, &size, &flags)) {
+		async_answer_0(&scall, EINVAL);
+		async_answer_0(call, EINVAL);
+		return;
+	}
+
+	if (nic_iface->rxring_set == NULL) {
+		async_answer_0(&scall, ENOTSUP);
+		async_answer_0(call, ENOTSUP);
+		return;
+	}
+
+	/* The driver fills the buffers, the client returns them */
+	if ((flags & (AS_AREA_READ | AS_AREA_WRITE)) !=
+	    (AS_AREA_READ | AS_AREA_WRITE)) {
+		async_answer_0(&scall, EINVAL);
+		async_answer_0(call, EINVAL);
+		return;
+	}
+
+	errno_t rc = async_share_out_finalize(&scall, &area);
+	if (rc != EOK || area == AS_MAP_FAILED) {
+		async_answer_0(call, ENOMEM);
+		return;
+	}
+
+	rc = nic_iface->rxring_set(dev, area, size);
+	if (rc != EOK)
+		as_area_destroy(area);
+
+	async_answer_0(call, rc);
+}
+
 /** Remote NIC interface operations.
  *
  */
@@ -2529,7 +2607,8 @@ static const remote_iface_func_ptr_t remote_nic_iface_ops[] = {
 	[NIC_OFFLOAD_SET] = remote_nic_offload_set,
 	[NIC_POLL_GET_MODE] = remote_nic_poll_get_mode,
 	[NIC_POLL_SET_MODE] = remote_nic_poll_set_mode,
-	[NIC_POLL_NOW] = remote_nic_poll_now
+	[NIC_POLL_NOW] = remote_nic_poll_now,
+	[NIC_RXRING_SET] = remote_nic_rxring_set
 };
 
 /** Remote NIC interface structure.
@@ -38,11 +38,13 @@
 #include <async.h>
 #include <nic/nic.h>
 #include <ipc/common.h>
+#include "nic_rxring.h"
 
 typedef enum {
 	NIC_EV_ADDR_CHANGED = IPC_FIRST_USER_METHOD,
 	NIC_EV_RECEIVED,
-	NIC_EV_DEVICE_STATE
+	NIC_EV_DEVICE_STATE,
+	NIC_EV_RXRING
 } nic_event_t;
 
 extern errno_t nic_send_frame(async_sess_t *, void *, size_t);
@@ -109,6 +111,8 @@ extern errno_t nic_poll_set_mode(async_sess_t *, nic_poll_mode_t,
     const struct timespec *);
 extern errno_t nic_poll_now(async_sess_t *);
 
+extern errno_t nic_rxring_set(async_sess_t *, nic_rxring_t *);
+
 #endif
 
 /** @}
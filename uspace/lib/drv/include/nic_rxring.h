@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libdrv
+ * @{
+ */
+/** @file Shared receive ring between a NIC driver and its client.
+ */
+
+#ifndef LIBDRV_NIC_RXRING_H_
+#define LIBDRV_NIC_RXRING_H_
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Number of frame buffers in the ring, a power of two */
+#define NIC_RXRING_SLOTS 256
+/** Size of one frame buffer, large enough for a VLAN-tagged frame */
+#define NIC_RXRING_FRAME_SIZE 2048
+/** Assumed cache line size, used to keep producer and consumer data apart */
+#define NIC_RXRING_CACHE_LINE 64
+
+/** Single-producer single-consumer queue of frame buffer indices.
+ *
+ * Only the producer writes @c head and the entries, only the consumer
+ * writes @c tail.
+ */
+typedef struct {
+	/** Position of the next entry to produce */
+	_Atomic(uint32_t) head;
+	uint8_t pad0[NIC_RXRING_CACHE_LINE - sizeof(uint32_t)];
+	/** Position of the next entry to consume */
+	_Atomic(uint32_t) tail;
+	uint8_t pad1[NIC_RXRING_CACHE_LINE - sizeof(uint32_t)];
+	/** Frame buffer indices */
+	uint32_t entry[NIC_RXRING_SLOTS];
+} nic_rxring_queue_t;
+
+/** Header at the start of the shared area, followed by the frame buffers */
+typedef struct {
+	/** Received frames, produced by the driver */
+	nic_rxring_queue_t rx;
+	/** Buffers handed back by the client, produced by the client */
+	nic_rxring_queue_t free;
+	/** Client is waiting for a notification (NIC_EV_RXRING) */
+	_Atomic(uint32_t) need_notify;
+	/** Frame sizes, indexed by frame buffer */
+	uint32_t size[NIC_RXRING_SLOTS];
+} nic_rxring_hdr_t;
+
+/** Shared receive ring, as mapped in one task */
+typedef struct {
+	/** Start of the shared area */
+	nic_rxring_hdr_t *hdr;
+	/** Frame buffers */
+	uint8_t *frames;
+	/** Size of the shared area */
+	size_t size;
+} nic_rxring_t;
+
+extern errno_t nic_rxring_create(nic_rxring_t **);
+extern errno_t nic_rxring_attach(void *, size_t, nic_rxring_t **);
+extern void nic_rxring_destroy(nic_rxring_t *);
+extern size_t nic_rxring_area_size(void);
+
+extern errno_t nic_rxring_put(nic_rxring_t *, const void *, size_t, bool *);
+
+extern bool nic_rxring_get(nic_rxring_t *, uint32_t *, void **, size_t *);
+extern void nic_rxring_release(nic_rxring_t *, uint32_t);
+extern bool nic_rxring_arm(nic_rxring_t *);
+
+#endif
+
+/** @}
+ */
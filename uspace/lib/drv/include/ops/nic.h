@@ -107,6 +107,8 @@ typedef struct nic_iface {
 	errno_t (*poll_set_mode)(ddf_fun_t *, nic_poll_mode_t,
 	    const struct timespec *);
 	errno_t (*poll_now)(ddf_fun_t *);
+
+	errno_t (*rxring_set)(ddf_fun_t *, void *, size_t);
 } nic_iface_t;
 
 #endif
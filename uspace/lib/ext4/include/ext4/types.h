@@ -35,7 +35,10 @@
 #ifndef LIBEXT4_TYPES_H_
 #define LIBEXT4_TYPES_H_
 
+#include <adt/list.h>
+#include <adt/odict.h>
 #include <block.h>
+#include <fibril_synch.h>
 
 /*
  * Structure of the super block
@@ -227,9 +230,53 @@ typedef struct ext4_superblock {
 	EXT4_FEATURE_RO_COMPAT_GDT_CSUM | \
 	EXT4_FEATURE_RO_COMPAT_EXTRA_ISIZE)
 
+/*
+ * In-memory allocation summary of a block group
+ *
+ * The summary only holds lower bounds, so it starts out empty and is
+ * tightened by the searches done by the allocators.
+ */
+typedef struct ext4_bg_summary {
+	fibril_mutex_t lock;        /* Serializes allocation in the group */
+	uint32_t first_free_block;  /* No free block below this index */
+	uint32_t first_free_byte;   /* No eight free blocks in a row below */
+	uint32_t first_free_inode;  /* No free i-node below this index */
+} ext4_bg_summary_t;
+
+/*
+ * Status of a cached run of logical blocks
+ */
+typedef enum {
+	EXT4_EXTENT_STATUS_MAPPED,     /* Blocks are mapped to disk */
+	EXT4_EXTENT_STATUS_UNWRITTEN,  /* Blocks are allocated, read as zeros */
+	EXT4_EXTENT_STATUS_HOLE        /* Blocks are not allocated */
+} ext4_extent_status_type_t;
+
+typedef struct ext4_extent_status_key {
+	uint32_t inode;             /* I-node number */
+	uint32_t first;             /* First logical block of the run */
+} ext4_extent_status_key_t;
+
+/*
+ * Cached run of logical blocks of an i-node
+ */
+typedef struct ext4_extent_status {
+	odlink_t lcache;            /* Link to ext4_filesystem_t.extent_cache */
+	link_t llru;                /* Link to ext4_filesystem_t.extent_lru */
+	ext4_extent_status_key_t key;
+	uint32_t count;             /* Number of blocks in the run */
+	uint64_t start;             /* First physical block, unless a hole */
+	ext4_extent_status_type_t type;
+} ext4_extent_status_t;
+
 typedef struct ext4_filesystem {
 	service_id_t device;
 	ext4_superblock_t *superblock;
+	ext4_bg_summary_t *bg_summary;
+	fibril_mutex_t extent_cache_lock;
+	odict_t extent_cache;       /* Cached runs ordered by i-node and block */
+	list_t extent_lru;          /* Cached runs, least recently used first */
+	size_t extent_cache_count;
 	aoff64_t inode_block_limits[4];
 	aoff64_t inode_blocks_per_level[4];
 } ext4_filesystem_t;
@@ -537,6 +584,12 @@ typedef struct ext4_extent_path {
 
 #define EXT4_EXTENT_MAGIC  0xF30A
 
+/* Longer extents are unwritten, their length is stored offset by this */
+#define EXT4_EXTENT_INIT_MAX_LEN  32768
+
+/* Maximum number of runs in the extent status cache of a filesystem */
+#define EXT4_EXTENT_CACHE_MAX  2048
+
 #define	EXT4_EXTENT_FIRST(header) \
 	((ext4_extent_t *) (((void *) (header)) + sizeof(ext4_extent_header_t)))
 
@@ -36,6 +36,8 @@
  */
 
 #include <errno.h>
+#include <fibril_synch.h>
+#include <macros.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "ext4/balloc.h"
@@ -46,6 +48,22 @@
 #include "ext4/superblock.h"
 #include "ext4/types.h"
 
+/** Record released blocks in the allocation summary of their block group.
+ *
+ * @param summary Allocation summary of the block group, must be locked
+ * @param index   Index of the first released block in the group
+ *
+ */
+static void ext4_balloc_summary_release(ext4_bg_summary_t *summary,
+    uint32_t index)
+{
+	if (index < summary->first_free_block)
+		summary->first_free_block = index;
+
+	if ((index & ~7) < summary->first_free_byte)
+		summary->first_free_byte = index & ~7;
+}
+
 /** Free block.
  *
  * @param inode_ref  Inode, where the block is allocated
@@ -70,12 +88,16 @@ errno_t ext4_balloc_free_block(ext4_inode_ref_t *inode_ref, uint32_t block_addr)
 	if (rc != EOK)
 		return rc;
 
+	ext4_bg_summary_t *summary = &fs->bg_summary[block_group];
+	fibril_mutex_lock(&summary->lock);
+
 	/* Load block with bitmap */
 	uint32_t bitmap_block_addr =
 	    ext4_block_group_get_block_bitmap(bg_ref->block_group, sb);
 	block_t *bitmap_block;
 	rc = block_get(&bitmap_block, fs->device, bitmap_block_addr, 0);
 	if (rc != EOK) {
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
@@ -83,15 +105,27 @@ errno_t ext4_balloc_free_block(ext4_inode_ref_t *inode_ref, uint32_t block_addr)
 	/* Modify bitmap */
 	ext4_bitmap_free_bit(bitmap_block->data, index_in_group);
 	bitmap_block->dirty = true;
+	ext4_balloc_summary_release(summary, index_in_group);
 
 	/* Release block with bitmap */
 	rc = block_put(bitmap_block);
 	if (rc != EOK) {
 		/* Error in saving bitmap */
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
 
+	/* Update block group free blocks count */
+	uint32_t free_blocks =
+	    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
+	free_blocks++;
+	ext4_block_group_set_free_blocks_count(bg_ref->block_group,
+	    sb, free_blocks);
+	bg_ref->dirty = true;
+
+	fibril_mutex_unlock(&summary->lock);
+
 	uint32_t block_size = ext4_superblock_get_block_size(sb);
 
 	/* Update superblock free blocks count */
@@ -107,14 +141,6 @@ errno_t ext4_balloc_free_block(ext4_inode_ref_t *inode_ref, uint32_t block_addr)
 	ext4_inode_set_blocks_count(sb, inode_ref->inode, ino_blocks);
 	inode_ref->dirty = true;
 
-	/* Update block group free blocks count */
-	uint32_t free_blocks =
-	    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
-	free_blocks++;
-	ext4_block_group_set_free_blocks_count(bg_ref->block_group,
-	    sb, free_blocks);
-	bg_ref->dirty = true;
-
 	/* Release block group reference */
 	return ext4_filesystem_put_block_group_ref(bg_ref);
 }
@@ -142,6 +168,9 @@ static errno_t ext4_balloc_free_blocks_internal(ext4_inode_ref_t *inode_ref,
 	uint32_t index_in_group_first =
 	    ext4_filesystem_blockaddr2_index_in_group(sb, first);
 
+	ext4_bg_summary_t *summary = &fs->bg_summary[block_group_first];
+	fibril_mutex_lock(&summary->lock);
+
 	/* Load block with bitmap */
 	uint32_t bitmap_block_addr =
 	    ext4_block_group_get_block_bitmap(bg_ref->block_group, sb);
@@ -149,6 +178,7 @@ static errno_t ext4_balloc_free_blocks_internal(ext4_inode_ref_t *inode_ref,
 	block_t *bitmap_block;
 	rc = block_get(&bitmap_block, fs->device, bitmap_block_addr, 0);
 	if (rc != EOK) {
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
@@ -156,15 +186,27 @@ static errno_t ext4_balloc_free_blocks_internal(ext4_inode_ref_t *inode_ref,
 	/* Modify bitmap */
 	ext4_bitmap_free_bits(bitmap_block->data, index_in_group_first, count);
 	bitmap_block->dirty = true;
+	ext4_balloc_summary_release(summary, index_in_group_first);
 
 	/* Release block with bitmap */
 	rc = block_put(bitmap_block);
 	if (rc != EOK) {
 		/* Error in saving bitmap */
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
 
+	/* Update block group free blocks count */
+	uint32_t free_blocks =
+	    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
+	free_blocks += count;
+	ext4_block_group_set_free_blocks_count(bg_ref->block_group,
+	    sb, free_blocks);
+	bg_ref->dirty = true;
+
+	fibril_mutex_unlock(&summary->lock);
+
 	uint32_t block_size = ext4_superblock_get_block_size(sb);
 
 	/* Update superblock free blocks count */
@@ -180,14 +222,6 @@ static errno_t ext4_balloc_free_blocks_internal(ext4_inode_ref_t *inode_ref,
 	ext4_inode_set_blocks_count(sb, inode_ref->inode, ino_blocks);
 	inode_ref->dirty = true;
 
-	/* Update block group free blocks count */
-	uint32_t free_blocks =
-	    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
-	free_blocks += count;
-	ext4_block_group_set_free_blocks_count(bg_ref->block_group,
-	    sb, free_blocks);
-	bg_ref->dirty = true;
-
 	/* Release block group reference */
 	return ext4_filesystem_put_block_group_ref(bg_ref);
 }
@@ -335,240 +369,202 @@ static errno_t ext4_balloc_find_goal(ext4_inode_ref_t *inode_ref, uint32_t *goal
 	return ext4_filesystem_put_block_group_ref(bg_ref);
 }
 
-/** Data block allocation algorithm.
+/** Allocate block in a block group.
  *
- * @param inode_ref Inode to allocate block for
- * @param fblock    Allocated block address
+ * Unless @a near is false, the block at @a start and the following blocks
+ * up to the next 64-block boundary are tried first. Then the bitmap is
+ * searched for a free byte (eight free blocks in a row) and finally for any
+ * free block. The allocation summary of the group lets both searches skip
+ * the part of the bitmap known to be used and is updated with their outcome.
  *
- * @return Error code
+ * @param fs     Filesystem
+ * @param bg_ref Block group, its allocation summary must be locked
+ * @param first  Index of the first data block in group
+ * @param start  Index in group where the search begins
+ * @param near   Try the blocks right after @a start first
+ * @param index  Output value - index of the allocated block in group
+ *
+ * @return EOK on success, ENOSPC if there is no free block from @a start
+ *         on, other error code on failure
  *
  */
-errno_t ext4_balloc_alloc_block(ext4_inode_ref_t *inode_ref, uint32_t *fblock)
+static errno_t ext4_balloc_alloc_in_group(ext4_filesystem_t *fs,
+    ext4_block_group_ref_t *bg_ref, uint32_t first, uint32_t start,
+    bool near, uint32_t *index)
 {
-	uint32_t allocated_block = 0;
-
-	uint32_t bitmap_block_addr;
-	block_t *bitmap_block;
-	uint32_t rel_block_idx = 0;
-	uint32_t free_blocks;
-	uint32_t goal;
-	uint32_t block_size;
-
-	/* Find GOAL */
-	errno_t rc = ext4_balloc_find_goal(inode_ref, &goal);
-	if (rc != EOK)
-		return rc;
-
-	ext4_superblock_t *sb = inode_ref->fs->superblock;
-
-	/* Load block group number for goal and relative index */
-	uint32_t block_group = ext4_filesystem_blockaddr2group(sb, goal);
-	uint32_t index_in_group =
-	    ext4_filesystem_blockaddr2_index_in_group(sb, goal);
-
-	/* Load block group reference */
-	ext4_block_group_ref_t *bg_ref;
-	rc = ext4_filesystem_get_block_group_ref(inode_ref->fs,
-	    block_group, &bg_ref);
-	if (rc != EOK)
-		return rc;
-
-	free_blocks =
-	    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
-	if (free_blocks == 0) {
-		/* This group has no free blocks */
-		goto goal_failed;
-	}
-
-	/* Compute indexes */
-	uint32_t first_in_group =
-	    ext4_balloc_get_first_data_block_in_group(sb, bg_ref);
-
-	uint32_t first_in_group_index =
-	    ext4_filesystem_blockaddr2_index_in_group(sb, first_in_group);
+	ext4_superblock_t *sb = fs->superblock;
+	ext4_bg_summary_t *summary = &fs->bg_summary[bg_ref->index];
+	uint32_t blocks_in_group =
+	    ext4_superblock_get_blocks_in_group(sb, bg_ref->index);
+	uint32_t idx;
 
-	if (index_in_group < first_in_group_index)
-		index_in_group = first_in_group_index;
+	/* There are no free data blocks below the first one */
+	uint32_t free_byte = max(summary->first_free_byte, first);
+	uint32_t free_block = max(summary->first_free_block, first);
 
 	/* Load block with bitmap */
-	bitmap_block_addr =
+	uint32_t bitmap_block_addr =
 	    ext4_block_group_get_block_bitmap(bg_ref->block_group, sb);
 
-	rc = block_get(&bitmap_block, inode_ref->fs->device,
-	    bitmap_block_addr, BLOCK_FLAGS_NONE);
-	if (rc != EOK) {
-		ext4_filesystem_put_block_group_ref(bg_ref);
+	block_t *bitmap_block;
+	errno_t rc = block_get(&bitmap_block, fs->device, bitmap_block_addr,
+	    BLOCK_FLAGS_NONE);
+	if (rc != EOK)
 		return rc;
-	}
 
-	/* Check if goal is free */
-	if (ext4_bitmap_is_free_bit(bitmap_block->data, index_in_group)) {
-		ext4_bitmap_set_bit(bitmap_block->data, index_in_group);
-		bitmap_block->dirty = true;
-		rc = block_put(bitmap_block);
-		if (rc != EOK) {
-			ext4_filesystem_put_block_group_ref(bg_ref);
-			return rc;
+	uint8_t *bitmap = bitmap_block->data;
+
+	if (near) {
+		/* Check if goal is free */
+		if ((start < blocks_in_group) &&
+		    (ext4_bitmap_is_free_bit(bitmap, start))) {
+			ext4_bitmap_set_bit(bitmap, start);
+			idx = start;
+			goto found;
 		}
 
-		allocated_block =
-		    ext4_filesystem_index_in_group2blockaddr(sb, index_in_group,
-		    block_group);
+		uint32_t end_idx = (start + 63) & ~63;
+		if (end_idx > blocks_in_group)
+			end_idx = blocks_in_group;
 
-		goto success;
+		/* Try to find free block near to goal */
+		for (idx = start + 1; idx < end_idx; ++idx) {
+			if (ext4_bitmap_is_free_bit(bitmap, idx)) {
+				ext4_bitmap_set_bit(bitmap, idx);
+				goto found;
+			}
+		}
 	}
 
-	uint32_t blocks_in_group =
-	    ext4_superblock_get_blocks_in_group(sb, block_group);
-
-	uint32_t end_idx = (index_in_group + 63) & ~63;
-	if (end_idx > blocks_in_group)
-		end_idx = blocks_in_group;
-
-	/* Try to find free block near to goal */
-	for (uint32_t tmp_idx = index_in_group + 1; tmp_idx < end_idx;
-	    ++tmp_idx) {
-		if (ext4_bitmap_is_free_bit(bitmap_block->data, tmp_idx)) {
-			ext4_bitmap_set_bit(bitmap_block->data, tmp_idx);
-			bitmap_block->dirty = true;
-			rc = block_put(bitmap_block);
-			if (rc != EOK)
-				return rc;
-
-			allocated_block =
-			    ext4_filesystem_index_in_group2blockaddr(sb, tmp_idx,
-			    block_group);
-
-			goto success;
-		}
+	/* Find free byte in bitmap, skipping bytes known to be used */
+	uint32_t byte_start = max(start, free_byte);
+	rc = ENOSPC;
+	if (byte_start < blocks_in_group) {
+		rc = ext4_bitmap_find_free_byte_and_set_bit(bitmap,
+		    byte_start, &idx, blocks_in_group);
 	}
 
-	/* Find free BYTE in bitmap */
-	rc = ext4_bitmap_find_free_byte_and_set_bit(bitmap_block->data,
-	    index_in_group, &rel_block_idx, blocks_in_group);
-	if (rc == EOK) {
-		bitmap_block->dirty = true;
-		rc = block_put(bitmap_block);
-		if (rc != EOK)
-			return rc;
+	if (start <= free_byte)
+		summary->first_free_byte = (rc == EOK) ? idx + 8 : blocks_in_group;
 
-		allocated_block =
-		    ext4_filesystem_index_in_group2blockaddr(sb, rel_block_idx,
-		    block_group);
+	if (rc == EOK)
+		goto found;
 
-		goto success;
+	/* Find free bit in bitmap, skipping blocks known to be used */
+	uint32_t bit_start = max(start, free_block);
+	rc = ENOSPC;
+	if (bit_start < blocks_in_group) {
+		rc = ext4_bitmap_find_free_bit_and_set(bitmap, bit_start,
+		    &idx, blocks_in_group);
 	}
 
-	/* Find free bit in bitmap */
-	rc = ext4_bitmap_find_free_bit_and_set(bitmap_block->data,
-	    index_in_group, &rel_block_idx, blocks_in_group);
-	if (rc == EOK) {
-		bitmap_block->dirty = true;
-		rc = block_put(bitmap_block);
-		if (rc != EOK)
-			return rc;
+	if (start <= free_block)
+		summary->first_free_block = (rc == EOK) ? idx + 1 : blocks_in_group;
 
-		allocated_block =
-		    ext4_filesystem_index_in_group2blockaddr(sb, rel_block_idx,
-		    block_group);
+	if (rc == EOK)
+		goto found;
 
-		goto success;
-	}
+	/* No free block found */
+	rc = block_put(bitmap_block);
+	if (rc != EOK)
+		return rc;
+
+	return ENOSPC;
 
-	/* No free block found yet */
+found:
+	if (idx == free_block)
+		summary->first_free_block = idx + 1;
+
+	bitmap_block->dirty = true;
 	rc = block_put(bitmap_block);
-	if (rc != EOK) {
-		ext4_filesystem_put_block_group_ref(bg_ref);
+	if (rc != EOK)
 		return rc;
-	}
 
-goal_failed:
+	*index = idx;
+	return EOK;
+}
 
-	rc = ext4_filesystem_put_block_group_ref(bg_ref);
+/** Data block allocation algorithm.
+ *
+ * The goal block group is searched from the goal on first. Then the other
+ * block groups and finally the goal group itself are searched from their
+ * first data block. Each block group is locked only while it is being
+ * searched, so allocations in different block groups do not contend.
+ *
+ * @param inode_ref Inode to allocate block for
+ * @param fblock    Allocated block address
+ *
+ * @return Error code
+ *
+ */
+errno_t ext4_balloc_alloc_block(ext4_inode_ref_t *inode_ref, uint32_t *fblock)
+{
+	ext4_filesystem_t *fs = inode_ref->fs;
+	ext4_superblock_t *sb = fs->superblock;
+	ext4_block_group_ref_t *bg_ref;
+	uint32_t block_size;
+	uint32_t goal;
+
+	/* Find GOAL */
+	errno_t rc = ext4_balloc_find_goal(inode_ref, &goal);
 	if (rc != EOK)
 		return rc;
 
-	/* Try other block groups */
-	uint32_t block_group_count = ext4_superblock_get_block_group_count(sb);
+	/* Load block group number for goal and relative index */
+	uint32_t block_group = ext4_filesystem_blockaddr2group(sb, goal);
+	uint32_t goal_index = ext4_filesystem_blockaddr2_index_in_group(sb, goal);
 
-	uint32_t bgid = (block_group + 1) % block_group_count;
-	uint32_t count = block_group_count;
+	uint32_t block_group_count = ext4_superblock_get_block_group_count(sb);
+	uint32_t bgid = block_group;
 
-	while (count > 0) {
-		rc = ext4_filesystem_get_block_group_ref(inode_ref->fs, bgid,
-		    &bg_ref);
+	for (uint32_t count = 0; count <= block_group_count; count++) {
+		rc = ext4_filesystem_get_block_group_ref(fs, bgid, &bg_ref);
 		if (rc != EOK)
 			return rc;
 
-		free_blocks =
+		uint32_t free_blocks =
 		    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
 		if (free_blocks == 0) {
 			/* This group has no free blocks */
 			goto next_group;
 		}
 
-		/* Load block with bitmap */
-		bitmap_block_addr =
-		    ext4_block_group_get_block_bitmap(bg_ref->block_group, sb);
-
-		rc = block_get(&bitmap_block, inode_ref->fs->device,
-		    bitmap_block_addr, 0);
-		if (rc != EOK) {
-			ext4_filesystem_put_block_group_ref(bg_ref);
-			return rc;
-		}
-
 		/* Compute indexes */
-		first_in_group =
+		uint32_t first_in_group =
 		    ext4_balloc_get_first_data_block_in_group(sb, bg_ref);
-		index_in_group =
+		uint32_t first =
 		    ext4_filesystem_blockaddr2_index_in_group(sb, first_in_group);
-		blocks_in_group = ext4_superblock_get_blocks_in_group(sb, bgid);
+		uint32_t start = first;
 
-		first_in_group_index =
-		    ext4_filesystem_blockaddr2_index_in_group(sb, first_in_group);
+		bool near = (count == 0);
+		if (near && (goal_index > start))
+			start = goal_index;
 
-		if (index_in_group < first_in_group_index)
-			index_in_group = first_in_group_index;
+		ext4_bg_summary_t *summary = &fs->bg_summary[bgid];
+		fibril_mutex_lock(&summary->lock);
 
-		/* Try to find free byte in bitmap */
-		rc = ext4_bitmap_find_free_byte_and_set_bit(bitmap_block->data,
-		    index_in_group, &rel_block_idx, blocks_in_group);
+		uint32_t index_in_group;
+		rc = ext4_balloc_alloc_in_group(fs, bg_ref, first, start, near,
+		    &index_in_group);
 		if (rc == EOK) {
-			bitmap_block->dirty = true;
-			rc = block_put(bitmap_block);
-			if (rc != EOK) {
-				ext4_filesystem_put_block_group_ref(bg_ref);
-				return rc;
-			}
-
-			allocated_block =
-			    ext4_filesystem_index_in_group2blockaddr(sb, rel_block_idx,
-			    bgid);
-
-			goto success;
+			/* Update block group free blocks count */
+			free_blocks = ext4_block_group_get_free_blocks_count(
+			    bg_ref->block_group, sb);
+			free_blocks--;
+			ext4_block_group_set_free_blocks_count(bg_ref->block_group,
+			    sb, free_blocks);
+			bg_ref->dirty = true;
 		}
 
-		/* Try to find free bit in bitmap */
-		rc = ext4_bitmap_find_free_bit_and_set(bitmap_block->data,
-		    index_in_group, &rel_block_idx, blocks_in_group);
-		if (rc == EOK) {
-			bitmap_block->dirty = true;
-			rc = block_put(bitmap_block);
-			if (rc != EOK) {
-				ext4_filesystem_put_block_group_ref(bg_ref);
-				return rc;
-			}
-
-			allocated_block =
-			    ext4_filesystem_index_in_group2blockaddr(sb, rel_block_idx,
-			    bgid);
+		fibril_mutex_unlock(&summary->lock);
 
+		if (rc == EOK) {
+			*fblock = ext4_filesystem_index_in_group2blockaddr(sb,
+			    index_in_group, bgid);
 			goto success;
 		}
 
-		rc = block_put(bitmap_block);
-		if (rc != EOK) {
+		if (rc != ENOSPC) {
 			ext4_filesystem_put_block_group_ref(bg_ref);
 			return rc;
 		}
@@ -580,7 +576,6 @@ goal_failed:
 
 		/* Goto next group */
 		bgid = (bgid + 1) % block_group_count;
-		count--;
 	}
 
 	return ENOSPC;
@@ -600,18 +595,7 @@ success:
 	ext4_inode_set_blocks_count(sb, inode_ref->inode, ino_blocks);
 	inode_ref->dirty = true;
 
-	/* Update block group free blocks count */
-	uint32_t bg_free_blocks =
-	    ext4_block_group_get_free_blocks_count(bg_ref->block_group, sb);
-	bg_free_blocks--;
-	ext4_block_group_set_free_blocks_count(bg_ref->block_group, sb,
-	    bg_free_blocks);
-	bg_ref->dirty = true;
-
-	rc = ext4_filesystem_put_block_group_ref(bg_ref);
-
-	*fblock = allocated_block;
-	return rc;
+	return ext4_filesystem_put_block_group_ref(bg_ref);
 }
 
 /** Try to allocate concrete block.
@@ -642,12 +626,16 @@ errno_t ext4_balloc_try_alloc_block(ext4_inode_ref_t *inode_ref, uint32_t fblock
 	if (rc != EOK)
 		return rc;
 
+	ext4_bg_summary_t *summary = &fs->bg_summary[block_group];
+	fibril_mutex_lock(&summary->lock);
+
 	/* Load block with bitmap */
 	uint32_t bitmap_block_addr =
 	    ext4_block_group_get_block_bitmap(bg_ref->block_group, sb);
 	block_t *bitmap_block;
 	rc = block_get(&bitmap_block, fs->device, bitmap_block_addr, 0);
 	if (rc != EOK) {
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
@@ -659,19 +647,25 @@ errno_t ext4_balloc_try_alloc_block(ext4_inode_ref_t *inode_ref, uint32_t fblock
 	if (*free) {
 		ext4_bitmap_set_bit(bitmap_block->data, index_in_group);
 		bitmap_block->dirty = true;
+
+		if (index_in_group == summary->first_free_block)
+			summary->first_free_block = index_in_group + 1;
 	}
 
 	/* Release block with bitmap */
 	rc = block_put(bitmap_block);
 	if (rc != EOK) {
 		/* Error in saving bitmap */
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
 
 	/* If block is not free, return */
-	if (!(*free))
+	if (!(*free)) {
+		fibril_mutex_unlock(&summary->lock);
 		goto terminate;
+	}
 
 	uint32_t block_size = ext4_superblock_get_block_size(sb);
 
@@ -695,6 +689,8 @@ errno_t ext4_balloc_try_alloc_block(ext4_inode_ref_t *inode_ref, uint32_t fblock
 	    sb, free_blocks);
 	bg_ref->dirty = true;
 
+	fibril_mutex_unlock(&summary->lock);
+
 terminate:
 	return ext4_filesystem_put_block_group_ref(bg_ref);
 }
@@ -36,6 +36,7 @@
 
 #include <byteorder.h>
 #include <errno.h>
+#include <fibril_synch.h>
 #include <mem.h>
 #include <stdlib.h>
 #include "ext4/balloc.h"
@@ -360,9 +361,242 @@ static void ext4_extent_binsearch(ext4_extent_header_t *header,
 	*extent = l - 1;
 }
 
-/** Find physical block in the extent tree by logical block number.
+static void *ext4_extent_cache_getkey(odlink_t *link)
+{
+	ext4_extent_status_t *es =
+	    odict_get_instance(link, ext4_extent_status_t, lcache);
+	return &es->key;
+}
+
+static int ext4_extent_cache_cmp(void *a, void *b)
+{
+	ext4_extent_status_key_t *ka = (ext4_extent_status_key_t *) a;
+	ext4_extent_status_key_t *kb = (ext4_extent_status_key_t *) b;
+
+	if (ka->inode != kb->inode)
+		return (ka->inode < kb->inode) ? -1 : 1;
+
+	if (ka->first != kb->first)
+		return (ka->first < kb->first) ? -1 : 1;
+
+	return 0;
+}
+
+/** Initialize extent status cache of a filesystem.
+ *
+ * @param fs Filesystem
+ *
+ */
+void ext4_extent_cache_init(ext4_filesystem_t *fs)
+{
+	fibril_mutex_initialize(&fs->extent_cache_lock);
+	odict_initialize(&fs->extent_cache, ext4_extent_cache_getkey,
+	    ext4_extent_cache_cmp);
+	list_initialize(&fs->extent_lru);
+	fs->extent_cache_count = 0;
+}
+
+/** Remove run from the extent status cache.
+ *
+ * @param fs Filesystem, its extent cache lock must be held
+ * @param es Cached run
+ *
+ */
+static void ext4_extent_cache_remove(ext4_filesystem_t *fs,
+    ext4_extent_status_t *es)
+{
+	odict_remove(&es->lcache);
+	list_remove(&es->llru);
+	fs->extent_cache_count--;
+	free(es);
+}
+
+/** Finalize extent status cache of a filesystem.
+ *
+ * @param fs Filesystem
+ *
+ */
+void ext4_extent_cache_fini(ext4_filesystem_t *fs)
+{
+	link_t *link;
+
+	while ((link = list_first(&fs->extent_lru)) != NULL) {
+		ext4_extent_cache_remove(fs,
+		    list_get_instance(link, ext4_extent_status_t, llru));
+	}
+
+	odict_finalize(&fs->extent_cache);
+}
+
+/** Drop cached runs of an i-node starting from the specified block.
+ *
+ * Must be called before the extent tree of the i-node is modified
+ * at or after @a iblock.
+ *
+ * @param inode_ref I-node whose runs are dropped
+ * @param iblock    First logical block which is no longer valid
+ *
+ */
+void ext4_extent_cache_invalidate(ext4_inode_ref_t *inode_ref, uint32_t iblock)
+{
+	ext4_filesystem_t *fs = inode_ref->fs;
+	ext4_extent_status_key_t key = {
+		.inode = inode_ref->index,
+		.first = iblock
+	};
+
+	fibril_mutex_lock(&fs->extent_cache_lock);
+
+	/* Start with the run which might contain iblock */
+	odlink_t *link = odict_find_leq(&fs->extent_cache, &key, NULL);
+	if (link == NULL)
+		link = odict_first(&fs->extent_cache);
+
+	while (link != NULL) {
+		ext4_extent_status_t *es =
+		    odict_get_instance(link, ext4_extent_status_t, lcache);
+		if (es->key.inode > inode_ref->index)
+			break;
+
+		link = odict_next(link, &fs->extent_cache);
+
+		if ((es->key.inode == inode_ref->index) &&
+		    (es->key.first + es->count > iblock))
+			ext4_extent_cache_remove(fs, es);
+	}
+
+	fibril_mutex_unlock(&fs->extent_cache_lock);
+}
+
+/** Translate logical block using a run.
  *
- * There is no need to save path in the tree during this algorithm.
+ * @param es        Run containing @a iblock
+ * @param iblock    Logical block number
+ * @param fblock    Output value for physical block number, 0 in a hole
+ * @param count     Output value for number of blocks from @a iblock to the
+ *                  end of the run
+ * @param unwritten Output value, true if the run is an unwritten extent
+ *
+ */
+static void ext4_extent_status_translate(ext4_extent_status_t *es,
+    uint32_t iblock, uint32_t *fblock, uint32_t *count, bool *unwritten)
+{
+	if (es->type == EXT4_EXTENT_STATUS_HOLE)
+		*fblock = 0;
+	else
+		*fblock = es->start + iblock - es->key.first;
+
+	*count = es->key.first + es->count - iblock;
+	*unwritten = (es->type == EXT4_EXTENT_STATUS_UNWRITTEN);
+}
+
+/** Look up logical block in the extent status cache.
+ *
+ * @param inode_ref I-node to look up block of
+ * @param iblock    Logical block number
+ * @param fblock    Output value for physical block number
+ * @param count     Output value for number of blocks in the rest of the run
+ * @param unwritten Output value, true if the run is an unwritten extent
+ *
+ * @return True if the block is covered by a cached run
+ *
+ */
+static bool ext4_extent_cache_lookup(ext4_inode_ref_t *inode_ref,
+    uint32_t iblock, uint32_t *fblock, uint32_t *count, bool *unwritten)
+{
+	ext4_filesystem_t *fs = inode_ref->fs;
+	ext4_extent_status_key_t key = {
+		.inode = inode_ref->index,
+		.first = iblock
+	};
+	bool found = false;
+
+	fibril_mutex_lock(&fs->extent_cache_lock);
+
+	odlink_t *link = odict_find_leq(&fs->extent_cache, &key, NULL);
+	if (link != NULL) {
+		ext4_extent_status_t *es =
+		    odict_get_instance(link, ext4_extent_status_t, lcache);
+		if ((es->key.inode == inode_ref->index) &&
+		    (iblock < es->key.first + es->count)) {
+			ext4_extent_status_translate(es, iblock, fblock, count,
+			    unwritten);
+
+			/* Move to the most recently used end */
+			list_remove(&es->llru);
+			list_append(&es->llru, &fs->extent_lru);
+			found = true;
+		}
+	}
+
+	fibril_mutex_unlock(&fs->extent_cache_lock);
+	return found;
+}
+
+/** Insert run into the extent status cache.
+ *
+ * Overlapping runs of the same i-node are replaced. If the cache is
+ * full, the least recently used run is evicted. Failure to allocate
+ * memory is not an error, the run is simply not cached.
+ *
+ * @param inode_ref I-node the run belongs to
+ * @param first     First logical block of the run
+ * @param count     Number of blocks in the run
+ * @param start     First physical block of the run
+ * @param type      Status of the blocks in the run
+ *
+ */
+static void ext4_extent_cache_insert(ext4_inode_ref_t *inode_ref,
+    uint32_t first, uint32_t count, uint64_t start,
+    ext4_extent_status_type_t type)
+{
+	ext4_filesystem_t *fs = inode_ref->fs;
+
+	ext4_extent_status_t *es = malloc(sizeof(ext4_extent_status_t));
+	if (es == NULL)
+		return;
+
+	odlink_initialize(&es->lcache);
+	link_initialize(&es->llru);
+	es->key.inode = inode_ref->index;
+	es->key.first = first;
+	es->count = count;
+	es->start = start;
+	es->type = type;
+
+	fibril_mutex_lock(&fs->extent_cache_lock);
+
+	/* Remove runs overlapping with the new one */
+	ext4_extent_status_key_t end_key = {
+		.inode = inode_ref->index,
+		.first = first + count
+	};
+
+	odlink_t *link = odict_find_lt(&fs->extent_cache, &end_key, NULL);
+	while (link != NULL) {
+		ext4_extent_status_t *old =
+		    odict_get_instance(link, ext4_extent_status_t, lcache);
+		if ((old->key.inode != inode_ref->index) ||
+		    (old->key.first + old->count <= first))
+			break;
+
+		link = odict_prev(link, &fs->extent_cache);
+		ext4_extent_cache_remove(fs, old);
+	}
+
+	if (fs->extent_cache_count >= EXT4_EXTENT_CACHE_MAX) {
+		ext4_extent_cache_remove(fs, list_get_instance(
+		    list_first(&fs->extent_lru), ext4_extent_status_t, llru));
+	}
+
+	odict_insert(&es->lcache, &fs->extent_cache, NULL);
+	list_append(&es->llru, &fs->extent_lru);
+	fs->extent_cache_count++;
+
+	fibril_mutex_unlock(&fs->extent_cache_lock);
+}
+
+/** Find physical block in the extent tree by logical block number.
  *
  * @param inode_ref I-node to load block from
  * @param iblock    Logical block number to find
@@ -373,6 +607,34 @@ static void ext4_extent_binsearch(ext4_extent_header_t *header,
  */
 errno_t ext4_extent_find_block(ext4_inode_ref_t *inode_ref, uint32_t iblock,
     uint32_t *fblock)
+{
+	uint32_t count;
+	bool unwritten;
+
+	return ext4_extent_find_run(inode_ref, iblock, fblock, &count,
+	    &unwritten);
+}
+
+/** Find run of blocks in the extent tree by logical block number.
+ *
+ * The extent status cache is consulted first. On a miss, the extent tree
+ * is walked from the root without saving the path and the run found in
+ * the leaf is added to the cache.
+ *
+ * @param inode_ref I-node to load block from
+ * @param iblock    Logical block number to find
+ * @param fblock    Output value for physical block number, 0 if the block
+ *                  is not allocated
+ * @param count     Output value for number of blocks from @a iblock on,
+ *                  which are contiguous on disk (or all not allocated)
+ * @param unwritten Output value, true if the blocks are allocated to an
+ *                  unwritten extent and read as zeros
+ *
+ * @return Error code
+ *
+ */
+errno_t ext4_extent_find_run(ext4_inode_ref_t *inode_ref, uint32_t iblock,
+    uint32_t *fblock, uint32_t *count, bool *unwritten)
 {
 	errno_t rc = EOK;
 	/* Compute bound defined by i-node size */
@@ -387,9 +649,15 @@ errno_t ext4_extent_find_block(ext4_inode_ref_t *inode_ref, uint32_t iblock,
 	/* Check if requested iblock is not over size of i-node */
 	if (iblock > last_idx) {
 		*fblock = 0;
+		*count = 1;
+		*unwritten = false;
 		return EOK;
 	}
 
+	if (ext4_extent_cache_lookup(inode_ref, iblock, fblock, count,
+	    unwritten))
+		return EOK;
+
 	block_t *block = NULL;
 
 	/* Walk through extent tree */
@@ -425,16 +693,51 @@ errno_t ext4_extent_find_block(ext4_inode_ref_t *inode_ref, uint32_t iblock,
 	/* Prevent empty leaf */
 	if (extent == NULL) {
 		*fblock = 0;
-	} else {
-		/* Compute requested physical block address */
-		uint32_t phys_block;
-		uint32_t first = ext4_extent_get_first_block(extent);
-		phys_block = ext4_extent_get_start(extent) + iblock - first;
+		*count = 1;
+		*unwritten = false;
+		goto cleanup;
+	}
+
+	ext4_extent_status_t es;
+	uint32_t first = ext4_extent_get_first_block(extent);
+	uint32_t len = ext4_extent_get_block_count(extent);
+
+	es.start = ext4_extent_get_start(extent);
+	es.type = EXT4_EXTENT_STATUS_MAPPED;
+	if (len > EXT4_EXTENT_INIT_MAX_LEN) {
+		len -= EXT4_EXTENT_INIT_MAX_LEN;
+		es.type = EXT4_EXTENT_STATUS_UNWRITTEN;
+	}
 
-		*fblock = phys_block;
+	if (iblock < first) {
+		/* Hole before the first extent in the leaf */
+		es.key.first = iblock;
+		es.count = first - iblock;
+		es.start = 0;
+		es.type = EXT4_EXTENT_STATUS_HOLE;
+	} else if (iblock >= first + len) {
+		/* Hole after the extent, up to the next one if known */
+		ext4_extent_t *last = EXT4_EXTENT_FIRST(header) +
+		    ext4_extent_header_get_entries_count(header) - 1;
+
+		es.key.first = first + len;
+		if (extent < last)
+			es.count = ext4_extent_get_first_block(extent + 1) -
+			    es.key.first;
+		else
+			es.count = iblock + 1 - es.key.first;
+		es.start = 0;
+		es.type = EXT4_EXTENT_STATUS_HOLE;
+	} else {
+		es.key.first = first;
+		es.count = len;
 	}
 
-	/* Cleanup */
+	ext4_extent_status_translate(&es, iblock, fblock, count, unwritten);
+	ext4_extent_cache_insert(inode_ref, es.key.first, es.count, es.start,
+	    es.type);
+
+cleanup:
 	if (block != NULL)
 		rc = block_put(block);
 
@@ -533,6 +836,89 @@ cleanup:
 	return rc;
 }
 
+/** Convert unwritten extent containing a block to written.
+ *
+ * Blocks of an unwritten extent are allocated, but read as zeros. Before
+ * any of them is written to, all blocks of the extent are zeroed on disk
+ * and the extent is marked written.
+ *
+ * @param inode_ref I-node the block belongs to
+ * @param iblock    Logical block number which is about to be written
+ *
+ * @return Error code
+ *
+ */
+errno_t ext4_extent_convert_unwritten(ext4_inode_ref_t *inode_ref,
+    uint32_t iblock)
+{
+	uint32_t fblock;
+	uint32_t count;
+	bool unwritten;
+
+	errno_t rc = ext4_extent_find_run(inode_ref, iblock, &fblock, &count,
+	    &unwritten);
+	if (rc != EOK || !unwritten)
+		return rc;
+
+	ext4_extent_cache_invalidate(inode_ref, iblock);
+
+	ext4_extent_path_t *path;
+	rc = ext4_extent_find_extent(inode_ref, iblock, &path);
+	if (rc != EOK)
+		return rc;
+
+	/* Jump to last item of the path (extent) */
+	ext4_extent_path_t *path_ptr = path;
+	while (path_ptr->depth != 0)
+		path_ptr++;
+
+	assert(path_ptr->extent != NULL);
+
+	uint16_t len = ext4_extent_get_block_count(path_ptr->extent);
+	if (len <= EXT4_EXTENT_INIT_MAX_LEN)
+		goto cleanup;
+
+	len -= EXT4_EXTENT_INIT_MAX_LEN;
+	uint64_t start = ext4_extent_get_start(path_ptr->extent);
+
+	/* Zero all blocks of the extent */
+	for (uint16_t i = 0; i < len; i++) {
+		block_t *block;
+		rc = block_get(&block, inode_ref->fs->device, start + i,
+		    BLOCK_FLAGS_NOREAD);
+		if (rc != EOK)
+			goto cleanup;
+
+		memset(block->data, 0, block->size);
+		block->dirty = true;
+
+		rc = block_put(block);
+		if (rc != EOK)
+			goto cleanup;
+	}
+
+	ext4_extent_set_block_count(path_ptr->extent, len);
+	path_ptr->block->dirty = true;
+
+cleanup:
+	/*
+	 * Put loaded blocks
+	 * starting from 1: 0 is a block with inode data
+	 */
+	for (uint16_t i = 1; i <= path->depth; ++i) {
+		if (path[i].block) {
+			errno_t rc2 = block_put(path[i].block);
+			if (rc == EOK && rc2 != EOK)
+				rc = rc2;
+		}
+	}
+
+	/* Destroy temporary data structure */
+	free(path);
+
+	return rc;
+}
+
 /** Release extent and all data blocks covered by the extent.
  *
  * @param inode_ref I-node to release extent and block from
@@ -619,6 +1005,8 @@ static errno_t ext4_extent_release_branch(ext4_inode_ref_t *inode_ref,
 errno_t ext4_extent_release_blocks_from(ext4_inode_ref_t *inode_ref,
     uint32_t iblock_from)
 {
+	ext4_extent_cache_invalidate(inode_ref, iblock_from);
+
 	/* Find the first extent to modify */
 	ext4_extent_path_t *path;
 	errno_t rc2;
@@ -978,6 +1366,8 @@ errno_t ext4_extent_append_block(ext4_inode_ref_t *inode_ref, uint32_t *iblock,
 		new_block_idx = inode_size / block_size;
 	}
 
+	ext4_extent_cache_invalidate(inode_ref, new_block_idx);
+
 	/* Load the nearest leaf (with extent) */
 	ext4_extent_path_t *path;
 	errno_t rc2;
@@ -137,6 +137,19 @@ static errno_t ext4_filesystem_init(ext4_filesystem_t *fs, service_id_t service_
 	if (rc != EOK)
 		goto err_2;
 
+	/* Allocation summaries are filled in lazily by the allocators */
+	uint32_t bg_count = ext4_superblock_get_block_group_count(fs->superblock);
+	fs->bg_summary = calloc(bg_count, sizeof(ext4_bg_summary_t));
+	if (fs->bg_summary == NULL) {
+		rc = ENOMEM;
+		goto err_2;
+	}
+
+	for (uint32_t i = 0; i < bg_count; i++)
+		fibril_mutex_initialize(&fs->bg_summary[i].lock);
+
+	ext4_extent_cache_init(fs);
+
 	return EOK;
 err_2:
 	block_cache_fini(fs->device);
@@ -155,8 +168,10 @@ err:
  */
 static void ext4_filesystem_fini(ext4_filesystem_t *fs)
 {
-	/* Release memory space for superblock */
+	/* Release memory space for superblock and in-memory caches */
 	free(fs->superblock);
+	free(fs->bg_summary);
+	ext4_extent_cache_fini(fs);
 
 	/* Finish work with block library */
 	block_cache_fini(fs->device);
@@ -1375,6 +1390,7 @@ errno_t ext4_filesystem_free_inode(ext4_inode_ref_t *inode_ref)
 	    EXT4_FEATURE_INCOMPAT_EXTENTS)) &&
 	    (ext4_inode_has_flag(inode_ref->inode, EXT4_INODE_FLAG_EXTENTS))) {
 		/* Data structures are released during truncate operation... */
+		ext4_extent_cache_invalidate(inode_ref, 0);
 		goto finish;
 	}
 
@@ -1689,6 +1705,46 @@ errno_t ext4_filesystem_get_inode_data_block_index(ext4_inode_ref_t *inode_ref,
 	return EOK;
 }
 
+/** Get physical block address of a run by logical index of its first block.
+ *
+ * For i-nodes using extents, the run extends up to the end of the extent
+ * (or hole) containing the block. Otherwise the run is a single block.
+ * Unlike ext4_filesystem_get_inode_data_block_index(), the address is 0
+ * for blocks of unwritten extents, since they read as zeros.
+ *
+ * @param inode_ref I-node to read block address from
+ * @param iblock    Logical index of block
+ * @param fblock    Output pointer for return physical block address,
+ *                  0 if the blocks read as zeros
+ * @param count     Output pointer for number of blocks in the run
+ *
+ * @return Error code
+ *
+ */
+errno_t ext4_filesystem_get_inode_data_run(ext4_inode_ref_t *inode_ref,
+    aoff64_t iblock, uint32_t *fblock, uint32_t *count)
+{
+	ext4_filesystem_t *fs = inode_ref->fs;
+
+	if ((ext4_inode_get_size(fs->superblock, inode_ref->inode) != 0) &&
+	    (ext4_superblock_has_feature_incompatible(fs->superblock,
+	    EXT4_FEATURE_INCOMPAT_EXTENTS)) &&
+	    (ext4_inode_has_flag(inode_ref->inode, EXT4_INODE_FLAG_EXTENTS))) {
+		bool unwritten;
+
+		errno_t rc = ext4_extent_find_run(inode_ref, iblock, fblock,
+		    count, &unwritten);
+		if (rc == EOK && unwritten)
+			*fblock = 0;
+
+		return rc;
+	}
+
+	*count = 1;
+	return ext4_filesystem_get_inode_data_block_index(inode_ref, iblock,
+	    fblock);
+}
+
 /** Set physical block address for the block logical address into the i-node.
  *
  * @param inode_ref I-node to set block address to
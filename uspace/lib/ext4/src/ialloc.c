@@ -36,6 +36,7 @@
  */
 
 #include <errno.h>
+#include <fibril_synch.h>
 #include <stdbool.h>
 #include "ext4/bitmap.h"
 #include "ext4/block_group.h"
@@ -88,6 +89,54 @@ static uint32_t ext4_ialloc_get_bgid_of_inode(ext4_superblock_t *sb,
 	return (inode - 1) / inodes_per_group;
 }
 
+/** Account an allocated i-node in its block group descriptor.
+ *
+ * Must be called with the block group summary lock held.
+ *
+ * @param sb             Superblock
+ * @param bg_ref         Reference to the block group of the i-node
+ * @param index_in_group Index of the allocated i-node in the block group
+ * @param is_dir         Flag if allocated i-node is a directory
+ *
+ */
+static void ext4_ialloc_account_alloc(ext4_superblock_t *sb,
+    ext4_block_group_ref_t *bg_ref, uint32_t index_in_group, bool is_dir)
+{
+	ext4_block_group_t *bg = bg_ref->block_group;
+
+	/* Modify filesystem counters */
+	uint32_t free_inodes = ext4_block_group_get_free_inodes_count(bg, sb);
+	free_inodes--;
+	ext4_block_group_set_free_inodes_count(bg, sb, free_inodes);
+
+	/* Increment used directories counter */
+	if (is_dir) {
+		uint32_t used_dirs = ext4_block_group_get_used_dirs_count(bg, sb);
+		used_dirs++;
+		ext4_block_group_set_used_dirs_count(bg, sb, used_dirs);
+	}
+
+	/* Decrease unused inodes count */
+	if (ext4_block_group_has_flag(bg,
+	    EXT4_BLOCK_GROUP_ITABLE_ZEROED)) {
+		uint32_t unused =
+		    ext4_block_group_get_itable_unused(bg, sb);
+
+		uint32_t inodes_in_group =
+		    ext4_superblock_get_inodes_in_group(sb, bg_ref->index);
+
+		uint32_t free = inodes_in_group - unused;
+
+		if (index_in_group >= free) {
+			unused = inodes_in_group - (index_in_group + 1);
+			ext4_block_group_set_itable_unused(bg, sb, unused);
+		}
+	}
+
+	/* Save modified block group */
+	bg_ref->dirty = true;
+}
+
 /** Free i-node number and modify filesystem data structers.
  *
  * @param fs     Filesystem, where the i-node is located
@@ -107,24 +156,34 @@ errno_t ext4_ialloc_free_inode(ext4_filesystem_t *fs, uint32_t index, bool is_di
 	if (rc != EOK)
 		return rc;
 
+	ext4_bg_summary_t *summary = &fs->bg_summary[block_group];
+	fibril_mutex_lock(&summary->lock);
+
 	/* Load i-node bitmap */
 	uint32_t bitmap_block_addr = ext4_block_group_get_inode_bitmap(
 	    bg_ref->block_group, sb);
 	block_t *bitmap_block;
 	rc = block_get(&bitmap_block, fs->device, bitmap_block_addr,
 	    BLOCK_FLAGS_NONE);
-	if (rc != EOK)
+	if (rc != EOK) {
+		fibril_mutex_unlock(&summary->lock);
+		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
+	}
 
 	/* Free i-node in the bitmap */
 	uint32_t index_in_group = ext4_ialloc_inode2index_in_group(sb, index);
 	ext4_bitmap_free_bit(bitmap_block->data, index_in_group);
 	bitmap_block->dirty = true;
 
+	if (index_in_group < summary->first_free_inode)
+		summary->first_free_inode = index_in_group;
+
 	/* Put back the block with bitmap */
 	rc = block_put(bitmap_block);
 	if (rc != EOK) {
 		/* Error in saving bitmap */
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
@@ -146,6 +205,7 @@ errno_t ext4_ialloc_free_inode(ext4_filesystem_t *fs, uint32_t index, bool is_di
 	    free_inodes);
 
 	bg_ref->dirty = true;
+	fibril_mutex_unlock(&summary->lock);
 
 	/* Put back the modified block group */
 	rc = ext4_filesystem_put_block_group_ref(bg_ref);
@@ -201,7 +261,6 @@ retry:
 		/* Read necessary values for algorithm */
 		uint32_t free_blocks = ext4_block_group_get_free_blocks_count(bg, sb);
 		uint32_t free_inodes = ext4_block_group_get_free_inodes_count(bg, sb);
-		uint32_t used_dirs = ext4_block_group_get_used_dirs_count(bg, sb);
 
 		/*
 		 * Check if this block group is a good candidate
@@ -217,6 +276,9 @@ retry:
 		 */
 		if (((free_inodes >= avg_free_inodes) ||
 		    (bgid == bg_count - 1) || pick_first_free) && (free_blocks > 0)) {
+			ext4_bg_summary_t *summary = &fs->bg_summary[bgid];
+			fibril_mutex_lock(&summary->lock);
+
 			/* Load block with bitmap */
 			uint32_t bitmap_block_addr = ext4_block_group_get_inode_bitmap(
 			    bg_ref->block_group, sb);
@@ -225,19 +287,31 @@ retry:
 			rc = block_get(&bitmap_block, fs->device, bitmap_block_addr,
 			    BLOCK_FLAGS_NONE);
 			if (rc != EOK) {
+				fibril_mutex_unlock(&summary->lock);
 				ext4_filesystem_put_block_group_ref(bg_ref);
 				return rc;
 			}
 
-			/* Try to allocate i-node in the bitmap */
+			/*
+			 * Try to allocate i-node in the bitmap, skipping
+			 * the i-nodes known to be used
+			 */
 			uint32_t inodes_in_group = ext4_superblock_get_inodes_in_group(sb, bgid);
 			uint32_t index_in_group;
-			rc = ext4_bitmap_find_free_bit_and_set(bitmap_block->data,
-			    0, &index_in_group, inodes_in_group);
+			rc = ENOSPC;
+			if (summary->first_free_inode < inodes_in_group) {
+				rc = ext4_bitmap_find_free_bit_and_set(
+				    bitmap_block->data, summary->first_free_inode,
+				    &index_in_group, inodes_in_group);
+			}
+
+			summary->first_free_inode = (rc == EOK) ?
+			    index_in_group + 1 : inodes_in_group;
 
 			/* Block group has not any free i-node */
 			if (rc == ENOSPC) {
 				rc = block_put(bitmap_block);
+				fibril_mutex_unlock(&summary->lock);
 				if (rc != EOK) {
 					ext4_filesystem_put_block_group_ref(bg_ref);
 					return rc;
@@ -256,45 +330,20 @@ retry:
 
 			rc = block_put(bitmap_block);
 			if (rc != EOK) {
+				fibril_mutex_unlock(&summary->lock);
 				ext4_filesystem_put_block_group_ref(bg_ref);
 				return rc;
 			}
 
-			/* Modify filesystem counters */
-			free_inodes--;
-			ext4_block_group_set_free_inodes_count(bg, sb, free_inodes);
-
-			/* Increment used directories counter */
-			if (is_dir) {
-				used_dirs++;
-				ext4_block_group_set_used_dirs_count(bg, sb, used_dirs);
-			}
-
-			/* Decrease unused inodes count */
-			if (ext4_block_group_has_flag(bg,
-			    EXT4_BLOCK_GROUP_ITABLE_ZEROED)) {
-				uint32_t unused =
-				    ext4_block_group_get_itable_unused(bg, sb);
-
-				uint32_t inodes_in_group =
-				    ext4_superblock_get_inodes_in_group(sb, bgid);
-
-				uint32_t free = inodes_in_group - unused;
-
-				if (index_in_group >= free) {
-					unused = inodes_in_group - (index_in_group + 1);
-					ext4_block_group_set_itable_unused(bg, sb, unused);
-				}
-			}
-
-			/* Save modified block group */
-			bg_ref->dirty = true;
+			ext4_ialloc_account_alloc(sb, bg_ref, index_in_group, is_dir);
+			fibril_mutex_unlock(&summary->lock);
 
 			rc = ext4_filesystem_put_block_group_ref(bg_ref);
 			if (rc != EOK)
 				return rc;
 
 			/* Update superblock */
+			sb_free_inodes = ext4_superblock_get_free_inodes_count(sb);
 			sb_free_inodes--;
 			ext4_superblock_set_free_inodes_count(sb, sb_free_inodes);
 
@@ -336,7 +385,6 @@ errno_t ext4_ialloc_alloc_this_inode(ext4_filesystem_t *fs, uint32_t inode,
 	ext4_superblock_t *sb = fs->superblock;
 
 	uint32_t bgid = ext4_ialloc_get_bgid_of_inode(sb, inode);
-	uint32_t sb_free_inodes = ext4_superblock_get_free_inodes_count(sb);
 
 	/* Load block group */
 	ext4_block_group_ref_t *bg_ref;
@@ -344,11 +392,8 @@ errno_t ext4_ialloc_alloc_this_inode(ext4_filesystem_t *fs, uint32_t inode,
 	if (rc != EOK)
 		return rc;
 
-	ext4_block_group_t *bg = bg_ref->block_group;
-
-	/* Read necessary values for algorithm */
-	uint32_t free_inodes = ext4_block_group_get_free_inodes_count(bg, sb);
-	uint32_t used_dirs = ext4_block_group_get_used_dirs_count(bg, sb);
+	ext4_bg_summary_t *summary = &fs->bg_summary[bgid];
+	fibril_mutex_lock(&summary->lock);
 
 	/* Load block with bitmap */
 	uint32_t bitmap_block_addr = ext4_block_group_get_inode_bitmap(
@@ -358,6 +403,7 @@ errno_t ext4_ialloc_alloc_this_inode(ext4_filesystem_t *fs, uint32_t inode,
 	rc = block_get(&bitmap_block, fs->device, bitmap_block_addr,
 	    BLOCK_FLAGS_NONE);
 	if (rc != EOK) {
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
@@ -366,50 +412,28 @@ errno_t ext4_ialloc_alloc_this_inode(ext4_filesystem_t *fs, uint32_t inode,
 	uint32_t index_in_group = ext4_ialloc_inode2index_in_group(sb, inode);
 	ext4_bitmap_set_bit(bitmap_block->data, index_in_group);
 
+	if (index_in_group == summary->first_free_inode)
+		summary->first_free_inode = index_in_group + 1;
+
 	/* Save the bitmap */
 	bitmap_block->dirty = true;
 
 	rc = block_put(bitmap_block);
 	if (rc != EOK) {
+		fibril_mutex_unlock(&summary->lock);
 		ext4_filesystem_put_block_group_ref(bg_ref);
 		return rc;
 	}
 
-	/* Modify filesystem counters */
-	free_inodes--;
-	ext4_block_group_set_free_inodes_count(bg, sb, free_inodes);
-
-	/* Increment used directories counter */
-	if (is_dir) {
-		used_dirs++;
-		ext4_block_group_set_used_dirs_count(bg, sb, used_dirs);
-	}
-
-	/* Decrease unused inodes count */
-	if (ext4_block_group_has_flag(bg,
-	    EXT4_BLOCK_GROUP_ITABLE_ZEROED)) {
-		uint32_t unused =
-		    ext4_block_group_get_itable_unused(bg, sb);
-
-		uint32_t inodes_in_group =
-		    ext4_superblock_get_inodes_in_group(sb, bgid);
-
-		uint32_t free = inodes_in_group - unused;
-
-		if (index_in_group >= free) {
-			unused = inodes_in_group - (index_in_group + 1);
-			ext4_block_group_set_itable_unused(bg, sb, unused);
-		}
-	}
-
-	/* Save modified block group */
-	bg_ref->dirty = true;
+	ext4_ialloc_account_alloc(sb, bg_ref, index_in_group, is_dir);
+	fibril_mutex_unlock(&summary->lock);
 
 	rc = ext4_filesystem_put_block_group_ref(bg_ref);
 	if (rc != EOK)
 		return rc;
 
 	/* Update superblock */
+	uint32_t sb_free_inodes = ext4_superblock_get_free_inodes_count(sb);
 	sb_free_inodes--;
 	ext4_superblock_set_free_inodes_count(sb, sb_free_inodes);
 
@@ -55,6 +55,9 @@
 #include "ext4/fstypes.h"
 #include "ext4/superblock.h"
 
+/** Maximum number of bytes returned by a single file read */
+#define EXT4_READ_MAX_BYTES  (64 * 1024)
+
 /* Forward declarations of auxiliary functions */
 
 static errno_t ext4_read_directory(ipc_call_t *, aoff64_t, size_t,
@@ -1206,41 +1209,43 @@ errno_t ext4_read_file(ipc_call_t *call, aoff64_t pos, size_t size,
 		return EOK;
 	}
 
-	/* For now, we only read data from one block at a time */
 	uint32_t block_size = ext4_superblock_get_block_size(sb);
 	aoff64_t file_block = pos / block_size;
 	uint32_t offset_in_block = pos % block_size;
-	uint32_t bytes = min(block_size - offset_in_block, size);
 
-	/* Handle end of file */
-	if (pos + bytes > file_size)
-		bytes = file_size - pos;
-
-	/* Get the real block number */
+	/* Get the real block number and the length of its run */
 	uint32_t fs_block;
-	errno_t rc = ext4_filesystem_get_inode_data_block_index(inode_ref,
-	    file_block, &fs_block);
+	uint32_t run_blocks;
+	errno_t rc = ext4_filesystem_get_inode_data_run(inode_ref,
+	    file_block, &fs_block, &run_blocks);
 	if (rc != EOK) {
 		async_answer_0(call, rc);
 		return rc;
 	}
 
+	/* Read as much of the run as requested, up to a limit */
+	uint64_t run_bytes = (uint64_t) run_blocks * block_size -
+	    offset_in_block;
+	size_t bytes = min(min(run_bytes, size), EXT4_READ_MAX_BYTES);
+
+	/* Handle end of file */
+	if (pos + bytes > file_size)
+		bytes = file_size - pos;
+
 	/*
 	 * Check for sparse file.
-	 * If ext4_filesystem_get_inode_data_block_index returned
-	 * fs_block == 0, it means that the given block is not allocated for the
-	 * file and we need to return a buffer of zeros
+	 * If ext4_filesystem_get_inode_data_run returned
+	 * fs_block == 0, it means that the given blocks are not allocated for
+	 * the file and we need to return a buffer of zeros
 	 */
 	uint8_t *buffer;
 	if (fs_block == 0) {
-		buffer = malloc(bytes);
+		buffer = calloc(1, bytes);
 		if (buffer == NULL) {
 			async_answer_0(call, ENOMEM);
 			return ENOMEM;
 		}
 
-		memset(buffer, 0, bytes);
-
 		rc = async_data_read_finalize(call, buffer, bytes);
 		*rbytes = bytes;
 
@@ -1250,20 +1255,64 @@ errno_t ext4_read_file(ipc_call_t *call, aoff64_t pos, size_t size,
 
 	/* Usual case - we need to read a block from device */
 	block_t *block;
-	rc = block_get(&block, inst->service_id, fs_block, BLOCK_FLAGS_NONE);
-	if (rc != EOK) {
-		async_answer_0(call, rc);
-		return rc;
+	if (offset_in_block + bytes <= block_size) {
+		rc = block_get(&block, inst->service_id, fs_block,
+		    BLOCK_FLAGS_NONE);
+		if (rc != EOK) {
+			async_answer_0(call, rc);
+			return rc;
+		}
+
+		rc = async_data_read_finalize(call,
+		    block->data + offset_in_block, bytes);
+		if (rc != EOK) {
+			block_put(block);
+			return rc;
+		}
+
+		rc = block_put(block);
+		if (rc != EOK)
+			return rc;
+
+		*rbytes = bytes;
+		return EOK;
 	}
 
-	assert(offset_in_block + bytes <= block_size);
-	rc = async_data_read_finalize(call, block->data + offset_in_block, bytes);
-	if (rc != EOK) {
-		block_put(block);
-		return rc;
+	/* The run is contiguous on disk, gather it into a single reply */
+	buffer = malloc(bytes);
+	if (buffer == NULL) {
+		async_answer_0(call, ENOMEM);
+		return ENOMEM;
 	}
 
-	rc = block_put(block);
+	size_t done = 0;
+	while (done < bytes) {
+		size_t chunk = min(block_size - offset_in_block, bytes - done);
+
+		rc = block_get(&block, inst->service_id, fs_block,
+		    BLOCK_FLAGS_NONE);
+		if (rc != EOK) {
+			free(buffer);
+			async_answer_0(call, rc);
+			return rc;
+		}
+
+		memcpy(buffer + done, block->data + offset_in_block, chunk);
+
+		rc = block_put(block);
+		if (rc != EOK) {
+			free(buffer);
+			async_answer_0(call, rc);
+			return rc;
+		}
+
+		done += chunk;
+		offset_in_block = 0;
+		fs_block++;
+	}
+
+	rc = async_data_read_finalize(call, buffer, bytes);
+	free(buffer);
 	if (rc != EOK)
 		return rc;
 
@@ -1319,6 +1368,18 @@ static errno_t ext4_write(service_id_t service_id, fs_index_t index, aoff64_t po
 
 	/* Load inode */
 	inode_ref = enode->inode_ref;
+
+	/* Blocks of unwritten extents read as zeros until they are converted */
+	if ((ext4_superblock_has_feature_incompatible(fs->superblock,
+	    EXT4_FEATURE_INCOMPAT_EXTENTS)) &&
+	    (ext4_inode_has_flag(inode_ref->inode, EXT4_INODE_FLAG_EXTENTS))) {
+		rc = ext4_extent_convert_unwritten(inode_ref, iblock);
+		if (rc != EOK) {
+			async_answer_0(&call, rc);
+			goto exit;
+		}
+	}
+
 	rc = ext4_filesystem_get_inode_data_block_index(inode_ref, iblock,
 	    &fblock);
 	if (rc != EOK) {
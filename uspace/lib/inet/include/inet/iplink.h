@@ -41,6 +41,9 @@
 
 struct iplink_ev_ops;
 
+/** Link completes TCP checksums of transmitted unfragmented datagrams */
+#define IPLINK_OFFLOAD_TX_TCP_CSUM  0x1
+
 typedef struct {
 	async_sess_t *sess;
 	struct iplink_ev_ops *ev_ops;
@@ -89,6 +92,7 @@ extern errno_t iplink_send6(iplink_t *, iplink_sdu6_t *);
 extern errno_t iplink_addr_add(iplink_t *, inet_addr_t *);
 extern errno_t iplink_addr_remove(iplink_t *, inet_addr_t *);
 extern errno_t iplink_get_mtu(iplink_t *, size_t *);
+extern errno_t iplink_get_offload(iplink_t *, uint32_t *);
 extern errno_t iplink_get_mac48(iplink_t *, eth_addr_t *);
 extern errno_t iplink_set_mac48(iplink_t *, eth_addr_t *);
 extern void *iplink_get_userptr(iplink_t *);
@@ -58,6 +58,7 @@ typedef struct iplink_ops {
 	errno_t (*send)(iplink_srv_t *, iplink_sdu_t *);
 	errno_t (*send6)(iplink_srv_t *, iplink_sdu6_t *);
 	errno_t (*get_mtu)(iplink_srv_t *, size_t *);
+	errno_t (*get_offload)(iplink_srv_t *, uint32_t *);
 	errno_t (*get_mac48)(iplink_srv_t *, eth_addr_t *);
 	errno_t (*set_mac48)(iplink_srv_t *, eth_addr_t *);
 	errno_t (*addr_add)(iplink_srv_t *, inet_addr_t *);
@@ -57,7 +57,12 @@ typedef struct {
 } inet_ev_ops_t;
 
 typedef enum {
-	INET_DF = 1
+	INET_DF = 1,
+	/**
+	 * Transport checksum field is zero and must be completed by the
+	 * IP layer or by the link
+	 */
+	INET_CSUM_DEFER = 2
 } inet_df_t;
 
 #endif
@@ -36,6 +36,7 @@
 #ifndef LIBNETTL_AMAP_H_
 #define LIBNETTL_AMAP_H_
 
+#include <adt/hash_table.h>
 #include <adt/list.h>
 #include <inet/endpoint.h>
 #include <nettl/portrng.h>
@@ -44,7 +45,7 @@
 /** Port range for (remote endpoint, local address) */
 typedef struct {
 	/** Link to amap_t.repla */
-	link_t lamap;
+	ht_link_t lamap;
 	/** Remote endpoint */
 	inet_ep_t rep;
 	/* Local address */
@@ -76,7 +77,7 @@ typedef struct {
 /** Association map */
 typedef struct {
 	/** Remote endpoint, local address */
-	list_t repla; /* of amap_repla_t */
+	hash_table_t repla; /* of amap_repla_t */
 	/** Local addresses */
 	list_t laddr; /* of amap_laddr_t */
 	/** Local links */
@@ -47,8 +47,14 @@
  *
  * In the unspecified case only the local port is known and the entry matches
  * all remote and local addresses.
+ *
+ * There is one repla entry for each connected remote endpoint, so these
+ * are kept in a hash table. The less specific entries are few and are
+ * kept in lists.
  */
 
+#include <adt/hash.h>
+#include <adt/hash_table.h>
 #include <adt/list.h>
 #include <errno.h>
 #include <inet/addr.h>
@@ -58,6 +64,109 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+/** Repla hash table key */
+typedef struct {
+	/** Remote endpoint */
+	inet_ep_t *rep;
+	/** Local address */
+	inet_addr_t *laddr;
+} amap_repla_key_t;
+
+static size_t amap_repla_hash(const ht_link_t *);
+static size_t amap_repla_key_hash(const void *);
+static bool amap_repla_key_equal(const void *, size_t, const ht_link_t *);
+static bool amap_repla_equal(const ht_link_t *, const ht_link_t *);
+
+static const hash_table_ops_t amap_repla_ops = {
+	.hash = amap_repla_hash,
+	.key_hash = amap_repla_key_hash,
+	.key_equal = amap_repla_key_equal,
+	.equal = amap_repla_equal,
+	.remove_callback = NULL
+};
+
+/** Compute hash of an IP address.
+ *
+ * @param addr Address
+ * @return Hash
+ */
+static size_t amap_addr_hash(inet_addr_t *addr)
+{
+	switch (addr->version) {
+	case ip_v4:
+		return hash_mix(addr->addr);
+	case ip_v6:
+		return hash_bytes(addr->addr6, sizeof(addr->addr6));
+	default:
+		return 0;
+	}
+}
+
+/** Compute hash of repla key.
+ *
+ * @param key Repla key
+ * @return Hash
+ */
+static size_t amap_repla_key_hash(const void *arg)
+{
+	const amap_repla_key_t *key = (const amap_repla_key_t *) arg;
+	size_t hash;
+
+	hash = amap_addr_hash(&key->rep->addr);
+	hash = hash_combine(hash, key->rep->port);
+	return hash_combine(hash, amap_addr_hash(key->laddr));
+}
+
+/** Compute hash of repla.
+ *
+ * @param item Link to repla
+ * @return Hash
+ */
+static size_t amap_repla_hash(const ht_link_t *item)
+{
+	amap_repla_t *repla = hash_table_get_inst(item, amap_repla_t, lamap);
+	amap_repla_key_t key;
+
+	key.rep = &repla->rep;
+	key.laddr = &repla->laddr;
+	return amap_repla_key_hash(&key);
+}
+
+/** Determine if repla matches key.
+ *
+ * @param arg Repla key
+ * @param hash Key hash
+ * @param item Link to repla
+ * @return @c true iff repla has the same key
+ */
+static bool amap_repla_key_equal(const void *arg, size_t hash,
+    const ht_link_t *item)
+{
+	const amap_repla_key_t *key = (const amap_repla_key_t *) arg;
+	amap_repla_t *repla = hash_table_get_inst(item, amap_repla_t, lamap);
+
+	(void) hash;
+	return inet_addr_compare(&repla->rep.addr, &key->rep->addr) &&
+	    repla->rep.port == key->rep->port &&
+	    inet_addr_compare(&repla->laddr, key->laddr);
+}
+
+/** Determine if two replas have the same key.
+ *
+ * @param item1 Link to first repla
+ * @param item2 Link to second repla
+ * @return @c true iff replas have the same key
+ */
+static bool amap_repla_equal(const ht_link_t *item1, const ht_link_t *item2)
+{
+	amap_repla_t *repla = hash_table_get_inst(item1, amap_repla_t, lamap);
+	amap_repla_key_t key;
+
+	key.rep = &repla->rep;
+	key.laddr = &repla->laddr;
+	return amap_repla_key_equal(&key, 0, item2);
+}
+
 /** Convert association map flags to port range flags.
  *
  * @param flags Association map flags
@@ -97,7 +206,12 @@ errno_t amap_create(amap_t **rmap)
 		return ENOMEM;
 	}
 
-	list_initialize(&map->repla);
+	if (!hash_table_create(&map->repla, 0, 0, &amap_repla_ops)) {
+		portrng_destroy(map->unspec);
+		free(map);
+		return ENOMEM;
+	}
+
 	list_initialize(&map->laddr);
 	list_initialize(&map->llink);
 
@@ -113,9 +227,10 @@ void amap_destroy(amap_t *map)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_destroy()");
 
-	assert(list_empty(&map->repla));
+	assert(hash_table_empty(&map->repla));
 	assert(list_empty(&map->laddr));
 	assert(list_empty(&map->llink));
+	hash_table_destroy(&map->repla);
 	free(map);
 }
 
@@ -133,34 +248,20 @@ void amap_destroy(amap_t *map)
 static errno_t amap_repla_find(amap_t *map, inet_ep_t *rep, inet_addr_t *la,
     amap_repla_t **rrepla)
 {
-	char *sraddr, *sladdr;
-
-	(void) inet_addr_format(&rep->addr, &sraddr);
-	(void) inet_addr_format(la, &sladdr);
-
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_repla_find(): rep=(%s,%" PRIu16
-	    ") la=%s", sraddr, rep->port, sladdr);
-	free(sraddr);
-	free(sladdr);
-
-	list_foreach(map->repla, lamap, amap_repla_t, repla) {
-		(void) inet_addr_format(&repla->rep.addr, &sraddr);
-		(void) inet_addr_format(&repla->laddr, &sladdr);
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_repla_find(): "
-		    "compare to rep=(%s, %" PRIu16 ") la=%s",
-		    sraddr, repla->rep.port, sladdr);
-		free(sraddr);
-		free(sladdr);
-		if (inet_addr_compare(&repla->rep.addr, &rep->addr) &&
-		    repla->rep.port == rep->port &&
-		    inet_addr_compare(&repla->laddr, la)) {
-			*rrepla = repla;
-			return EOK;
-		}
+	amap_repla_key_t key;
+	ht_link_t *link;
+
+	key.rep = rep;
+	key.laddr = la;
+
+	link = hash_table_find(&map->repla, &key);
+	if (link == NULL) {
+		*rrepla = NULL;
+		return ENOENT;
 	}
 
-	*rrepla = NULL;
-	return ENOENT;
+	*rrepla = hash_table_get_inst(link, amap_repla_t, lamap);
+	return EOK;
 }
 
 /** Insert repla.
@@ -194,7 +295,7 @@ static errno_t amap_repla_insert(amap_t *map, inet_ep_t *rep, inet_addr_t *la,
 
 	repla->rep = *rep;
 	repla->laddr = *la;
-	list_append(&repla->lamap, &map->repla);
+	hash_table_insert(&map->repla, &repla->lamap);
 
 	*rrepla = repla;
 	return EOK;
@@ -209,7 +310,7 @@ static errno_t amap_repla_insert(amap_t *map, inet_ep_t *rep, inet_addr_t *la,
  */
 static void amap_repla_remove(amap_t *map, amap_repla_t *repla)
 {
-	list_remove(&repla->lamap);
+	hash_table_remove_item(&map->repla, &repla->lamap);
 	portrng_destroy(repla->portrng);
 	free(repla);
 }
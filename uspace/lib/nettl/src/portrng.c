@@ -36,7 +36,7 @@
  * Allocates port numbers from IETF port number ranges.
  */
 
-#include <adt/list.h>
+#include <adt/hash_table.h>
 #include <errno.h>
 #include <inet/endpoint.h>
 #include <nettl/portrng.h>
@@ -45,6 +45,89 @@
 
 #include <io/log.h>
 
+static size_t portrng_port_hash(const ht_link_t *);
+static size_t portrng_port_key_hash(const void *);
+static bool portrng_port_key_equal(const void *, size_t, const ht_link_t *);
+static bool portrng_port_equal(const ht_link_t *, const ht_link_t *);
+
+static const hash_table_ops_t portrng_port_ops = {
+	.hash = portrng_port_hash,
+	.key_hash = portrng_port_key_hash,
+	.key_equal = portrng_port_key_equal,
+	.equal = portrng_port_equal,
+	.remove_callback = NULL
+};
+
+/** Compute hash of port number key.
+ *
+ * @param key Pointer to port number
+ * @return Hash
+ */
+static size_t portrng_port_key_hash(const void *key)
+{
+	return *(const uint16_t *) key;
+}
+
+/** Compute hash of allocated port.
+ *
+ * @param item Link to allocated port
+ * @return Hash
+ */
+static size_t portrng_port_hash(const ht_link_t *item)
+{
+	portrng_port_t *port = hash_table_get_inst(item, portrng_port_t, lprng);
+	return port->pn;
+}
+
+/** Determine if allocated port has port number.
+ *
+ * @param key Pointer to port number
+ * @param hash Key hash
+ * @param item Link to allocated port
+ * @return @c true iff port has the port number
+ */
+static bool portrng_port_key_equal(const void *key, size_t hash,
+    const ht_link_t *item)
+{
+	portrng_port_t *port = hash_table_get_inst(item, portrng_port_t, lprng);
+
+	(void) hash;
+	return port->pn == *(const uint16_t *) key;
+}
+
+/** Determine if two allocated ports have the same port number.
+ *
+ * @param item1 Link to first allocated port
+ * @param item2 Link to second allocated port
+ * @return @c true iff ports have the same port number
+ */
+static bool portrng_port_equal(const ht_link_t *item1, const ht_link_t *item2)
+{
+	portrng_port_t *port1 = hash_table_get_inst(item1, portrng_port_t,
+	    lprng);
+	portrng_port_t *port2 = hash_table_get_inst(item2, portrng_port_t,
+	    lprng);
+
+	return port1->pn == port2->pn;
+}
+
+/** Find allocated port.
+ *
+ * @param pr   Port range
+ * @param pnum Port number
+ * @return Allocated port or @c NULL if @a pnum is not allocated
+ */
+static portrng_port_t *portrng_port_find(portrng_t *pr, uint16_t pnum)
+{
+	ht_link_t *link;
+
+	link = hash_table_find(&pr->used, &pnum);
+	if (link == NULL)
+		return NULL;
+
+	return hash_table_get_inst(link, portrng_port_t, lprng);
+}
+
 /** Create port range.
  *
  * @param rpr Place to store pointer to new port range
@@ -60,7 +143,11 @@ errno_t portrng_create(portrng_t **rpr)
 	if (pr == NULL)
 		return ENOMEM;
 
-	list_initialize(&pr->used);
+	if (!hash_table_create(&pr->used, 0, 0, &portrng_port_ops)) {
+		free(pr);
+		return ENOMEM;
+	}
+
 	*rpr = pr;
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_create() - end");
 	return EOK;
@@ -73,7 +160,8 @@ errno_t portrng_create(portrng_t **rpr)
 void portrng_destroy(portrng_t *pr)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_destroy()");
-	assert(list_empty(&pr->used));
+	assert(hash_table_empty(&pr->used));
+	hash_table_destroy(&pr->used);
 	free(pr);
 }
 
@@ -97,7 +185,6 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
 {
 	portrng_port_t *p;
 	uint32_t i;
-	bool found;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_alloc() - begin");
 
@@ -105,15 +192,7 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
 
 		for (i = inet_port_dyn_lo; i <= inet_port_dyn_hi; i++) {
 			log_msg(LOG_DEFAULT, LVL_DEBUG2, "trying %" PRIu32, i);
-			found = false;
-			list_foreach(pr->used, lprng, portrng_port_t, port) {
-				if (port->pn == pnum) {
-					found = true;
-					break;
-				}
-			}
-
-			if (!found) {
+			if (portrng_port_find(pr, i) == NULL) {
 				pnum = i;
 				break;
 			}
@@ -133,11 +212,9 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
 			return EINVAL;
 		}
 
-		list_foreach(pr->used, lprng, portrng_port_t, port) {
-			if (port->pn == pnum) {
-				log_msg(LOG_DEFAULT, LVL_DEBUG2, "port already used");
-				return EEXIST;
-			}
+		if (portrng_port_find(pr, pnum) != NULL) {
+			log_msg(LOG_DEFAULT, LVL_DEBUG2, "port already used");
+			return EEXIST;
 		}
 	}
 
@@ -147,7 +224,7 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
 
 	p->pn = pnum;
 	p->arg = arg;
-	list_append(&p->lprng, &pr->used);
+	hash_table_insert(&pr->used, &p->lprng);
 	*apnum = pnum;
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_alloc() - end OK pn=%" PRIu16,
 	    pnum);
@@ -164,14 +241,14 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
  */
 errno_t portrng_find_port(portrng_t *pr, uint16_t pnum, void **rarg)
 {
-	list_foreach(pr->used, lprng, portrng_port_t, port) {
-		if (port->pn == pnum) {
-			*rarg = port->arg;
-			return EOK;
-		}
-	}
+	portrng_port_t *port;
+
+	port = portrng_port_find(pr, pnum);
+	if (port == NULL)
+		return ENOENT;
 
-	return ENOENT;
+	*rarg = port->arg;
+	return EOK;
 }
 
 /** Free port in port range.
@@ -183,19 +260,17 @@ void portrng_free_port(portrng_t *pr, uint16_t pnum)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port(%u)", pnum);
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port() - begin");
-	list_foreach(pr->used, lprng, portrng_port_t, port) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - check port %u", port->pn);
-		if (port->pn == pnum) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - OK");
-			list_remove(&port->lprng);
-			free(port);
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port() - end");
-			return;
-		}
+
+	portrng_port_t *port = portrng_port_find(pr, pnum);
+	if (port == NULL) {
+		log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - FAIL");
+		assert(false);
+		return;
 	}
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - FAIL");
-	assert(false);
+	hash_table_remove_item(&pr->used, &port->lprng);
+	free(port);
+	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port() - end");
 }
 
 /** Determine if port range is empty.
@@ -206,7 +281,7 @@ void portrng_free_port(portrng_t *pr, uint16_t pnum)
 bool portrng_empty(portrng_t *pr)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_empty()");
-	return list_empty(&pr->used);
+	return hash_table_empty(&pr->used);
 }
 
 /**
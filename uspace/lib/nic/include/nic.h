@@ -274,6 +274,10 @@ extern void nic_set_wol_max_caps(nic_t *, nic_wv_type_t, int);
 extern uint64_t nic_mcast_hash(const nic_address_t *, size_t);
 extern uint64_t nic_query_mcast_hash(nic_t *);
 
+/* Checksum offload helpers */
+extern errno_t nic_csum_tx_prepare(void *, size_t, uint32_t, size_t *,
+    size_t *);
+
 /* Software period functions */
 extern void nic_sw_period_start(nic_t *);
 extern void nic_sw_period_stop(nic_t *);
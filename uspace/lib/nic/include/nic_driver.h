@@ -45,6 +45,7 @@
 #include <fibril_synch.h>
 #include <nic/nic.h>
 #include <async.h>
+#include <nic_rxring.h>
 #include <pcapdump_srv.h>
 
 #include "nic.h"
@@ -80,6 +81,13 @@ struct nic {
 	nic_address_t default_mac;
 	/** Client callback session */
 	async_sess_t *client_session;
+	/** Receive ring shared by the client or NULL */
+	nic_rxring_t *rxring;
+	/**
+	 * Lock for the receive ring, serializes the drivers' receive paths
+	 * which are its single producer. Does not nest with other locks.
+	 */
+	fibril_mutex_t rxring_lock;
 	/** Current polling mode of the NIC */
 	nic_poll_mode_t poll_mode;
 	/** Polling period (applicable when poll_mode == NIC_POLL_PERIODIC) */
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @addtogroup libnic
+ * @{
+ */
+/**
+ * @file
+ * @brief Transmit checksum offload helpers
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <nic/nic.h>
+#include "nic.h"
+
+#define NIC_CSUM_ETH_HDR_SIZE  14
+#define NIC_CSUM_IP_HDR_SIZE   20
+#define NIC_CSUM_IP6_HDR_SIZE  40
+
+#define NIC_CSUM_ETYPE_IP   0x0800
+#define NIC_CSUM_ETYPE_IP6  0x86dd
+
+#define NIC_CSUM_PROTO_TCP  6
+#define NIC_CSUM_PROTO_UDP  17
+
+/** Offset of the checksum field in the TCP header */
+#define NIC_CSUM_TCP_OFFSET  16
+/** Offset of the checksum field in the UDP header */
+#define NIC_CSUM_UDP_OFFSET  6
+
+static uint16_t nic_csum_get16(const uint8_t *data)
+{
+	return ((uint16_t) data[0] << 8) | data[1];
+}
+
+/** Add 16-bit big-endian words to a ones' complement sum (unfolded). */
+static uint32_t nic_csum_add(uint32_t sum, const uint8_t *data, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i + 1 < size; i += 2)
+		sum += nic_csum_get16(data + i);
+
+	if (size % 2 != 0)
+		sum += (uint32_t) data[size - 1] << 8;
+
+	return sum;
+}
+
+static uint16_t nic_csum_fold(uint32_t sum)
+{
+	while ((sum >> 16) != 0)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t) sum;
+}
+
+/** Prepare a frame for transport checksum insertion by the NIC.
+ *
+ * Locate the TCP or UDP header in an untagged Ethernet frame carrying
+ * an unfragmented IPv4 or IPv6 datagram and seed its checksum field
+ * with the sum of the pseudo-header. The NIC then sums the frame from
+ * @a *csum_start to its end and stores the complemented result at
+ * @a *csum_start + @a *csum_offset.
+ *
+ * The checksum field is overwritten regardless of its previous value.
+ *
+ * @param data        Frame data
+ * @param size        Frame size in bytes
+ * @param offload     Active offload flags (NIC_OFFLOAD_TX_TCP_CSUM,
+ *                    NIC_OFFLOAD_TX_UDP_CSUM)
+ * @param csum_start  Place to store offset of the transport header
+ * @param csum_offset Place to store offset of the checksum field within
+ *                    the transport header
+ *
+ * @return EOK on success
+ * @return ENOTSUP if the checksum of this frame cannot be offloaded
+ */
+errno_t nic_csum_tx_prepare(void *data, size_t size, uint32_t offload,
+    size_t *csum_start, size_t *csum_offset)
+{
+	uint8_t *frame = (uint8_t *) data;
+	uint8_t *ip;
+	size_t ihl;
+	size_t tot_len;
+	size_t l4_start;
+	size_t l4_size;
+	uint8_t proto;
+	uint32_t sum;
+
+	if (size < NIC_CSUM_ETH_HDR_SIZE)
+		return ENOTSUP;
+
+	ip = frame + NIC_CSUM_ETH_HDR_SIZE;
+
+	switch (nic_csum_get16(frame + 12)) {
+	case NIC_CSUM_ETYPE_IP:
+		if (size < NIC_CSUM_ETH_HDR_SIZE + NIC_CSUM_IP_HDR_SIZE)
+			return ENOTSUP;
+		if ((ip[0] >> 4) != 4)
+			return ENOTSUP;
+
+		ihl = (ip[0] & 0x0f) * 4;
+		tot_len = nic_csum_get16(ip + 2);
+
+		/* More fragments flag or non-zero fragment offset */
+		if ((nic_csum_get16(ip + 6) & 0x3fff) != 0)
+			return ENOTSUP;
+		if (ihl < NIC_CSUM_IP_HDR_SIZE || tot_len < ihl ||
+		    NIC_CSUM_ETH_HDR_SIZE + tot_len > size)
+			return ENOTSUP;
+
+		proto = ip[9];
+		l4_start = NIC_CSUM_ETH_HDR_SIZE + ihl;
+		l4_size = tot_len - ihl;
+
+		/* Source and destination address */
+		sum = nic_csum_add(0, ip + 12, 8);
+		break;
+	case NIC_CSUM_ETYPE_IP6:
+		if (size < NIC_CSUM_ETH_HDR_SIZE + NIC_CSUM_IP6_HDR_SIZE)
+			return ENOTSUP;
+		if ((ip[0] >> 4) != 6)
+			return ENOTSUP;
+
+		/* Extension headers are not supported */
+		proto = ip[6];
+		l4_start = NIC_CSUM_ETH_HDR_SIZE + NIC_CSUM_IP6_HDR_SIZE;
+		l4_size = nic_csum_get16(ip + 4);
+		if (l4_start + l4_size > size)
+			return ENOTSUP;
+
+		/* Source and destination address */
+		sum = nic_csum_add(0, ip + 8, 32);
+		break;
+	default:
+		return ENOTSUP;
+	}
+
+	switch (proto) {
+	case NIC_CSUM_PROTO_TCP:
+		if ((offload & NIC_OFFLOAD_TX_TCP_CSUM) == 0 || l4_size < 20)
+			return ENOTSUP;
+		*csum_offset = NIC_CSUM_TCP_OFFSET;
+		break;
+	case NIC_CSUM_PROTO_UDP:
+		if ((offload & NIC_OFFLOAD_TX_UDP_CSUM) == 0 || l4_size < 8)
+			return ENOTSUP;
+		*csum_offset = NIC_CSUM_UDP_OFFSET;
+		break;
+	default:
+		return ENOTSUP;
+	}
+
+	sum += proto;
+	sum += l4_size;
+
+	uint16_t phsum = nic_csum_fold(sum);
+	frame[l4_start + *csum_offset] = phsum >> 8;
+	frame[l4_start + *csum_offset + 1] = phsum & 0xff;
+
+	*csum_start = l4_start;
+	return EOK;
+}
+
+/** @}
+ */
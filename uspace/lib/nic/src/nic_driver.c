@@ -144,6 +144,8 @@ void nic_driver_implement(driver_ops_t *driver_ops, ddf_dev_ops_t *dev_ops,
 			iface->poll_set_mode = nic_poll_set_mode_impl;
 		if (!iface->poll_now)
 			iface->poll_now = nic_poll_now_impl;
+		if (!iface->rxring_set)
+			iface->rxring_set = nic_rxring_set_impl;
 	}
 }
 
@@ -508,6 +510,43 @@ void nic_set_tx_busy(nic_t *nic_data, int busy)
 	nic_data->tx_busy = busy;
 }
 
+/**
+ * Pass a received frame to the client. The frame is placed into the receive
+ * ring if the client shared one, the client is only notified if it waits
+ * for more frames. Otherwise the frame is sent in a message of its own.
+ *
+ * @param nic_data
+ * @param data		Frame data
+ * @param size		Frame size in bytes
+ */
+static void nic_deliver_frame(nic_t *nic_data, void *data, size_t size)
+{
+	bool notify = false;
+	errno_t rc = ENOTSUP;
+
+	fibril_mutex_lock(&nic_data->rxring_lock);
+	if (nic_data->rxring != NULL)
+		rc = nic_rxring_put(nic_data->rxring, data, size, &notify);
+	fibril_mutex_unlock(&nic_data->rxring_lock);
+
+	switch (rc) {
+	case EOK:
+		if (notify)
+			nic_ev_rxring(nic_data->client_session);
+		break;
+	case ENOMEM:
+		/* The client did not keep up, all buffers are in use */
+		fibril_rwlock_write_lock(&nic_data->stats_lock);
+		nic_data->stats.receive_dropped++;
+		fibril_rwlock_write_unlock(&nic_data->stats_lock);
+		break;
+	default:
+		/* No ring or the frame does not fit into a ring buffer */
+		nic_ev_received(nic_data->client_session, data, size);
+		break;
+	}
+}
+
 /**
  * This is the function that the driver should call when it receives a frame.
  * The frame is checked by filters and then sent up to the NIL layer or
@@ -545,8 +584,7 @@ void nic_received_frame(nic_t *nic_data, nic_frame_t *frame)
 			break;
 		}
 		fibril_rwlock_write_unlock(&nic_data->stats_lock);
-		nic_ev_received(nic_data->client_session, frame->data,
-		    frame->size);
+		nic_deliver_frame(nic_data, frame->data, frame->size);
 	} else {
 		switch (frame_type) {
 		case NIC_FRAME_UNICAST:
@@ -612,6 +650,7 @@ static nic_t *nic_create(ddf_dev_t *dev)
 	nic_data->fun = NULL;
 	nic_data->state = NIC_STATE_STOPPED;
 	nic_data->client_session = NULL;
+	nic_data->rxring = NULL;
 	nic_data->poll_mode = NIC_POLL_IMMEDIATE;
 	nic_data->default_poll_mode = NIC_POLL_IMMEDIATE;
 	nic_data->send_frame = NULL;
@@ -624,6 +663,7 @@ static nic_t *nic_create(ddf_dev_t *dev)
 	fibril_rwlock_initialize(&nic_data->stats_lock);
 	fibril_rwlock_initialize(&nic_data->rxc_lock);
 	fibril_rwlock_initialize(&nic_data->wv_lock);
+	fibril_mutex_initialize(&nic_data->rxring_lock);
 
 	memset(&nic_data->mac, 0, sizeof(nic_address_t));
 	memset(&nic_data->default_mac, 0, sizeof(nic_address_t));
@@ -666,6 +706,8 @@ nic_t *nic_create_and_bind(ddf_dev_t *device)
  */
 static void nic_destroy(nic_t *nic_data)
 {
+	if (nic_data->rxring != NULL)
+		nic_rxring_destroy(nic_data->rxring);
 	free(nic_data->specific);
 }
 
@@ -93,5 +93,13 @@ errno_t nic_ev_received(async_sess_t *sess, void *data, size_t size)
 	return retval;
 }
 
+/** Frames placed into the receive ring. */
+void nic_ev_rxring(async_sess_t *sess)
+{
+	async_exch_t *exch = async_exchange_begin(sess);
+	async_msg_0(exch, NIC_EV_RXRING);
+	async_exchange_end(exch);
+}
+
 /** @}
  */
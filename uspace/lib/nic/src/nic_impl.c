@@ -204,6 +204,14 @@ errno_t nic_callback_create_impl(ddf_fun_t *fun)
 		return ENOMEM;
 	}
 
+	/* A receive ring belongs to the previous client */
+	fibril_mutex_lock(&nic->rxring_lock);
+	if (nic->rxring != NULL) {
+		nic_rxring_destroy(nic->rxring);
+		nic->rxring = NULL;
+	}
+	fibril_mutex_unlock(&nic->rxring_lock);
+
 	fibril_rwlock_write_unlock(&nic->main_lock);
 	return EOK;
 }
@@ -809,6 +817,39 @@ errno_t nic_poll_now_impl(ddf_fun_t *fun)
 	}
 }
 
+/**
+ * Default implementation of the rxring_set method.
+ * Received frames are placed into the ring from now on.
+ *
+ * @param[in]	fun
+ * @param[in]	area	Shared area holding the ring
+ * @param[in]	size	Size of the area
+ *
+ * @return EOK		If the ring was set
+ * @return EBUSY	If a ring is already set
+ * @return EINVAL	If the area is too small
+ * @return ENOMEM	If there was not enough memory
+ */
+errno_t nic_rxring_set_impl(ddf_fun_t *fun, void *area, size_t size)
+{
+	nic_t *nic_data = nic_get_from_ddf_fun(fun);
+	nic_rxring_t *ring;
+	errno_t rc;
+
+	fibril_mutex_lock(&nic_data->rxring_lock);
+	if (nic_data->rxring != NULL) {
+		fibril_mutex_unlock(&nic_data->rxring_lock);
+		return EBUSY;
+	}
+
+	rc = nic_rxring_attach(area, size, &ring);
+	if (rc == EOK)
+		nic_data->rxring = ring;
+
+	fibril_mutex_unlock(&nic_data->rxring_lock);
+	return rc;
+}
+
 /**
  * Default handler for unknown methods (outside of the NIC interface).
  * Logs a warning message and returns ENOTSUP to the caller.
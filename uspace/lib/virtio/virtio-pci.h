@@ -63,6 +63,9 @@
 
 #define VIRTIO_F_VERSION_1	1
 
+/** Driver and device use the used_event and avail_event ring fields */
+#define VIRTIO_F_RING_EVENT_IDX	(1U << 29)
+
 /** Common configuration structure layout according to VIRTIO version 1.0 */
 typedef struct virtio_pci_common_cfg {
 	ioport32_t device_feature_select;
@@ -151,6 +154,15 @@ typedef struct {
 	virtq_used_t *used;
 	uint16_t used_last_idx;
 
+	/** Event index feature negotiated */
+	bool event_idx;
+	/** Used buffer notifications (interrupts) are requested */
+	bool intr_enabled;
+	/** used_event field following the available ring */
+	ioport16_t *used_event;
+	/** avail_event field following the used ring */
+	ioport16_t *avail_event;
+
 	/** Address of the queue's notification register */
 	ioport16_t *notify;
 } virtq_t;
@@ -179,6 +191,9 @@ typedef struct {
 	/** Device-specific configuration */
 	void *device_cfg;
 
+	/** Negotiated feature bits 0 - 31 */
+	uint32_t features;
+
 	/** Virtqueues */
 	virtq_t *queues;
 } virtio_dev_t;
@@ -198,13 +213,17 @@ extern uint16_t virtio_alloc_desc(virtio_dev_t *, uint16_t, uint16_t *);
 extern void virtio_free_desc(virtio_dev_t *, uint16_t, uint16_t *, uint16_t);
 
 extern void virtio_virtq_produce_available(virtio_dev_t *, uint16_t, uint16_t);
+extern void virtio_virtq_produce_available_batch(virtio_dev_t *, uint16_t,
+    const uint16_t *, size_t);
 extern bool virtio_virtq_consume_used(virtio_dev_t *, uint16_t, uint16_t *,
     uint32_t *);
+extern void virtio_virtq_disable_interrupts(virtio_dev_t *, uint16_t);
+extern bool virtio_virtq_enable_interrupts(virtio_dev_t *, uint16_t);
 
 extern errno_t virtio_virtq_setup(virtio_dev_t *, uint16_t, uint16_t);
 extern void virtio_virtq_teardown(virtio_dev_t *, uint16_t);
 
-extern errno_t virtio_device_setup_start(virtio_dev_t *, uint32_t);
+extern errno_t virtio_device_setup_start(virtio_dev_t *, uint32_t, uint32_t);
 extern void virtio_device_setup_fail(virtio_dev_t *);
 extern void virtio_device_setup_finalize(virtio_dev_t *);
 
@@ -170,18 +170,62 @@ void virtio_free_desc(virtio_dev_t *vdev, uint16_t num, uint16_t *head,
 	fibril_mutex_unlock(&q->lock);
 }
 
+/** Determine whether the device needs to be notified about new buffers
+ *
+ * @param q        Virtqueue
+ * @param old_idx  Available ring index before the buffers were added
+ * @param new_idx  Available ring index after the buffers were added
+ */
+static bool virtio_virtq_need_notify(virtq_t *q, uint16_t old_idx,
+    uint16_t new_idx)
+{
+	if (q->event_idx) {
+		uint16_t event = pio_read_le16(q->avail_event);
+		return (uint16_t) (new_idx - event - 1) <
+		    (uint16_t) (new_idx - old_idx);
+	}
+
+	return !(pio_read_le16(&q->used->flags) & VIRTQ_USED_F_NO_NOTIFY);
+}
+
 void virtio_virtq_produce_available(virtio_dev_t *vdev, uint16_t num,
     uint16_t descno)
+{
+	virtio_virtq_produce_available_batch(vdev, num, &descno, 1);
+}
+
+/** Make several descriptors available to the device at once
+ *
+ * The available ring index is updated and the device is notified at most
+ * once for the whole batch.
+ *
+ * @param vdev[in]    VIRTIO device
+ * @param num[in]     Index of the virtqueue
+ * @param descno[in]  Array of descriptors to make available
+ * @param count[in]   Number of descriptors in @a descno
+ */
+void virtio_virtq_produce_available_batch(virtio_dev_t *vdev, uint16_t num,
+    const uint16_t *descno, size_t count)
 {
 	virtq_t *q = &vdev->queues[num];
 
+	if (count == 0)
+		return;
+
 	fibril_mutex_lock(&q->lock);
-	uint16_t idx = pio_read_le16(&q->avail->idx);
-	pio_write_le16(&q->avail->ring[idx % q->queue_size], descno);
-	write_barrier();
-	pio_write_le16(&q->avail->idx, idx + 1);
+	uint16_t old_idx = pio_read_le16(&q->avail->idx);
+	for (size_t i = 0; i < count; i++) {
+		uint16_t idx = old_idx + i;
+		pio_write_le16(&q->avail->ring[idx % q->queue_size],
+		    descno[i]);
+	}
 	write_barrier();
-	pio_write_le16(q->notify, num);
+	uint16_t new_idx = old_idx + count;
+	pio_write_le16(&q->avail->idx, new_idx);
+	/* The index must be visible before we look at the device's event */
+	memory_barrier();
+	if (virtio_virtq_need_notify(q, old_idx, new_idx))
+		pio_write_le16(q->notify, num);
 	fibril_mutex_unlock(&q->lock);
 }
 
@@ -201,11 +245,65 @@ bool virtio_virtq_consume_used(virtio_dev_t *vdev, uint16_t num,
 	*len = pio_read_le32(&q->used->ring[last_idx].len);
 
 	q->used_last_idx++;
+
+	/* Ask for an interrupt once the device uses the next buffer */
+	if (q->event_idx && q->intr_enabled)
+		pio_write_le16(q->used_event, q->used_last_idx);
+
 	fibril_mutex_unlock(&q->lock);
 
 	return true;
 }
 
+/** Suppress used buffer notifications (interrupts) for a virtqueue
+ *
+ * This is only a hint, the device may still interrupt.
+ *
+ * @param vdev[in]  VIRTIO device
+ * @param num[in]   Index of the virtqueue
+ */
+void virtio_virtq_disable_interrupts(virtio_dev_t *vdev, uint16_t num)
+{
+	virtq_t *q = &vdev->queues[num];
+
+	fibril_mutex_lock(&q->lock);
+	q->intr_enabled = false;
+	if (q->event_idx) {
+		/* Place the event as far away from the used index as possible */
+		pio_write_le16(q->used_event, q->used_last_idx - 1);
+	} else {
+		pio_write_le16(&q->avail->flags, VIRTQ_AVAIL_F_NO_INTERRUPT);
+	}
+	fibril_mutex_unlock(&q->lock);
+}
+
+/** Re-enable used buffer notifications (interrupts) for a virtqueue
+ *
+ * Buffers used by the device before the notifications were enabled do
+ * not trigger an interrupt, the caller must consume them.
+ *
+ * @param vdev[in]  VIRTIO device
+ * @param num[in]   Index of the virtqueue
+ *
+ * @return  True if there are used buffers pending, false otherwise.
+ */
+bool virtio_virtq_enable_interrupts(virtio_dev_t *vdev, uint16_t num)
+{
+	virtq_t *q = &vdev->queues[num];
+
+	fibril_mutex_lock(&q->lock);
+	q->intr_enabled = true;
+	if (q->event_idx)
+		pio_write_le16(q->used_event, q->used_last_idx);
+	else
+		pio_write_le16(&q->avail->flags, 0);
+	memory_barrier();
+	bool pending = pio_read_le16(&q->used->idx) != q->used_last_idx;
+	fibril_mutex_unlock(&q->lock);
+
+	return pending;
+}
+
 errno_t virtio_virtq_setup(virtio_dev_t *vdev, uint16_t num, uint16_t size)
 {
 	virtq_t *q = &vdev->queues[num];
@@ -258,6 +356,10 @@ errno_t virtio_virtq_setup(virtio_dev_t *vdev, uint16_t num, uint16_t size)
 	q->avail = q->virt + avail_offset;
 	q->used = q->virt + used_offset;
 	q->used_last_idx = 0;
+	q->event_idx = (vdev->features & VIRTIO_F_RING_EVENT_IDX) != 0;
+	q->intr_enabled = true;
+	q->used_event = &q->avail->ring[size];
+	q->avail_event = (ioport16_t *) &q->used->ring[size];
 
 	memset(q->virt, 0, q->size);
 
@@ -299,8 +401,13 @@ void virtio_virtq_teardown(virtio_dev_t *vdev, uint16_t num)
 /**
  * Perform device initialization as described in section 3.1.1 of the
  * specification, steps 1 - 6.
+ *
+ * All of @a features must be offered by the device, @a optional features
+ * are accepted only if offered. The negotiated set is stored in
+ * @a vdev->features.
  */
-errno_t virtio_device_setup_start(virtio_dev_t *vdev, uint32_t features)
+errno_t virtio_device_setup_start(virtio_dev_t *vdev, uint32_t features,
+    uint32_t optional)
 {
 	virtio_pci_common_cfg_t *cfg = vdev->common_cfg;
 
@@ -330,6 +437,8 @@ errno_t virtio_device_setup_start(virtio_dev_t *vdev, uint32_t features)
 	if (features != (features & device_features))
 		return ENOTSUP;
 	features &= device_features;
+	features |= optional & device_features;
+	vdev->features = features;
 
 	if (reserved_features != (reserved_features & device_reserved_features))
 		return ENOTSUP;
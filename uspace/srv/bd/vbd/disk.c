@@ -72,6 +72,9 @@ static errno_t vbds_bd_write_blocks(bd_srv_t *, aoff64_t, size_t, const void *,
 static errno_t vbds_bd_get_block_size(bd_srv_t *, size_t *);
 static errno_t vbds_bd_get_num_blocks(bd_srv_t *, aoff64_t *);
 static errno_t vbds_bd_eject(bd_srv_t *);
+static errno_t vbds_bd_fwd_begin(bd_srv_t *, aoff64_t, size_t, async_sess_t **,
+    aoff64_t *);
+static void vbds_bd_fwd_end(bd_srv_t *);
 
 static errno_t vbds_bsa_translate(vbds_part_t *, aoff64_t, size_t, aoff64_t *);
 
@@ -95,7 +98,9 @@ static bd_ops_t vbds_bd_ops = {
 	.write_blocks = vbds_bd_write_blocks,
 	.get_block_size = vbds_bd_get_block_size,
 	.get_num_blocks = vbds_bd_get_num_blocks,
-	.eject = vbds_bd_eject
+	.eject = vbds_bd_eject,
+	.fwd_begin = vbds_bd_fwd_begin,
+	.fwd_end = vbds_bd_fwd_end
 };
 
 /** Provide disk access to liblabel */
@@ -527,6 +532,22 @@ errno_t vbds_disk_add(service_id_t sid)
 
 	block_inited = true;
 
+	disk->sess = loc_service_connect(sid, INTERFACE_BLOCK, 0);
+	if (disk->sess == NULL) {
+		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed connecting to %s.",
+		    disk->svc_name);
+		rc = EIO;
+		goto error;
+	}
+
+	rc = bd_open(disk->sess, &disk->bd);
+	if (rc != EOK) {
+		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed opening %s.",
+		    disk->svc_name);
+		rc = EIO;
+		goto error;
+	}
+
 	lbd.ops = &vbds_label_bd_ops;
 	lbd.arg = (void *) disk;
 
@@ -552,6 +573,10 @@ errno_t vbds_disk_add(service_id_t sid)
 	return EOK;
 error:
 	label_close(label);
+	if (disk != NULL && disk->bd != NULL)
+		bd_close(disk->bd);
+	if (disk != NULL && disk->sess != NULL)
+		async_hangup(disk->sess);
 	if (block_inited) {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "block_fini(%zu)", sid);
 		block_fini(sid);
@@ -581,6 +606,8 @@ errno_t vbds_disk_remove(service_id_t sid)
 
 	list_remove(&disk->ldisks);
 	label_close(disk->label);
+	bd_close(disk->bd);
+	async_hangup(disk->sess);
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "block_fini(%zu)", sid);
 	block_fini(sid);
 	free(disk->svc_name);
@@ -1111,6 +1138,35 @@ static errno_t vbds_bd_eject(bd_srv_t *bd)
 	return rc;
 }
 
+/** Begin forwarding partition I/O to the disk.
+ *
+ * The partition is kept locked for reading until vbds_bd_fwd_end()
+ * so that it cannot go away while the request is in progress.
+ */
+static errno_t vbds_bd_fwd_begin(bd_srv_t *bd, aoff64_t ba, size_t cnt,
+    async_sess_t **rsess, aoff64_t *rgba)
+{
+	vbds_part_t *part = bd_srv_part(bd);
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG2, "vbds_bd_fwd_begin()");
+	fibril_rwlock_read_lock(&part->lock);
+
+	if (vbds_bsa_translate(part, ba, cnt, rgba) != EOK) {
+		fibril_rwlock_read_unlock(&part->lock);
+		return ELIMIT;
+	}
+
+	*rsess = part->disk->sess;
+	return EOK;
+}
+
+static void vbds_bd_fwd_end(bd_srv_t *bd)
+{
+	vbds_part_t *part = bd_srv_part(bd);
+
+	fibril_rwlock_read_unlock(&part->lock);
+}
+
 void vbds_bd_conn(ipc_call_t *icall, void *arg)
 {
 	vbds_part_t *part;
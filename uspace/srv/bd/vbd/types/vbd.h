@@ -38,6 +38,8 @@
 #define TYPES_VBDS_H_
 
 #include <adt/list.h>
+#include <async.h>
+#include <bd.h>
 #include <bd_srv.h>
 #include <label/label.h>
 #include <loc.h>
@@ -93,6 +95,10 @@ typedef struct vbds_disk {
 	service_id_t svc_id;
 	/** Disk service name */
 	char *svc_name;
+	/** Session to disk, partition I/O is forwarded here */
+	async_sess_t *sess;
+	/** Block device opened on @c sess */
+	bd_t *bd;
 	/** Label */
 	label_t *label;
 	/** Partitions */
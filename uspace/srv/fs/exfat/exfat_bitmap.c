@@ -44,196 +44,484 @@
 #include <align.h>
 #include <assert.h>
 #include <fibril_synch.h>
+#include <adt/list.h>
+#include <macros.h>
 #include <mem.h>
+#include <stdlib.h>
 
-errno_t exfat_bitmap_is_free(exfat_bs_t *bs, service_id_t service_id,
-    exfat_cluster_t clst)
+/**
+ * Number of free clusters that a newly allocated contiguous run tries to
+ * leave behind itself so that the node can later grow without having to
+ * switch to a FAT chain.
+ */
+#define EXFAT_BITMAP_SLACK	16
+
+/**
+ * In-memory copy of the Allocation Bitmap of one file system instance.
+ *
+ * The copy is authoritative for lookups; every modification is written
+ * through to the on-disk bitmap.
+ */
+typedef struct {
+	link_t link;
+	service_id_t service_id;
+
+	/** Protects all of the fields below. */
+	fibril_mutex_t lock;
+	/** One bit per data cluster, same layout as on disk. */
+	uint8_t *map;
+	/** Number of data clusters covered by @c map. */
+	exfat_cluster_t clusters;
+	/** Number of free data clusters. */
+	exfat_cluster_t free;
+	/** Bit index at which the next contiguous run search starts. */
+	exfat_cluster_t hint;
+} exfat_bitmap_cache_t;
+
+/** Mutex protecting the list of bitmap caches. */
+static FIBRIL_MUTEX_INITIALIZE(bitmap_cache_lock);
+
+/** List of bitmap caches. */
+static LIST_INITIALIZE(bitmap_cache_list);
+
+static inline bool bitmap_test(exfat_bitmap_cache_t *cache, exfat_cluster_t i)
+{
+	return cache->map[i / 8] & (1 << (i % 8));
+}
+
+/** Set or clear a range of bits and keep the free cluster count in sync. */
+static void bitmap_mark(exfat_bitmap_cache_t *cache, exfat_cluster_t first,
+    exfat_cluster_t count, bool alloc)
+{
+	exfat_cluster_t i;
+
+	for (i = first; i < first + count; i++) {
+		if (bitmap_test(cache, i) == alloc)
+			continue;
+		if (alloc) {
+			cache->map[i / 8] |= (1 << (i % 8));
+			cache->free--;
+		} else {
+			cache->map[i / 8] &= ~(1 << (i % 8));
+			cache->free++;
+		}
+	}
+}
+
+/** Find a run of @a count free bits in the interval [@a from, @a to). */
+static bool bitmap_find_run(exfat_bitmap_cache_t *cache, exfat_cluster_t from,
+    exfat_cluster_t to, exfat_cluster_t count, exfat_cluster_t *first)
+{
+	exfat_cluster_t i = from;
+	exfat_cluster_t start = from;
+	exfat_cluster_t run = 0;
+
+	while (i < to) {
+		/* Skip over whole bytes that are completely used or free. */
+		if (i % 8 == 0 && i + 8 <= to) {
+			uint8_t byte = cache->map[i / 8];
+
+			if (byte == 0xff) {
+				run = 0;
+				i += 8;
+				continue;
+			}
+			if (byte == 0) {
+				if (run == 0)
+					start = i;
+				run += 8;
+				i += 8;
+				if (run >= count) {
+					*first = start;
+					return true;
+				}
+				continue;
+			}
+		}
+
+		if (bitmap_test(cache, i)) {
+			run = 0;
+		} else {
+			if (run == 0)
+				start = i;
+			if (++run == count) {
+				*first = start;
+				return true;
+			}
+		}
+		i++;
+	}
+
+	return false;
+}
+
+/** Write the bytes covering the given range of bits back to the disk. */
+static errno_t bitmap_write(exfat_bs_t *bs, exfat_bitmap_cache_t *cache,
+    exfat_cluster_t first, exfat_cluster_t count)
 {
 	fs_node_t *fn;
-	block_t *b = NULL;
 	exfat_node_t *bitmapp;
-	uint8_t *bitmap;
+	block_t *b;
+	aoff64_t offset, end;
+	size_t n;
 	errno_t rc;
-	bool alloc;
-
-	clst -= EXFAT_CLST_FIRST;
 
-	rc = exfat_bitmap_get(&fn, service_id);
+	rc = exfat_bitmap_get(&fn, cache->service_id);
 	if (rc != EOK)
 		return rc;
 	bitmapp = EXFAT_NODE(fn);
 
-	aoff64_t offset = clst / 8;
-	rc = exfat_block_get(&b, bs, bitmapp, offset / BPS(bs), BLOCK_FLAGS_NONE);
-	if (rc != EOK) {
-		(void) exfat_node_put(fn);
-		return rc;
+	offset = first / 8;
+	end = (first + count - 1) / 8 + 1;
+	while (offset < end) {
+		rc = exfat_block_get(&b, bs, bitmapp, offset / BPS(bs),
+		    BLOCK_FLAGS_NONE);
+		if (rc != EOK) {
+			(void) exfat_node_put(fn);
+			return rc;
+		}
+
+		n = min(end - offset, BPS(bs) - offset % BPS(bs));
+		memcpy((uint8_t *) b->data + offset % BPS(bs),
+		    cache->map + offset, n);
+		b->dirty = true;
+		rc = block_put(b);
+		if (rc != EOK) {
+			(void) exfat_node_put(fn);
+			return rc;
+		}
+		offset += n;
 	}
-	bitmap = (uint8_t *)b->data;
-	alloc = bitmap[offset % BPS(bs)] & (1 << (clst % 8));
 
-	rc = block_put(b);
-	if (rc != EOK) {
-		(void) exfat_node_put(fn);
+	return exfat_node_put(fn);
+}
+
+/** Read the on-disk bitmap into a freshly allocated cache. */
+static errno_t bitmap_load(exfat_bs_t *bs, exfat_bitmap_cache_t *cache)
+{
+	fs_node_t *fn;
+	exfat_node_t *bitmapp;
+	block_t *b;
+	aoff64_t offset, size;
+	exfat_cluster_t i;
+	size_t n;
+	errno_t rc;
+
+	rc = exfat_bitmap_get(&fn, cache->service_id);
+	if (rc != EOK)
 		return rc;
+	bitmapp = EXFAT_NODE(fn);
+
+	size = ROUND_UP(cache->clusters, 8) / 8;
+	offset = 0;
+	while (offset < size) {
+		rc = exfat_block_get(&b, bs, bitmapp, offset / BPS(bs),
+		    BLOCK_FLAGS_NONE);
+		if (rc != EOK) {
+			(void) exfat_node_put(fn);
+			return rc;
+		}
+
+		n = min(size - offset, BPS(bs));
+		memcpy(cache->map + offset, b->data, n);
+		rc = block_put(b);
+		if (rc != EOK) {
+			(void) exfat_node_put(fn);
+			return rc;
+		}
+		offset += n;
 	}
+
 	rc = exfat_node_put(fn);
 	if (rc != EOK)
 		return rc;
 
-	if (alloc)
-		return ENOENT;
+	/* Bits past the last cluster are never allocatable. */
+	for (i = cache->clusters; i < size * 8; i++)
+		cache->map[i / 8] |= (1 << (i % 8));
+
+	cache->free = 0;
+	for (i = 0; i < cache->clusters; i++) {
+		if (!bitmap_test(cache, i))
+			cache->free++;
+	}
 
 	return EOK;
 }
 
-errno_t exfat_bitmap_set_cluster(exfat_bs_t *bs, service_id_t service_id,
-    exfat_cluster_t clst)
+/** Get the bitmap cache of a file system instance, loading it if needed. */
+static errno_t bitmap_cache_get(exfat_bs_t *bs, service_id_t service_id,
+    exfat_bitmap_cache_t **rcache)
 {
-	fs_node_t *fn;
-	block_t *b = NULL;
-	exfat_node_t *bitmapp;
-	uint8_t *bitmap;
+	exfat_bitmap_cache_t *cache;
 	errno_t rc;
 
-	clst -= EXFAT_CLST_FIRST;
+	fibril_mutex_lock(&bitmap_cache_lock);
+	list_foreach(bitmap_cache_list, link, exfat_bitmap_cache_t, c) {
+		if (c->service_id == service_id) {
+			fibril_mutex_unlock(&bitmap_cache_lock);
+			*rcache = c;
+			return EOK;
+		}
+	}
 
-	rc = exfat_bitmap_get(&fn, service_id);
-	if (rc != EOK)
-		return rc;
-	bitmapp = EXFAT_NODE(fn);
+	cache = malloc(sizeof(exfat_bitmap_cache_t));
+	if (cache == NULL) {
+		fibril_mutex_unlock(&bitmap_cache_lock);
+		return ENOMEM;
+	}
 
-	aoff64_t offset = clst / 8;
-	rc = exfat_block_get(&b, bs, bitmapp, offset / BPS(bs), BLOCK_FLAGS_NONE);
-	if (rc != EOK) {
-		(void) exfat_node_put(fn);
-		return rc;
+	link_initialize(&cache->link);
+	cache->service_id = service_id;
+	fibril_mutex_initialize(&cache->lock);
+	cache->clusters = DATA_CNT(bs);
+	cache->hint = 0;
+	cache->map = malloc(ROUND_UP(cache->clusters, 8) / 8);
+	if (cache->map == NULL) {
+		free(cache);
+		fibril_mutex_unlock(&bitmap_cache_lock);
+		return ENOMEM;
 	}
-	bitmap = (uint8_t *)b->data;
-	bitmap[offset % BPS(bs)] |= (1 << (clst % 8));
 
-	b->dirty = true;
-	rc = block_put(b);
+	rc = bitmap_load(bs, cache);
 	if (rc != EOK) {
-		(void) exfat_node_put(fn);
+		free(cache->map);
+		free(cache);
+		fibril_mutex_unlock(&bitmap_cache_lock);
 		return rc;
 	}
 
-	return exfat_node_put(fn);
+	list_append(&cache->link, &bitmap_cache_list);
+	fibril_mutex_unlock(&bitmap_cache_lock);
+
+	*rcache = cache;
+	return EOK;
 }
 
-errno_t exfat_bitmap_clear_cluster(exfat_bs_t *bs, service_id_t service_id,
-    exfat_cluster_t clst)
+/** Mark a range of clusters and write the change through to the disk.
+ *
+ * Must be called with the cache locked. On failure the in-memory state is
+ * rolled back.
+ */
+static errno_t bitmap_update(exfat_bs_t *bs, exfat_bitmap_cache_t *cache,
+    exfat_cluster_t first, exfat_cluster_t count, bool alloc)
 {
-	fs_node_t *fn;
-	block_t *b = NULL;
-	exfat_node_t *bitmapp;
-	uint8_t *bitmap;
 	errno_t rc;
 
-	clst -= EXFAT_CLST_FIRST;
+	bitmap_mark(cache, first, count, alloc);
+	rc = bitmap_write(bs, cache, first, count);
+	if (rc != EOK) {
+		bitmap_mark(cache, first, count, !alloc);
+		(void) bitmap_write(bs, cache, first, count);
+	}
+
+	return rc;
+}
 
-	rc = exfat_bitmap_get(&fn, service_id);
+/** Drop the bitmap cache of a file system instance.
+ *
+ * @param service_id	Service ID of the file system.
+ */
+void exfat_bitmap_fini(service_id_t service_id)
+{
+	fibril_mutex_lock(&bitmap_cache_lock);
+	list_foreach_safe(bitmap_cache_list, cur, next) {
+		exfat_bitmap_cache_t *cache = list_get_instance(cur,
+		    exfat_bitmap_cache_t, link);
+
+		if (cache->service_id == service_id) {
+			list_remove(&cache->link);
+			free(cache->map);
+			free(cache);
+			break;
+		}
+	}
+	fibril_mutex_unlock(&bitmap_cache_lock);
+}
+
+/** Get the number of free clusters.
+ *
+ * @param bs		Buffer holding the boot sector of the file system.
+ * @param service_id	Service ID of the file system.
+ * @param count		Place to store the number of free clusters.
+ *
+ * @return		EOK on success or an error code.
+ */
+errno_t exfat_bitmap_count_free(exfat_bs_t *bs, service_id_t service_id,
+    uint64_t *count)
+{
+	exfat_bitmap_cache_t *cache;
+	errno_t rc;
+
+	rc = bitmap_cache_get(bs, service_id, &cache);
 	if (rc != EOK)
 		return rc;
-	bitmapp = EXFAT_NODE(fn);
 
-	aoff64_t offset = clst / 8;
-	rc = exfat_block_get(&b, bs, bitmapp, offset / BPS(bs),
-	    BLOCK_FLAGS_NONE);
-	if (rc != EOK) {
-		(void) exfat_node_put(fn);
-		return rc;
-	}
-	bitmap = (uint8_t *)b->data;
-	bitmap[offset % BPS(bs)] &= ~(1 << (clst % 8));
+	fibril_mutex_lock(&cache->lock);
+	*count = cache->free;
+	fibril_mutex_unlock(&cache->lock);
 
-	b->dirty = true;
-	rc = block_put(b);
-	if (rc != EOK) {
-		(void) exfat_node_put(fn);
+	return EOK;
+}
+
+errno_t exfat_bitmap_is_free(exfat_bs_t *bs, service_id_t service_id,
+    exfat_cluster_t clst)
+{
+	exfat_bitmap_cache_t *cache;
+	errno_t rc;
+	bool alloc;
+
+	rc = bitmap_cache_get(bs, service_id, &cache);
+	if (rc != EOK)
 		return rc;
-	}
 
-	return exfat_node_put(fn);
+	clst -= EXFAT_CLST_FIRST;
+	if (clst >= cache->clusters)
+		return ENOENT;
+
+	fibril_mutex_lock(&cache->lock);
+	alloc = bitmap_test(cache, clst);
+	fibril_mutex_unlock(&cache->lock);
+
+	if (alloc)
+		return ENOENT;
+
+	return EOK;
+}
+
+errno_t exfat_bitmap_set_cluster(exfat_bs_t *bs, service_id_t service_id,
+    exfat_cluster_t clst)
+{
+	return exfat_bitmap_set_clusters(bs, service_id, clst, 1);
+}
+
+errno_t exfat_bitmap_clear_cluster(exfat_bs_t *bs, service_id_t service_id,
+    exfat_cluster_t clst)
+{
+	return exfat_bitmap_clear_clusters(bs, service_id, clst, 1);
 }
 
 errno_t exfat_bitmap_set_clusters(exfat_bs_t *bs, service_id_t service_id,
     exfat_cluster_t firstc, exfat_cluster_t count)
 {
+	exfat_bitmap_cache_t *cache;
 	errno_t rc;
-	exfat_cluster_t clst;
-	clst = firstc;
 
-	while (clst < firstc + count) {
-		rc = exfat_bitmap_set_cluster(bs, service_id, clst);
-		if (rc != EOK) {
-			if (clst - firstc > 0)
-				(void) exfat_bitmap_clear_clusters(bs, service_id,
-				    firstc, clst - firstc);
-			return rc;
-		}
-		clst++;
-	}
-	return EOK;
+	rc = bitmap_cache_get(bs, service_id, &cache);
+	if (rc != EOK)
+		return rc;
+
+	firstc -= EXFAT_CLST_FIRST;
+	if (firstc >= cache->clusters || count > cache->clusters - firstc)
+		return EINVAL;
+
+	fibril_mutex_lock(&cache->lock);
+	rc = bitmap_update(bs, cache, firstc, count, true);
+	fibril_mutex_unlock(&cache->lock);
+
+	return rc;
 }
 
 errno_t exfat_bitmap_clear_clusters(exfat_bs_t *bs, service_id_t service_id,
     exfat_cluster_t firstc, exfat_cluster_t count)
 {
+	exfat_bitmap_cache_t *cache;
 	errno_t rc;
-	exfat_cluster_t clst;
-	clst = firstc;
 
-	while (clst < firstc + count) {
-		rc = exfat_bitmap_clear_cluster(bs, service_id, clst);
-		if (rc != EOK)
-			return rc;
-		clst++;
-	}
-	return EOK;
+	rc = bitmap_cache_get(bs, service_id, &cache);
+	if (rc != EOK)
+		return rc;
+
+	firstc -= EXFAT_CLST_FIRST;
+	if (firstc >= cache->clusters || count > cache->clusters - firstc)
+		return EINVAL;
+
+	fibril_mutex_lock(&cache->lock);
+	rc = bitmap_update(bs, cache, firstc, count, false);
+	fibril_mutex_unlock(&cache->lock);
+
+	return rc;
 }
 
+/** Allocate a contiguous run of clusters.
+ *
+ * The search starts where the previous allocation ended. A run that leaves
+ * a few free clusters behind itself is preferred, so that the file can
+ * later be extended in place.
+ */
 errno_t exfat_bitmap_alloc_clusters(exfat_bs_t *bs, service_id_t service_id,
     exfat_cluster_t *firstc, exfat_cluster_t count)
 {
-	exfat_cluster_t startc, endc;
-	startc = EXFAT_CLST_FIRST;
-
-	while (startc < DATA_CNT(bs) + 2) {
-		endc = startc;
-		while (exfat_bitmap_is_free(bs, service_id, endc) == EOK) {
-			if ((endc - startc) + 1 == count) {
-				*firstc = startc;
-				return exfat_bitmap_set_clusters(bs, service_id, startc, count);
-			} else
-				endc++;
-		}
-		startc = endc + 1;
+	exfat_bitmap_cache_t *cache;
+	exfat_cluster_t first, slack;
+	errno_t rc;
+
+	if (count == 0)
+		return EINVAL;
+
+	rc = bitmap_cache_get(bs, service_id, &cache);
+	if (rc != EOK)
+		return rc;
+
+	fibril_mutex_lock(&cache->lock);
+
+	if (count > cache->free) {
+		fibril_mutex_unlock(&cache->lock);
+		return ENOSPC;
 	}
-	return ENOSPC;
+
+	slack = min(EXFAT_BITMAP_SLACK, cache->free - count);
+	if (!bitmap_find_run(cache, cache->hint, cache->clusters,
+	    count + slack, &first) &&
+	    !bitmap_find_run(cache, 0, cache->clusters, count + slack,
+	    &first) &&
+	    !bitmap_find_run(cache, 0, cache->clusters, count, &first)) {
+		fibril_mutex_unlock(&cache->lock);
+		return ENOSPC;
+	}
+
+	rc = bitmap_update(bs, cache, first, count, true);
+	if (rc == EOK) {
+		cache->hint = min(first + count + slack, cache->clusters);
+		if (cache->hint == cache->clusters)
+			cache->hint = 0;
+		*firstc = first + EXFAT_CLST_FIRST;
+	}
+
+	fibril_mutex_unlock(&cache->lock);
+	return rc;
 }
 
 errno_t exfat_bitmap_append_clusters(exfat_bs_t *bs, exfat_node_t *nodep,
     exfat_cluster_t count)
 {
+	exfat_bitmap_cache_t *cache;
+	exfat_cluster_t lastc, first;
+	errno_t rc;
+
 	if (nodep->firstc == 0) {
 		return exfat_bitmap_alloc_clusters(bs, nodep->idx->service_id,
 		    &nodep->firstc, count);
-	} else {
-		exfat_cluster_t lastc, clst;
-		lastc = nodep->firstc + ROUND_UP(nodep->size, BPC(bs)) / BPC(bs) - 1;
-
-		clst = lastc + 1;
-		while (exfat_bitmap_is_free(bs, nodep->idx->service_id, clst) == EOK) {
-			if (clst - lastc == count) {
-				return exfat_bitmap_set_clusters(bs, nodep->idx->service_id,
-				    lastc + 1, count);
-			} else
-				clst++;
-		}
+	}
+
+	rc = bitmap_cache_get(bs, nodep->idx->service_id, &cache);
+	if (rc != EOK)
+		return rc;
+
+	lastc = nodep->firstc + ROUND_UP(nodep->size, BPC(bs)) / BPC(bs) - 1;
+	first = lastc + 1 - EXFAT_CLST_FIRST;
+
+	fibril_mutex_lock(&cache->lock);
+
+	if (first >= cache->clusters || count > cache->clusters - first ||
+	    !bitmap_find_run(cache, first, first + count, count, &first)) {
+		fibril_mutex_unlock(&cache->lock);
 		return ENOSPC;
 	}
+
+	rc = bitmap_update(bs, cache, first, count, true);
+	fibril_mutex_unlock(&cache->lock);
+	return rc;
 }
 
 errno_t exfat_bitmap_free_clusters(exfat_bs_t *bs, exfat_node_t *nodep,
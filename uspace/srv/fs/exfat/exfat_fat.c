@@ -282,7 +282,7 @@ exfat_set_cluster(exfat_bs_t *bs, service_id_t service_id,
  * This function will attempt to allocate the requested number of clusters in
  * the FAT.  The FAT will be altered so that the allocated
  * clusters form an independent chain (i.e. a chain which does not belong to any
- * file yet).
+ * file yet). A contiguous run of clusters is used if one is available.
  *
  * @param bs		Buffer holding the boot sector of the file system.
  * @param service_id	Service ID of the file system.
@@ -300,17 +300,48 @@ exfat_alloc_clusters(exfat_bs_t *bs, service_id_t service_id, unsigned nclsts,
 {
 	exfat_cluster_t *lifo;    /* stack for storing free cluster numbers */
 	unsigned found = 0;     /* top of the free cluster number stack */
-	exfat_cluster_t clst;
+	exfat_cluster_t clst, firstc;
 	errno_t rc = EOK;
 
+	fibril_mutex_lock(&exfat_alloc_lock);
+
+	/* Prefer a contiguous run so that the chain can be read sequentially. */
+	rc = exfat_bitmap_alloc_clusters(bs, service_id, &firstc, nclsts);
+	if (rc == EOK) {
+		for (clst = firstc; clst < firstc + nclsts; clst++) {
+			rc = exfat_set_cluster(bs, service_id, clst,
+			    (clst == firstc + nclsts - 1) ? EXFAT_CLST_EOF :
+			    clst + 1);
+			if (rc != EOK)
+				break;
+		}
+		if (rc == EOK) {
+			*mcl = firstc;
+			*lcl = firstc + nclsts - 1;
+			fibril_mutex_unlock(&exfat_alloc_lock);
+			return EOK;
+		}
+		while (clst-- > firstc)
+			(void) exfat_set_cluster(bs, service_id, clst, 0);
+		(void) exfat_bitmap_clear_clusters(bs, service_id, firstc,
+		    nclsts);
+		fibril_mutex_unlock(&exfat_alloc_lock);
+		return rc;
+	}
+	if (rc != ENOSPC) {
+		fibril_mutex_unlock(&exfat_alloc_lock);
+		return rc;
+	}
+	rc = EOK;
+
 	lifo = (exfat_cluster_t *) malloc(nclsts * sizeof(exfat_cluster_t));
-	if (!lifo)
+	if (!lifo) {
+		fibril_mutex_unlock(&exfat_alloc_lock);
 		return ENOMEM;
+	}
 
-	fibril_mutex_lock(&exfat_alloc_lock);
 	for (clst = EXFAT_CLST_FIRST; clst < DATA_CNT(bs) + 2 && found < nclsts;
 	    clst++) {
-		/* Need to rewrite because of multiple exfat_bitmap_get calls */
 		if (exfat_bitmap_is_free(bs, service_id, clst) == EOK) {
 			/*
 			 * The cluster is free. Put it into our stack
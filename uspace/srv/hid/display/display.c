@@ -47,6 +47,7 @@
 #include "cursor.h"
 #include "display.h"
 #include "idevcfg.h"
+#include "region.h"
 #include "seat.h"
 #include "window.h"
 #include "wmclient.h"
@@ -873,10 +874,7 @@ static errno_t ds_display_alloc_backbuf(ds_display_t *disp)
 	if (rc != EOK)
 		goto error;
 
-	disp->dirty_rect.p0.x = 0;
-	disp->dirty_rect.p0.y = 0;
-	disp->dirty_rect.p1.x = 0;
-	disp->dirty_rect.p1.y = 0;
+	ds_region_init(&disp->dirty);
 
 	return EOK;
 error:
@@ -1193,6 +1191,7 @@ errno_t ds_display_paint_bg(ds_display_t *disp, gfx_rect_t *rect)
  */
 static errno_t ds_display_update(ds_display_t *disp)
 {
+	size_t i;
 	errno_t rc;
 
 	if (disp->backbuf == NULL) {
@@ -1200,36 +1199,55 @@ static errno_t ds_display_update(ds_display_t *disp)
 		return EOK;
 	}
 
-	rc = gfx_bitmap_render(disp->backbuf, &disp->dirty_rect, NULL);
-	if (rc != EOK)
-		return rc;
-
-	disp->dirty_rect.p0.x = 0;
-	disp->dirty_rect.p0.y = 0;
-	disp->dirty_rect.p1.x = 0;
-	disp->dirty_rect.p1.y = 0;
+	/* Only copy the damaged rectangles to the front buffer */
+	for (i = 0; i < disp->dirty.nrects; i++) {
+		rc = gfx_bitmap_render(disp->backbuf, &disp->dirty.rect[i],
+		    NULL);
+		if (rc != EOK)
+			return rc;
+	}
 
+	ds_region_init(&disp->dirty);
 	return EOK;
 }
 
-/** Paint display.
+/** Paint display rectangle into the back buffer.
+ *
+ * The front buffer is not updated.
  *
  * @param display Display
  * @param rect Bounding rectangle or @c NULL to repaint entire display
  */
-errno_t ds_display_paint(ds_display_t *disp, gfx_rect_t *rect)
+static errno_t ds_display_paint_rect(ds_display_t *disp, gfx_rect_t *rect)
 {
 	errno_t rc;
+	gfx_rect_t crect;
 	ds_window_t *wnd;
 	ds_seat_t *seat;
 
-	/* Paint background */
-	rc = ds_display_paint_bg(disp, rect);
-	if (rc != EOK)
-		return rc;
+	if (rect != NULL)
+		gfx_rect_clip(&disp->rect, rect, &crect);
+	else
+		crect = disp->rect;
 
-	/* Paint windows bottom to top */
-	wnd = ds_display_last_window(disp);
+	/*
+	 * Find the topmost opaque window completely covering the painted
+	 * area. The background and any windows below it are fully occluded.
+	 */
+	wnd = ds_display_first_window(disp);
+	while (wnd != NULL && !ds_window_covers_rect(wnd, &crect))
+		wnd = ds_display_next_window(wnd);
+
+	if (wnd == NULL) {
+		/* Paint background */
+		rc = ds_display_paint_bg(disp, rect);
+		if (rc != EOK)
+			return rc;
+
+		wnd = ds_display_last_window(disp);
+	}
+
+	/* Paint (non-occluded) windows bottom to top */
 	while (wnd != NULL) {
 		rc = ds_window_paint(wnd, rect);
 		if (rc != EOK)
@@ -1258,13 +1276,54 @@ errno_t ds_display_paint(ds_display_t *disp, gfx_rect_t *rect)
 		seat = ds_display_next_seat(seat);
 	}
 
+	return EOK;
+}
+
+/** Paint display.
+ *
+ * @param display Display
+ * @param rect Bounding rectangle or @c NULL to repaint entire display
+ */
+errno_t ds_display_paint(ds_display_t *disp, gfx_rect_t *rect)
+{
+	errno_t rc;
+
+	rc = ds_display_paint_rect(disp, rect);
+	if (rc != EOK)
+		return rc;
+
+	return ds_display_update(disp);
+}
+
+/** Paint display region.
+ *
+ * Each rectangle of the region is painted separately, so the area
+ * between distant rectangles is left alone.
+ *
+ * @param display Display
+ * @param region Region to repaint
+ */
+errno_t ds_display_paint_region(ds_display_t *disp, ds_region_t *region)
+{
+	errno_t rc;
+	size_t i;
+
+	if (ds_region_is_empty(region))
+		return EOK;
+
+	for (i = 0; i < region->nrects; i++) {
+		rc = ds_display_paint_rect(disp, &region->rect[i]);
+		if (rc != EOK)
+			return rc;
+	}
+
 	return ds_display_update(disp);
 }
 
 /** Display invalidate callback.
  *
  * Called by backbuffer memory GC when something is rendered into it.
- * Updates the display's dirty rectangle.
+ * Adds the rectangle to the display's damage region.
  *
  * @param arg Argument (display cast as void *)
  * @param rect Rectangle to update
@@ -1272,10 +1331,8 @@ errno_t ds_display_paint(ds_display_t *disp, gfx_rect_t *rect)
 static void ds_display_invalidate_cb(void *arg, gfx_rect_t *rect)
 {
 	ds_display_t *disp = (ds_display_t *) arg;
-	gfx_rect_t env;
 
-	gfx_rect_envelope(&disp->dirty_rect, rect, &env);
-	disp->dirty_rect = env;
+	ds_region_add(&disp->dirty, rect);
 }
 
 /** Display update callback.
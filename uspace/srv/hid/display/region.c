@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup display
+ * @{
+ */
+/**
+ * @file Display server damage region
+ *
+ * The damage region records which parts of the display need to be
+ * updated. Compared to a single bounding rectangle this avoids updating
+ * the (potentially large) area between two distant small changes, such
+ * as a blinking text cursor in one window and the mouse pointer in another.
+ */
+
+#include <assert.h>
+#include <gfx/coord.h>
+#include <stdint.h>
+#include "region.h"
+
+/** Compute area of rectangle.
+ *
+ * @param rect Rectangle
+ * @return Area in pixels
+ */
+static uint64_t ds_rect_area(gfx_rect_t *rect)
+{
+	gfx_coord2_t dims;
+
+	if (gfx_rect_is_empty(rect))
+		return 0;
+
+	gfx_rect_dims(rect, &dims);
+	return (uint64_t) dims.x * (uint64_t) dims.y;
+}
+
+/** Remove rectangle from region.
+ *
+ * @param region Region
+ * @param idx Index of rectangle to remove
+ */
+static void ds_region_remove(ds_region_t *region, size_t idx)
+{
+	assert(idx < region->nrects);
+
+	region->rect[idx] = region->rect[region->nrects - 1];
+	--region->nrects;
+}
+
+/** Initialize region to empty.
+ *
+ * @param region Region
+ */
+void ds_region_init(ds_region_t *region)
+{
+	region->nrects = 0;
+}
+
+/** Add rectangle to region.
+ *
+ * Rectangles that are already covered are dropped, rectangles covered
+ * by the new rectangle are removed and overlapping rectangles are merged
+ * if their envelope is no larger than the sum of their areas. If the
+ * region is full, the new rectangle is merged with the rectangle whose
+ * area grows the least.
+ *
+ * @param region Region
+ * @param rect Rectangle to add
+ */
+void ds_region_add(ds_region_t *region, gfx_rect_t *rect)
+{
+	gfx_rect_t nrect;
+	gfx_rect_t env;
+	uint64_t growth;
+	uint64_t best_growth;
+	size_t best;
+	bool merged;
+	size_t i;
+
+	if (gfx_rect_is_empty(rect))
+		return;
+
+	nrect = *rect;
+
+	do {
+		merged = false;
+		i = 0;
+		while (i < region->nrects) {
+			if (gfx_rect_is_inside(&nrect, &region->rect[i])) {
+				/* Already covered */
+				return;
+			}
+
+			if (gfx_rect_is_inside(&region->rect[i], &nrect)) {
+				/* Existing rectangle covered by new one */
+				ds_region_remove(region, i);
+				continue;
+			}
+
+			if (gfx_rect_is_incident(&region->rect[i], &nrect)) {
+				gfx_rect_envelope(&region->rect[i], &nrect, &env);
+				if (ds_rect_area(&env) <= ds_rect_area(&nrect) +
+				    ds_rect_area(&region->rect[i])) {
+					/* Merging is cheap, do it */
+					ds_region_remove(region, i);
+					nrect = env;
+					merged = true;
+					continue;
+				}
+			}
+
+			++i;
+		}
+	} while (merged);
+
+	if (region->nrects < ds_region_max_rects) {
+		region->rect[region->nrects++] = nrect;
+		return;
+	}
+
+	/* Region is full. Merge with rectangle that grows the least. */
+	best = 0;
+	best_growth = UINT64_MAX;
+	for (i = 0; i < region->nrects; i++) {
+		gfx_rect_envelope(&region->rect[i], &nrect, &env);
+		growth = ds_rect_area(&env) - ds_rect_area(&region->rect[i]);
+		if (growth < best_growth) {
+			best_growth = growth;
+			best = i;
+		}
+	}
+
+	gfx_rect_envelope(&region->rect[best], &nrect, &env);
+	ds_region_remove(region, best);
+	ds_region_add(region, &env);
+}
+
+/** Determine if region is empty.
+ *
+ * @param region Region
+ * @return @c true iff region is empty
+ */
+bool ds_region_is_empty(ds_region_t *region)
+{
+	return region->nrects == 0;
+}
+
+/** @}
+ */
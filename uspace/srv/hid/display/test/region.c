@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gfx/coord.h>
+#include <pcut/pcut.h>
+
+#include "../region.h"
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(region);
+
+/** Newly initialized region is empty */
+PCUT_TEST(init_empty)
+{
+	ds_region_t region;
+
+	ds_region_init(&region);
+	PCUT_ASSERT_TRUE(ds_region_is_empty(&region));
+}
+
+/** Adding an empty rectangle has no effect */
+PCUT_TEST(add_empty)
+{
+	ds_region_t region;
+	gfx_rect_t rect;
+
+	ds_region_init(&region);
+
+	rect.p0.x = 10;
+	rect.p0.y = 10;
+	rect.p1.x = 10;
+	rect.p1.y = 20;
+	ds_region_add(&region, &rect);
+
+	PCUT_ASSERT_TRUE(ds_region_is_empty(&region));
+}
+
+/** Distant rectangles are kept separate */
+PCUT_TEST(add_distant)
+{
+	ds_region_t region;
+	gfx_rect_t rect;
+
+	ds_region_init(&region);
+
+	rect.p0.x = 0;
+	rect.p0.y = 0;
+	rect.p1.x = 2;
+	rect.p1.y = 2;
+	ds_region_add(&region, &rect);
+
+	rect.p0.x = 100;
+	rect.p0.y = 100;
+	rect.p1.x = 102;
+	rect.p1.y = 102;
+	ds_region_add(&region, &rect);
+
+	PCUT_ASSERT_INT_EQUALS(2, region.nrects);
+	PCUT_ASSERT_FALSE(ds_region_is_empty(&region));
+}
+
+/** Rectangle inside an existing rectangle is dropped */
+PCUT_TEST(add_covered)
+{
+	ds_region_t region;
+	gfx_rect_t rect;
+
+	ds_region_init(&region);
+
+	rect.p0.x = 0;
+	rect.p0.y = 0;
+	rect.p1.x = 10;
+	rect.p1.y = 10;
+	ds_region_add(&region, &rect);
+
+	rect.p0.x = 2;
+	rect.p0.y = 2;
+	rect.p1.x = 5;
+	rect.p1.y = 5;
+	ds_region_add(&region, &rect);
+
+	PCUT_ASSERT_INT_EQUALS(1, region.nrects);
+	PCUT_ASSERT_INT_EQUALS(0, region.rect[0].p0.x);
+	PCUT_ASSERT_INT_EQUALS(0, region.rect[0].p0.y);
+	PCUT_ASSERT_INT_EQUALS(10, region.rect[0].p1.x);
+	PCUT_ASSERT_INT_EQUALS(10, region.rect[0].p1.y);
+}
+
+/** Rectangle covering an existing rectangle replaces it */
+PCUT_TEST(add_covering)
+{
+	ds_region_t region;
+	gfx_rect_t rect;
+
+	ds_region_init(&region);
+
+	rect.p0.x = 2;
+	rect.p0.y = 2;
+	rect.p1.x = 5;
+	rect.p1.y = 5;
+	ds_region_add(&region, &rect);
+
+	rect.p0.x = 0;
+	rect.p0.y = 0;
+	rect.p1.x = 10;
+	rect.p1.y = 10;
+	ds_region_add(&region, &rect);
+
+	PCUT_ASSERT_INT_EQUALS(1, region.nrects);
+	PCUT_ASSERT_INT_EQUALS(0, region.rect[0].p0.x);
+	PCUT_ASSERT_INT_EQUALS(10, region.rect[0].p1.x);
+}
+
+/** Adjacent overlapping rectangles are merged */
+PCUT_TEST(add_merge)
+{
+	ds_region_t region;
+	gfx_rect_t rect;
+
+	ds_region_init(&region);
+
+	rect.p0.x = 0;
+	rect.p0.y = 0;
+	rect.p1.x = 10;
+	rect.p1.y = 10;
+	ds_region_add(&region, &rect);
+
+	rect.p0.x = 5;
+	rect.p0.y = 0;
+	rect.p1.x = 15;
+	rect.p1.y = 10;
+	ds_region_add(&region, &rect);
+
+	PCUT_ASSERT_INT_EQUALS(1, region.nrects);
+	PCUT_ASSERT_INT_EQUALS(0, region.rect[0].p0.x);
+	PCUT_ASSERT_INT_EQUALS(0, region.rect[0].p0.y);
+	PCUT_ASSERT_INT_EQUALS(15, region.rect[0].p1.x);
+	PCUT_ASSERT_INT_EQUALS(10, region.rect[0].p1.y);
+}
+
+/** Full region merges new rectangle instead of growing */
+PCUT_TEST(add_full)
+{
+	ds_region_t region;
+	gfx_rect_t rect;
+	int i;
+
+	ds_region_init(&region);
+
+	for (i = 0; i < ds_region_max_rects + 1; i++) {
+		rect.p0.x = 100 * i;
+		rect.p0.y = 0;
+		rect.p1.x = 100 * i + 1;
+		rect.p1.y = 1;
+		ds_region_add(&region, &rect);
+	}
+
+	PCUT_ASSERT_INT_EQUALS(ds_region_max_rects, region.nrects);
+}
+
+PCUT_EXPORT(region);
@@ -90,6 +90,8 @@ typedef struct ds_window {
 	gfx_context_t *gc;
 	/** Bitmap in the display device */
 	gfx_bitmap_t *bitmap;
+	/** Flags of the window bitmap */
+	gfx_bitmap_flags_t bmp_flags;
 	/** Pixel map for accessing the window bitmap */
 	pixelmap_t pixelmap;
 	/** Current drawing color */
@@ -47,6 +47,7 @@
 #include <wndmgt.h>
 #include "client.h"
 #include "display.h"
+#include "region.h"
 #include "seat.h"
 #include "window.h"
 #include "wmclient.h"
@@ -101,6 +102,7 @@ errno_t ds_window_create(ds_client_t *client, display_wnd_params_t *params,
 
 	gfx_bitmap_params_init(&bparams);
 	bparams.rect = params->rect;
+	wnd->bmp_flags = bparams.flags;
 
 	/* Allocate window bitmap */
 
@@ -242,6 +244,43 @@ bool ds_window_is_visible(ds_window_t *wnd)
 	return (wnd->flags & wndf_minimized) == 0;
 }
 
+/** Determine if window is opaque.
+ *
+ * A window whose bitmap uses a color key lets pixels of the key color
+ * show what is below it.
+ *
+ * @param wnd Window
+ * @return @c true iff window is opaque
+ */
+bool ds_window_is_opaque(ds_window_t *wnd)
+{
+	return (wnd->bmp_flags & bmpf_color_key) == 0;
+}
+
+/** Determine if window completely covers a display rectangle.
+ *
+ * If so, anything below the window need not be painted when repainting
+ * @a rect.
+ *
+ * @param wnd Window
+ * @param rect Display rectangle
+ * @return @c true iff window is visible, opaque and covers all of @a rect
+ */
+bool ds_window_covers_rect(ds_window_t *wnd, gfx_rect_t *rect)
+{
+	gfx_rect_t drect;
+
+	if (!ds_window_is_visible(wnd) || !ds_window_is_opaque(wnd))
+		return false;
+
+	/* This can happen in unit tests */
+	if (wnd->bitmap == NULL)
+		return false;
+
+	gfx_rect_translate(&wnd->dpos, &wnd->rect, &drect);
+	return gfx_rect_is_inside(rect, &drect);
+}
+
 /** Paint a window using its backing bitmap.
  *
  * @param wnd Window to paint
@@ -397,11 +436,8 @@ errno_t ds_window_paint_preview(ds_window_t *wnd, gfx_rect_t *rect)
  */
 static errno_t ds_window_repaint_preview(ds_window_t *wnd, gfx_rect_t *old_rect)
 {
-	errno_t rc;
 	gfx_rect_t prect;
-	gfx_rect_t envelope;
-	bool oldr;
-	bool newr;
+	ds_region_t region;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG2, "ds_window_repaint_preview");
 
@@ -411,36 +447,17 @@ static errno_t ds_window_repaint_preview(ds_window_t *wnd, gfx_rect_t *old_rect)
 	 */
 	ds_window_get_preview_rect(wnd, &prect);
 
-	oldr = (old_rect != NULL) && !gfx_rect_is_empty(old_rect);
-	newr = !gfx_rect_is_empty(&prect);
-
-	if (oldr && newr && gfx_rect_is_incident(old_rect, &prect)) {
-		/*
-		 * As an optimization, repaint both rectangles in a single
-		 * operation.
-		 */
-
-		gfx_rect_envelope(old_rect, &prect, &envelope);
-
-		rc = ds_display_paint(wnd->display, &envelope);
-		if (rc != EOK)
-			return rc;
-	} else {
-		/* Repaint each rectangle separately */
-		if (oldr) {
-			rc = ds_display_paint(wnd->display, old_rect);
-			if (rc != EOK)
-				return rc;
-		}
-
-		if (newr) {
-			rc = ds_display_paint(wnd->display, &prect);
-			if (rc != EOK)
-				return rc;
-		}
-	}
+	/*
+	 * The region merges the rectangles if they overlap enough,
+	 * otherwise they are repainted separately. Empty rectangles
+	 * are ignored.
+	 */
+	ds_region_init(&region);
+	if (old_rect != NULL)
+		ds_region_add(&region, old_rect);
+	ds_region_add(&region, &prect);
 
-	return EOK;
+	return ds_display_paint_region(wnd->display, &region);
 }
 
 /** Start moving a window by mouse drag.
@@ -854,6 +871,7 @@ errno_t ds_window_resize(ds_window_t *wnd, gfx_coord2_t *offs,
 	if (dgc != NULL) {
 		gfx_bitmap_params_init(&bparams);
 		bparams.rect = *nrect;
+		bparams.flags = wnd->bmp_flags;
 
 		rc = gfx_bitmap_create(dgc, &bparams, NULL, &nbitmap);
 		if (rc != EOK)
@@ -289,7 +289,16 @@ static int ldr_load(ipc_call_t *req)
 {
 	DPRINTF("LOADER_LOAD()\n");
 
-	errno_t rc = elf_load(program_fd, &prog_info);
+	/*
+	 * Servers and drivers may be needed by VFS to serve page-in
+	 * requests, so only applications are paged from the file.
+	 */
+	eld_flags_t flags = 0;
+	if (progname != NULL &&
+	    str_lcmp(progname, "/app/", str_length("/app/")) == 0)
+		flags |= ELDF_PAGED;
+
+	errno_t rc = elf_load(program_fd, flags, &prog_info);
 	if (rc != EOK) {
 		DPRINTF("Failed to load executable for '%s'.\n", progname);
 		async_answer_0(req, EINVAL);
@@ -43,6 +43,7 @@
 #include <inet/eth_addr.h>
 #include <inet/iplink_srv.h>
 #include <loc.h>
+#include <nic_rxring.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -63,6 +64,12 @@ typedef struct ethip_nic {
 	/** MAC address */
 	eth_addr_t mac_addr;
 
+	/** Active NIC offload computations (NIC_OFFLOAD_*) */
+	uint32_t offload;
+
+	/** Receive ring shared with the NIC or NULL */
+	nic_rxring_t *rxring;
+
 	/**
 	 * List of IP addresses configured on this link
 	 * (of the type ethip_link_addr_t)
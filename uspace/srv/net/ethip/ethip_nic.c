@@ -139,6 +139,9 @@ static void ethip_nic_delete(ethip_nic_t *nic)
 	if (nic->svc_name != NULL)
 		free(nic->svc_name);
 
+	if (nic->rxring != NULL)
+		nic_rxring_destroy(nic->rxring);
+
 	free(nic);
 }
 
@@ -147,6 +150,51 @@ static void ethip_link_addr_delete(ethip_link_addr_t *laddr)
 	free(laddr);
 }
 
+/** Enable offload computations the NIC supports and the stack can use. */
+static void ethip_nic_offload_init(ethip_nic_t *nic)
+{
+	uint32_t supported;
+	uint32_t active;
+	errno_t rc;
+
+	rc = nic_offload_probe(nic->sess, &supported, &active);
+	if (rc != EOK || (supported & NIC_OFFLOAD_TX_TCP_CSUM) == 0)
+		return;
+
+	rc = nic_offload_set(nic->sess, NIC_OFFLOAD_TX_TCP_CSUM,
+	    NIC_OFFLOAD_TX_TCP_CSUM);
+	if (rc != EOK) {
+		log_msg(LOG_DEFAULT, LVL_WARN, "Failed enabling checksum "
+		    "offload on '%s'.", nic->svc_name);
+		return;
+	}
+
+	nic->offload = NIC_OFFLOAD_TX_TCP_CSUM;
+}
+
+/** Share a receive ring with the NIC if it supports one. */
+static void ethip_nic_rxring_init(ethip_nic_t *nic)
+{
+	nic_rxring_t *ring;
+	errno_t rc;
+
+	rc = nic_rxring_create(&ring);
+	if (rc != EOK)
+		return;
+
+	rc = nic_rxring_set(nic->sess, ring);
+	if (rc != EOK) {
+		if (rc != ENOTSUP) {
+			log_msg(LOG_DEFAULT, LVL_WARN, "Failed sharing receive "
+			    "ring with '%s'.", nic->svc_name);
+		}
+		nic_rxring_destroy(ring);
+		return;
+	}
+
+	nic->rxring = ring;
+}
+
 static errno_t ethip_nic_open(service_id_t sid)
 {
 	bool in_list = false;
@@ -182,6 +230,9 @@ static errno_t ethip_nic_open(service_id_t sid)
 	list_append(&nic->link, &ethip_nic_list);
 	in_list = true;
 
+	ethip_nic_offload_init(nic);
+	ethip_nic_rxring_init(nic);
+
 	rc = ethip_iplink_init(nic);
 	if (rc != EOK)
 		goto error;
@@ -284,6 +335,26 @@ static void ethip_nic_received(ethip_nic_t *nic, ipc_call_t *call)
 	async_answer_0(call, rc);
 }
 
+/** Process all frames in the receive ring, then wait for the next batch. */
+static void ethip_nic_rxring(ethip_nic_t *nic, ipc_call_t *call)
+{
+	uint32_t idx;
+	void *data;
+	size_t size;
+
+	async_answer_0(call, EOK);
+
+	if (nic->rxring == NULL)
+		return;
+
+	do {
+		while (nic_rxring_get(nic->rxring, &idx, &data, &size)) {
+			(void) ethip_received(&nic->iplink, data, size);
+			nic_rxring_release(nic->rxring, idx);
+		}
+	} while (!nic_rxring_arm(nic->rxring));
+}
+
 static void ethip_nic_device_state(ethip_nic_t *nic, ipc_call_t *call)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_nic_device_state()");
@@ -315,6 +386,9 @@ static void ethip_nic_cb_conn(ipc_call_t *icall, void *arg)
 		case NIC_EV_DEVICE_STATE:
 			ethip_nic_device_state(nic, &call);
 			break;
+		case NIC_EV_RXRING:
+			ethip_nic_rxring(nic, &call);
+			break;
 		default:
 			log_msg(LOG_DEFAULT, LVL_DEBUG, "unknown IPC method: %" PRIun, ipc_get_imethod(&call));
 			async_answer_0(&call, ENOTSUP);
@@ -34,6 +34,7 @@
  * @brief
  */
 
+#include <align.h>
 #include <errno.h>
 #include <fibril_synch.h>
 #include <inet/dhcp.h>
@@ -48,6 +49,7 @@
 #include "addrobj.h"
 #include "inetsrv.h"
 #include "inet_link.h"
+#include "inet_std.h"
 #include "pdu.h"
 
 static bool first_link = true;
@@ -120,7 +122,6 @@ static errno_t inet_iplink_recv(iplink_t *iplink, iplink_recv_sdu_t *sdu, ip_ver
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "call inet_recv_packet()");
 	rc = inet_recv_packet(&packet);
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "call inet_recv_packet -> %s", str_error_name(rc));
-	free(packet.data);
 
 	return rc;
 }
@@ -218,6 +219,11 @@ static errno_t inet_link_open_locked(service_id_t sid)
 	rc = iplink_get_mac48(ilink->iplink, &ilink->mac);
 	ilink->mac_valid = (rc == EOK);
 
+	/* Links that do not support the query perform no offload */
+	rc = iplink_get_offload(ilink->iplink, &ilink->offload);
+	if (rc != EOK)
+		ilink->offload = 0;
+
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "Opened IP link '%s'", ilink->svc_name);
 
 	if (inet_link_get_by_id_locked(sid) != NULL) {
@@ -324,6 +330,35 @@ errno_t inet_link_open(service_id_t sid)
 	return rc;
 }
 
+/** Complete deferred transport checksum unless the link can do it.
+ *
+ * The link can only complete the checksum of a TCP segment that is
+ * not going to be fragmented.
+ *
+ * @param ilink    Internet link
+ * @param dgram    Datagram
+ * @param proto    Protocol
+ * @param df       Flags (inet_df_t)
+ * @param hdr_size Size of the IP header
+ *
+ * @return EOK on success or an error code
+ */
+static errno_t inet_link_csum_prepare(inet_link_t *ilink, inet_dgram_t *dgram,
+    uint8_t proto, int df, size_t hdr_size)
+{
+	if ((df & INET_CSUM_DEFER) == 0)
+		return EOK;
+
+	if (proto == IP_PROTO_TCP &&
+	    (ilink->offload & IPLINK_OFFLOAD_TX_TCP_CSUM) != 0 &&
+	    hdr_size < ilink->def_mtu &&
+	    dgram->size <= ALIGN_DOWN(ilink->def_mtu - hdr_size,
+	    FRAG_OFFS_UNIT))
+		return EOK;
+
+	return inet_csum_complete(dgram, proto);
+}
+
 /** Send IPv4 datagram over Internet link
  *
  * @param ilink Internet link
@@ -332,7 +367,7 @@ errno_t inet_link_open(service_id_t sid)
  * @param dgram IPv4 datagram body
  * @param proto Protocol
  * @param ttl   Time-to-live
- * @param df    Do-not-Fragment flag
+ * @param df    Do-not-Fragment and checksum deferral flags (inet_df_t)
  *
  * @return EOK on success
  * @return ENOMEM when not enough memory to create the datagram
@@ -352,6 +387,11 @@ errno_t inet_link_send_dgram(inet_link_t *ilink, addr32_t lsrc, addr32_t ldest,
 	if (dest_ver != ip_v4)
 		return EINVAL;
 
+	errno_t rc = inet_link_csum_prepare(ilink, dgram, proto, df,
+	    sizeof(ip_header_t));
+	if (rc != EOK)
+		return rc;
+
 	/*
 	 * Fill packet structure. Fragmentation is performed by
 	 * inet_pdu_encode().
@@ -375,11 +415,10 @@ errno_t inet_link_send_dgram(inet_link_t *ilink, addr32_t lsrc, addr32_t ldest,
 	packet.ident = ++ip_ident;
 	fibril_mutex_unlock(&ip_ident_lock);
 
-	packet.df = df;
+	packet.df = (df & INET_DF) != 0;
 	packet.data = dgram->data;
 	packet.size = dgram->size;
 
-	errno_t rc;
 	size_t offs = 0;
 
 	do {
@@ -408,7 +447,7 @@ errno_t inet_link_send_dgram(inet_link_t *ilink, addr32_t lsrc, addr32_t ldest,
  * @param dgram IPv6 datagram body
  * @param proto Next header
  * @param ttl   Hop limit
- * @param df    Do-not-Fragment flag (unused)
+ * @param df    Checksum deferral flag (Do-not-Fragment is unused)
  *
  * @return EOK on success
  * @return ENOMEM when not enough memory to create the datagram
@@ -427,6 +466,11 @@ errno_t inet_link_send_dgram6(inet_link_t *ilink, eth_addr_t *ldest,
 	if (dest_ver != ip_v6)
 		return EINVAL;
 
+	errno_t rc = inet_link_csum_prepare(ilink, dgram, proto, df,
+	    sizeof(ip6_header_t));
+	if (rc != EOK)
+		return rc;
+
 	iplink_sdu6_t sdu6;
 	sdu6.dest = *ldest;
 
@@ -448,11 +492,10 @@ errno_t inet_link_send_dgram6(inet_link_t *ilink, eth_addr_t *ldest,
 	packet.ident = ++ip_ident;
 	fibril_mutex_unlock(&ip_ident_lock);
 
-	packet.df = df;
+	packet.df = (df & INET_DF) != 0;
 	packet.data = dgram->data;
 	packet.size = dgram->size;
 
-	errno_t rc;
 	size_t offs = 0;
 
 	do {
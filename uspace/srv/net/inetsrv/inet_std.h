@@ -41,6 +41,14 @@
 
 #define IP6_NEXT_FRAGMENT  44
 
+#define IP_PROTO_TCP  6
+#define IP_PROTO_UDP  17
+
+/** Offset of the checksum field in the TCP header */
+#define TCP_CSUM_OFFS  16
+/** Offset of the checksum field in the UDP header */
+#define UDP_CSUM_OFFS  6
+
 /** IPv4 Datagram header (fixed part) */
 typedef struct {
 	/** Version, Internet Header Length */
@@ -131,6 +139,34 @@ typedef struct {
 	uint32_t id;
 } ip6_header_fragment_t;
 
+/** IPv4 pseudo-header for transport checksum computation */
+typedef struct {
+	/** Source address */
+	uint32_t src_addr;
+	/** Destination address */
+	uint32_t dest_addr;
+	/** Zero */
+	uint8_t zero;
+	/** Protocol */
+	uint8_t protocol;
+	/** Transport header and data length */
+	uint16_t length;
+} ip_phdr_t;
+
+/** IPv6 pseudo-header for transport checksum computation */
+typedef struct {
+	/** Source address */
+	uint8_t src_addr[16];
+	/** Destination address */
+	uint8_t dest_addr[16];
+	/** Transport header and data length */
+	uint32_t length;
+	/** Zeroes */
+	uint8_t zeroes[3];
+	/** Next header */
+	uint8_t next;
+} ip6_phdr_t;
+
 /** Fragment offset is expressed in units of 8 bytes */
 #define FRAG_OFFS_UNIT 8
 
@@ -112,6 +112,8 @@ typedef struct {
 	size_t def_mtu;
 	eth_addr_t mac;
 	bool mac_valid;
+	/** Offload computations performed by the link (IPLINK_OFFLOAD_*) */
+	uint32_t offload;
 } inet_link_t;
 
 /** Link information needed for autoconfiguration */
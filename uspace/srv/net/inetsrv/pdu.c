@@ -84,6 +84,90 @@ uint16_t inet_checksum_calc(uint16_t ivalue, void *data, size_t size)
 	return ~sum;
 }
 
+/** Complete deferred transport checksum.
+ *
+ * The checksum field in the TCP or UDP header of @a dgram is expected
+ * to be zero. It is filled in with the checksum computed over the
+ * pseudo-header and the whole datagram body.
+ *
+ * @param dgram Datagram
+ * @param proto Transport protocol
+ *
+ * @return EOK on success
+ * @return EINVAL if the datagram is too short
+ * @return ENOTSUP if the protocol is not supported
+ */
+errno_t inet_csum_complete(inet_dgram_t *dgram, uint8_t proto)
+{
+	size_t csum_offs;
+	uint16_t cs_phdr;
+	ip_phdr_t phdr;
+	ip6_phdr_t phdr6;
+
+	switch (proto) {
+	case IP_PROTO_TCP:
+		csum_offs = TCP_CSUM_OFFS;
+		break;
+	case IP_PROTO_UDP:
+		csum_offs = UDP_CSUM_OFFS;
+		break;
+	default:
+		return ENOTSUP;
+	}
+
+	if (dgram->size < csum_offs + sizeof(uint16_t))
+		return EINVAL;
+
+	addr32_t src_v4;
+	addr128_t src_v6;
+	ip_ver_t src_ver = inet_addr_get(&dgram->src, &src_v4, &src_v6);
+
+	addr32_t dest_v4;
+	addr128_t dest_v6;
+	ip_ver_t dest_ver = inet_addr_get(&dgram->dest, &dest_v4, &dest_v6);
+
+	if (src_ver != dest_ver)
+		return EINVAL;
+
+	switch (src_ver) {
+	case ip_v4:
+		phdr.src_addr = host2uint32_t_be(src_v4);
+		phdr.dest_addr = host2uint32_t_be(dest_v4);
+		phdr.zero = 0;
+		phdr.protocol = proto;
+		phdr.length = host2uint16_t_be(dgram->size);
+
+		cs_phdr = inet_checksum_calc(INET_CHECKSUM_INIT, &phdr,
+		    sizeof(ip_phdr_t));
+		break;
+	case ip_v6:
+		host2addr128_t_be(src_v6, phdr6.src_addr);
+		host2addr128_t_be(dest_v6, phdr6.dest_addr);
+		phdr6.length = host2uint32_t_be(dgram->size);
+		memset(phdr6.zeroes, 0, 3);
+		phdr6.next = proto;
+
+		cs_phdr = inet_checksum_calc(INET_CHECKSUM_INIT, &phdr6,
+		    sizeof(ip6_phdr_t));
+		break;
+	default:
+		return EINVAL;
+	}
+
+	uint16_t cs_all = inet_checksum_calc(cs_phdr, dgram->data,
+	    dgram->size);
+
+	/* Zero UDP checksum means no checksum */
+	if (proto == IP_PROTO_UDP && cs_all == 0)
+		cs_all = 0xffff;
+
+	uint8_t *csum = (uint8_t *) dgram->data + csum_offs;
+	csum[0] = cs_all >> 8;
+	csum[1] = cs_all & 0xff;
+
+	return EOK;
+}
+
 /** Encode IPv4 PDU.
  *
  * Encode internet packet into PDU (serialized form). Will encode a
@@ -297,6 +381,8 @@ errno_t inet_pdu_encode6(inet_packet_t *packet, addr128_t src, addr128_t dest,
 }
 
 /** Decode IPv4 datagram
+ *
+ * The payload is not copied, @a packet->data points into @a data.
  *
  * @param data    Serialized IPv4 datagram
  * @param size    Length of serialized IPv4 datagram
@@ -305,7 +391,6 @@ errno_t inet_pdu_encode6(inet_packet_t *packet, addr128_t src, addr128_t dest,
  *
  * @return EOK on success
  * @return EINVAL if the datagram is invalid or damaged
- * @return ENOMEM if not enough memory
  *
  */
 errno_t inet_pdu_decode(void *data, size_t size, service_id_t link_id,
@@ -361,19 +446,15 @@ errno_t inet_pdu_decode(void *data, size_t size, service_id_t link_id,
 	    BIT_RANGE_EXTRACT(uint8_t, VI_IHL_h, VI_IHL_l, hdr->ver_ihl);
 
 	packet->size = tot_len - data_offs;
-	packet->data = calloc(packet->size, 1);
-	if (packet->data == NULL) {
-		log_msg(LOG_DEFAULT, LVL_WARN, "Out of memory.");
-		return ENOMEM;
-	}
-
-	memcpy(packet->data, (uint8_t *) data + data_offs, packet->size);
+	packet->data = (uint8_t *) data + data_offs;
 	packet->link_id = link_id;
 
 	return EOK;
 }
 
 /** Decode IPv6 datagram
+ *
+ * The payload is not copied, @a packet->data points into @a data.
  *
  * @param data    Serialized IPv6 datagram
  * @param size    Length of serialized IPv6 datagram
@@ -382,7 +463,6 @@ errno_t inet_pdu_decode(void *data, size_t size, service_id_t link_id,
  *
  * @return EOK on success
  * @return EINVAL if the datagram is invalid or damaged
- * @return ENOMEM if not enough memory
  *
  */
 errno_t inet_pdu_decode6(void *data, size_t size, service_id_t link_id,
@@ -455,13 +535,7 @@ errno_t inet_pdu_decode6(void *data, size_t size, service_id_t link_id,
 	packet->offs = foff * FRAG_OFFS_UNIT;
 
 	packet->size = payload_len;
-	packet->data = calloc(packet->size, 1);
-	if (packet->data == NULL) {
-		log_msg(LOG_DEFAULT, LVL_WARN, "Out of memory.");
-		return ENOMEM;
-	}
-
-	memcpy(packet->data, (uint8_t *) data + data_offs, packet->size);
+	packet->data = (uint8_t *) data + data_offs;
 	packet->link_id = link_id;
 	return EOK;
 }
@@ -144,7 +144,8 @@ void tcp_transmit_pdu(tcp_pdu_t *pdu)
 	dgram.data = pdu_raw;
 	dgram.size = pdu_raw_size;
 
-	rc = inet_send(&dgram, INET_TTL_MAX, 0);
+	/* Checksum is completed by inetsrv or by the NIC */
+	rc = inet_send(&dgram, INET_TTL_MAX, INET_CSUM_DEFER);
 	if (rc != EOK)
 		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed to transmit PDU.");
 
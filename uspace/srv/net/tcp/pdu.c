@@ -46,44 +46,6 @@
 #include "std.h"
 #include "tcp_type.h"
 
-#define TCP_CHECKSUM_INIT 0xffff
-
-/** One's complement addition.
- *
- * Result is a + b + carry.
- */
-static uint16_t tcp_ocadd16(uint16_t a, uint16_t b)
-{
-	uint32_t s;
-
-	s = (uint32_t)a + (uint32_t)b;
-	return (s & 0xffff) + (s >> 16);
-}
-
-static uint16_t tcp_checksum_calc(uint16_t ivalue, void *data, size_t size)
-{
-	uint16_t sum;
-	uint16_t w;
-	size_t words, i;
-	uint8_t *bdata;
-
-	sum = ~ivalue;
-	words = size / 2;
-	bdata = (uint8_t *)data;
-
-	for (i = 0; i < words; i++) {
-		w = ((uint16_t)bdata[2 * i] << 8) | bdata[2 * i + 1];
-		sum = tcp_ocadd16(sum, w);
-	}
-
-	if (size % 2 != 0) {
-		w = ((uint16_t)bdata[2 * words] << 8);
-		sum = tcp_ocadd16(sum, w);
-	}
-
-	return ~sum;
-}
-
 static void tcp_header_decode_flags(uint16_t doff_flags, tcp_control_t *rctl)
 {
 	tcp_control_t ctl;
@@ -144,43 +106,6 @@ static void tcp_header_setup(inet_ep2_t *epp, tcp_segment_t *seg, tcp_header_t *
 	hdr->urg_ptr = host2uint16_t_be(seg->up);
 }
 
-static ip_ver_t tcp_phdr_setup(tcp_pdu_t *pdu, tcp_phdr_t *phdr,
-    tcp_phdr6_t *phdr6)
-{
-	addr32_t src_v4;
-	addr128_t src_v6;
-	uint16_t src_ver = inet_addr_get(&pdu->src, &src_v4, &src_v6);
-
-	addr32_t dest_v4;
-	addr128_t dest_v6;
-	uint16_t dest_ver = inet_addr_get(&pdu->dest, &dest_v4, &dest_v6);
-
-	assert(src_ver == dest_ver);
-
-	switch (src_ver) {
-	case ip_v4:
-		phdr->src = host2uint32_t_be(src_v4);
-		phdr->dest = host2uint32_t_be(dest_v4);
-		phdr->zero = 0;
-		phdr->protocol = IP_PROTO_TCP;
-		phdr->tcp_length =
-		    host2uint16_t_be(pdu->header_size + pdu->text_size);
-		break;
-	case ip_v6:
-		host2addr128_t_be(src_v6, phdr6->src);
-		host2addr128_t_be(dest_v6, phdr6->dest);
-		phdr6->tcp_length =
-		    host2uint32_t_be(pdu->header_size + pdu->text_size);
-		memset(phdr6->zeroes, 0, 3);
-		phdr6->next = IP_PROTO_TCP;
-		break;
-	default:
-		assert(false);
-	}
-
-	return src_ver;
-}
-
 static void tcp_header_decode(tcp_header_t *hdr, tcp_segment_t *seg)
 {
 	tcp_header_decode_flags(uint16_t_be2host(hdr->doff_flags), &seg->ctrl);
@@ -260,39 +185,6 @@ void tcp_pdu_delete(tcp_pdu_t *pdu)
 	free(pdu);
 }
 
-static uint16_t tcp_pdu_checksum_calc(tcp_pdu_t *pdu)
-{
-	uint16_t cs_phdr;
-	uint16_t cs_headers;
-	tcp_phdr_t phdr;
-	tcp_phdr6_t phdr6;
-
-	ip_ver_t ver = tcp_phdr_setup(pdu, &phdr, &phdr6);
-	switch (ver) {
-	case ip_v4:
-		cs_phdr = tcp_checksum_calc(TCP_CHECKSUM_INIT, (void *) &phdr,
-		    sizeof(tcp_phdr_t));
-		break;
-	case ip_v6:
-		cs_phdr = tcp_checksum_calc(TCP_CHECKSUM_INIT, (void *) &phdr6,
-		    sizeof(tcp_phdr6_t));
-		break;
-	default:
-		assert(false);
-	}
-
-	cs_headers = tcp_checksum_calc(cs_phdr, pdu->header, pdu->header_size);
-	return tcp_checksum_calc(cs_headers, pdu->text, pdu->text_size);
-}
-
-static void tcp_pdu_set_checksum(tcp_pdu_t *pdu, uint16_t checksum)
-{
-	tcp_header_t *hdr;
-
-	hdr = (tcp_header_t *)pdu->header;
-	hdr->checksum = host2uint16_t_be(checksum);
-}
-
 /** Decode incoming PDU */
 errno_t tcp_pdu_decode(tcp_pdu_t *pdu, inet_ep2_t *epp, tcp_segment_t **seg)
 {
@@ -317,12 +209,15 @@ errno_t tcp_pdu_decode(tcp_pdu_t *pdu, inet_ep2_t *epp, tcp_segment_t **seg)
 	return EOK;
 }
 
-/** Encode outgoing PDU */
+/** Encode outgoing PDU
+ *
+ * The checksum field is left zero. Computing the checksum is deferred
+ * to the IP layer or to the network interface (see tcp_transmit_pdu()).
+ */
 errno_t tcp_pdu_encode(inet_ep2_t *epp, tcp_segment_t *seg, tcp_pdu_t **pdu)
 {
 	tcp_pdu_t *npdu;
 	size_t text_size;
-	uint16_t checksum;
 	errno_t rc;
 
 	npdu = tcp_pdu_new();
@@ -348,10 +243,6 @@ errno_t tcp_pdu_encode(inet_ep2_t *epp, tcp_segment_t *seg, tcp_pdu_t **pdu)
 	npdu->text_size = text_size;
 	memcpy(npdu->text, seg->data, text_size);
 
-	/* Checksum calculation */
-	checksum = tcp_pdu_checksum_calc(npdu);
-	tcp_pdu_set_checksum(npdu, checksum);
-
 	*pdu = npdu;
 	return EOK;
 }
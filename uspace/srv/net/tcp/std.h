@@ -38,7 +38,6 @@
 #define STD_H
 
 #include <stdint.h>
-#include <inet/addr.h>
 
 #define IP_PROTO_TCP  6
 
@@ -74,34 +73,6 @@ enum doff_flags_bits {
 	DF_FIN			= 0
 };
 
-/** TCP over IPv4 checksum pseudo header */
-typedef struct {
-	/** Source address */
-	uint32_t src;
-	/** Destination address */
-	uint32_t dest;
-	/** Zero */
-	uint8_t zero;
-	/** Protocol */
-	uint8_t protocol;
-	/** TCP length */
-	uint16_t tcp_length;
-} tcp_phdr_t;
-
-/** TCP over IPv6 checksum pseudo header */
-typedef struct {
-	/** Source address */
-	addr128_t src;
-	/** Destination address */
-	addr128_t dest;
-	/** TCP length */
-	uint32_t tcp_length;
-	/** Zeroes */
-	uint8_t zeroes[3];
-	/** Next header */
-	uint8_t next;
-} tcp_phdr6_t;
-
 /** Option kind */
 enum opt_kind {
 	/** End of option list */
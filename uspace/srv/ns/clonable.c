@@ -42,6 +42,9 @@
 #include "clonable.h"
 #include "ns.h"
 
+/** Number of idle loaders kept ready for incoming connection requests. */
+#define CS_POOL_SIZE  2
+
 /** Request for connection to a clonable service. */
 typedef struct {
 	link_t link;
@@ -50,12 +53,89 @@ typedef struct {
 	ipc_call_t call;
 } cs_req_t;
 
+/** Idle clonable server waiting for a client. */
+typedef struct {
+	link_t link;
+	async_sess_t *sess;
+} cs_srv_t;
+
 /** List of clonable-service connection requests. */
 static list_t cs_req;
 
+/** List of idle clonable servers. */
+static list_t cs_pool;
+
+/** Number of spawned servers which have not registered yet. */
+static size_t cs_spawned = 0;
+
+/** Spawn a new clonable server.
+ *
+ * The server will register with us asynchronously, either to satisfy
+ * a pending connection request or to join the pool of idle servers.
+ *
+ * @return Zero on success or a value from @ref errno.h.
+ *
+ */
+static errno_t ns_clonable_spawn(void)
+{
+	/*
+	 * Account for the server before spawning it, since spawning
+	 * might block and let another fibril observe the pool.
+	 */
+	cs_spawned++;
+
+	errno_t rc = loader_spawn("loader");
+	if (rc != EOK)
+		cs_spawned--;
+
+	return rc;
+}
+
+/** Top up the pool of idle clonable servers.
+ *
+ * Servers which are already spawned but not yet registered are
+ * counted as idle unless a pending request is waiting for them.
+ *
+ */
+static void ns_clonable_refill(void)
+{
+	while (list_count(&cs_pool) + cs_spawned <
+	    list_count(&cs_req) + CS_POOL_SIZE) {
+		if (ns_clonable_spawn() != EOK)
+			break;
+	}
+}
+
+/** Forward connection request to a clonable server.
+ *
+ * @param csr  Connection request.
+ * @param sess Callback session to the server.
+ *
+ */
+static void ns_clonable_connect(cs_req_t *csr, async_sess_t *sess)
+{
+	/* Currently we can only handle a single type of clonable service. */
+	assert(ns_service_is_clonable(csr->service, csr->iface));
+
+	async_exch_t *exch = async_exchange_begin(sess);
+	async_forward_1(&csr->call, exch, csr->iface,
+	    ipc_get_arg3(&csr->call), IPC_FF_NONE);
+	async_exchange_end(exch);
+
+	async_hangup(sess);
+}
+
 errno_t ns_clonable_init(void)
 {
 	list_initialize(&cs_req);
+	list_initialize(&cs_pool);
+
+	/*
+	 * Pre-spawn the pool so that even the first client does not have
+	 * to wait for a loader to start. Failure is not fatal, the pool
+	 * is refilled on demand.
+	 */
+	ns_clonable_refill();
 	return EOK;
 }
 
@@ -66,42 +146,63 @@ bool ns_service_is_clonable(service_t service, iface_t iface)
 }
 
 /** Register clonable service.
+ *
+ * If there is a pending connection request, it is forwarded to the
+ * server right away. Otherwise the server is kept in the pool of idle
+ * servers until a client asks for it.
  *
  * @param call Pointer to call structure.
  *
  */
 void ns_clonable_register(ipc_call_t *call)
 {
-	link_t *req_link = list_first(&cs_req);
-	if (req_link == NULL) {
-		/* There was no pending connection request. */
+	if (cs_spawned == 0) {
+		/* We did not spawn this server. */
 		printf("%s: Unexpected clonable server.\n", NAME);
 		async_answer_0(call, EBUSY);
 		return;
 	}
 
-	cs_req_t *csr = list_get_instance(req_link, cs_req_t, link);
-	list_remove(req_link);
+	cs_spawned--;
 
-	/* Currently we can only handle a single type of clonable service. */
-	assert(ns_service_is_clonable(csr->service, csr->iface));
+	cs_srv_t *srv = malloc(sizeof(cs_srv_t));
+	if (srv == NULL) {
+		async_answer_0(call, ENOMEM);
+		ns_clonable_refill();
+		return;
+	}
 
 	async_answer_0(call, EOK);
 
-	async_sess_t *sess = async_callback_receive(EXCHANGE_SERIALIZE);
-	if (sess == NULL)
-		async_answer_0(call, EIO);
+	srv->sess = async_callback_receive(EXCHANGE_SERIALIZE);
+	if (srv->sess == NULL) {
+		free(srv);
+		ns_clonable_refill();
+		return;
+	}
 
-	async_exch_t *exch = async_exchange_begin(sess);
-	async_forward_1(&csr->call, exch, csr->iface,
-	    ipc_get_arg3(&csr->call), IPC_FF_NONE);
-	async_exchange_end(exch);
+	link_t *req_link = list_first(&cs_req);
+	if (req_link == NULL) {
+		/* Nobody is waiting, keep the server for later. */
+		link_initialize(&srv->link);
+		list_append(&srv->link, &cs_pool);
+		return;
+	}
+
+	cs_req_t *csr = list_get_instance(req_link, cs_req_t, link);
+	list_remove(req_link);
+
+	ns_clonable_connect(csr, srv->sess);
 
 	free(csr);
-	async_hangup(sess);
+	free(srv);
 }
 
 /** Connect client to clonable service.
+ *
+ * The request is forwarded to an idle server from the pool if there
+ * is one. Otherwise it is queued until a freshly spawned server
+ * registers.
  *
  * @param service Service to be connected to.
  * @param iface   Interface to be connected to.
@@ -120,26 +221,41 @@ void ns_clonable_forward(service_t service, iface_t iface, ipc_call_t *call)
 		return;
 	}
 
-	/* Spawn a loader. */
-	errno_t rc = loader_spawn("loader");
+	link_initialize(&csr->link);
+	csr->service = service;
+	csr->iface = iface;
+	csr->call = *call;
+
+	link_t *srv_link = list_first(&cs_pool);
+	if (srv_link != NULL) {
+		cs_srv_t *srv = list_get_instance(srv_link, cs_srv_t, link);
+		list_remove(srv_link);
+
+		ns_clonable_connect(csr, srv->sess);
+
+		free(csr);
+		free(srv);
+
+		ns_clonable_refill();
+		return;
+	}
 
+	/* Spawn a loader. */
+	errno_t rc = ns_clonable_spawn();
 	if (rc != EOK) {
 		free(csr);
 		async_answer_0(call, rc);
 		return;
 	}
 
-	link_initialize(&csr->link);
-	csr->service = service;
-	csr->iface = iface;
-	csr->call = *call;
-
 	/*
 	 * We can forward the call only after the server we spawned connects
 	 * to us. Meanwhile we might need to service more connection requests.
 	 * Thus we store the call in a queue.
 	 */
 	list_append(&csr->link, &cs_req);
+
+	ns_clonable_refill();
 }
 
 /**
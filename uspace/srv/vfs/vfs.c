@@ -99,6 +99,23 @@ int main(int argc, char **argv)
 		return ENOMEM;
 	}
 
+	/*
+	 * Initialize the directory entry cache.
+	 */
+	if (!vfs_dcache_init()) {
+		printf("%s: Failed to initialize directory entry cache\n",
+		    NAME);
+		return ENOMEM;
+	}
+
+	/*
+	 * Initialize the page cache.
+	 */
+	if (!vfs_pager_init()) {
+		printf("%s: Failed to initialize page cache\n", NAME);
+		return ENOMEM;
+	}
+
 	/*
 	 * Allocate and initialize the Path Lookup Buffer.
 	 */
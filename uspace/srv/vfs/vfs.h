@@ -124,6 +124,16 @@ typedef struct _vfs_node {
 	fibril_rwlock_t contents_rwlock;
 
 	struct _vfs_node *mount;
+
+	/** Pages of the file in the page cache */
+	list_t pages;
+	/** Incremented whenever the cached pages of the file are dropped */
+	unsigned pages_gen;
+	/**
+	 * Number of pager handles pinning the file. The file cannot be
+	 * written to or resized while pinned.
+	 */
+	unsigned pager_pins;
 } vfs_node_t;
 
 /**
@@ -196,6 +206,8 @@ extern void vfs_client_data_destroy(void *);
 
 extern void vfs_op_pass_handle(task_id_t, task_id_t, int);
 extern errno_t vfs_wait_handle_internal(bool, int *);
+extern errno_t vfs_pager_pin_internal(int, sysarg_t *);
+extern vfs_file_t *vfs_pager_file_get(sysarg_t);
 
 extern vfs_file_t *vfs_file_get(int);
 extern void vfs_file_put(vfs_file_t *);
@@ -212,6 +224,7 @@ extern errno_t vfs_op_fsprobe(const char *, service_id_t, vfs_fs_probe_info_t *)
 extern errno_t vfs_op_mount(int mpfd, unsigned servid, unsigned flags, unsigned instance, const char *opts, const char *fsname, int *outfd);
 extern errno_t vfs_op_mtab_get(void);
 extern errno_t vfs_op_open(int fd, int flags);
+extern errno_t vfs_op_pager_pin(int fd, sysarg_t *out_id);
 extern errno_t vfs_op_put(int fd);
 extern errno_t vfs_op_read(int fd, aoff64_t, size_t *out_bytes);
 extern errno_t vfs_op_rename(int basefd, char *old, char *new);
@@ -227,6 +240,15 @@ extern errno_t vfs_op_write(int fd, aoff64_t, size_t *out_bytes);
 
 extern void vfs_register(ipc_call_t *);
 
+extern bool vfs_dcache_init(void);
+extern bool vfs_dcache_lookup(vfs_node_t *, const char *, size_t, int,
+    vfs_lookup_res_t *, errno_t *, unsigned *);
+extern void vfs_dcache_insert(vfs_node_t *, const char *, size_t, int,
+    vfs_lookup_res_t *, unsigned);
+extern void vfs_dcache_flush(bool);
+
+extern bool vfs_pager_init(void);
+extern void vfs_pager_node_release(vfs_node_t *);
 extern void vfs_page_in(ipc_call_t *);
 
 typedef struct {
@@ -234,7 +256,8 @@ typedef struct {
 	size_t size;
 } rdwr_io_chunk_t;
 
-extern errno_t vfs_rdwr_internal(int, aoff64_t, bool, rdwr_io_chunk_t *);
+extern errno_t vfs_rdwr_internal(vfs_file_t *, aoff64_t, bool,
+    rdwr_io_chunk_t *);
 
 extern void vfs_connection(ipc_call_t *, void *);
 
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup vfs
+ * @{
+ */
+
+/**
+ * @file vfs_dcache.c
+ * @brief Directory entry cache.
+ *
+ * The cache remembers results of recent path lookups so that repeated
+ * lookups of the same path can be resolved without asking the file system
+ * servers. An entry maps a base node and a path relative to it to the node
+ * the path resolves to, or records that the path does not exist.
+ *
+ * File system servers resolve all components of a path in one
+ * VFS_OUT_LOOKUP request, so the intermediate nodes are never seen by VFS
+ * and the cached name may span several components.
+ *
+ * Positive entries hold a reference to the node they resolve to, which
+ * keeps its size up to date while the node is not open. Entries are
+ * invalidated wholesale whenever the namespace changes: negative entries
+ * when a name is created, all entries when a name is removed or a file
+ * system is mounted or unmounted. Lookups which query a file system whose
+ * names change without VFS knowing (such as locfs) are not cached.
+ */
+
+#include "vfs.h"
+#include <adt/hash.h>
+#include <adt/hash_table.h>
+#include <adt/list.h>
+#include <fibril_synch.h>
+#include <stdlib.h>
+#include <str.h>
+
+/** Maximum number of cached directory entries. */
+#define VFS_DCACHE_MAX  512
+
+typedef struct {
+	vfs_triplet_t base;
+	int lflag;
+	const char *path;
+	size_t len;
+} dentry_key_t;
+
+typedef struct {
+	ht_link_t link;
+	/** Link to the LRU list. */
+	link_t lru_link;
+
+	vfs_triplet_t base;
+	int lflag;
+	char *path;
+	size_t len;
+
+	/** Node the path resolves to or NULL if it does not exist. */
+	vfs_node_t *node;
+} dentry_t;
+
+static FIBRIL_MUTEX_INITIALIZE(dcache_mutex);
+
+static hash_table_t dcache;
+
+/** Cached entries, least recently used first. */
+static LIST_INITIALIZE(dcache_lru);
+
+/** Incremented by every invalidation. */
+static unsigned dcache_gen = 0;
+
+static size_t dcache_key_hash(const void *arg)
+{
+	const dentry_key_t *key = arg;
+	size_t hash = hash_combine(key->base.fs_handle, key->base.index);
+	hash = hash_combine(hash, key->base.service_id);
+	hash = hash_combine(hash, key->lflag);
+	return hash_combine(hash, hash_bytes(key->path, key->len));
+}
+
+static size_t dcache_hash(const ht_link_t *item)
+{
+	dentry_t *dentry = hash_table_get_inst(item, dentry_t, link);
+	dentry_key_t key = {
+		.base = dentry->base,
+		.lflag = dentry->lflag,
+		.path = dentry->path,
+		.len = dentry->len
+	};
+
+	return dcache_key_hash(&key);
+}
+
+static bool dcache_key_equal(const void *arg, size_t hash,
+    const ht_link_t *item)
+{
+	const dentry_key_t *key = arg;
+	dentry_t *dentry = hash_table_get_inst(item, dentry_t, link);
+
+	return dentry->base.fs_handle == key->base.fs_handle &&
+	    dentry->base.service_id == key->base.service_id &&
+	    dentry->base.index == key->base.index &&
+	    dentry->lflag == key->lflag && dentry->len == key->len &&
+	    memcmp(dentry->path, key->path, key->len) == 0;
+}
+
+static const hash_table_ops_t dcache_ops = {
+	.hash = dcache_hash,
+	.key_hash = dcache_key_hash,
+	.key_equal = dcache_key_equal,
+	.equal = NULL,
+	.remove_callback = NULL
+};
+
+bool vfs_dcache_init(void)
+{
+	return hash_table_create(&dcache, 0, 0, &dcache_ops);
+}
+
+/** Remove entry from the cache.
+ *
+ * The entry is moved to @a dead so that the node references can be
+ * dropped after releasing the cache mutex.
+ */
+static void dcache_remove(dentry_t *dentry, list_t *dead)
+{
+	hash_table_remove_item(&dcache, &dentry->link);
+	list_remove(&dentry->lru_link);
+	list_append(&dentry->lru_link, dead);
+}
+
+static void dcache_destroy_dead(list_t *dead)
+{
+	link_t *link;
+
+	while ((link = list_first(dead)) != NULL) {
+		dentry_t *dentry = list_get_instance(link, dentry_t, lru_link);
+		list_remove(link);
+
+		if (dentry->node != NULL)
+			vfs_node_put(dentry->node);
+		free(dentry->path);
+		free(dentry);
+	}
+}
+
+/** Look up a path in the directory entry cache.
+ *
+ * @param base    Node from which the lookup is performed.
+ * @param path    Path relative to @a base, not necessarily NULL-terminated.
+ * @param len     Length of @a path.
+ * @param lflag   Lookup flags.
+ * @param result  Where to store the cached result. Can be NULL.
+ * @param rc      Where to store the cached return code on a hit.
+ * @param gen     Where to store the cache generation on a miss, to be
+ *                passed to vfs_dcache_insert().
+ *
+ * @return True on a hit.
+ */
+bool vfs_dcache_lookup(vfs_node_t *base, const char *path, size_t len,
+    int lflag, vfs_lookup_res_t *result, errno_t *rc, unsigned *gen)
+{
+	dentry_key_t key = {
+		.base = *((vfs_triplet_t *) base),
+		.lflag = lflag,
+		.path = path,
+		.len = len
+	};
+
+	fibril_mutex_lock(&dcache_mutex);
+
+	ht_link_t *item = hash_table_find(&dcache, &key);
+	if (item == NULL) {
+		*gen = dcache_gen;
+		fibril_mutex_unlock(&dcache_mutex);
+		return false;
+	}
+
+	dentry_t *dentry = hash_table_get_inst(item, dentry_t, link);
+	list_remove(&dentry->lru_link);
+	list_append(&dentry->lru_link, &dcache_lru);
+
+	if (dentry->node == NULL) {
+		*rc = ENOENT;
+	} else {
+		*rc = EOK;
+		if (result != NULL) {
+			result->triplet = *((vfs_triplet_t *) dentry->node);
+			result->type = dentry->node->type;
+			result->size = dentry->node->size;
+		}
+	}
+
+	fibril_mutex_unlock(&dcache_mutex);
+	return true;
+}
+
+/** Insert result of a path lookup into the directory entry cache.
+ *
+ * Nothing is inserted if the cache has been invalidated since @a gen
+ * was obtained, because the result might already be stale.
+ *
+ * @param base    Node from which the lookup was performed.
+ * @param path    Path relative to @a base, not necessarily NULL-terminated.
+ * @param len     Length of @a path.
+ * @param lflag   Lookup flags.
+ * @param result  Lookup result or NULL if the path does not exist.
+ * @param gen     Cache generation returned by vfs_dcache_lookup().
+ */
+void vfs_dcache_insert(vfs_node_t *base, const char *path, size_t len,
+    int lflag, vfs_lookup_res_t *result, unsigned gen)
+{
+	dentry_t *dentry = malloc(sizeof(dentry_t));
+	if (dentry == NULL)
+		return;
+
+	dentry->path = malloc(len);
+	if (dentry->path == NULL) {
+		free(dentry);
+		return;
+	}
+
+	memcpy(dentry->path, path, len);
+	dentry->len = len;
+	dentry->base = *((vfs_triplet_t *) base);
+	dentry->lflag = lflag;
+	link_initialize(&dentry->lru_link);
+
+	dentry->node = NULL;
+	if (result != NULL) {
+		dentry->node = vfs_node_get(result);
+		if (dentry->node == NULL) {
+			free(dentry->path);
+			free(dentry);
+			return;
+		}
+	}
+
+	list_t dead;
+	list_initialize(&dead);
+
+	fibril_mutex_lock(&dcache_mutex);
+
+	dentry_key_t key = {
+		.base = dentry->base,
+		.lflag = lflag,
+		.path = dentry->path,
+		.len = len
+	};
+
+	if ((gen != dcache_gen) || (hash_table_find(&dcache, &key) != NULL)) {
+		/* Stale or already cached by someone else */
+		list_append(&dentry->lru_link, &dead);
+	} else {
+		if (hash_table_size(&dcache) >= VFS_DCACHE_MAX) {
+			dcache_remove(list_get_instance(list_first(&dcache_lru),
+			    dentry_t, lru_link), &dead);
+		}
+
+		hash_table_insert(&dcache, &dentry->link);
+		list_append(&dentry->lru_link, &dcache_lru);
+	}
+
+	fibril_mutex_unlock(&dcache_mutex);
+
+	dcache_destroy_dead(&dead);
+}
+
+/** Invalidate the directory entry cache.
+ *
+ * @param negative_only Only drop entries recording non-existent paths.
+ *                      This is sufficient when names are being created.
+ */
+void vfs_dcache_flush(bool negative_only)
+{
+	list_t dead;
+	list_initialize(&dead);
+
+	fibril_mutex_lock(&dcache_mutex);
+
+	dcache_gen++;
+
+	link_t *link = list_first(&dcache_lru);
+	while (link != NULL) {
+		dentry_t *dentry = list_get_instance(link, dentry_t, lru_link);
+		link = list_next(link, &dcache_lru);
+
+		if (!negative_only || dentry->node == NULL)
+			dcache_remove(dentry, &dead);
+	}
+
+	fibril_mutex_unlock(&dcache_mutex);
+
+	dcache_destroy_dead(&dead);
+}
+
+/**
+ * @}
+ */
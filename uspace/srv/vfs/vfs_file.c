@@ -54,6 +54,8 @@ typedef struct {
 	fibril_mutex_t lock;
 	fibril_condvar_t cv;
 	list_t passed_handles;
+	list_t pager_pins;
+	sysarg_t pager_next_id;
 	vfs_file_t **files;
 } vfs_client_data_t;
 
@@ -63,7 +65,20 @@ typedef struct {
 	int permissions;
 } vfs_boxed_handle_t;
 
+/** File pinned for the VFS pager.
+ *
+ * The client cannot see or close the pin, which lasts until the client
+ * goes away.
+ */
+typedef struct {
+	link_t link;
+	/** Pager handle */
+	sysarg_t id;
+	vfs_file_t *file;
+} vfs_pager_pin_t;
+
 static errno_t _vfs_fd_free(vfs_client_data_t *, int);
+static errno_t vfs_file_delref(vfs_client_data_t *, vfs_file_t *);
 
 /** Initialize the table of open files. */
 static bool vfs_files_init(vfs_client_data_t *vfs_data)
@@ -81,11 +96,34 @@ static bool vfs_files_init(vfs_client_data_t *vfs_data)
 	return true;
 }
 
+/** Release the files pinned for the VFS pager. */
+static void vfs_pager_pins_done(vfs_client_data_t *vfs_data)
+{
+	while (!list_empty(&vfs_data->pager_pins)) {
+		vfs_pager_pin_t *pin;
+
+		pin = list_get_instance(list_first(&vfs_data->pager_pins),
+		    vfs_pager_pin_t, link);
+		list_remove(&pin->link);
+
+		fibril_rwlock_write_lock(&pin->file->node->contents_rwlock);
+		pin->file->node->pager_pins--;
+		fibril_rwlock_write_unlock(&pin->file->node->contents_rwlock);
+
+		fibril_mutex_lock(&vfs_data->lock);
+		(void) vfs_file_delref(vfs_data, pin->file);
+		fibril_mutex_unlock(&vfs_data->lock);
+		free(pin);
+	}
+}
+
 /** Cleanup the table of open files. */
 static void vfs_files_done(vfs_client_data_t *vfs_data)
 {
 	int i;
 
+	vfs_pager_pins_done(vfs_data);
+
 	if (!vfs_data->files)
 		return;
 
@@ -117,6 +155,8 @@ void *vfs_client_data_create(void)
 		fibril_mutex_initialize(&vfs_data->lock);
 		fibril_condvar_initialize(&vfs_data->cv);
 		list_initialize(&vfs_data->passed_handles);
+		list_initialize(&vfs_data->pager_pins);
+		vfs_data->pager_next_id = 1;
 		vfs_data->files = NULL;
 	}
 
@@ -455,6 +495,80 @@ errno_t vfs_wait_handle_internal(bool high_fd, int *out_fd)
 	return EOK;
 }
 
+/** Pin a file for the VFS pager.
+ *
+ * The pager handle refers to the open file independently of the file
+ * descriptor, so the client can put the descriptor while the file stays
+ * mapped. The file cannot be written to or resized while pinned.
+ *
+ * @param fd		File descriptor of a file open for reading
+ * @param[out] out_id	Pager handle
+ *
+ * @return		EOK on success or an error code
+ */
+errno_t vfs_pager_pin_internal(int fd, sysarg_t *out_id)
+{
+	vfs_client_data_t *vfs_data = VFS_DATA;
+
+	vfs_file_t *file = _vfs_file_get(vfs_data, fd);
+	if (!file)
+		return EBADF;
+
+	if (!file->open_read || file->node->type != VFS_NODE_FILE) {
+		_vfs_file_put(vfs_data, file);
+		return EINVAL;
+	}
+
+	vfs_pager_pin_t *pin = malloc(sizeof(vfs_pager_pin_t));
+	if (!pin) {
+		_vfs_file_put(vfs_data, file);
+		return ENOMEM;
+	}
+
+	fibril_rwlock_write_lock(&file->node->contents_rwlock);
+	file->node->pager_pins++;
+	fibril_rwlock_write_unlock(&file->node->contents_rwlock);
+
+	link_initialize(&pin->link);
+	pin->file = file;
+
+	fibril_mutex_lock(&vfs_data->lock);
+	vfs_file_addref(vfs_data, file);
+	pin->id = vfs_data->pager_next_id++;
+	list_append(&pin->link, &vfs_data->pager_pins);
+	fibril_mutex_unlock(&vfs_data->lock);
+
+	*out_id = pin->id;
+	_vfs_file_put(vfs_data, file);
+	return EOK;
+}
+
+/** Find the file pinned under a pager handle.
+ *
+ * @param id		Pager handle
+ *
+ * @return		File structure, must be put afterwards, or @c NULL
+ */
+vfs_file_t *vfs_pager_file_get(sysarg_t id)
+{
+	vfs_client_data_t *vfs_data = VFS_DATA;
+
+	fibril_mutex_lock(&vfs_data->lock);
+	list_foreach(vfs_data->pager_pins, link, vfs_pager_pin_t, pin) {
+		if (pin->id == id) {
+			vfs_file_t *file = pin->file;
+			vfs_file_addref(vfs_data, file);
+			fibril_mutex_unlock(&vfs_data->lock);
+
+			fibril_mutex_lock(&file->_lock);
+			return file;
+		}
+	}
+	fibril_mutex_unlock(&vfs_data->lock);
+
+	return NULL;
+}
+
 /**
  * @}
  */
@@ -165,6 +165,15 @@ static void vfs_in_open(ipc_call_t *req)
 	async_answer_0(req, rc);
 }
 
+static void vfs_in_pager_pin(ipc_call_t *req)
+{
+	int fd = ipc_get_arg1(req);
+	sysarg_t id = 0;
+
+	errno_t rc = vfs_op_pager_pin(fd, &id);
+	async_answer_1(req, rc, id);
+}
+
 static void vfs_in_put(ipc_call_t *req)
 {
 	int fd = ipc_get_arg1(req);
@@ -350,6 +359,9 @@ void vfs_connection(ipc_call_t *icall, void *arg)
 		case VFS_IN_OPEN:
 			vfs_in_open(&call);
 			break;
+		case VFS_IN_PAGER_PIN:
+			vfs_in_pager_pin(&call);
+			break;
 		case VFS_IN_PUT:
 			vfs_in_put(&call);
 			break;
@@ -202,6 +202,10 @@ errno_t vfs_link_internal(vfs_node_t *base, char *path, vfs_triplet_t *child)
 	if (orig_rc != EOK)
 		rc = orig_rc;
 
+	/* The new name may be cached as non-existent */
+	if (rc == EOK)
+		vfs_dcache_flush(true);
+
 out:
 	return rc;
 }
@@ -243,6 +247,16 @@ static errno_t _vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 	size_t first;
 	errno_t rc;
 
+	/* Lookups which create or remove names must reach the file system */
+	bool cacheable = !(lflag & (L_CREATE | L_EXCLUSIVE | L_UNLINK));
+	unsigned gen;
+
+	if (cacheable &&
+	    vfs_dcache_lookup(base, path, len, lflag, result, &rc, &gen))
+		return rc;
+
+	vfs_node_t *orig_base = base;
+
 	plb_entry_t entry;
 	rc = plb_insert_entry(&entry, path, &first, len);
 	if (rc != EOK)
@@ -264,6 +278,11 @@ static errno_t _vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 			base = base->mount;
 		}
 
+		/* Names on some file systems change behind our back */
+		vfs_info_t *fs_info = fs_handle_to_info(base->fs_handle);
+		if (fs_info != NULL && fs_info->uncached_lookup)
+			cacheable = false;
+
 		rc = out_lookup((vfs_triplet_t *) base, &next, &nlen, lflag,
 		    &res);
 		if (rc != EOK)
@@ -318,6 +337,12 @@ static errno_t _vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 
 out:
 	plb_clear_entry(&entry, first, len);
+
+	if (cacheable && rc == EOK && result != NULL)
+		vfs_dcache_insert(orig_base, path, len, lflag, result, gen);
+	else if (cacheable && rc == ENOENT)
+		vfs_dcache_insert(orig_base, path, len, lflag, NULL, gen);
+
 	return rc;
 }
 
@@ -350,6 +375,15 @@ errno_t vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 
 	assert(path[0] == '/');
 
+	if (lflag & L_UNLINK) {
+		/*
+		 * Drop all cached entries, and the node references they
+		 * hold, before the name disappears. Otherwise the file system
+		 * would not be asked to destroy the node once it is unlinked.
+		 */
+		vfs_dcache_flush(false);
+	}
+
 	if (lflag & (L_CREATE | L_UNLINK)) {
 
 		/*
@@ -387,6 +421,10 @@ errno_t vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 
 		vfs_node_put(parent);
 
+		/* The name may have been created, forget it did not exist */
+		if ((rc == EOK) && (lflag & L_CREATE))
+			vfs_dcache_flush(true);
+
 	} else {
 		rc = _vfs_lookup_internal(base, path, lflag, result, len);
 	}
@@ -271,6 +271,9 @@ errno_t vfs_op_mount(int mpfd, unsigned service_id, unsigned flags,
 		vfs_node_addref(mp->node);
 		vfs_node_addref(root);
 		mp->node->mount = root;
+
+		/* Cached lookups did not cross the new mount point */
+		vfs_dcache_flush(false);
 	}
 
 	fibril_rwlock_write_unlock(&namespace_rwlock);
@@ -348,6 +351,11 @@ errno_t vfs_op_open(int fd, int mode)
 	return EOK;
 }
 
+errno_t vfs_op_pager_pin(int fd, sysarg_t *out_id)
+{
+	return vfs_pager_pin_internal(fd, out_id);
+}
+
 typedef errno_t (*rdwr_ipc_cb_t)(async_exch_t *, vfs_file_t *, aoff64_t,
     ipc_call_t *, bool, void *);
 
@@ -407,28 +415,11 @@ static errno_t rdwr_ipc_internal(async_exch_t *exch, vfs_file_t *file, aoff64_t
 	return (errno_t) rc;
 }
 
-static errno_t vfs_rdwr(int fd, aoff64_t pos, bool read, rdwr_ipc_cb_t ipc_cb,
-    void *ipc_cb_data)
+static errno_t vfs_rdwr_file(vfs_file_t *file, aoff64_t pos, bool read,
+    rdwr_ipc_cb_t ipc_cb, void *ipc_cb_data)
 {
-	/*
-	 * The following code strongly depends on the fact that the files data
-	 * structure can be only accessed by a single fibril and all file
-	 * operations are serialized (i.e. the reads and writes cannot
-	 * interleave and a file cannot be closed while it is being read).
-	 *
-	 * Additional synchronization needs to be added once the table of
-	 * open files supports parallel access!
-	 */
-
-	/* Lookup the file structure corresponding to the file descriptor. */
-	vfs_file_t *file = vfs_file_get(fd);
-	if (!file)
-		return EBADF;
-
-	if ((read && !file->open_read) || (!read && !file->open_write)) {
-		vfs_file_put(file);
+	if ((read && !file->open_read) || (!read && !file->open_write))
 		return EINVAL;
-	}
 
 	vfs_info_t *fs_info = fs_handle_to_info(file->node->fs_handle);
 	assert(fs_info);
@@ -460,13 +451,21 @@ static errno_t vfs_rdwr(int fd, aoff64_t pos, bool read, rdwr_ipc_cb_t ipc_cb,
 				fibril_rwlock_write_unlock(
 				    &file->node->contents_rwlock);
 			}
-			vfs_file_put(file);
 			return EINVAL;
 		}
 
 		fibril_rwlock_read_lock(&namespace_rwlock);
 	}
 
+	/* The file is mapped by the pager, do not change its contents */
+	if (!read && file->node->pager_pins > 0) {
+		if (rlock)
+			fibril_rwlock_read_unlock(&file->node->contents_rwlock);
+		else
+			fibril_rwlock_write_unlock(&file->node->contents_rwlock);
+		return ETXTBSY;
+	}
+
 	async_exch_t *fs_exch = vfs_exchange_grab(file->node->fs_handle);
 
 	if (!read && file->append)
@@ -495,14 +494,42 @@ static errno_t vfs_rdwr(int fd, aoff64_t pos, bool read, rdwr_ipc_cb_t ipc_cb,
 		fibril_rwlock_write_unlock(&file->node->contents_rwlock);
 	}
 
+	/* Cached pages of the file are no longer valid */
+	if (!read && rc == EOK)
+		vfs_pager_node_release(file->node);
+
+	return rc;
+}
+
+static errno_t vfs_rdwr(int fd, aoff64_t pos, bool read, rdwr_ipc_cb_t ipc_cb,
+    void *ipc_cb_data)
+{
+	/*
+	 * The following code strongly depends on the fact that the files data
+	 * structure can be only accessed by a single fibril and all file
+	 * operations are serialized (i.e. the reads and writes cannot
+	 * interleave and a file cannot be closed while it is being read).
+	 *
+	 * Additional synchronization needs to be added once the table of
+	 * open files supports parallel access!
+	 */
+
+	/* Lookup the file structure corresponding to the file descriptor. */
+	vfs_file_t *file = vfs_file_get(fd);
+	if (!file)
+		return EBADF;
+
+	errno_t rc = vfs_rdwr_file(file, pos, read, ipc_cb, ipc_cb_data);
+
 	vfs_file_put(file);
 
 	return rc;
 }
 
-errno_t vfs_rdwr_internal(int fd, aoff64_t pos, bool read, rdwr_io_chunk_t *chunk)
+errno_t vfs_rdwr_internal(vfs_file_t *file, aoff64_t pos, bool read,
+    rdwr_io_chunk_t *chunk)
 {
-	return vfs_rdwr(fd, pos, read, rdwr_ipc_internal, chunk);
+	return vfs_rdwr_file(file, pos, read, rdwr_ipc_internal, chunk);
 }
 
 errno_t vfs_op_read(int fd, aoff64_t pos, size_t *out_bytes)
@@ -624,12 +651,22 @@ errno_t vfs_op_resize(int fd, int64_t size)
 
 	fibril_rwlock_write_lock(&file->node->contents_rwlock);
 
+	/* The file is mapped by the pager, do not change its contents */
+	if (file->node->pager_pins > 0) {
+		fibril_rwlock_write_unlock(&file->node->contents_rwlock);
+		vfs_file_put(file);
+		return ETXTBSY;
+	}
+
 	errno_t rc = vfs_truncate_internal(file->node->fs_handle,
 	    file->node->service_id, file->node->index, size);
 	if (rc == EOK)
 		file->node->size = size;
 
 	fibril_rwlock_write_unlock(&file->node->contents_rwlock);
+
+	if (rc == EOK)
+		vfs_pager_node_release(file->node);
 	vfs_file_put(file);
 	return rc;
 }
@@ -797,6 +834,9 @@ errno_t vfs_op_unmount(int mpfd)
 
 	fibril_rwlock_write_lock(&namespace_rwlock);
 
+	/* Release references held by cached lookups */
+	vfs_dcache_flush(false);
+
 	/*
 	 * Count the total number of references for the mounted file system. We
 	 * are expecting at least one, which is held by the mount point.
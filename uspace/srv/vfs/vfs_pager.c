@@ -36,37 +36,106 @@
  */
 
 #include "vfs.h"
+#include <adt/hash.h>
+#include <adt/hash_table.h>
+#include <adt/list.h>
 #include <async.h>
 #include <fibril_synch.h>
 #include <errno.h>
 #include <as.h>
+#include <macros.h>
+#include <smc.h>
+#include <stdlib.h>
 
-void vfs_page_in(ipc_call_t *req)
+/** Maximum number of pages kept in the page cache */
+#define VFS_PAGE_CACHE_MAX	1024
+
+/** Page of file data shared by read-only mappings of the file */
+typedef struct {
+	/** Link to vfs_pages */
+	ht_link_t lpages;
+	/** Link to vfs_pages_lru */
+	link_t llru;
+	/** Link to vfs_node_t.pages */
+	link_t lnode;
+	/** Node the page belongs to */
+	vfs_node_t *node;
+	/** Offset of the data in the file */
+	aoff64_t offset;
+	/** Number of bytes of file data in the page, the rest is zero */
+	size_t size;
+	/** Page in VFS address space */
+	void *page;
+} vfs_page_t;
+
+typedef struct {
+	vfs_node_t *node;
+	aoff64_t offset;
+	size_t size;
+} vfs_page_key_t;
+
+static size_t pages_key_hash(const void *);
+static size_t pages_hash(const ht_link_t *);
+static bool pages_key_equal(const void *, size_t, const ht_link_t *);
+
+static const hash_table_ops_t pages_ops = {
+	.hash = pages_hash,
+	.key_hash = pages_key_hash,
+	.key_equal = pages_key_equal,
+	.equal = NULL,
+	.remove_callback = NULL
+};
+
+/** Protects the page cache */
+static FIBRIL_MUTEX_INITIALIZE(pages_mutex);
+/** Cached pages (vfs_page_t) */
+static hash_table_t vfs_pages;
+/** Cached pages (vfs_page_t) in least-recently-used order */
+static LIST_INITIALIZE(vfs_pages_lru);
+/** Number of cached pages */
+static size_t vfs_pages_cnt;
+
+/** Initialize the page cache.
+ *
+ * @return		Return true on success, false on failure.
+ */
+bool vfs_pager_init(void)
+{
+	return hash_table_create(&vfs_pages, 0, 0, &pages_ops);
+}
+
+/** Allocate page and fill it with file data.
+ *
+ * @param file		Pinned file
+ * @param offset	Offset of the data in the file
+ * @param page_size	Page size
+ * @param size		Number of bytes to read, the rest of the page is zero
+ * @param rpage		Place to store pointer to the page
+ *
+ * @return		EOK on success or an error code
+ */
+static errno_t vfs_page_read(vfs_file_t *file, aoff64_t offset,
+    size_t page_size, size_t size, void **rpage)
 {
-	aoff64_t offset = ipc_get_arg1(req);
-	size_t page_size = ipc_get_arg2(req);
-	int fd = ipc_get_arg3(req);
 	void *page;
-	errno_t rc;
+	errno_t rc = EOK;
 
 	page = as_area_create(AS_AREA_ANY, page_size,
 	    AS_AREA_READ | AS_AREA_WRITE | AS_AREA_CACHEABLE,
 	    AS_AREA_UNPAGED);
 
-	if (page == AS_MAP_FAILED) {
-		async_answer_0(req, ENOMEM);
-		return;
-	}
+	if (page == AS_MAP_FAILED)
+		return ENOMEM;
 
 	rdwr_io_chunk_t chunk = {
 		.buffer = page,
-		.size = page_size
+		.size = size
 	};
 
 	size_t total = 0;
 	aoff64_t pos = offset;
-	do {
-		rc = vfs_rdwr_internal(fd, pos, true, &chunk);
+	while (total < size) {
+		rc = vfs_rdwr_internal(file, pos, true, &chunk);
 		if (rc != EOK)
 			break;
 		if (chunk.size == 0)
@@ -74,20 +143,244 @@ void vfs_page_in(ipc_call_t *req)
 		total += chunk.size;
 		pos += chunk.size;
 		chunk.buffer += chunk.size;
-		chunk.size = page_size - total;
-	} while (total < page_size);
+		chunk.size = size - total;
+	}
+
+	if (rc != EOK) {
+		as_area_destroy(page);
+		return rc;
+	}
+
+	*rpage = page;
+	return EOK;
+}
+
+/** Remove page from the page cache and free it.
+ *
+ * Mappings of the page in other tasks are not affected.
+ *
+ * @param vpage		Page
+ */
+static void vfs_page_remove(vfs_page_t *vpage)
+{
+	assert(fibril_mutex_is_locked(&pages_mutex));
+
+	hash_table_remove_item(&vfs_pages, &vpage->lpages);
+	list_remove(&vpage->llru);
+	list_remove(&vpage->lnode);
+	vfs_pages_cnt--;
+
+	as_area_destroy(vpage->page);
+	free(vpage);
+}
+
+/** Drop all cached pages of a node.
+ *
+ * Called when the node's contents change or the node goes away.
+ *
+ * @param node		VFS node
+ */
+void vfs_pager_node_release(vfs_node_t *node)
+{
+	fibril_mutex_lock(&pages_mutex);
+
+	node->pages_gen++;
+	while (!list_empty(&node->pages)) {
+		vfs_page_t *vpage = list_get_instance(list_first(&node->pages),
+		    vfs_page_t, lnode);
+		vfs_page_remove(vpage);
+	}
+
+	fibril_mutex_unlock(&pages_mutex);
+}
+
+/** Serve page-in request from the page cache.
+ *
+ * On a miss the page is read from the file and cached.
+ *
+ * @param req		Page-in request
+ * @param file		Pinned file
+ * @param key		Node, offset and size of the data
+ * @param page_size	Page size
+ */
+static void vfs_page_in_shared(ipc_call_t *req, vfs_file_t *file,
+    vfs_page_key_t *key, size_t page_size)
+{
+	vfs_page_t *vpage;
+	unsigned gen;
+	void *page;
+	errno_t rc;
+
+	fibril_mutex_lock(&pages_mutex);
+
+	ht_link_t *link = hash_table_find(&vfs_pages, key);
+	if (link != NULL) {
+		vpage = hash_table_get_inst(link, vfs_page_t, lpages);
+		list_remove(&vpage->llru);
+		list_append(&vpage->llru, &vfs_pages_lru);
+		/* The kernel takes its own reference to the frame */
+		async_answer_1(req, EOK, (sysarg_t) vpage->page);
+		fibril_mutex_unlock(&pages_mutex);
+		return;
+	}
 
-	async_answer_1(req, rc, (sysarg_t) page);
+	gen = key->node->pages_gen;
+	fibril_mutex_unlock(&pages_mutex);
+
+	rc = vfs_page_read(file, key->offset, page_size, key->size, &page);
+	if (rc != EOK) {
+		async_answer_0(req, rc);
+		return;
+	}
+
+	/* The page may be executed by the client */
+	(void) smc_coherence(page, page_size);
+
+	vpage = calloc(1, sizeof(vfs_page_t));
+	if (vpage == NULL) {
+		/* Serve the page uncached */
+		async_answer_1(req, EOK, (sysarg_t) page);
+		as_area_destroy(page);
+		return;
+	}
+
+	vpage->node = key->node;
+	vpage->offset = key->offset;
+	vpage->size = key->size;
+	vpage->page = page;
+
+	fibril_mutex_lock(&pages_mutex);
+
+	if (key->node->pages_gen != gen) {
+		/*
+		 * The cached pages were dropped while we were reading, the
+		 * data might be stale already. Serve the page uncached.
+		 */
+		fibril_mutex_unlock(&pages_mutex);
+		free(vpage);
+		async_answer_1(req, EOK, (sysarg_t) page);
+		as_area_destroy(page);
+		return;
+	}
+
+	/* Someone else could have read the same page in the meantime */
+	link = hash_table_find(&vfs_pages, key);
+	if (link != NULL) {
+		free(vpage);
+		as_area_destroy(page);
+		vpage = hash_table_get_inst(link, vfs_page_t, lpages);
+	} else {
+		hash_table_insert(&vfs_pages, &vpage->lpages);
+		list_append(&vpage->lnode, &key->node->pages);
+		list_append(&vpage->llru, &vfs_pages_lru);
+		vfs_pages_cnt++;
+	}
+
+	async_answer_1(req, EOK, (sysarg_t) vpage->page);
+
+	while (vfs_pages_cnt > VFS_PAGE_CACHE_MAX) {
+		vfs_page_remove(list_get_instance(list_first(&vfs_pages_lru),
+		    vfs_page_t, llru));
+	}
+
+	fibril_mutex_unlock(&pages_mutex);
+}
+
+/** Serve page-in request.
+ *
+ * Pager IDs are the pager handle of a pinned file (possibly with
+ * VFS_PAGER_SHARED), the offset of the area in the file and the number
+ * of bytes of the area backed by the file (zero meaning up to the end
+ * of file).
+ *
+ * @param req		Page-in request
+ */
+void vfs_page_in(ipc_call_t *req)
+{
+	aoff64_t area_offset = ipc_get_arg1(req);
+	size_t page_size = ipc_get_arg2(req);
+	sysarg_t id1 = ipc_get_arg3(req);
+	aoff64_t file_offset = ipc_get_arg4(req);
+	size_t file_size = ipc_get_arg5(req);
+	vfs_file_t *file;
+	size_t size;
+	void *page;
+	errno_t rc;
+
+	size = page_size;
+	if (file_size != 0) {
+		if (area_offset >= file_size)
+			size = 0;
+		else
+			size = min(page_size, file_size - area_offset);
+	}
+
+	file = vfs_pager_file_get(id1 & ~VFS_PAGER_SHARED);
+	if (file == NULL) {
+		async_answer_0(req, EBADF);
+		return;
+	}
+
+	if ((id1 & VFS_PAGER_SHARED) != 0 && size > 0) {
+		vfs_page_key_t key = {
+			.node = file->node,
+			.offset = file_offset + area_offset,
+			.size = size
+		};
+
+		vfs_page_in_shared(req, file, &key, page_size);
+		vfs_file_put(file);
+		return;
+	}
+
+	/* Private page */
+	rc = vfs_page_read(file, file_offset + area_offset, page_size, size,
+	    &page);
+	vfs_file_put(file);
+	if (rc != EOK) {
+		async_answer_0(req, rc);
+		return;
+	}
+
+	async_answer_1(req, EOK, (sysarg_t) page);
 
 	/*
-	 * FIXME:
-	 * This is just for now until we implement proper page cache
-	 * management.  Not keeping the pages around in a cache results in
-	 * inherently non-coherent private mappings.
+	 * The client got its own reference to the frame, writes to
+	 * the page are private to the client.
 	 */
 	as_area_destroy(page);
 }
 
+static size_t pages_key_hash(const void *key)
+{
+	const vfs_page_key_t *pkey = key;
+	size_t hash = hash_combine((uintptr_t) pkey->node,
+	    hash_mix64(pkey->offset));
+	return hash_combine(hash, pkey->size);
+}
+
+static size_t pages_hash(const ht_link_t *item)
+{
+	vfs_page_t *vpage = hash_table_get_inst(item, vfs_page_t, lpages);
+	vfs_page_key_t key = {
+		.node = vpage->node,
+		.offset = vpage->offset,
+		.size = vpage->size
+	};
+
+	return pages_key_hash(&key);
+}
+
+static bool pages_key_equal(const void *key, size_t hash,
+    const ht_link_t *item)
+{
+	const vfs_page_key_t *pkey = key;
+	vfs_page_t *vpage = hash_table_get_inst(item, vfs_page_t, lpages);
+
+	return vpage->node == pkey->node && vpage->offset == pkey->offset &&
+	    vpage->size == pkey->size;
+}
+
 /**
  * @}
  */